@@ -0,0 +1,232 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as published by the
+	Free Software Foundation, either version 3 of the License, or (at your option)
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+// Random A* queries on the maps we ship. Every path found is checked against a
+// Dijkstra on the same node graph : same reachability, same length. Then the
+// queries are timed.
+//
+// Usage : aStarBench Content/main/maps/*.bvm
+
+#include "CAStar.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <vector>
+
+
+#define NB_CHECK 200
+#define NB_QUERY 2000
+
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+//
+// The passable cells of a .bvm, padded to a power of two like Map does for the A*
+//
+static bool loadMap(const char * filename, std::vector<unsigned char> & passables, int & sizeX, int & sizeY)
+{
+	FILE * file = fopen(filename, "rb");
+	if (!file) return false;
+	std::vector<unsigned char> data;
+	unsigned char buffer[4096];
+	size_t nb;
+	while ((nb = fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + nb);
+	fclose(file);
+
+	size_t pos = 0;
+	unsigned int version;
+	if (data.size() < 4) return false;
+	memcpy(&version, &data[0], 4);
+	pos += 4;
+	switch (version)
+	{
+	case 10010:
+	case 10011: break;
+	case 20201: pos += 4; break; // theme, weather
+	case 20202: pos += 25 + 4; break; // author, theme, weather
+	default: return false;
+	}
+
+	// The "ints" of the map files are shorts (see CBinaryReader::getInt)
+	short size[2];
+	if (data.size() < pos + 4) return false;
+	memcpy(size, &data[pos], 4);
+	pos += 4;
+	if (size[0] <= 0 || size[1] <= 0 || size[0] > 512 || size[1] > 512) return false;
+	if (data.size() < pos + (size_t)(size[0] * size[1] * 2)) return false;
+
+	sizeX = 1;
+	while (sizeX < size[0]) sizeX *= 2;
+	sizeY = 1;
+	while (sizeY < size[1]) sizeY *= 2;
+	passables.assign(sizeX * sizeY, 0);
+	for (int j=0;j<size[1];++j)
+	{
+		for (int i=0;i<size[0];++i)
+		{
+			if (data[pos + (j * size[0] + i) * 2] & 128) passables[j * sizeX + i] = 255;
+		}
+	}
+	return true;
+}
+
+
+
+//
+// Shortest length from one node to the other, FLT_MAX if we can't get there
+//
+static float dijkstra(CAStar & aStar, int in_start, int in_end, std::vector<float> & dist)
+{
+	typedef std::pair<float, int> entry;
+	std::priority_queue<entry, std::vector<entry>, std::greater<entry> > open;
+	dist.assign(aStar.GetNodeCount(), FLT_MAX);
+	dist[in_start] = 0;
+	open.push(entry(0.0f, in_start));
+	while (!open.empty())
+	{
+		entry top = open.top();
+		open.pop();
+		if (top.second == in_end) return top.first;
+		if (top.first > dist[top.second]) continue;
+		for (int i=aStar.GetNeighborStart(top.second);i<aStar.GetNeighborStart(top.second + 1);++i)
+		{
+			int n = aStar.GetNeighbor(i);
+			float d = top.first + aStar.GetNeighborCost(i);
+			if (d < dist[n])
+			{
+				dist[n] = d;
+				open.push(entry(d, n));
+			}
+		}
+	}
+	return FLT_MAX;
+}
+
+
+
+//
+// Length of the path A* left in the parent links
+//
+static float pathLength(CPathNode * in_end)
+{
+	float length = 0;
+	for (CPathNode * node = in_end;node->parentNode;node = node->parentNode)
+	{
+		float dx = node->m_centerX - node->parentNode->m_centerX;
+		float dy = node->m_centerY - node->parentNode->m_centerY;
+		length += sqrtf(dx * dx + dy * dy);
+	}
+	return length;
+}
+
+
+
+int main(int argc, char ** argv)
+{
+	if (argc < 2)
+	{
+		printf("Usage : aStarBench map.bvm ...\n");
+		return 1;
+	}
+
+	srand(1234);
+	int nbMap = 0;
+	int nbChecked = 0;
+	int nbWrong = 0;
+	int nbQuery = 0;
+	double totalMs = 0;
+	std::vector<float> dist;
+
+	for (int m=1;m<argc;++m)
+	{
+		std::vector<unsigned char> passables;
+		int sizeX, sizeY;
+		if (!loadMap(argv[m], passables, sizeX, sizeY))
+		{
+			printf("%s : can't read it\n", argv[m]);
+			continue;
+		}
+
+		CAStar aStar;
+		if (!aStar.Build(&passables[0], sizeX, sizeY)) continue;
+
+		std::vector<int> cells;
+		for (int i=0;i<sizeX*sizeY;++i)
+		{
+			if (passables[i]) cells.push_back(i);
+		}
+		if (cells.size() < 2) continue;
+		nbMap++;
+
+		//--- Same as a Dijkstra ?
+		int nbMapWrong = 0;
+		for (int q=0;q<NB_CHECK;++q)
+		{
+			int from = cells[rand() % cells.size()];
+			int to = cells[rand() % cells.size()];
+			CPathNode * start = aStar.GetNodeAt(from % sizeX, from / sizeX);
+			CPathNode * end = aStar.GetNodeAt(to % sizeX, to / sizeX);
+			if (start == end) continue;
+
+			float expected = dijkstra(aStar, aStar.GetNodeIndex(start), aStar.GetNodeIndex(end), dist);
+			CPathNode * result = aStar.FindPath(start, end);
+			nbChecked++;
+			if (expected == FLT_MAX)
+			{
+				if (result == end) nbMapWrong++;
+			}
+			else if (result != end || fabsf(pathLength(end) - expected) > .001f * (1 + expected))
+			{
+				nbMapWrong++;
+			}
+		}
+		nbWrong += nbMapWrong;
+
+		//--- Timing
+		std::vector<CPathNode*> queries;
+		for (int q=0;q<NB_QUERY;++q)
+		{
+			int from = cells[rand() % cells.size()];
+			int to = cells[rand() % cells.size()];
+			queries.push_back(aStar.GetNodeAt(from % sizeX, from / sizeX));
+			queries.push_back(aStar.GetNodeAt(to % sizeX, to / sizeX));
+		}
+		auto start = std::chrono::steady_clock::now();
+		for (int q=0;q<NB_QUERY;++q) aStar.FindPath(queries[q*2], queries[q*2+1]);
+		double ms = elapsedMs(start);
+		totalMs += ms;
+		nbQuery += NB_QUERY;
+
+		printf("%-40s %4i nodes  %7.2f us/query  %i wrong\n", argv[m], aStar.GetNodeCount(), ms * 1000.0 / NB_QUERY, nbMapWrong);
+	}
+
+	printf("%i maps, %i paths checked against Dijkstra, %i wrong\n", nbMap, nbChecked, nbWrong);
+	if (nbQuery) printf("%.2f us/query on average\n", totalMs * 1000.0 / nbQuery);
+
+	return (nbWrong == 0) ? 0 : 1;
+}
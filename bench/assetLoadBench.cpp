@@ -0,0 +1,683 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as published by the
+	Free Software Foundation, either version 3 of the License, or (at your option)
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+// Every .bvm, .dko and .tga under a folder, read the way the loaders did before
+// CBinaryReader (FileIO, one fread per field, strings one byte at a time) and the
+// way they do now. Both must read the same thing, then both are timed. The GL and
+// the game around the loaders are left out, only the file reading is measured.
+//
+// Usage : assetLoadBench Content
+
+#include "CBinaryReader.h"
+#include "FileIO.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <dirent.h>
+	#include <strings.h>
+	#include <sys/stat.h>
+#endif
+
+
+#define NB_PASS 5
+
+#define GAME_TYPE_COUNT 4 // Same as Game.h
+#define GAME_TYPE_CTF 2
+#define GAME_TYPE_SND 3
+
+// Same as CdkoModel.h
+const short CHUNK_DKO_VERSION = 0x0000;
+const short CHUNK_DKO_TIME_INFO = 0x0001;
+const short CHUNK_DKO_PROPERTIES = 0x0100;
+const short CHUNK_DKO_NAME = 0x0110;
+const short CHUNK_DKO_POSITION = 0x0120;
+const short CHUNK_DKO_MATRIX = 0x0130;
+const short CHUNK_DKO_MATLIST = 0x0200;
+const short CHUNK_DKO_MATNAME = 0x0210;
+const short CHUNK_DKO_TEX_DKT = 0x0220;
+const short CHUNK_DKO_AMBIENT = 0x0230;
+const short CHUNK_DKO_DIFFUSE = 0x0240;
+const short CHUNK_DKO_SPECULAR = 0x0250;
+const short CHUNK_DKO_EMISSIVE = 0x0260;
+const short CHUNK_DKO_SHININESS = 0x0270;
+const short CHUNK_DKO_TRANSPARENCY = 0x0280;
+const short CHUNK_DKO_TWO_SIDED = 0x0290;
+const short CHUNK_DKO_WIRE_FRAME = 0x02A0;
+const short CHUNK_DKO_WIRE_WIDTH = 0x02B0;
+const short CHUNK_DKO_TEX_DIFFUSE = 0x02C0;
+const short CHUNK_DKO_TEX_BUMP = 0x02D0;
+const short CHUNK_DKO_TEX_SPECULAR = 0x02E0;
+const short CHUNK_DKO_TEX_SELFILL = 0x02F0;
+const short CHUNK_DKO_TRI_MESH = 0x0300;
+const short CHUNK_DKO_NB_MAT_GROUP = 0x0340;
+const short CHUNK_DKO_MAT_ID = 0x0341;
+const short CHUNK_DKO_NB_VERTEX = 0x0342;
+const short CHUNK_DKO_VERTEX_ARRAY = 0x0343;
+const short CHUNK_DKO_NORMAL_ARRAY = 0x0344;
+const short CHUNK_DKO_TEXCOORD_ARRAY = 0x0345;
+const short CHUNK_DKO_TEXCOORD_ARRAY_ANIM = 0x0346;
+const short CHUNK_DKO_DUMMY = 0x0400;
+const short CHUNK_DKO_END = 0x0900;
+
+
+// What a loader got out of a file, to compare the old and the new reading
+struct asset_data
+{
+	std::vector<int> ints;
+	std::vector<float> floats;
+	std::vector<std::string> strings;
+	std::vector<unsigned char> bytes;
+
+	bool operator==(const asset_data & other) const
+	{
+		return ints == other.ints && strings == other.strings && bytes == other.bytes &&
+			floats.size() == other.floats.size() &&
+			(floats.empty() || memcmp(&floats[0], &other.floats[0], floats.size() * sizeof(float)) == 0);
+	}
+};
+
+
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+//
+// Every file under a folder with one of our extensions
+//
+static bool hasExtension(const char * filename, const char * extension)
+{
+	const char * dot = strrchr(filename, '.');
+#ifdef WIN32
+	return dot && !stricmp(dot + 1, extension);
+#else
+	return dot && !strcasecmp(dot + 1, extension);
+#endif
+}
+
+static void listFiles(const std::string & folder, std::vector<std::string> & files)
+{
+#ifdef WIN32
+	WIN32_FIND_DATA FindFileData;
+	HANDLE hFind = FindFirstFile((folder + "\\*").c_str(), &FindFileData);
+	if (hFind == INVALID_HANDLE_VALUE) return;
+	do
+	{
+		if (FindFileData.cFileName[0] == '.') continue;
+		std::string path = folder + "\\" + FindFileData.cFileName;
+		if (FindFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) listFiles(path, files);
+		else files.push_back(path);
+	} while (FindNextFile(hFind, &FindFileData) != 0);
+	FindClose(hFind);
+#else
+	DIR * hFile = opendir(folder.c_str());
+	if (!hFile) return;
+	dirent * file;
+	while ((file = readdir(hFile)) != 0)
+	{
+		if (file->d_name[0] == '.') continue;
+		std::string path = folder + "/" + file->d_name;
+		struct stat attrib;
+		if (stat(path.c_str(), &attrib) != 0) continue;
+		if (S_ISDIR(attrib.st_mode)) listFiles(path, files);
+		else files.push_back(path);
+	}
+	closedir(hFile);
+#endif
+}
+
+
+
+//
+// .bvm : the cells two virtual getUByte at a time before, one span now.
+// The rest is the same code for both, like Map::Map.
+//
+static void readCells(FileIO & file, int count, asset_data & data)
+{
+	for (int i=0;i<count;++i)
+	{
+		unsigned char passable = file.getUByte();
+		data.bytes.push_back(passable & 128);
+		data.bytes.push_back(passable & 127);
+		data.floats.push_back(((float)file.getUByte())/255.0f);
+	}
+}
+
+static void readCells(CBinaryReader & file, int count, asset_data & data)
+{
+	const unsigned char * cells = file.getSpan(count*2);
+	if (!cells) return;
+	for (int i=0;i<count;++i)
+	{
+		unsigned char passable = *(cells++);
+		data.bytes.push_back(passable & 128);
+		data.bytes.push_back(passable & 127);
+		data.floats.push_back(((float)*(cells++))/255.0f);
+	}
+}
+
+static void readAuthor(FileIO & file, asset_data & data)
+{
+	char * author = file.getByteArray(25);
+	author[24] = '\0';
+	data.strings.push_back(author);
+	delete [] author;
+}
+
+static void readAuthor(CBinaryReader & file, asset_data & data)
+{
+	const char * author = (const char *)file.getSpan(25);
+	if (author) data.strings.push_back(std::string(author, strnlen(author, 24)));
+}
+
+template <typename T>
+static void readSpawns(T & file, asset_data & data)
+{
+	int nbSpawn = file.getInt();
+	data.ints.push_back(nbSpawn);
+	for (int i=0;i<nbSpawn;++i)
+	{
+		CVector3f spawn = file.getVector3f();
+		data.floats.insert(data.floats.end(), spawn.s, spawn.s + 3);
+	}
+}
+
+template <typename T>
+static void readVectors(T & file, int count, asset_data & data)
+{
+	for (int i=0;i<count;++i)
+	{
+		CVector3f v = file.getVector3f();
+		data.floats.insert(data.floats.end(), v.s, v.s + 3);
+	}
+}
+
+template <typename T>
+static void loadMap(T & file, asset_data & data)
+{
+	unsigned long mapVersion = file.getULong();
+	data.ints.push_back((int)mapVersion);
+	switch (mapVersion)
+	{
+	case 10010:
+	case 10011:
+	case 20201:
+		{
+			if (mapVersion == 20201)
+			{
+				data.ints.push_back(file.getInt()); // theme
+				data.ints.push_back(file.getInt()); // weather
+			}
+			int sizeX = file.getInt();
+			int sizeY = file.getInt();
+			data.ints.push_back(sizeX);
+			data.ints.push_back(sizeY);
+			readCells(file, sizeX * sizeY, data);
+			if (mapVersion == 10010) break;
+			readVectors(file, 4, data); // flags, objectives
+			readSpawns(file, data);
+			readSpawns(file, data);
+			readSpawns(file, data);
+			break;
+		}
+	case 20202:
+		{
+			readAuthor(file, data);
+			data.ints.push_back(file.getInt()); // theme
+			data.ints.push_back(file.getInt()); // weather
+			int sizeX = file.getInt();
+			int sizeY = file.getInt();
+			data.ints.push_back(sizeX);
+			data.ints.push_back(sizeY);
+			readCells(file, sizeX * sizeY, data);
+			readSpawns(file, data);
+			for (int gtnum=0;gtnum<GAME_TYPE_COUNT;++gtnum)
+			{
+				int id = file.getInt();
+				data.ints.push_back(id);
+				if (id == GAME_TYPE_CTF) readVectors(file, 2, data);
+				if (id == GAME_TYPE_SND)
+				{
+					readVectors(file, 2, data);
+					readSpawns(file, data);
+					readSpawns(file, data);
+				}
+			}
+			break;
+		}
+	}
+}
+
+
+
+//
+// .dko : the old readChunk and readString on a FILE, the new ones on the reader.
+// The chunk walk is the one of CDkoModel, CdkoMaterial and CdkoMesh.
+//
+static short readChunk(FILE * file)
+{
+	short chunkID;
+	if (fread(&chunkID, 1, sizeof(short), file) != sizeof(short)) return CHUNK_DKO_END;
+	return chunkID;
+}
+
+static short readChunk(CBinaryReader & file)
+{
+	if (file.getRemaining() < (int)sizeof(short)) return CHUNK_DKO_END;
+	return (short)file.getInt();
+}
+
+static char * readString(FILE * file)
+{
+	char tmp[256];
+	int i = 0;
+	fread(tmp, 1, 1, file);
+	while (*(tmp + i++) != 0 && i < 256)
+	{
+		fread(tmp + i, 1, 1, file);
+	}
+	tmp[255] = '\0';
+	char * newStr = new char [i];
+	strcpy(newStr, tmp);
+	return newStr;
+}
+
+static char * readString(CBinaryReader & file)
+{
+	const char * str = file.getString();
+	if (!str) str = "";
+	char * newStr = new char [strlen(str)+1];
+	strcpy(newStr, str);
+	return newStr;
+}
+
+static void readData(FILE * file, void * dest, int size)
+{
+	if ((int)fread(dest, 1, size, file) != size) memset(dest, 0, size);
+}
+
+static void readData(CBinaryReader & file, void * dest, int size)
+{
+	file.read(dest, size);
+}
+
+template <typename T>
+static void keepString(T & file, asset_data & data)
+{
+	char * str = readString(file);
+	data.strings.push_back(str);
+	delete [] str;
+}
+
+template <typename T>
+static void keepFloats(T & file, int count, asset_data & data)
+{
+	float * floats = new float [count];
+	readData(file, floats, count * sizeof(float));
+	data.floats.insert(data.floats.end(), floats, floats + count);
+	delete [] floats;
+}
+
+template <typename T>
+static void keepShort(T & file, asset_data & data)
+{
+	short value;
+	readData(file, &value, sizeof(short));
+	data.ints.push_back(value);
+}
+
+template <typename T>
+static void loadNamePosMatrix(T & file, int nbFrame, asset_data & data)
+{
+	short chunkID = readChunk(file);
+	while (chunkID != CHUNK_DKO_END)
+	{
+		switch (chunkID)
+		{
+		case CHUNK_DKO_NAME: keepString(file, data); break;
+		case CHUNK_DKO_POSITION: keepFloats(file, 3 * nbFrame, data); break;
+		case CHUNK_DKO_MATRIX: keepFloats(file, 9 * nbFrame, data); break;
+		}
+		chunkID = readChunk(file);
+	}
+}
+
+template <typename T>
+static void loadMaterial(T & file, asset_data & data)
+{
+	short chunkID = readChunk(file);
+	while (chunkID != CHUNK_DKO_END)
+	{
+		switch (chunkID)
+		{
+		case CHUNK_DKO_MATNAME:
+		case CHUNK_DKO_TEX_DKT:
+		case CHUNK_DKO_TEX_DIFFUSE:
+		case CHUNK_DKO_TEX_BUMP:
+		case CHUNK_DKO_TEX_SPECULAR:
+		case CHUNK_DKO_TEX_SELFILL: keepString(file, data); break;
+		case CHUNK_DKO_AMBIENT:
+		case CHUNK_DKO_DIFFUSE:
+		case CHUNK_DKO_SPECULAR:
+		case CHUNK_DKO_EMISSIVE: keepFloats(file, 4, data); break;
+		case CHUNK_DKO_SHININESS: keepShort(file, data); break;
+		case CHUNK_DKO_TRANSPARENCY:
+		case CHUNK_DKO_WIRE_WIDTH: keepFloats(file, 1, data); break;
+		case CHUNK_DKO_TWO_SIDED:
+		case CHUNK_DKO_WIRE_FRAME:
+			{
+				char temp;
+				readData(file, &temp, sizeof(char));
+				data.bytes.push_back(temp);
+				break;
+			}
+		}
+		chunkID = readChunk(file);
+	}
+}
+
+template <typename T>
+static void loadMatGroup(T & file, int nbFrame, asset_data & data)
+{
+	int32_t nbVertex = 0;
+	short chunkID = readChunk(file);
+	while (chunkID != CHUNK_DKO_END)
+	{
+		switch (chunkID)
+		{
+		case CHUNK_DKO_MAT_ID: keepShort(file, data); break;
+		case CHUNK_DKO_NB_VERTEX:
+			{
+				readData(file, &nbVertex, sizeof(nbVertex));
+				data.ints.push_back(nbVertex);
+				break;
+			}
+		case CHUNK_DKO_VERTEX_ARRAY:
+		case CHUNK_DKO_NORMAL_ARRAY:
+			{
+				for (int f=0;f<nbFrame;f++) keepFloats(file, nbVertex * 3, data);
+				break;
+			}
+		case CHUNK_DKO_TEXCOORD_ARRAY: keepFloats(file, nbVertex * 2, data); break;
+		case CHUNK_DKO_TEXCOORD_ARRAY_ANIM:
+			{
+				for (int f=0;f<nbFrame;f++) keepFloats(file, nbVertex * 2, data);
+				break;
+			}
+		}
+		chunkID = readChunk(file);
+	}
+}
+
+template <typename T>
+static void loadMesh(T & file, int nbFrame, asset_data & data)
+{
+	short chunkID = readChunk(file);
+	while (chunkID != CHUNK_DKO_END)
+	{
+		switch (chunkID)
+		{
+		case CHUNK_DKO_NAME: keepString(file, data); break;
+		case CHUNK_DKO_POSITION: keepFloats(file, 3, data); break;
+		case CHUNK_DKO_MATRIX: keepFloats(file, 9, data); break;
+		case CHUNK_DKO_NB_MAT_GROUP:
+			{
+				short nbMatGroup;
+				readData(file, &nbMatGroup, sizeof(short));
+				data.ints.push_back(nbMatGroup);
+				for (int i=0;i<nbMatGroup;i++) loadMatGroup(file, nbFrame, data);
+				break;
+			}
+		}
+		chunkID = readChunk(file);
+	}
+}
+
+template <typename T>
+static bool loadModel(T & file, asset_data & data)
+{
+	short timeInfo[3] = {0, 0, 0};
+	short chunkID = readChunk(file);
+	while (chunkID != CHUNK_DKO_END)
+	{
+		switch (chunkID)
+		{
+		case CHUNK_DKO_VERSION: keepShort(file, data); break;
+		case CHUNK_DKO_TIME_INFO:
+			{
+				readData(file, timeInfo, sizeof(short)*3);
+				data.ints.insert(data.ints.end(), timeInfo, timeInfo + 3);
+				break;
+			}
+		case CHUNK_DKO_PROPERTIES: loadNamePosMatrix(file, 1, data); break;
+		case CHUNK_DKO_MATLIST:
+			{
+				short nbMat;
+				readData(file, &nbMat, sizeof(short));
+				data.ints.push_back(nbMat);
+				for (int i=0;i<nbMat;i++) loadMaterial(file, data);
+				break;
+			}
+		case CHUNK_DKO_TRI_MESH: loadMesh(file, timeInfo[2], data); break;
+		case CHUNK_DKO_DUMMY: loadNamePosMatrix(file, timeInfo[2], data); break;
+		default: return false; // Can't go on without knowing its size
+		}
+		chunkID = readChunk(file);
+	}
+	return true;
+}
+
+
+
+//
+// .tga : the old copy and red/blue swap, the new span given as BGR to GL.
+// The bytes are kept as RGB for both so they compare.
+//
+static void loadTGAOld(const char * filename, asset_data & data, bool keep)
+{
+	FILE * file = fopen(filename, "rb");
+	if (!file) return;
+	unsigned char TGAcompare[12];
+	unsigned char header[6];
+	fread(TGAcompare, 1, sizeof(TGAcompare), file);
+	fread(header, 1, sizeof(header), file);
+	unsigned int width = header[1] * 256 + header[0];
+	unsigned int height = header[3] * 256 + header[2];
+	unsigned int bytesPerPixel = header[4]/8;
+	unsigned int imageSize = width * height * bytesPerPixel;
+	unsigned char * imageData = new unsigned char [imageSize];
+	fread(imageData, 1, imageSize, file);
+	for (unsigned int i=0;i<imageSize;i+=bytesPerPixel)
+	{
+		unsigned char temp = imageData[i];
+		imageData[i] = imageData[i + 2];
+		imageData[i + 2] = temp;
+	}
+	fclose(file);
+	if (keep)
+	{
+		data.ints.push_back(width);
+		data.ints.push_back(height);
+		data.ints.push_back(bytesPerPixel);
+		data.bytes.assign(imageData, imageData + imageSize);
+	}
+	delete [] imageData;
+}
+
+static void loadTGANew(const char * filename, asset_data & data, bool keep)
+{
+	CBinaryReader file(filename);
+	if (!file.isValid()) return;
+	file.skip(12);
+	const unsigned char * header = file.getSpan(6);
+	if (!header) return;
+	unsigned int width = header[1] * 256 + header[0];
+	unsigned int height = header[3] * 256 + header[2];
+	unsigned int bytesPerPixel = header[4]/8;
+	if (bytesPerPixel != 3 && bytesPerPixel != 4) return;
+	unsigned int imageSize = width * height * bytesPerPixel;
+	const unsigned char * imageData = file.getSpan(imageSize);
+	if (!imageData) return;
+
+	// Same as CTextureJob::read, every page is touched
+	volatile unsigned char touch = 0;
+	for (unsigned int i=0;i<imageSize;i+=4096) touch += imageData[i];
+	if (imageSize) touch += imageData[imageSize-1];
+
+	if (keep)
+	{
+		data.ints.push_back(width);
+		data.ints.push_back(height);
+		data.ints.push_back(bytesPerPixel);
+		data.bytes.assign(imageData, imageData + imageSize);
+		for (unsigned int i=0;i<imageSize;i+=bytesPerPixel)
+		{
+			unsigned char temp = data.bytes[i];
+			data.bytes[i] = data.bytes[i + 2];
+			data.bytes[i + 2] = temp;
+		}
+	}
+}
+
+
+
+enum asset_type {ASSET_MAP, ASSET_MODEL, ASSET_TEXTURE, ASSET_TYPE_COUNT};
+
+static void loadOld(asset_type type, const char * filename, asset_data & data, bool keep)
+{
+	switch (type)
+	{
+	case ASSET_MAP:
+		{
+			FileIO file(CString("%s", filename), "rb");
+			if (file.isValid()) loadMap(file, data);
+			break;
+		}
+	case ASSET_MODEL:
+		{
+			FILE * file = fopen(filename, "rb");
+			if (!file) break;
+			loadModel(file, data);
+			fclose(file);
+			break;
+		}
+	case ASSET_TEXTURE: loadTGAOld(filename, data, keep); break;
+	default: break;
+	}
+}
+
+static void loadNew(asset_type type, const char * filename, asset_data & data, bool keep)
+{
+	CBinaryReader file;
+	switch (type)
+	{
+	case ASSET_MAP:
+		{
+			if (file.open(filename)) loadMap(file, data);
+			break;
+		}
+	case ASSET_MODEL:
+		{
+			if (file.open(filename)) loadModel(file, data);
+			break;
+		}
+	case ASSET_TEXTURE: loadTGANew(filename, data, keep); break;
+	default: break;
+	}
+}
+
+
+
+int main(int argc, char ** argv)
+{
+	if (argc < 2)
+	{
+		printf("Usage : assetLoadBench Content\n");
+		return 1;
+	}
+
+	std::vector<std::string> all;
+	listFiles(argv[1], all);
+
+	const char * typeName[ASSET_TYPE_COUNT] = {"bvm", "dko", "tga"};
+	std::vector<std::string> files[ASSET_TYPE_COUNT];
+	for (int i=0;i<(int)all.size();++i)
+	{
+		for (int t=0;t<ASSET_TYPE_COUNT;++t)
+		{
+			if (hasExtension(all[i].c_str(), typeName[t])) files[t].push_back(all[i]);
+		}
+	}
+
+	int nbDiff = 0;
+	for (int t=0;t<ASSET_TYPE_COUNT;++t)
+	{
+		asset_type type = (asset_type)t;
+
+		//--- Same result ? The first read also brings the files in the cache
+		int nbTypeDiff = 0;
+		for (int i=0;i<(int)files[t].size();++i)
+		{
+			asset_data oldData, newData;
+			loadOld(type, files[t][i].c_str(), oldData, true);
+			loadNew(type, files[t][i].c_str(), newData, true);
+			if (!(oldData == newData))
+			{
+				printf("%s : not the same\n", files[t][i].c_str());
+				nbTypeDiff++;
+			}
+		}
+		nbDiff += nbTypeDiff;
+
+		//--- Timing. The dko and bvm results are kept like the loaders keep them.
+		bool keep = (type != ASSET_TEXTURE);
+		double oldMs = 0;
+		double newMs = 0;
+		for (int pass=0;pass<NB_PASS;++pass)
+		{
+			for (int i=0;i<(int)files[t].size();++i)
+			{
+				asset_data data;
+				auto start = std::chrono::steady_clock::now();
+				loadOld(type, files[t][i].c_str(), data, keep);
+				oldMs += elapsedMs(start);
+			}
+			for (int i=0;i<(int)files[t].size();++i)
+			{
+				asset_data data;
+				auto start = std::chrono::steady_clock::now();
+				loadNew(type, files[t][i].c_str(), data, keep);
+				newMs += elapsedMs(start);
+			}
+		}
+
+		printf("%3i .%s : old %8.2f ms  new %8.2f ms  (all of them, once)  %i different\n",
+			(int)files[t].size(), typeName[t], oldMs / NB_PASS, newMs / NB_PASS, nbTypeDiff);
+	}
+
+	return (nbDiff == 0) ? 0 : 1;
+}
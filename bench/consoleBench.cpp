@@ -0,0 +1,241 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as published by the
+	Free Software Foundation, either version 3 of the License, or (at your option)
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+// Finding the console command, the chain of == that Console::sendCommand was
+// against the table of Console::runCommand. Both must find the same command for
+// every line. Then a launch script is read with FileIO::getLine the way
+// cmdExecute does, the lines with a % must come out as they were written.
+//
+// The commands themselves need the game, only finding them is measured.
+
+#include "FileIO.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+#define NB_DISPATCH 200000
+#define NB_SCRIPT_LINE 2000
+#define NB_SCRIPT_RUN 50
+#define SCRIPT_FILENAME "consoleBench.cfg"
+
+
+// In the order sendCommand compared them
+static const char * commandNames[] = {
+	"help", "?", "execute", "admin", "info", "remoteAdmin", "-", "set", "quit", "host",
+	"dedicate", "voteon", "novote", "addmap", "playerlist", "move", "moveid", "nukeall", "nuke",
+	"nukeid", "allwatch", "addreporturl", "removereporturl", "removeallreporturls",
+	"listreporturls", "approveall", "approveplayer", "rejectplayer", "rejectallplayers",
+	"listapprovedplayers", "savemap", "savemapforce", "vote", "maplist", "maplistall",
+	"removemap", "changemap", "connect", "disconnect", "sayall", "sayid", "sayteam", "edit",
+	"playerinfo", "playersinfo", "forceplayerspawn", "blueTeamScore", "redTeamScore",
+	"redFlagReturn", "blueFlagReturn", "mapinfos", "listbluespawns", "listredspawns",
+	"allplayerpos", "rebuildmap", "restart", "kick", "kickid", "banlist", "ban", "banip", "banid",
+	"unban", "cachelist", "cacheban", "cachebanned", "cacheunban", "cachelistremote",
+	"cachebanremote", "getinvalidchecksums", "deleteinvalidchecksums", "invalidchecksumsinfo",
+	"status",
+};
+static const int nbCommand = sizeof(commandNames) / sizeof(commandNames[0]);
+
+
+// What the server gets from the admins, the votes and itself
+static const char * commandLines[] = {
+	"sayall \x4Next map in 30 seconds",
+	"set sv_gameTimeLimit 15",
+	"vote yes",
+	"changemap Rocket",
+	"kickid 3",
+	"playersinfo",
+	"BlueTeamScore 5",
+	"cachebanremote pass 12 60",
+	"status 1",
+	"notacommand with arguments",
+};
+static const int nbCommandLine = sizeof(commandLines) / sizeof(commandLines[0]);
+
+
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+//
+// The command of a line, -1 if there is none. Like sendCommand before, like runCommand now.
+//
+static int findOld(CString commandLine)
+{
+	commandLine.trim('\n');
+	CString tokenize = commandLine;
+	CString command = tokenize.getFirstToken(' ');
+	for (int i=0;i<nbCommand;++i)
+	{
+		if (command == commandNames[i]) return i;
+	}
+	return -1;
+}
+
+static const std::unordered_map<std::string, int> & getCommands()
+{
+	static std::unordered_map<std::string, int> commands;
+	if (commands.empty())
+	{
+		for (int i=0;i<nbCommand;++i)
+		{
+			CString name("%s", commandNames[i]);
+			name.toLower();
+			commands.insert(std::make_pair(std::string(name.s), i));
+		}
+	}
+	return commands;
+}
+
+static int findNew(CString commandLine)
+{
+	commandLine.trim('\n');
+	CString tokenize = commandLine;
+	CString command = tokenize.getFirstToken(' ');
+	command.toLower();
+	const std::unordered_map<std::string, int> & commands = getCommands();
+	std::unordered_map<std::string, int>::const_iterator it = commands.find(command.s);
+	return (it == commands.end()) ? -1 : it->second;
+}
+
+
+
+//
+// The lines of a launch script, read like cmdExecute
+//
+static void readScript(const char * filename, std::vector<CString> & lines)
+{
+	lines.clear();
+	FileIO file(CString("%s", filename), "r");
+	if (!file.isValid()) return;
+	for (;;)
+	{
+		CString line = file.getLine();
+		if (line.isNull()) break;
+		line.trim('\n');
+		line.trim('\r');
+		if (line == "endscript") break;
+
+		int len = line.len();
+		CString newText;
+		for (int i=0;i<len;++i)
+		{
+			if (line[i] == '^' && i < len - 1)
+			{
+				char number = line[i+1] - '0';
+				if (number >= 1 && number <= 9) newText.append(&number, 1);
+				++i;
+			}
+			else
+			{
+				newText.append(line.s + i, 1);
+			}
+		}
+
+		if (strncmp("//", newText.s, 2) == 0) continue;
+		if (newText.s[0] == ' ' || newText.s[0] == '\0' || newText.s[0] == '\n') continue;
+
+		lines.push_back(newText);
+	}
+}
+
+
+
+int main()
+{
+	std::vector<CString> names, commands;
+	for (int i=0;i<nbCommand;++i) names.push_back(CString("%s", commandNames[i]));
+	for (int i=0;i<nbCommandLine;++i) commands.push_back(CString("%s", commandLines[i]));
+
+	//--- The chain and the table must agree
+	int nbDiff = 0;
+	for (int i=0;i<nbCommand;++i)
+	{
+		if (findOld(names[i]) != findNew(names[i])) nbDiff++;
+	}
+	for (int i=0;i<nbCommandLine;++i)
+	{
+		if (findOld(commands[i]) != findNew(commands[i])) nbDiff++;
+	}
+
+	//--- Dispatch
+	int found = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i=0;i<NB_DISPATCH;++i) found += findOld(commands[i % nbCommandLine]);
+	double oldMs = elapsedMs(start);
+	start = std::chrono::steady_clock::now();
+	for (int i=0;i<NB_DISPATCH;++i) found -= findNew(commands[i % nbCommandLine]);
+	double newMs = elapsedMs(start);
+
+	//--- A big launch script, some lines have a %
+	FILE * file = fopen(SCRIPT_FILENAME, "w");
+	if (!file)
+	{
+		printf("Can't write %s\n", SCRIPT_FILENAME);
+		return 1;
+	}
+	int nbPercent = 0;
+	for (int i=0;i<NB_SCRIPT_LINE;++i)
+	{
+		switch (i % 5)
+		{
+		case 0: fprintf(file, "// Settings %i\n", i); break;
+		case 1: fprintf(file, "set sv_gameName ^1Babo ^2Server %i\n", i); break;
+		case 2: fprintf(file, "sayall 100%% %%s %%i of the damage %i\n", i); nbPercent++; break;
+		case 3: fprintf(file, "\n"); break;
+		case 4: fprintf(file, "addmap Map%i\r\n", i); break;
+		}
+	}
+	fprintf(file, "endscript\n");
+	fclose(file);
+
+	std::vector<CString> lines;
+	int nbPercentOk = 0;
+	readScript(SCRIPT_FILENAME, lines);
+	for (int i=0;i<(int)lines.size();++i)
+	{
+		if (strstr(lines[i].s, "100% %s %i of the damage")) nbPercentOk++;
+	}
+
+	start = std::chrono::steady_clock::now();
+	for (int run=0;run<NB_SCRIPT_RUN;++run)
+	{
+		readScript(SCRIPT_FILENAME, lines);
+		for (int i=0;i<(int)lines.size();++i) found += findNew(lines[i]);
+	}
+	double scriptMs = elapsedMs(start);
+	remove(SCRIPT_FILENAME);
+
+	printf("%i commands, %i lines found the same way by both : %s\n", nbCommand, nbCommand + nbCommandLine, (nbDiff == 0) ? "yes" : "NO");
+	printf("chain of == : %8.1f ns/command\n", oldMs * 1000000.0 / NB_DISPATCH);
+	printf("table       : %8.1f ns/command\n", newMs * 1000000.0 / NB_DISPATCH);
+	printf("script of %i lines (%i commands) : %8.3f ms to read and find\n", NB_SCRIPT_LINE, (int)lines.size(), scriptMs / NB_SCRIPT_RUN);
+	printf("lines with a %% read as written : %i/%i\n", nbPercentOk, nbPercent);
+	if (found == 12345) printf("\n"); // Keep the lookups
+
+	return (nbDiff == 0 && nbPercentOk == nbPercent) ? 0 : 1;
+}
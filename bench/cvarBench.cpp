@@ -0,0 +1,174 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as published by the
+	Free Software Foundation, either version 3 of the License, or (at your option)
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+// The cvar registry with about as many variables as the game : dksvarCommand,
+// and what GameVar::sendSVVar does for a joining client, once by names like it
+// used to and once with the handles it finds now. GameVar needs the whole game,
+// so its sendOne is done here the same way, without the network send.
+
+#include "dksvar.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+
+#define NB_VAR 300
+#define NB_COMMAND 100000
+#define NB_JOIN 10000
+
+
+// The variables GameVar::sendSVVar sends, in the same order
+static const char * svNames[] = {
+	"sv_friendlyFire", "sv_reflectedDamage", "sv_timeToSpawn", "sv_topView", "sv_minSendInterval",
+	"sv_forceRespawn", "sv_baboStats", "sv_roundTimeLimit", "sv_gameTimeLimit", "sv_scoreLimit",
+	"sv_winLimit", "sv_gameType", "sv_serverType", "sv_spawnType", "sv_subGameType", "sv_bombTime",
+	"sv_gameName", "sv_port", "sv_maxPlayer", "sv_maxPlayerInGame", "sv_password", "sv_enableSMG",
+	"sv_enableShotgun", "sv_enableSniper", "sv_enableDualMachineGun", "sv_enableChainGun",
+	"sv_enableBazooka", "sv_enablePhotonRifle", "sv_enableFlameThrower", "sv_enableShotgunReload",
+	"sv_slideOnIce", "sv_showEnemyTag", "sv_enableSecondary", "sv_enableKnives", "sv_enableNuclear",
+	"sv_enableShield", "sv_enableMinibot", "sv_autoBalance", "sv_autoBalanceTime", "sv_gamePublic",
+	"sv_matchcode", "sv_matchmode", "sv_maxPing", "sv_shottyDropRadius", "sv_shottyRange",
+	"sv_enableMolotov", "sv_ftMaxRange", "sv_ftMinRange", "sv_photonDamageCoefficient",
+	"sv_zookaRemoteDet", "sv_smgDamage", "sv_ftDamage", "sv_dmgDamage", "sv_cgDamage",
+	"sv_shottyDamage", "sv_sniperDamage", "sv_zookaDamage", "sv_photonType", "sv_zookaRadius",
+	"sv_nukeRadius", "sv_nukeTimer", "sv_nukeReload", "sv_minTilesPerBabo", "sv_maxTilesPerBabo",
+	"sv_photonDistMult", "sv_photonVerticalShift", "sv_photonHorizontalShift", "sv_joinMessage",
+	"sv_sendJoinMessage", "sv_ftExpirationTimer", "sv_explodingFT", "sv_enableVote",
+};
+static const int nbSVVar = sizeof(svNames) / sizeof(svNames[0]);
+
+
+// Same as main.cpp
+class StringInterface : public CStringInterface
+{
+public:
+	virtual void updateString(CString* string, char * newValue)
+	{
+		*string = newValue;
+	}
+};
+
+
+// Where sendOne copies the command before the send
+static char svChange[80];
+
+
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+//
+// GameVar::sendOne, by name like before and by handle like now
+//
+static void sendOne(char * varName)
+{
+	CString varCom;
+	dksvarGetFormatedVar(varName, &varCom);
+	varCom.insert("set ", 0);
+	if (varCom.len() > 79) varCom.resize(79);
+	memcpy(svChange, varCom.s, varCom.len()+1);
+}
+
+static void sendOne(dksvarHandle var)
+{
+	if (!var) return;
+	CString varCom;
+	dksvarGetFormatedVar(var, &varCom);
+	varCom.insert("set ", 0);
+	if (varCom.len() > 79) varCom.resize(79);
+	memcpy(svChange, varCom.s, varCom.len()+1);
+}
+
+
+
+int main()
+{
+	StringInterface stringInterface;
+	dksvarInit(&stringInterface);
+
+	//--- The client variables first, then the server ones, like GameVar
+	static int ints[NB_VAR];
+	static float floats[NB_VAR];
+	static CString strings[NB_VAR];
+	int nbVar = 0;
+	for (;nbVar<NB_VAR-nbSVVar;++nbVar)
+	{
+		floats[nbVar] = (float)nbVar;
+		dksvarRegister(CString("cl_var%i", nbVar), &(floats[nbVar]), 0, 1000, LIMIT_MIN | LIMIT_MAX, false);
+	}
+	for (int i=0;i<nbSVVar;++i, ++nbVar)
+	{
+		if (strstr(svNames[i], "Name") || strstr(svNames[i], "Message") || strstr(svNames[i], "password"))
+		{
+			strings[nbVar] = "Some server text";
+			dksvarRegister(CString("%s", svNames[i]), &(strings[nbVar]), false);
+		}
+		else
+		{
+			ints[nbVar] = i;
+			dksvarRegister(CString("%s", svNames[i]), &(ints[nbVar]), 0, 1000, LIMIT_MIN | LIMIT_MAX, false);
+		}
+	}
+
+	//--- dksvarCommand on a server variable, the last ones registered are the far ones in a list
+	char command[128];
+	auto start = std::chrono::steady_clock::now();
+	for (int i=0;i<NB_COMMAND;++i)
+	{
+		sprintf(command, "set %s %i", svNames[i % nbSVVar], i % 1000);
+		dksvarCommand(command);
+	}
+	double commandMs = elapsedMs(start);
+
+	//--- sendSVVar by names
+	start = std::chrono::steady_clock::now();
+	for (int j=0;j<NB_JOIN;++j)
+	{
+		for (int i=0;i<nbSVVar;++i) sendOne((char*)svNames[i]);
+	}
+	double byNameMs = elapsedMs(start);
+
+	//--- sendSVVar with the handles, found on the first join
+	start = std::chrono::steady_clock::now();
+	static dksvarHandle handles[sizeof(svNames) / sizeof(svNames[0])];
+	for (int i=0;i<nbSVVar;++i) handles[i] = dksvarFind(svNames[i]);
+	for (int j=0;j<NB_JOIN;++j)
+	{
+		for (int i=0;i<nbSVVar;++i) sendOne(handles[i]);
+	}
+	double byHandleMs = elapsedMs(start);
+
+	int nbMissing = 0;
+	for (int i=0;i<nbSVVar;++i)
+	{
+		if (!handles[i]) nbMissing++;
+	}
+
+	printf("%i variables, %i sent to a joining client\n", nbVar, nbSVVar);
+	printf("dksvarCommand           : %8.3f us/command\n", commandMs * 1000.0 / NB_COMMAND);
+	printf("sendSVVar, by names     : %8.3f us/join\n", byNameMs * 1000.0 / NB_JOIN);
+	printf("sendSVVar, with handles : %8.3f us/join\n", byHandleMs * 1000.0 / NB_JOIN);
+	printf("variables not found : %i\n", nbMissing);
+
+	return (nbMissing == 0) ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as published by the
+	Free Software Foundation, either version 3 of the License, or (at your option)
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+// Map ray tests on a random grid : the old 3 tiles stepper, the cell walk one ray
+// at a time, and the batch from one origin (radius damage). The walk and the batch
+// must give the same results, the old stepper is only there to compare the time.
+
+#include "MapCollision.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+
+#define MAP_SIZE 64
+#define NB_ORIGIN 2000
+#define NB_RAY 32
+#define NB_PASS 20
+
+
+//
+// The ray test before the cell walk, kept here to compare
+//
+static bool oldRayTest(const CMapCollision & map, CVector3f & p1, CVector3f & p2, CVector3f & normal)
+{
+	int i = (int)p1[0];
+	int j = (int)p1[1];
+	if (i < 0 || i >= map.width || j < 0 || j >= map.height) return false;
+	if (!map.isPassable(i, j) && p1[2] < map.getHeight(i, j))
+	{
+		p2 = p1;
+		return true;
+	}
+
+	bool alongX = fabsf(p2[0] - p1[0]) > fabsf(p2[1] - p1[1]);
+	bool positive = (alongX) ? (p2[0] > p1[0]) : (p2[1] > p1[1]);
+	float percent;
+	while (true)
+	{
+		if (i < 0 || i >= map.width || j < 0 || j >= map.height) return false;
+		if (alongX && positive && i > (int)p2[0]) return false;
+		if (alongX && !positive && i < (int)p2[0]) return false;
+		if (!alongX && positive && j > (int)p2[1]) return false;
+		if (!alongX && !positive && j < (int)p2[1]) return false;
+
+		if (alongX)
+		{
+			if (map.rayTileTest(i, j, p1, p2, normal)) return true;
+			if (map.rayTileTest(i, j-1, p1, p2, normal)) return true;
+			if (map.rayTileTest(i, j+1, p1, p2, normal)) return true;
+			if (positive)
+			{
+				i++;
+				percent = ((float)i - p1[0]) / fabsf(p2[0] - p1[0]);
+			}
+			else
+			{
+				i--;
+				percent = (p1[0] - (float)(i+1)) / fabsf(p2[0] - p1[0]);
+			}
+			j = (int)(p1[1] + (p2[1] - p1[1]) * percent);
+		}
+		else
+		{
+			if (map.rayTileTest(i, j, p1, p2, normal)) return true;
+			if (map.rayTileTest(i-1, j, p1, p2, normal)) return true;
+			if (map.rayTileTest(i+1, j, p1, p2, normal)) return true;
+			if (positive)
+			{
+				j++;
+				percent = ((float)j - p1[1]) / fabsf(p2[1] - p1[1]);
+			}
+			else
+			{
+				j--;
+				percent = (p1[1] - (float)(j+1)) / fabsf(p2[1] - p1[1]);
+			}
+			i = (int)(p1[0] + (p2[0] - p1[0]) * percent);
+		}
+	}
+}
+
+
+
+static float randf(float min, float max)
+{
+	return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+int main()
+{
+	srand(1234);
+
+	//--- A map with the border closed and 20% of walls
+	CMapCollision map;
+	map.resize(MAP_SIZE, MAP_SIZE);
+	for (int y=0;y<MAP_SIZE;++y)
+	{
+		for (int x=0;x<MAP_SIZE;++x)
+		{
+			bool border = (x == 0 || y == 0 || x == MAP_SIZE-1 || y == MAP_SIZE-1);
+			bool wall = border || (rand() % 5 == 0);
+			map.setCell(y * MAP_SIZE + x, !wall, (wall) ? 2 : 0);
+		}
+	}
+	map.buildWallDistance();
+
+	//--- Rays from free cells, like a grenade at the height of a player
+	std::vector<CVector3f> origins;
+	std::vector<CVector3f> ends;
+	while ((int)origins.size() < NB_ORIGIN)
+	{
+		CVector3f origin(randf(1, MAP_SIZE-1), randf(1, MAP_SIZE-1), .25f);
+		if (!map.isPassable((int)origin[0], (int)origin[1])) continue;
+		origins.push_back(origin);
+		for (int k=0;k<NB_RAY;++k)
+		{
+			ends.push_back(CVector3f(origin[0] + randf(-6, 6), origin[1] + randf(-6, 6), randf(-.1f, .5f)));
+		}
+	}
+
+	std::vector<CVector3f> oldEnds(ends.size()), walkEnds(ends.size()), batchEnds(ends.size());
+	std::vector<CVector3f> walkNormals(ends.size()), batchNormals(ends.size());
+	bool * oldHits = new bool [ends.size()];
+	bool * walkHits = new bool [ends.size()];
+	bool * batchHits = new bool [ends.size()];
+	CVector3f normal;
+
+	//--- Old stepper
+	double oldMs = 0;
+	for (int pass=0;pass<NB_PASS;++pass)
+	{
+		oldEnds = ends;
+		auto start = std::chrono::steady_clock::now();
+		for (int o=0;o<NB_ORIGIN;++o)
+		{
+			for (int k=0;k<NB_RAY;++k)
+			{
+				CVector3f p1 = origins[o];
+				oldHits[o*NB_RAY+k] = oldRayTest(map, p1, oldEnds[o*NB_RAY+k], normal);
+			}
+		}
+		oldMs += elapsedMs(start);
+	}
+
+	//--- Cell walk, one ray at a time
+	double walkMs = 0;
+	for (int pass=0;pass<NB_PASS;++pass)
+	{
+		walkEnds = ends;
+		auto start = std::chrono::steady_clock::now();
+		for (int o=0;o<NB_ORIGIN;++o)
+		{
+			for (int k=0;k<NB_RAY;++k)
+			{
+				CVector3f p1 = origins[o];
+				walkHits[o*NB_RAY+k] = map.rayTest(p1, walkEnds[o*NB_RAY+k], walkNormals[o*NB_RAY+k]);
+			}
+		}
+		walkMs += elapsedMs(start);
+	}
+
+	//--- Batch
+	double batchMs = 0;
+	for (int pass=0;pass<NB_PASS;++pass)
+	{
+		batchEnds = ends;
+		auto start = std::chrono::steady_clock::now();
+		for (int o=0;o<NB_ORIGIN;++o)
+		{
+			map.rayTestBatch(origins[o], &batchEnds[o*NB_RAY], NB_RAY, batchHits + o*NB_RAY, &batchNormals[o*NB_RAY]);
+		}
+		batchMs += elapsedMs(start);
+	}
+
+	//--- The batch must give exactly what the walk gives
+	int nbRay = (int)ends.size();
+	int nbDiff = 0;
+	int nbOldDiff = 0;
+	int nbHit = 0;
+	for (int k=0;k<nbRay;++k)
+	{
+		if (walkHits[k]) nbHit++;
+		if (walkHits[k] != batchHits[k] || walkEnds[k] != batchEnds[k] ||
+			(walkHits[k] && walkNormals[k] != batchNormals[k])) nbDiff++;
+		if (walkHits[k] != oldHits[k]) nbOldDiff++;
+	}
+
+#ifdef MAPCOLLISION_SSE2
+	printf("SSE2 batch setup\n");
+#else
+	printf("Scalar batch setup\n");
+#endif
+	printf("%i rays x %i passes, %i hits\n", nbRay, NB_PASS, nbHit);
+	printf("old stepper : %8.2f ns/ray\n", oldMs * 1000000.0 / (nbRay * NB_PASS));
+	printf("cell walk   : %8.2f ns/ray\n", walkMs * 1000000.0 / (nbRay * NB_PASS));
+	printf("batch       : %8.2f ns/ray\n", batchMs * 1000000.0 / (nbRay * NB_PASS));
+	printf("batch differs from the walk on %i rays\n", nbDiff);
+	printf("old stepper hit/miss differs on %i rays\n", nbOldDiff);
+
+	delete [] oldHits;
+	delete [] walkHits;
+	delete [] batchHits;
+
+	return (nbDiff == 0) ? 0 : 1;
+}
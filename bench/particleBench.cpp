@@ -0,0 +1,146 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as published by the
+	Free Software Foundation, either version 3 of the License, or (at your option)
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+// 50k particles without a GPU : update and sort every frame, the dead ones are
+// replaced so the count stays up. The first frame is checked against a plain
+// scalar update and the sort is checked to be back to front.
+
+#include "CParticlePool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+
+#define NB_PARTICLE 50000
+#define NB_FRAME 300
+#define FRAME_DELAY (1.0f / 60.0f)
+
+
+static float randf(float min, float max)
+{
+	return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+//
+// Something like the blood and the smoke of a big fight
+//
+static void spawn(CParticlePool & pool)
+{
+	float position[3] = {randf(0, 64), randf(0, 64), randf(0, 2)};
+	float vel[3] = {randf(-2, 2), randf(-2, 2), randf(0, 3)};
+	float startColor[4] = {1, randf(0, 1), 0, 1};
+	float endColor[4] = {.5f, .5f, .5f, 0};
+	pool.add(position, vel, startColor, endColor, randf(.1f, .5f), randf(.5f, 2), randf(.5f, 3),
+		randf(0, 1), randf(-90, 90), 1 + rand() % 8, 0x0302, 0x0303);
+}
+
+
+
+//
+// Float arrays must be the same bit for bit
+//
+static bool sameFloats(const float * a, const float * b, int count)
+{
+	return memcmp(a, b, sizeof(float) * count) == 0;
+}
+
+
+
+int main()
+{
+	srand(1234);
+
+	CParticlePool pool(NB_PARTICLE);
+	CVector3f gravity(0, 0, -9.8f);
+	CVector3f camPos(32, 20, 15);
+	while (pool.count < NB_PARTICLE) spawn(pool);
+
+	//--- First frame against the straight scalar update. Nobody dies that early.
+	int count = pool.count;
+	std::vector<float> posX(pool.posX, pool.posX + count), posY(pool.posY, pool.posY + count), posZ(pool.posZ, pool.posZ + count);
+	std::vector<float> velX(pool.velX, pool.velX + count), velY(pool.velY, pool.velY + count), velZ(pool.velZ, pool.velZ + count);
+	std::vector<float> life(pool.life, pool.life + count), angle(pool.angle, pool.angle + count), camDis(count);
+	for (int i=0;i<count;++i)
+	{
+		life[i] += pool.fadeSpeed[i] * FRAME_DELAY;
+		angle[i] += pool.rotationSpeed[i] * FRAME_DELAY;
+		velX[i] += gravity[0] * FRAME_DELAY * pool.density[i];
+		velY[i] += gravity[1] * FRAME_DELAY * pool.density[i];
+		velZ[i] += gravity[2] * FRAME_DELAY * pool.density[i];
+		posX[i] += velX[i] * FRAME_DELAY;
+		posY[i] += velY[i] * FRAME_DELAY;
+		posZ[i] += velZ[i] * FRAME_DELAY;
+		float dx = camPos[0] - posX[i];
+		float dy = camPos[1] - posY[i];
+		float dz = camPos[2] - posZ[i];
+		camDis[i] = dx*dx + dy*dy + dz*dz;
+	}
+	pool.update(FRAME_DELAY, gravity, camPos);
+	bool updateOk = (pool.count == count) &&
+		sameFloats(pool.posX, posX.data(), count) && sameFloats(pool.posY, posY.data(), count) && sameFloats(pool.posZ, posZ.data(), count) &&
+		sameFloats(pool.velX, velX.data(), count) && sameFloats(pool.velY, velY.data(), count) && sameFloats(pool.velZ, velZ.data(), count) &&
+		sameFloats(pool.life, life.data(), count) && sameFloats(pool.angle, angle.data(), count) && sameFloats(pool.camDis, camDis.data(), count);
+
+	//--- The frames
+	double updateMs = 0;
+	double sortMs = 0;
+	bool sortOk = true;
+	int nbDead = 0;
+	for (int frame=0;frame<NB_FRAME;++frame)
+	{
+		auto start = std::chrono::steady_clock::now();
+		pool.update(FRAME_DELAY, gravity, camPos);
+		updateMs += elapsedMs(start);
+
+		nbDead += NB_PARTICLE - pool.count;
+		while (pool.count < NB_PARTICLE) spawn(pool);
+
+		start = std::chrono::steady_clock::now();
+		pool.sort();
+		sortMs += elapsedMs(start);
+
+		for (int i=1;i<pool.count && sortOk;++i)
+		{
+			if (pool.camDis[pool.order[i-1]] < pool.camDis[pool.order[i]]) sortOk = false;
+		}
+	}
+
+#ifdef DKP_SSE2
+	printf("SSE2 update\n");
+#else
+	printf("Scalar update\n");
+#endif
+	printf("%i particles x %i frames, %i died and came back\n", NB_PARTICLE, NB_FRAME, nbDead);
+	printf("update : %8.3f ms/frame\n", updateMs / NB_FRAME);
+	printf("sort   : %8.3f ms/frame\n", sortMs / NB_FRAME);
+	printf("first frame same as the scalar update : %s\n", (updateOk) ? "yes" : "NO");
+	printf("back to front : %s\n", (sortOk) ? "yes" : "NO");
+
+	return (updateOk && sortOk) ? 0 : 1;
+}
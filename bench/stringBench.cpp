@@ -0,0 +1,185 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as published by the
+	Free Software Foundation, either version 3 of the License, or (at your option)
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+// Heap allocations made by CString on the console and cvar paths. operator new is
+// counted, then each path is run many times and we print allocations and time per call.
+//
+// Console::add pulls the whole game, so its string work is done here the same way :
+// the message by value, textColorLess, the copy kept in the list, the ">> " for the admins.
+// The cvars are the real dksvar.
+
+#include "dksvar.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <new>
+#include <vector>
+
+
+#define NB_CALL 100000
+
+
+static unsigned long nbAlloc = 0;
+
+void * operator new(size_t size)
+{
+	nbAlloc++;
+	void * p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+void * operator new[](size_t size)
+{
+	nbAlloc++;
+	void * p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+void operator delete(void * p) noexcept {free(p);}
+void operator delete[](void * p) noexcept {free(p);}
+void operator delete(void * p, size_t) noexcept {free(p);}
+void operator delete[](void * p, size_t) noexcept {free(p);}
+
+
+
+// Same as main.cpp
+class StringInterface : public CStringInterface
+{
+public:
+	virtual void updateString(CString* string, char * newValue)
+	{
+		*string = newValue;
+	}
+};
+
+
+
+// Same as Helper.cpp
+static CString textColorLess(const CString & text)
+{
+	char result[MAX_CARAC];
+	int ri = 0;
+	for (int i=0;i<text.len();++i)
+	{
+		char c = text[i];
+		if ((unsigned char)c >= '\x10' || (unsigned char)c == '\n') result[ri++] = c;
+	}
+	result[ri] = '\0';
+	return CString("%s", result);
+}
+
+
+
+// The string work of Console::add, with one admin on the server
+static std::vector<CString> messages;
+static void consoleAdd(CString message)
+{
+	CString messageStr = textColorLess(message);
+	if (messages.size() >= 64) messages.clear();
+	messages.push_back(message);
+	message = CString(">> ") + message;
+}
+
+
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+// Run a path NB_CALL times, print allocations and time per call
+template <typename T>
+static void measure(const char * name, T path)
+{
+	path(0); // Warm up, the first run can fill caches
+	unsigned long before = nbAlloc;
+	auto start = std::chrono::steady_clock::now();
+	for (int i=0;i<NB_CALL;++i) path(i);
+	double ms = elapsedMs(start);
+	printf("%-36s %6.2f alloc/call  %8.1f ns/call\n", name, (double)(nbAlloc - before) / NB_CALL, ms * 1000000.0 / NB_CALL);
+}
+
+
+
+int main()
+{
+	StringInterface stringInterface;
+	dksvarInit(&stringInterface);
+
+	//--- About as many cvars as the game registers
+	static int intVars[100];
+	static float floatVars[100];
+	static CString stringVars[100];
+	for (int i=0;i<100;++i)
+	{
+		intVars[i] = i;
+		floatVars[i] = (float)i;
+		stringVars[i] = "Some server name";
+		dksvarRegister(CString("sv_intVar%i", i), &(intVars[i]), 0, 1000, LIMIT_MIN | LIMIT_MAX, false);
+		dksvarRegister(CString("cl_floatVar%i", i), &(floatVars[i]), 0, 1000, LIMIT_MIN | LIMIT_MAX, false);
+		dksvarRegister(CString("sv_stringVar%i", i), &(stringVars[i]), false);
+	}
+
+	const char * playerName = "\x4Some\x1Player";
+
+	measure("console, short message", [&](int)
+	{
+		consoleAdd(CString("\x4> Map restart"));
+	});
+	measure("console, player joined", [&](int)
+	{
+		consoleAdd(CString("\x3> %s joined the game", playerName));
+	});
+	measure("console, long message", [&](int)
+	{
+		consoleAdd(CString("\x4> %s has been kicked by the vote of the players (%i/%i)", playerName, 5, 8));
+	});
+
+	char command[64];
+	measure("dksvarCommand set int", [&](int i)
+	{
+		sprintf(command, "set sv_intVar%i %i", i % 100, i % 1000);
+		dksvarCommand(command);
+	});
+	measure("dksvarCommand set string", [&](int i)
+	{
+		sprintf(command, "set sv_stringVar%i \"Some other server\"", i % 100);
+		dksvarCommand(command);
+	});
+	measure("dksvarFind", [&](int i)
+	{
+		sprintf(command, "cl_floatVar%i", i % 100);
+		dksvarFind(command);
+	});
+	CString formated;
+	dksvarHandle handle = dksvarFind("sv_stringVar42");
+	measure("dksvarGetFormatedVar (handle)", [&](int)
+	{
+		dksvarGetFormatedVar(handle, &formated);
+	});
+	measure("dksvarGetFormatedVar (name)", [&](int i)
+	{
+		sprintf(command, "sv_intVar%i", i % 100);
+		dksvarGetFormatedVar(command, &formated);
+	});
+
+	return 0;
+}
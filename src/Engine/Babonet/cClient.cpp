@@ -823,32 +823,39 @@ cPacket* cClient::GetReadyPacket()
 int cClient::Send(UINT4 &nbByte)
 {
 	//on va envoyer les packets en attente dans la liste PacketsTCP
+	if(!PacketsToSend) return 0;
 
-	int	packed			=	0;
-	char	*buf		=	new char[3072];
+	//how many packets go in this batch, DataRate bytes per update (at least one packet)
+	int		total		=	KEY_SIZE;
 	char	NbPacket	=	0;
-
-
-	if(PacketsToSend)
+	for(cPacket *p=PacketsToSend;p && NbPacket < TCP_MAX_PACKETS;p=p->Next)
 	{
+		NbPacket++;
+		total += sizeof(stHeader) + p->Size;
 
-		//on parse notre key
-		memcpy(buf + packed,&Key,sizeof(char)*4);
-            //packed += sizeof(sizeof(char)*4);
-            packed += sizeof(UINT4);
-	
-		//on parse le packetID
-		char pid[5];
-		GetLastPacketID(pid);
-		memcpy(buf + packed,&(pid),sizeof(char) * 4);
-		packed += (sizeof(char) * 4) + 1; //+1 pour laisser 1 place pour le nombre de packet
+		if(total >= DataRate) break; //on est pret a envoyer une premier bacth
 	}
-	
 
-	cPacket *toKill=0;
-	for(cPacket *p=PacketsToSend;p;delete toKill)
+	int		packed		=	0;
+	char	*buf		=	(total <= TCP_FRAME_SIZE) ? SendBuffer : new char[total];
+
+	//on parse notre key
+	memcpy(buf + packed,&Key,sizeof(char)*4);
+	packed += sizeof(UINT4);
+
+	//on parse le packetID
+	char pid[5];
+	GetLastPacketID(pid);
+	memcpy(buf + packed,&(pid),sizeof(char) * 4);
+	packed += sizeof(char) * 4;
+
+	//on copie le nombre de packet qui sen vient
+	memcpy(buf + packed,&NbPacket,sizeof(char));
+	packed += sizeof(char);
+
+	for(char i=0;i<NbPacket;i++)
 	{
-		NbPacket++;
+		cPacket *p = PacketsToSend;
 
 		stHeader header;
 
@@ -865,72 +872,32 @@ int cClient::Send(UINT4 &nbByte)
 			packed += header.Size;
 		}
 
-		
-		if(packed >= DataRate) //on est pret a envoyer une premier bacth
-		{
-			//on copie le nombre de packet qui sen vient
-			memcpy(&(buf[8]),&NbPacket,sizeof(char));
-
-			int sent	=	0;
-			
-			while(sent < packed)
-			{
-				int iSent=0;
-				iSent = send(FileDescriptor,buf + sent,packed - sent,0);
-
-				if(iSent <= 0)
-				{
-					printf("Problem sending packets in cClient::Send() \n");
-					//sprintf(LastError,"Problem sending packets in cClient::Send()");
-					delete [] buf;
-					return 1;
-				}
-
-				sent += iSent;
-			}
-			nbByte += packed;
-			packed = 0;
-
-			toKill = p;
-			PacketsToSend=p=p->Next;
-			
-			delete [] buf;
-
-			delete toKill;
-			return 0;
-		}
-
-		toKill = p;
-		PacketsToSend=p=p->Next;
+		PacketsToSend = p->Next;
+		if(PacketsToSend) PacketsToSend->Previous = 0;
+		delete p;
 	}
 
-	if(packed)
+	int sent	=	0;
+	
+	while(sent < packed)
 	{
+		int iSent=0;
+		iSent = send(FileDescriptor,buf + sent,packed - sent,0);
 
-		memcpy(&(buf[8]),&NbPacket,sizeof(char));
-
-		int sent	=	0;
-		
-		while(sent < packed)
+		if(iSent <= 0)
 		{
-			int iSent=0;
-			iSent = send(FileDescriptor,buf + sent,packed - sent,0);
-
-			if(iSent <= 0)
-			{
-				printf("Problem sending packets in cClient::Send() \n");
-				//sprintf(LastError,"Problem sending packets in cClient::Send()");
-				delete [] buf;
-				return 1;
-			}
-
-			sent += iSent;
+			printf("Problem sending packets in cClient::Send() \n");
+			//sprintf(LastError,"Problem sending packets in cClient::Send()");
+			if(buf != SendBuffer) delete [] buf;
+			return 1;
 		}
 
-		nbByte += packed;
+		sent += iSent;
 	}
 
-	delete [] buf;
+	nbByte += packed;
+
+	if(buf != SendBuffer) delete [] buf;
 	return 0;
 
 }
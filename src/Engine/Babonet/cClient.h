@@ -81,6 +81,8 @@ private:
 
 	bool			isServer;			// garde si oui ou non on est en mode serveur
 
+	char			SendBuffer[TCP_FRAME_SIZE];	// the TCP batch is built here, no allocation per send
+
 
 	bool			GetPendingID(char *pid);				// returns true if hash are different
 	void			GetLastPacketID(char *pid);	// returns hashed packetID
@@ -19,11 +19,17 @@
 #include "cPacket.h"
 
 
+//the recycled shared payloads, only the thread that sends (bb_serverSend) uses them
+static stSharedData	*FreeShared		=	0;
+static int			NbFreeShared	=	0;
+
+
 cPacket::cPacket()
 {
 	//isAlive	=	false;
 	TypeID	=	0;
 	Data	=	0;
+	Shared	=	0;
 	Size	=	0;
 
 	Remaining	=	0;
@@ -36,6 +42,7 @@ cPacket::cPacket(cPacket *packet)
 {
 	TypeID	=	packet->TypeID;
 	Size	=	packet->Size;
+	Shared	=	0;
 
 	//si on passe pas de data
 	if(!Size)
@@ -58,6 +65,7 @@ cPacket::cPacket(char *data,int size,unsigned short typeID)
 {
 	TypeID	=	typeID;
 	Size	=	(unsigned short)size;
+	Shared	=	0;
 	//isAlive	=	true;
 
 	//si on passe pas de data
@@ -78,6 +86,70 @@ cPacket::cPacket(char *data,int size,unsigned short typeID)
 }
 
 
+cPacket::cPacket(stSharedData *shared,int size,unsigned short typeID)
+{
+	TypeID	=	typeID;
+	Size	=	(unsigned short)size;
+
+	//on copie pas, on garde une reference
+	Shared	=	shared;
+	Shared->RefCount++;
+	Data	=	Size ? GetSharedData(Shared) : 0;
+
+	Remaining	=	Size;
+
+	Next		=	0;
+	Previous	=	0;
+}
+
+stSharedData* cPacket::CreateSharedData(char *data,int size)
+{
+	stSharedData *shared = 0;
+
+	if(size <= SHARED_BLOCK_SIZE)
+	{
+		//on reprend un bloc du pool si on peut
+		if(FreeShared)
+		{
+			shared = FreeShared;
+			FreeShared = shared->NextFree;
+			NbFreeShared--;
+		}
+		else
+		{
+			shared = (stSharedData*)(new char[sizeof(stSharedData) + SHARED_BLOCK_SIZE]);
+			shared->Capacity = SHARED_BLOCK_SIZE;
+		}
+	}
+	else
+	{
+		shared = (stSharedData*)(new char[sizeof(stSharedData) + size]);
+		shared->Capacity = size;
+	}
+
+	shared->RefCount	=	1;
+	shared->NextFree	=	0;
+	if(size) memcpy(GetSharedData(shared),data,size);
+
+	return shared;
+}
+
+void cPacket::ReleaseSharedData(stSharedData *shared)
+{
+	if(--shared->RefCount > 0) return;
+
+	//les petits blocs retournent dans le pool
+	if(shared->Capacity == SHARED_BLOCK_SIZE && NbFreeShared < SHARED_POOL_SIZE)
+	{
+		shared->NextFree = FreeShared;
+		FreeShared = shared;
+		NbFreeShared++;
+		return;
+	}
+
+	delete [] (char*)shared;
+}
+
 int cPacket::Send(int socketFD)
 {
 	//on setup une struct pour envoyer
@@ -209,5 +281,10 @@ cPacket::~cPacket()
 	Next		=	0;
 	Previous	=	0;
 
-	if(Data) delete Data;
+	if(Shared)
+	{
+		ReleaseSharedData(Shared);
+		Shared = 0;
+	}
+	else if(Data) delete [] Data;
 }
@@ -38,6 +38,12 @@
 //un header de packet UDP est composer de 4 bytes
 #define UDP_HEADER_SIZE		4
 
+//the TCP batch buffer of a client, bigger batches are allocated
+#define TCP_FRAME_SIZE		3072
+
+//the TCP batch header holds the number of packets on a signed char
+#define TCP_MAX_PACKETS		127
+
 
 	//notre packet header
 	struct stHeader
@@ -46,6 +52,20 @@
 		unsigned short typeID;
 	};
 
+	//a payload shared by all the packets of a broadcast, the data follows the struct
+	struct stSharedData
+	{
+		int				RefCount;	//how many packets still use it
+		int				Capacity;	//size of the data block
+		stSharedData	*NextFree;	//for the pool
+	};
+
+//small shared payloads are recycled, this is their block size
+#define SHARED_BLOCK_SIZE	256
+
+//max number of blocks kept in the pool
+#define SHARED_POOL_SIZE	512
+
 		
 
 class cPacket
@@ -78,17 +98,23 @@ public:
 
 	
 	char			*Data;		//pointeur vers le data du packet
+	stSharedData	*Shared;	//if Data belongs to a shared payload (broadcast), 0 otherwise
 		
 
 	cPacket();
 	cPacket(cPacket *packet);
 	cPacket(char *data,int size,unsigned short typeID); // packet de recpetion par un client
+	cPacket(stSharedData *shared,int size,unsigned short typeID); // packet that uses a shared payload, no copy
 	//cPacket(unsigned short Size,char *data,unsigned short typeID); //packet d'envoie d'un client
 	~cPacket();
 
 
 	int				Send(int socketFD);					//le packet s'envoie au socket passer en param, retourne le nombre de byte envoyer
 	int				SendUDP(int socketFD,sockaddr_in *ip);	//envoie d'un packet UDP
+
+	static stSharedData*	CreateSharedData(char *data,int size);	//copy the data once for all the recipients, the caller holds one reference
+	static void				ReleaseSharedData(stSharedData *shared);	//drop one reference, the last one gives the block back
+	static char*			GetSharedData(stSharedData *shared)	{	return (char*)(shared + 1);	}
 };
 
 
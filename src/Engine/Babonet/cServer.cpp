@@ -30,6 +30,12 @@ cServer::cServer()
 	ipAdress.sin_port = htons(11112);
 	ListenPort	=	11112;
 
+	Listener	=	0;
+	EpollFD		=	-1;
+#ifdef USE_EPOLL
+	EpollFD		=	epoll_create(MAX_EPOLL_EVENTS);
+#endif
+
 	if(PrepareHosting())
 	{
 		sprintf(LastMessage,"Error spawning server - See bb_getLastError");
@@ -83,6 +89,11 @@ cServer::cServer(bool udpenabled,int maxclients,unsigned short port)
 	Timeout.tv_usec =	0;
 
 	Listener = 0;
+
+	EpollFD		=	-1;
+#ifdef USE_EPOLL
+	EpollFD		=	epoll_create(MAX_EPOLL_EVENTS);
+#endif
 	
 	
 	if(PrepareHosting())
@@ -204,6 +215,7 @@ int cServer::PrepareHosting()
 
 	// add the TCP listener to the master set
             FD_SET((unsigned int)(Listener), &master);
+	WatchSocket(Listener,0);
 
 
 	if(UDPenabled)
@@ -280,8 +292,43 @@ int cServer::SendPacketsToClients()
 	//Timeout.tv_usec =	0;
 
 
-	//pour chaque client on va envoyer les packets quil a dans son queue
+	//one select() for all the clients that have something to send, the idle ones cost nothing
+	fd_set	writeTCP;
+	int		maxFD = -1;
+	FD_ZERO(&writeTCP);
 	for(cClient *C = Clients;C;C=C->Next)
+	{
+		if(!C->PacketsToSend) continue;
+
+		FD_SET((unsigned int)(C->FileDescriptor), &writeTCP);
+		if(C->FileDescriptor > maxFD) maxFD = C->FileDescriptor;
+	}
+
+	if(maxFD >= 0)
+	{
+		Timeout.tv_sec	=	0;
+		Timeout.tv_usec =	0;
+
+		if (select(maxFD+1, NULL, &writeTCP, NULL, &Timeout) == -1)
+		{
+			// an invalid socket is in the fd_set, find who with the per-client test
+			if( errno == 9 )
+			{
+				for(cClient *C = Clients;C;C=C->Next)
+				{
+					if(C->PacketsToSend && C->IsReadyToSend() == BBNET_ERROR)
+					{
+						RemoveClient(C);
+						return 0;
+					}
+				}
+			}
+			FD_ZERO(&writeTCP);
+		}
+	}
+
+	//pour chaque client on va envoyer les packets quil a dans son queue
+	for(cClient *C = Clients;maxFD >= 0 && C;C=C->Next)
 	{
 		//if(UDPenabled)
 		//{
@@ -307,16 +354,7 @@ int cServer::SendPacketsToClients()
 		//}
 
 		//le client est pret a envoyer en tcp
-		INT4 isReady = C->IsReadyToSend();
-
-		// check if we have a problem with the client
-		if( isReady == BBNET_ERROR )
-		{
-			RemoveClient(C);
-            return 0;
-		}
-
-		if( isReady )
+		if( C->PacketsToSend && FD_ISSET( C->FileDescriptor , &writeTCP ) )
 		{
 			if(C->Send(BytesSent))
 			{
@@ -361,8 +399,37 @@ int	cServer::ReceiveDatagram(cPacket *packet,sockaddr_in fromIP)
 
 INT4 cServer::ReceivePacketsFromClients()
 {
+#ifdef USE_EPOLL
+	if(EpollFD != -1)
+	{
+		//on a juste les sockets prets, pas besoin de passer tout les clients
+		epoll_event events[MAX_EPOLL_EVENTS];
+		int n = epoll_wait(EpollFD, events, MAX_EPOLL_EVENTS, 0);
+		if(n == -1)
+		{
+			if(errno != EINTR) printf(" error epoll_wait()ing while cServer::ReceivePacketsFromClients() \n errno : %i", errno);
+			return 0;
+		}
 
-	
+		for(int i=0;i<n;i++)
+		{
+			cClient *c = (cClient*)(events[i].data.ptr);
+
+			//check if we need to accept a new connection
+			if(!c)
+			{
+				AcceptConnection(++NewConnID);
+				continue;
+			}
+
+			// a disconnected client ends this update, the others are still ready for the next one
+			INT4 r = ReceiveFromClient(c);
+			if(r) return r;
+		}
+
+		return 0;
+	}
+#endif
 	
 	//TCP part-----------------------------------
 	read_fds = master; // copy it
@@ -400,57 +467,8 @@ INT4 cServer::ReceivePacketsFromClients()
 			// ready to receive from him
 			if( tRecv )
 			{
-				int nbytes=0;		//garde le nombre de bytes retourner par recv()
-				char buf[2048];		//buffer for client data
-
-
-				if ((nbytes = recv(c->FileDescriptor, buf, sizeof(buf), 0)) <= 0)
-				{
-					// got error or connection closed by client
-					if (nbytes == 0)
-					{
-						// connection closed
-						//sprintf(LastMessage,"Server : client on socket %i disconnected", c->FileDescriptor);
-					} 
-					else
-					{
-						//printf(" error recv()ing while cServer::ReceivePacketsFromClients() error = %i \n", nbytes);
-						//sprintf(LastError,"Error : Problem recv()ing, client on socket %i will be disconnected WSA %i",i,WSAGetLastError());
-					}
-					//getClientByFD((UINT4)i)->CloseSocket(i); // bye!
-					//FD_CLR(i, &master); // remove from master set
-		
-					int disconnectedClient = c->NetID * -1;
-		
-					//on va enlever le client de la liste des clients
-					RemoveClient(c);
-
-					//fdmax = GetMaxFD();
-		
-					return disconnectedClient;
-				}
-				else
-				{
-					//on va recevoir les packets quia a recevoir par clients
-					if(c->ReceiveStream(nbytes,buf))
-					{
-						//potential hacking detected
-						sprintf(LastMessage,"Server : client disconnected due to potential hacking");
-		
-						//getClientByFD(i)->CloseSocket(i); // bye!
-						//FD_CLR(i, &master); // remove from master set
-		
-						int disconnectedClient = c->NetID * -1;
-		
-						//on va enlever le client de la liste des clients
-						RemoveClient(c);
-
-						//fdmax = GetMaxFD();
-		
-						return disconnectedClient;
-					}	
-					BytesReceived += nbytes;
-				}
+				INT4 r = ReceiveFromClient(c);
+				if(r) return r;
 			}
 
 		}
@@ -609,6 +627,81 @@ INT4 cServer::ReceivePacketsFromClients()
 	return 0;
 }
 
+INT4 cServer::ReceiveFromClient(cClient *c)
+{
+	int nbytes=0;		//garde le nombre de bytes retourner par recv()
+	char buf[2048];		//buffer for client data
+
+
+	if ((nbytes = recv(c->FileDescriptor, buf, sizeof(buf), 0)) <= 0)
+	{
+		// got error or connection closed by client
+		if (nbytes == 0)
+		{
+			// connection closed
+			//sprintf(LastMessage,"Server : client on socket %i disconnected", c->FileDescriptor);
+		} 
+		else
+		{
+			//printf(" error recv()ing while cServer::ReceivePacketsFromClients() error = %i \n", nbytes);
+			//sprintf(LastError,"Error : Problem recv()ing, client on socket %i will be disconnected WSA %i",i,WSAGetLastError());
+		}
+		//getClientByFD((UINT4)i)->CloseSocket(i); // bye!
+		//FD_CLR(i, &master); // remove from master set
+	
+		int disconnectedClient = c->NetID * -1;
+	
+		//on va enlever le client de la liste des clients
+		RemoveClient(c);
+
+		//fdmax = GetMaxFD();
+	
+		return disconnectedClient;
+	}
+	else
+	{
+		//on va recevoir les packets quia a recevoir par clients
+		if(c->ReceiveStream(nbytes,buf))
+		{
+			//potential hacking detected
+			sprintf(LastMessage,"Server : client disconnected due to potential hacking");
+	
+			//getClientByFD(i)->CloseSocket(i); // bye!
+			//FD_CLR(i, &master); // remove from master set
+	
+			int disconnectedClient = c->NetID * -1;
+	
+			//on va enlever le client de la liste des clients
+			RemoveClient(c);
+
+			//fdmax = GetMaxFD();
+	
+			return disconnectedClient;
+		}	
+		BytesReceived += nbytes;
+	}
+
+	return 0;
+}
+
+void cServer::WatchSocket(int socketFD,cClient *client)
+{
+#ifdef USE_EPOLL
+	if(EpollFD == -1) return;
+
+	//un socket ferme sort tout seul du set, pas besoin de le retirer
+	epoll_event event;
+	memset(&event, 0, sizeof(epoll_event));
+	event.events	=	EPOLLIN;
+	event.data.ptr	=	client;
+
+	if(epoll_ctl(EpollFD, EPOLL_CTL_ADD, socketFD, &event) == -1)
+	{
+		printf(" error epoll_ctl()ing socket %i errno : %i \n", socketFD, errno);
+	}
+#endif
+}
+
 INT4 cServer::UpdateConnections(char *newIP)
 {
 
@@ -752,6 +845,7 @@ int cServer::CreateListener()
 
     // add the TCP listener to the master set
         FD_SET((unsigned int)(Listener), &master);
+	WatchSocket(Listener,0);
 
 
 	// keep track of the biggest TCP file descriptor
@@ -865,6 +959,9 @@ INT4 cServer::CreateClient(sockaddr_in *ip, int fileDescriptor,unsigned short ud
 
 	Cli->UDPport	=	UDPenabled ? udpPort : 0;
 
+	//on va watcher son socket pour savoir quand il nous envoie de quoi
+	WatchSocket(fileDescriptor,Cli);
+
 	//on va ajouter le nouveau file descriptor au master set
 	//FD_SET(fileDescriptor,&master);
 
@@ -882,10 +979,17 @@ int cServer::Send(char *dataToSend,int dataSize,int typeID,INT4 destination,int
 	//envoie a toute les clients
 	if(destination<1)
 	{
+		if(!Clients) return 0;
+
+		//le data est copie une seule fois, tout les clients partagent le meme payload
+		stSharedData *shared = cPacket::CreateSharedData(dataToSend,dataSize);
+
 		for(cClient *C=Clients;C;C=C->Next)
 		{
-			C->CreatePacket(new cPacket(dataToSend,dataSize,(unsigned short)(typeID)),UDPenabled ? (protocol ? true : false) : false);
+			C->CreatePacket(new cPacket(shared,dataSize,(unsigned short)(typeID)),UDPenabled ? (protocol ? true : false) : false);
 		}
+
+		cPacket::ReleaseSharedData(shared);
 	}
 	else
 	{
@@ -1086,5 +1190,6 @@ cServer::~cServer()
 	Listener	=	0;
 	UDPfd		=	0;
 
-
+	if(EpollFD != -1) CloseSocket(EpollFD);
+	EpollFD		=	-1;
 }
@@ -30,6 +30,16 @@
 	#include <arpa/inet.h>
 #endif
 
+//on linux the sockets are watched with epoll, select() is the fallback
+#if defined(__linux__)
+	#include <sys/epoll.h>
+	#define USE_EPOLL
+#endif
+
+
+//how many ready sockets we handle per epoll_wait()
+#define MAX_EPOLL_EVENTS	64
+
 
 //notre class serveur
 class cServer
@@ -56,6 +66,11 @@ private:
 	
 	bool			UDPenabled;			// on est a tu UDP pour le server ?
 
+	int			EpollFD;			// the epoll set of the listener and the clients, -1 if we use select()
+
+	void		WatchSocket(int socketFD,cClient *client);		// add a socket to the epoll set, client 0 is the listener
+	INT4		ReceiveFromClient(cClient *c);					// recv() what a ready client sent, returns -babonetID if he got disconnected
+
 public:
 
 	UINT4	BytesSent;			// nombre total de byte que le serveur a envoyer
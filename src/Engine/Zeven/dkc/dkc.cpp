@@ -118,11 +118,10 @@ void			dkcJumpToFrame(int frame)
 
 
 //
-// Will return the current frame count
+// Le nombre de tick du CPU
 //
-INT4			dkcUpdateTimer()
+INT64 CDkc::getTickCount()
 {
-	// On prend le nombre de tick du CPU
 	INT64 lGetTickCount;
 	
 	#ifdef WIN32
@@ -150,6 +149,31 @@ INT4			dkcUpdateTimer()
 
 	#endif
 
+	return lGetTickCount;
+}
+
+
+
+//
+// Time left before the next update cycle is due
+//
+float			dkcGetTimeToNextFrame()
+{
+	double elapsedd = (double)((CDkc::lastFrameCount) ? CDkc::getTickCount() - CDkc::lastFrameCount : 0) / (double)CDkc::frequency;
+	float timeLeft = CDkc::perSeconde - CDkc::currentFrameDelay - (float)elapsedd;
+	return (timeLeft > 0) ? timeLeft : 0;
+}
+
+
+
+//
+// Will return the current frame count
+//
+INT4			dkcUpdateTimer()
+{
+	// On prend le nombre de tick du CPU
+	INT64 lGetTickCount = CDkc::getTickCount();
+
 	// On update le timer
 	double elapsedd = (double)((CDkc::lastFrameCount) ? lGetTickCount - CDkc::lastFrameCount : 0) / (double)CDkc::frequency;
 	CDkc::lastFrameCount = lGetTickCount;
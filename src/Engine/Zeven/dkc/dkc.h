@@ -104,6 +104,15 @@ void			dkcJumpToFrame(int frame);
 INT4			dkcUpdateTimer();
 
 
+
+/// \brief returns the time left before the next update cycle is due
+///
+/// This function returns, in seconds, how long before dkcUpdateTimer() returns at least one update cycle. A loop with nothing else to do can sleep that long.
+///
+/// \return the time left before the next update cycle, 0 if one is already due
+float			dkcGetTimeToNextFrame();
+
+
 void			dkcSleep(INT4 ms);
 
 
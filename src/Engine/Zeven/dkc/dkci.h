@@ -59,6 +59,7 @@ DLL_API(INT4)			dkcGetFrame(); // Pour obtenir le nb de frame o on est rendu
 DLL_API(void)			dkcInit(int framePerSecond); // Init the timer (do at your program start)
 DLL_API(void)			dkcJumpToFrame(int frame); // To step a couple of frame or to init it to 0
 DLL_API(INT4)			dkcUpdateTimer(); // Will return the current frame count
+DLL_API(float)			dkcGetTimeToNextFrame(); // Time left before the next update cycle is due
 DLL_API(void)			dkcSleep(INT4 ms);
 
 
@@ -79,6 +80,8 @@ public:
 	static int oneSecondFrameCound;
 	static float oneSecondElapsedcpt;
 
+	static INT64 getTickCount(); // Le nombre de tick du CPU
+
 public:
 };
 
@@ -0,0 +1,331 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+/* TCE (c) All rights reserved */
+
+
+#include "CParticlePool.h"
+#include <string.h>
+#include <stdlib.h>
+#ifdef DKP_SSE2
+	#include <emmintrin.h>
+#endif
+
+
+
+
+//
+// Constructeur / Destructeur
+//
+CParticlePool::CParticlePool(int in_capacity)
+{
+	count = 0;
+	capacity = in_capacity;
+	sortedCount = 0;
+
+	posX = new float [capacity];
+	posY = new float [capacity];
+	posZ = new float [capacity];
+	velX = new float [capacity];
+	velY = new float [capacity];
+	velZ = new float [capacity];
+	life = new float [capacity];
+	fadeSpeed = new float [capacity];
+	density = new float [capacity];
+	angle = new float [capacity];
+	rotationSpeed = new float [capacity];
+	camDis = new float [capacity];
+	look = new dkp_particle_look [capacity];
+
+	order = new int [capacity];
+	orderTmp = new int [capacity];
+	sortKeys = new unsigned int [capacity];
+	sortKeysTmp = new unsigned int [capacity];
+}
+
+CParticlePool::~CParticlePool()
+{
+	delete [] posX;
+	delete [] posY;
+	delete [] posZ;
+	delete [] velX;
+	delete [] velY;
+	delete [] velZ;
+	delete [] life;
+	delete [] fadeSpeed;
+	delete [] density;
+	delete [] angle;
+	delete [] rotationSpeed;
+	delete [] camDis;
+	delete [] look;
+	delete [] order;
+	delete [] orderTmp;
+	delete [] sortKeys;
+	delete [] sortKeysTmp;
+}
+
+
+
+//
+// Add one particle at the end
+//
+int CParticlePool::add(float * mposition,
+					   float * mvel,
+					   float * mstartColor,
+					   float * mendColor,
+					   float mstartSize,
+					   float mendSize,
+					   float mduration,
+					   float mdensity,
+					   float mrotationSpeed,
+					   unsigned int mtexture,
+					   unsigned int msrcBlend,
+					   unsigned int mdstBlend)
+{
+	if (count >= capacity) return -1;
+	int i = count++;
+
+	posX[i] = mposition[0];
+	posY[i] = mposition[1];
+	posZ[i] = mposition[2];
+	velX[i] = mvel[0];
+	velY[i] = mvel[1];
+	velZ[i] = mvel[2];
+	life[i] = 0;
+	fadeSpeed[i] = 1.0f / mduration;
+	density[i] = mdensity;
+	angle[i] = (float)(rand()%36000)/100.0f;
+	rotationSpeed[i] = mrotationSpeed;
+	camDis[i] = distanceSquared(camPos, CVector3f(mposition));
+
+	dkp_particle_look & l = look[i];
+	l.startColor = CColor4f(mstartColor);
+	l.endColor = CColor4f(mendColor);
+	l.startSize = mstartSize;
+	l.endSize = mendSize;
+	l.texture = mtexture;
+	l.textureArray = 0;
+	l.nbFrame = 1;
+	l.srcBlend = msrcBlend;
+	l.dstBlend = mdstBlend;
+	l.billboard = false;
+	l.toDelete = false;
+	l.billboardOpacity = 0;
+	l.billboardFadeDis = 16;
+	l.billboardFadeDelay = 1;
+
+	return i;
+}
+
+
+
+//
+// Swap remove, the last particle takes its place
+//
+void CParticlePool::remove(int i)
+{
+	int last = --count;
+	if (i == last) return;
+
+	posX[i] = posX[last];
+	posY[i] = posY[last];
+	posZ[i] = posZ[last];
+	velX[i] = velX[last];
+	velY[i] = velY[last];
+	velZ[i] = velZ[last];
+	life[i] = life[last];
+	fadeSpeed[i] = fadeSpeed[last];
+	density[i] = density[last];
+	angle[i] = angle[last];
+	rotationSpeed[i] = rotationSpeed[last];
+	camDis[i] = camDis[last];
+	look[i] = look[last];
+}
+
+
+
+//
+// Kill them all
+//
+void CParticlePool::clear()
+{
+	count = 0;
+	sortedCount = 0;
+}
+
+
+
+//
+// Pour les updater
+//
+int CParticlePool::update(float delay, const CVector3f & gravity, const CVector3f & in_camPos)
+{
+	int i;
+	float gravX = gravity[0] * delay;
+	float gravY = gravity[1] * delay;
+	float gravZ = gravity[2] * delay;
+	float camX = in_camPos[0];
+	float camY = in_camPos[1];
+	float camZ = in_camPos[2];
+	camPos = in_camPos;
+
+	//--- Billboards have no fadeSpeed, density or speed, this leaves them in place.
+	i = 0;
+#ifdef DKP_SSE2
+	const __m128 delay4 = _mm_set1_ps(delay);
+	const __m128 gravX4 = _mm_set1_ps(gravX);
+	const __m128 gravY4 = _mm_set1_ps(gravY);
+	const __m128 gravZ4 = _mm_set1_ps(gravZ);
+	const __m128 camX4 = _mm_set1_ps(camX);
+	const __m128 camY4 = _mm_set1_ps(camY);
+	const __m128 camZ4 = _mm_set1_ps(camZ);
+	for (;i+4<=count;i+=4)
+	{
+		_mm_storeu_ps(life+i, _mm_add_ps(_mm_loadu_ps(life+i), _mm_mul_ps(_mm_loadu_ps(fadeSpeed+i), delay4)));
+		_mm_storeu_ps(angle+i, _mm_add_ps(_mm_loadu_ps(angle+i), _mm_mul_ps(_mm_loadu_ps(rotationSpeed+i), delay4)));
+
+		__m128 d = _mm_loadu_ps(density+i);
+		__m128 vx = _mm_add_ps(_mm_loadu_ps(velX+i), _mm_mul_ps(gravX4, d));
+		__m128 vy = _mm_add_ps(_mm_loadu_ps(velY+i), _mm_mul_ps(gravY4, d));
+		__m128 vz = _mm_add_ps(_mm_loadu_ps(velZ+i), _mm_mul_ps(gravZ4, d));
+		_mm_storeu_ps(velX+i, vx);
+		_mm_storeu_ps(velY+i, vy);
+		_mm_storeu_ps(velZ+i, vz);
+
+		__m128 px = _mm_add_ps(_mm_loadu_ps(posX+i), _mm_mul_ps(vx, delay4));
+		__m128 py = _mm_add_ps(_mm_loadu_ps(posY+i), _mm_mul_ps(vy, delay4));
+		__m128 pz = _mm_add_ps(_mm_loadu_ps(posZ+i), _mm_mul_ps(vz, delay4));
+		_mm_storeu_ps(posX+i, px);
+		_mm_storeu_ps(posY+i, py);
+		_mm_storeu_ps(posZ+i, pz);
+
+		__m128 dx = _mm_sub_ps(camX4, px);
+		__m128 dy = _mm_sub_ps(camY4, py);
+		__m128 dz = _mm_sub_ps(camZ4, pz);
+		_mm_storeu_ps(camDis+i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+	}
+#endif
+	for (;i<count;++i)
+	{
+		life[i] += fadeSpeed[i] * delay;
+		angle[i] += rotationSpeed[i] * delay;
+
+		// On affecte la gravite
+		velX[i] += gravX * density[i];
+		velY[i] += gravY * density[i];
+		velZ[i] += gravZ * density[i];
+
+		// On anim finalement sa position
+		posX[i] += velX[i] * delay;
+		posY[i] += velY[i] * delay;
+		posZ[i] += velZ[i] * delay;
+
+		// Sa distance avec notre camera
+		float dx = camX - posX[i];
+		float dy = camY - posY[i];
+		float dz = camZ - posZ[i];
+		camDis[i] = dx*dx + dy*dy + dz*dz;
+	}
+
+	//--- Billboards fade in and out, the others die of old age
+	for (i=0;i<count;)
+	{
+		bool dead;
+		dkp_particle_look & l = look[i];
+		if (l.billboard)
+		{
+			dead = false;
+			if (l.toDelete)
+			{
+				l.billboardOpacity -= delay * l.billboardFadeDelay;
+				if (l.billboardOpacity <= 0) dead = true;
+			}
+			else if (camDis[i] >= l.billboardFadeDis*l.billboardFadeDis)
+			{
+				l.toDelete = true;
+			}
+			else if (l.billboardOpacity < 1)
+			{
+				l.billboardOpacity += delay * l.billboardFadeDelay;
+				if (l.billboardOpacity > 1) l.billboardOpacity = 1;
+			}
+		}
+		else
+		{
+			dead = (life[i] >= 1);
+		}
+
+		// The last one comes here, we check it next
+		if (dead) remove(i);
+		else ++i;
+	}
+
+	// The order we had is no good anymore
+	sortedCount = 0;
+
+	return count;
+}
+
+
+
+//
+// Back to front on camDis, radix sort on the float bits (camDis is never negative)
+//
+void CParticlePool::sort()
+{
+	int i;
+	for (i=0;i<count;++i)
+	{
+		unsigned int bits;
+		memcpy(&bits, &(camDis[i]), sizeof(bits));
+		sortKeys[i] = ~bits; // Far ones first
+		order[i] = i;
+	}
+
+	unsigned int * keys = sortKeys;
+	unsigned int * keysTmp = sortKeysTmp;
+	int * indices = order;
+	int * indicesTmp = orderTmp;
+	int histogram[256];
+	for (int shift=0;shift<32;shift+=8)
+	{
+		memset(histogram, 0, sizeof(histogram));
+		for (i=0;i<count;++i) histogram[(keys[i] >> shift) & 0xff]++;
+
+		int total = 0;
+		for (int b=0;b<256;++b)
+		{
+			int nb = histogram[b];
+			histogram[b] = total;
+			total += nb;
+		}
+
+		for (i=0;i<count;++i)
+		{
+			int dst = histogram[(keys[i] >> shift) & 0xff]++;
+			keysTmp[dst] = keys[i];
+			indicesTmp[dst] = indices[i];
+		}
+
+		unsigned int * swapKeys = keys; keys = keysTmp; keysTmp = swapKeys;
+		int * swapIndices = indices; indices = indicesTmp; indicesTmp = swapIndices;
+	}
+
+	// 4 passes, the result is back in order
+	sortedCount = count;
+}
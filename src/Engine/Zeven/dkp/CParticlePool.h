@@ -0,0 +1,136 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+/* TCE (c) All rights reserved */
+
+
+#ifndef CPARTICLEPOOL_H
+#define CPARTICLEPOOL_H
+
+
+#include "CVector.h"
+
+
+// How many particles can live at the same time. Past that, new ones are dropped
+#define DKP_MAX_PARTICLE 16384
+
+// update() moves 4 particles per SSE register when we have SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define DKP_SSE2
+#endif
+
+
+// What is set at creation and only read when rendering
+struct dkp_particle_look
+{
+	// Sa couleur au debut et a la fin
+	CColor4f startColor;
+	CColor4f endColor;
+
+	// Sa grosseur au debut et a la fin
+	float startSize;
+	float endSize;
+
+	// Sa texture, ou ses frames si elle est animee
+	unsigned int texture;
+	unsigned int * textureArray;
+	int nbFrame;
+
+	// La fonction de blending utilise
+	unsigned int srcBlend;
+	unsigned int dstBlend;
+
+	// Si c'est un billboard, son opacity et sa distance avant de fader
+	bool billboard;
+	bool toDelete;
+	float billboardOpacity;
+	float billboardFadeDis;
+	float billboardFadeDelay;
+};
+
+
+// All the particles, one array per field. Dead ones are replaced by the last one.
+class CParticlePool
+{
+public:
+	// Le nb de particles vivantes, elles sont de 0 a count-1
+	int count;
+	int capacity;
+
+	// What update() touches every frame
+	float * posX;
+	float * posY;
+	float * posZ;
+	float * velX;
+	float * velY;
+	float * velZ;
+	float * life; // 0 a 1, 1 etant mort
+	float * fadeSpeed; // 1 / sa duree, 0 pour un billboard
+	float * density; // 1 = fully attracted by gravity
+	float * angle;
+	float * rotationSpeed;
+	float * camDis; // Distance au carre avec la camera
+
+	dkp_particle_look * look;
+
+	// Back to front after sort(). The ones created since are sortedCount and up.
+	int * order;
+	int sortedCount;
+
+private:
+	unsigned int * sortKeys;
+	unsigned int * sortKeysTmp;
+	int * orderTmp;
+
+	// Where the camera was on the last update, for the new ones
+	CVector3f camPos;
+
+public:
+	// Constructeur / Destructeur
+	CParticlePool(int in_capacity = DKP_MAX_PARTICLE);
+	virtual ~CParticlePool();
+
+	// Add one, returns its index or -1 if the pool is full
+	int add(float * position,
+			float * vel,
+			float * startColor,
+			float * endColor,
+			float startSize,
+			float endSize,
+			float duration,
+			float density,
+			float rotationSpeed,
+			unsigned int texture,
+			unsigned int srcBlend,
+			unsigned int dstBlend);
+
+	// The last particle takes its place
+	void remove(int index);
+
+	// Kill them all
+	void clear();
+
+	// Move everything, remove the dead ones. Returns the count
+	int update(float delay, const CVector3f & gravity, const CVector3f & in_camPos);
+
+	// Back to front on camDis
+	void sort();
+};
+
+
+#endif
@@ -27,7 +27,7 @@
 #endif
 
 // Les trucs statics
-std::vector<CParticle*> CDkp::particles;
+CParticlePool CDkp::particles;
 CVector3f CDkp::gravity = CVector3f(0,0,-9.8f);
 float CDkp::delay = 0;
 float CDkp::modelView[16] = {0};
@@ -38,7 +38,6 @@ float* CDkp::normalArray = 0;
 float* CDkp::texCoordArray = 0;
 float CDkp::airDensity = 103.4f;
 bool CDkp::sorting = false;
-std::vector<CParticle*>::size_type CDkp::currentSortInteration = 0;
 unsigned int CDkp::lastTexture = 0;
 
 
@@ -56,36 +55,18 @@ void			dkpCreateBillboard(	CVector3f & positionFrom,
 									unsigned int srcBlend,
 									unsigned int dstBlend)
 {
-	CParticle * newPart = new CParticle(
+	int i = CDkp::particles.add(
 		rand(positionFrom, positionTo).s, CVector3f().s, color.s, color.s, size, size, 1, 
-		0, 0, 0, textureID, srcBlend, dstBlend, 0);
-
-	newPart->billboard = true;
-	newPart->billboardFadeDis = fadeOutDistance;
-	newPart->billboardFadeDelay = 1.0f / fadeSpeed;
-	newPart->angle = 0;
-
-	// On l'ajoute  notre liste
-	// On va tout suite l'ajouter au bon endroit pour pas avoir des tri important  faire tantot
-	if (CDkp::particles.size() > 1 && CDkp::sorting) // Il faut qu'il y en ai au moins 1
-	{
-		std::vector<CParticle*>::size_type i;
-		for (i=0;i<CDkp::particles.size();i++)
-		{
-			CParticle * p1 = CDkp::particles.at(i);
-			if (newPart->camDis > p1->camDis)
-			{
-				CDkp::particles.insert(CDkp::particles.begin()+i, newPart);
-				return;
-			}
-		}
-		if (i==CDkp::particles.size())
-		{
-			CDkp::particles.push_back(newPart);
-		}
-	}
-	else
-		CDkp::particles.push_back(newPart);
+		0, 0, textureID, srcBlend, dstBlend);
+	if (i == -1) return;
+
+	// Il bouge pas et vieillit pas, c'est sa distance qui le fait fader
+	dkp_particle_look & look = CDkp::particles.look[i];
+	look.billboard = true;
+	look.billboardFadeDis = fadeOutDistance;
+	look.billboardFadeDelay = 1.0f / fadeSpeed;
+	CDkp::particles.fadeSpeed[i] = 0;
+	CDkp::particles.angle[i] = 0;
 }
 
 
@@ -108,31 +89,11 @@ void			dkpCreateParticle(	float *position,
 									unsigned int dstBlend,
 									int transitionFunc)
 {
-	CParticle * newPart = new CParticle(
+	CDkp::particles.add(
 		position, vel, startColor, endColor, startSize, endSize, duration, 
-		density, airResistanceInfluence, rotationSpeed, texture, srcBlend, dstBlend, transitionFunc);
-
-	// On l'ajoute  notre liste
-	// On va tout suite l'ajouter au bon endroit pour pas avoir des tri important  faire tantot
-	if (CDkp::particles.size() > 1 && CDkp::sorting) // Il faut qu'il y en ai au moins 1
-	{
-		std::vector<CParticle*>::size_type i;
-		for (i=0;i<CDkp::particles.size();i++)
-		{
-			CParticle * p1 = CDkp::particles.at(i);
-			if (newPart->camDis > p1->camDis)
-			{
-				CDkp::particles.insert(CDkp::particles.begin()+i, newPart);
-				break;
-			}
-		}
-		if (i==CDkp::particles.size())
-		{
-			CDkp::particles.push_back(newPart);
-		}
-	}
-	else
-		CDkp::particles.push_back(newPart);
+		density, rotationSpeed, texture, srcBlend, dstBlend);
+	(void)airResistanceInfluence; // Pas utilis
+	(void)transitionFunc;
 }
 
 
@@ -170,6 +131,8 @@ void			dkpCreateParticleEx(CVector3f & positionFrom,
 									unsigned int srcBlend,
 									unsigned int dstBlend)
 {
+	(void)airResistanceInfluence; // Pas utilis
+
 	// On dfini combient on en emet
 	int total = rand((int)particleCountFrom, (int)particleCountTo);
 
@@ -184,7 +147,7 @@ void			dkpCreateParticleEx(CVector3f & positionFrom,
 		vel = rotateAboutAxis(vel, rand((float)0, (float)360), direction);
 
 		// On cr notre particule
-		CParticle * newPart = new CParticle(
+		int i = CDkp::particles.add(
 			rand(positionFrom, positionTo).s, 
 			vel.s, 
 			rand(startColorFrom, startColorTo).s, 
@@ -193,42 +156,20 @@ void			dkpCreateParticleEx(CVector3f & positionFrom,
 			rand(endSizeFrom, endSizeTo),
 			rand(durationFrom, durationTo),
 			gravityInfluence, 
-			airResistanceInfluence,  
 			rand(angleSpeedFrom, angleSpeedTo),
 			(texture) ? *texture : 0, 
 			srcBlend, 
-			dstBlend, 
-			0);
-		newPart->angle = rand(angleFrom, angleTo);
+			dstBlend);
 
-		if (textureFrameCount > 1 && texture)
-		{
-			newPart->isMultipleTexture = true;
-			newPart->nbFrame = textureFrameCount;
-			newPart->textureArray = texture;
-		}
+		// Full, no need to go on
+		if (i == -1) break;
 
-		// On l'ajoute  notre liste
-		// On va tout suite l'ajouter au bon endroit pour pas avoir des tri important  faire tantot
-		if (CDkp::particles.size() > 1 && CDkp::sorting) // Il faut qu'il y en ai au moins 1
+		CDkp::particles.angle[i] = rand(angleFrom, angleTo);
+		if (textureFrameCount > 1 && texture)
 		{
-			std::vector<CParticle*>::size_type i;
-			for (i=0;i<CDkp::particles.size();i++)
-			{
-				CParticle * p1 = CDkp::particles.at(i);
-				if (newPart->camDis > p1->camDis)
-				{
-					CDkp::particles.insert(CDkp::particles.begin()+i, newPart);
-					break;
-				}
-			}
-			if (i==CDkp::particles.size())
-			{
-				CDkp::particles.push_back(newPart);
-			}
+			CDkp::particles.look[i].nbFrame = textureFrameCount;
+			CDkp::particles.look[i].textureArray = texture;
 		}
-		else
-			CDkp::particles.push_back(newPart);
 	}
 }
 
@@ -378,6 +319,73 @@ void			dkpInit()
 
 
 
+//
+// Pour en rendre une
+//
+static void renderParticle(const CParticlePool & pool, int i)
+{
+#ifndef _DX_
+	const dkp_particle_look & l = pool.look[i];
+
+	// On la positionne
+	glPushMatrix();
+
+		glBlendFunc(l.srcBlend, l.dstBlend);
+
+		CColor4f curColor = l.startColor + (l.endColor - l.startColor) * pool.life[i];
+
+		if (l.billboard) curColor[3] *= l.billboardOpacity;
+
+		float sizeTime = l.startSize + (l.endSize - l.startSize) * pool.life[i];
+		glTranslatef(pool.posX[i], pool.posY[i], pool.posZ[i]);
+		glMultMatrixf(CDkp::modelView);
+		glScalef(sizeTime, sizeTime, sizeTime);
+		glRotatef(pool.angle[i], 0, 0, 1);
+
+		if (l.textureArray)
+		{
+			int currentFrame = (int)(l.nbFrame*pool.life[i]);
+			int nextFrame = currentFrame+1;
+			float midFrame = (float)l.nbFrame * pool.life[i] - (float)currentFrame;
+			if (nextFrame >= l.nbFrame) nextFrame = currentFrame;
+
+			glBindTexture(GL_TEXTURE_2D, l.textureArray[currentFrame]);
+			glColor4fv((curColor*CColor4f(1,1,1,1-midFrame)).s);
+			glPushAttrib(GL_ENABLE_BIT);
+				if (l.dstBlend == DKP_ONE || l.dstBlend == DKP_ZERO) 
+				{
+					glDisable(GL_FOG);
+					glDisable(GL_LIGHTING);
+				}
+				glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
+
+				glBindTexture(GL_TEXTURE_2D, l.textureArray[nextFrame]);
+				glColor4fv((curColor*CColor4f(1,1,1,midFrame)).s);
+				glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
+			glPopAttrib();
+			CDkp::lastTexture = l.textureArray[nextFrame];
+		}
+		else 
+		{
+			if (CDkp::lastTexture != l.texture) glBindTexture(GL_TEXTURE_2D, l.texture);
+			CDkp::lastTexture = l.texture;
+			glColor4fv(curColor.s);
+			glPushAttrib(GL_ENABLE_BIT);
+				glDisable(GL_LIGHTING);
+				if (l.dstBlend == DKP_ONE || l.dstBlend == DKP_ZERO) 
+				{
+					glDisable(GL_FOG);
+					glDisable(GL_LIGHTING);
+				}
+				glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
+			glPopAttrib();
+		}
+	glPopMatrix();
+#endif
+}
+
+
+
 //
 // Pour afficher le tout
 //
@@ -438,11 +446,10 @@ void			dkpRender()
 		glNormalPointer(GL_FLOAT, 0, CDkp::normalArray);
 		glTexCoordPointer(2, GL_FLOAT, 0, CDkp::texCoordArray);
 		// On render les particles, apres tout c'est la job de ce API
-		for (i=0;i<(int)CDkp::particles.size();i++)
-		{
-			CParticle * particle = CDkp::particles.at(i);
-			particle->render();
-		}
+		// Back to front, then the ones created since the last sort
+		CParticlePool & pool = CDkp::particles;
+		for (i=0;i<pool.sortedCount;i++) renderParticle(pool, pool.order[i]);
+		for (i=pool.sortedCount;i<pool.count;i++) renderParticle(pool, i);
 		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 		glDisableClientState(GL_NORMAL_ARRAY);
 		glDisableClientState(GL_VERTEX_ARRAY);
@@ -457,11 +464,6 @@ void			dkpRender()
 //
 void			dkpReset()
 {
-	for (int i=0;i<(int)CDkp::particles.size();i++)
-	{
-		CParticle * particle = CDkp::particles.at(i);
-		if (particle) delete particle;
-	}
 	CDkp::particles.clear();
 }
 
@@ -502,11 +504,6 @@ void			dkpSetSorting(bool sort)
 //
 void			dkpShutDown()
 {
-	for (int i=0;i<(int)CDkp::particles.size();i++)
-	{
-		CParticle * particle = CDkp::particles.at(i);
-		if (particle) delete particle;
-	}
 	CDkp::particles.clear();
 
 	// On efface la display list
@@ -524,71 +521,14 @@ void			dkpShutDown()
 //
 int				dkpUpdate(float delay)
 {
-	// Le nb de particle
-	int particleCount=0;
-
 	// On update notre delait gnral
 	CDkp::delay = delay;
 
-	// On les updates normalement avant tout
-	for (int i=0;i<(int)CDkp::particles.size();i++)
-	{
-		CParticle * particle = CDkp::particles.at(i);
-		if (!particle->update())
-		{
-			// On doit effacer cette particule
-			delete particle;
-			CDkp::particles.erase(CDkp::particles.begin() + i);
-			i--;
-			continue;
-		}
-		else
-			particleCount++;
-	}
-
-	std::vector<CParticle*>::size_type lastIndex = std::vector<CParticle*>::size_type(-1);
-	int curInteration = 0;
-	if (CDkp::currentSortInteration >= CDkp::particles.size()-1) CDkp::currentSortInteration = 0;
+	// On les updates, les mortes sont enleves
+	int particleCount = CDkp::particles.update(delay, CDkp::gravity, CDkp::camPos);
 
 	// Maintenant, il faut trier ses particles par rapport  la camera
-	if (CDkp::particles.size() > 1 && CDkp::sorting) // Il faut qu'il y en ai au moins 2
-	{
-		for (std::vector<CParticle*>::size_type i=CDkp::currentSortInteration;i<CDkp::particles.size()-1;i++)
-		{
-			curInteration++;
-
-			// On ne veut pas surcharger
-			if (curInteration >= 2000)
-			{
-				CDkp::currentSortInteration = i;
-				break;
-			}
-
-			CParticle * p1 = CDkp::particles.at(i);
-			CParticle * p2 = CDkp::particles.at(i+1);
-			if (p1->camDis < p2->camDis)
-			{
-				// Alors il faut switcher les deux
-				CDkp::particles.erase(CDkp::particles.begin()+i+1);
-				CDkp::particles.insert(CDkp::particles.begin()+i, p2);
-				if (lastIndex == -1) lastIndex = i;
-				if (i>0) i-=2;
-				continue;
-			}
-			else if (lastIndex != -1)
-			{
-				i = lastIndex - 1;
-				lastIndex = std::vector<CParticle*>::size_type(-1);
-				continue;
-			}
-
-			if (i == CDkp::particles.size()-2)
-			{
-				CDkp::currentSortInteration = 0;
-				break;
-			}
-		}
-	}
+	if (CDkp::sorting) CDkp::particles.sort();
 
 	return particleCount;
 }
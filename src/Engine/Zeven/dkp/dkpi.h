@@ -44,7 +44,7 @@
 
 #include "dkgl.h"
 
-#include "CParticle.h"
+#include "CParticlePool.h"
 
 
 
@@ -183,8 +183,8 @@ DLL_API int				dkpUpdate(float delay);
 class CDkp
 {
 public:
-	// La liste de toute les particles ouais poup
-	static std::vector<CParticle*> particles;
+	// Toute les particles ouais poup
+	static CParticlePool particles;
 
 	// La gravit
 	static CVector3f gravity;
@@ -212,9 +212,6 @@ public:
 	// Si on doit les sorter ou pas
 	static bool sorting;
 
-	// Pour sorter o on est rendu
-	static std::vector<CParticle*>::size_type currentSortInteration;
-
 public:
 };
 
@@ -45,6 +45,7 @@ CSystemVariable::~CSystemVariable()
 		if (svType) delete svType;
 	}
 	variables.clear();
+	names.clear();
 }
 
 
@@ -70,43 +71,15 @@ bool CSVString::setValue(const CString & paramsT){
 //
 void CSystemVariable::loadConfig(char * filename)
 {
-	ifstream ficIn(filename, ios::in);
-
-	if (ficIn.fail())
-	{
-		// On imprime message  la console? (pkoi pas, on est dedans :P)
-		return;
-	}
-
-	while (!ficIn.eof())
-	{
-		char variable[256];
-		ficIn >> variable;
-		if ((variable[0] == '/') && (variable[1] == '/'))
-		{
-			ficIn.ignore(512, '\n');
-			continue;
-		}
-
-		// On check  quel variable a correspond
-		for (int i=0;i<(int)variables.size();i++)
-		{
-			CSVType *svType = variables.at(i);
-			CString varNameTmp = svType->variableName;
-			if (varNameTmp.getFirstToken(' ') == variable)
-			{
-				svType->loadConfig(ficIn);
-				break;
-			}
-		}
-
-		// On flush le reste de la ligne
-		ficIn.ignore(512, '\n');
-	}
-	ficIn.close();
+	loadConfig(filename, false);
 }
 
 void CSystemVariable::loadConfigSVOnly(char * filename)
+{
+	loadConfig(filename, true);
+}
+
+void CSystemVariable::loadConfig(char * filename, bool svOnly)
 {
 	ifstream ficIn(filename, ios::in);
 
@@ -127,23 +100,10 @@ void CSystemVariable::loadConfigSVOnly(char * filename)
 		}
 
 		// On check  quel variable a correspond
-		for (int i=0;i<(int)variables.size();i++)
+		CSVType *svType = find(variable);
+		if (svType && (!svOnly || strnicmp(variable, "sv_", 3) == 0))
 		{
-			CSVType *svType = variables.at(i);
-			CString varNameTmp = svType->variableName;
-			if (varNameTmp.getFirstToken(' ') == variable)
-			{
-				if (strnicmp(variable, "sv_", 3) == 0)
-				{
-					svType->loadConfig(ficIn);
-					break;
-				}
-				else
-				{
-					ficIn.ignore(512, '\n');
-					continue;
-				}
-			}
+			svType->loadConfig(ficIn);
 		}
 
 		// On flush le reste de la ligne
@@ -179,8 +139,7 @@ void CSystemVariable::saveConfig(char * filename)
 		ficOut << endl;
 		CSVType *svType = variables.at(i);
 
-		CString varNameTmp = svType->variableName;
-		ficOut <<varNameTmp.getFirstToken(' ').s << " ";
+		ficOut << svType->name.s << " ";
 		svType->saveConfig(ficOut);
 		ficOut << endl;
 	}
@@ -217,21 +176,73 @@ void CSystemVariable::saveConfig(char * filename)
 //
 void CSystemVariable::unregisterSystemVariable(const CString &screenName)
 {
+	CSVType *svType = find(screenName.s);
+	if (!svType) return;
+
+	std::string key = getKey(svType->name.s, svType->name.len());
+	names.erase(key);
 	for (int i=0;i<(int)variables.size();i++)
 	{
-		CSVType *svType = variables.at(i);
-		CString varCopy = svType->variableName;
-		if (varCopy.getFirstToken(' ') == screenName)
+		if (variables[i] == svType)
 		{
 			variables.erase(variables.begin() + i);
-			delete svType;
-			return;
+			break;
+		}
+	}
+	delete svType;
+
+	// Une autre du mme nom, enregistre aprs, prend sa place
+	for (int i=0;i<(int)variables.size();i++)
+	{
+		if (getKey(variables[i]->name.s, variables[i]->name.len()) == key)
+		{
+			names[key] = variables[i];
+			break;
 		}
 	}
 }
 
 
 
+//
+// Trouver une variable par son nom, on ignore les majuscules comme avant
+//
+CSVType * CSystemVariable::find(const char * varName)
+{
+	std::unordered_map<std::string, CSVType*>::iterator it = names.find(getKey(varName, (int)strlen(varName)));
+	return (it != names.end()) ? it->second : 0;
+}
+
+
+
+//
+// La cl d'un nom
+//
+std::string CSystemVariable::getKey(const char * varName, int len)
+{
+	std::string key(varName, len);
+	for (int i=0;i<len;++i)
+	{
+		if (key[i] >= 'A' && key[i] <= 'Z') key[i] += 32;
+	}
+	return key;
+}
+
+
+
+//
+// Ajouter une variable, la premire enregistre sous un nom le garde
+//
+void CSystemVariable::add(CSVType * newType)
+{
+	CString varCopy = newType->variableName;
+	newType->name = varCopy.getFirstToken(' ');
+	variables.push_back(newType);
+	names.insert(std::make_pair(getKey(newType->name.s, newType->name.len()), newType));
+}
+
+
+
 //
 // Pour grer les commandes pour modifier les variables
 //
@@ -243,19 +254,15 @@ CMD_RET CSystemVariable::command(CString & commandName, CString & params)
 		CString varName = params.getFirstToken(' ');
 		varName.trim('\"'); // Au cas o, y en a des pais tse
 
-		// On loop les variables pour savoir si elle existe et on lui transfer ses params
-		for (int i=0;i<(int)variables.size();i++)
+		// On regarde si elle existe et on lui transfer ses params
+		CSVType *svType = find(varName.s);
+		if (svType)
 		{
-			CSVType *svType = variables.at(i);
-			CString varCopy = svType->variableName;
-			if (varCopy.getFirstToken(' ') == varName)
+			if (svType->setValue(params)) return CR_OK;
+			else
 			{
-				if (svType->setValue(params)) return CR_OK;
-				else
-				{
-					// Oups, un ti message d'erreur. Mauvais nombre de param probablement
-					return CR_INVALIDARGS;
-				}
+				// Oups, un ti message d'erreur. Mauvais nombre de param probablement
+				return CR_INVALIDARGS;
 			}
 		}
 
@@ -275,55 +282,55 @@ CMD_RET CSystemVariable::command(CString & commandName, CString & params)
 void CSystemVariable::registerSystemVariable(const CString &screenName, bool *defaultValue, bool mConfigBypass)
 {
 	CSVType *newType = new CSVBool(screenName, defaultValue, mConfigBypass);
-	variables.push_back(newType);
+	add(newType);
 }
 
 void CSystemVariable::registerSystemVariable(const CString &screenName, int *defaultValue, int minValue,
 											 int maxValue, int flags, bool mConfigBypass)
 {
 	CSVType *newType = new CSVInt(screenName, defaultValue, minValue, maxValue, flags, mConfigBypass);
-	variables.push_back(newType);
+	add(newType);
 }
 
 void CSystemVariable::registerSystemVariable(const CString &screenName, float *defaultValue, float minValue,
 											 float maxValue, int flags, bool mConfigBypass)
 {
 	CSVType *newType = new CSVFloat(screenName, defaultValue, minValue, maxValue, flags, mConfigBypass);
-	variables.push_back(newType);
+	add(newType);
 }
 
 void CSystemVariable::registerSystemVariable(const CString &screenName, CVector2i *defaultValue, bool mConfigBypass)
 {
 	CSVType *newType = new CSVVector2i(screenName, defaultValue, mConfigBypass);
-	variables.push_back(newType);
+	add(newType);
 }
 
 void CSystemVariable::registerSystemVariable(const CString &screenName, CVector2f *defaultValue, bool mConfigBypass)
 {
 	CSVType *newType = new CSVVector2f(screenName, defaultValue, mConfigBypass);
-	variables.push_back(newType);
+	add(newType);
 }
 
 void CSystemVariable::registerSystemVariable(const CString &screenName, CVector3i *defaultValue, bool mConfigBypass)
 {
 	CSVType *newType = new CSVVector3i(screenName, defaultValue, mConfigBypass);
-	variables.push_back(newType);
+	add(newType);
 }
 
 void CSystemVariable::registerSystemVariable(const CString &screenName, CVector3f *defaultValue, bool mConfigBypass)
 {
 	CSVType *newType = new CSVVector3f(screenName, defaultValue, mConfigBypass);
-	variables.push_back(newType);
+	add(newType);
 }
 
 void CSystemVariable::registerSystemVariable(const CString &screenName, CVector4f *defaultValue, bool mConfigBypass)
 {
 	CSVType *newType = new CSVVector4f(screenName, defaultValue, mConfigBypass);
-	variables.push_back(newType);
+	add(newType);
 }
 
 void CSystemVariable::registerSystemVariable(const CString &screenName, CString *defaultValue, bool mConfigBypass)
 {
 	CSVType *newType = new CSVString(screenName, defaultValue, mConfigBypass);
-	variables.push_back(newType);
+	add(newType);
 }
@@ -43,6 +43,8 @@
 
 
 #include <vector>
+#include <string>
+#include <unordered_map>
 #include "CVector.h"
 #include "CString.h"
 #include <fstream>
@@ -59,6 +61,9 @@ public:
 	// Son nom  tre affich
 	CString variableName;
 
+	// Juste le nom, sans la description (le premier token de variableName)
+	CString name;
+
 	// Est-ce que cette variable peut tre bypass par le fichier config
 	bool configBypass;
 
@@ -410,6 +415,7 @@ public:
 	{
 		value = svString.value;
 		variableName = svString.variableName;
+		name = svString.name;
 		configBypass = svString.configBypass;
 	}
 	CString *value;
@@ -439,9 +445,12 @@ public:
 class CSystemVariable
 {
 public:
-	// La listes des variables enregistr
+	// La listes des variables enregistr, dans l'ordre
 	std::vector<CSVType*> variables;
 
+	// Les mmes, par nom en minuscule
+	std::unordered_map<std::string, CSVType*> names;
+
 public:
 	// Constructeur / Destructeur
 	CSystemVariable(); virtual ~CSystemVariable();
@@ -465,10 +474,25 @@ public:
 	// Pour effacer une variable du stack
 	void unregisterSystemVariable(const CString &screenName);
 
+	// Trouver une variable par son nom, 0 si elle n'existe pas
+	CSVType * find(const char * varName);
+
 	// pour loader un fichier config contenant la prdfinition des variables
 	void loadConfig(char * filename);
 	void loadConfigSVOnly(char * filename);
 
+private:
+	// Ajouter une variable dans la liste et l'index
+	void add(CSVType * newType);
+
+	// La cl d'un nom dans l'index
+	static std::string getKey(const char * varName, int len);
+
+	// Le load des fichiers config, une ligne  la fois
+	void loadConfig(char * filename, bool svOnly);
+
+public:
+
 	// Pour saver un fichier config contenant la prdfinition des variables
 	void saveConfig(char * filename);
 
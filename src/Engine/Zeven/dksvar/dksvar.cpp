@@ -47,8 +47,38 @@ CMD_RET			dksvarCommand(char * str_command)
 
 
 
+//
+// Trouver une variable une fois, pour ne plus la chercher par son nom
+//
+dksvarHandle	dksvarFind(const char * varName)
+{
+	return systemVariable.find(varName);
+}
+
+
+
+void			dksvarGetFormatedVar(dksvarHandle var, CString * formatedString)
+{
+	if (!var) return;
+
+	// On pogne son nom avec la valeur apres
+	CString formatedName = var->name + " " + var->getValue();
+	systemVariable.stringInterface->updateString(formatedString, formatedName.s);
+}
+
+
+
 void			dksvarGetFormatedVar(char * varName, CString * formatedString)
 {
+	// Le nom exact d'abord, sinon la premiere qui commence par varName comme avant
+	CSVType * found = systemVariable.find(varName);
+	if (found)
+	{
+		CString formatedName = CString(varName) + " " + found->getValue();
+		systemVariable.stringInterface->updateString(formatedString, formatedName.s);
+		return;
+	}
+
 	for (int i=0;i<(int)systemVariable.variables.size();++i)
 	{
 		CSVType * var = systemVariable.variables[i];
@@ -50,6 +50,12 @@ public:
         }
 };
 
+/// Identifiant d'une variable enregistre, valide jusqu' son dsenregistrement
+class CSVType;
+typedef CSVType * dksvarHandle;
+
+
+
 // Les fonction du DKSVAR
 
 
@@ -113,4 +119,22 @@ void			dksvarGetFormatedVar(char * varName, CString * formatedString);
 
 
 
+/// \brief trouve une variable enregistre par son nom
+///
+/// Cette fonction retourne un identifiant qui reste valide jusqu'au dsenregistrement de la variable. On peut donc chercher une variable une seule fois et la rutiliser sans refaire la recherche par nom.
+///
+/// \param varName nom de la variable (les majuscules sont ignores)
+/// \return identifiant de la variable, 0 si aucune variable ne porte ce nom
+dksvarHandle	dksvarFind(const char * varName);
+
+
+
+/// \brief obtient le nom d'une variable suivi de sa valeur, comme la commande set l'attend
+///
+/// \param var identifiant obtenu par dksvarFind
+/// \param formatedString reoit "nomDeLaVariable valeur"
+void			dksvarGetFormatedVar(dksvarHandle var, CString * formatedString);
+
+
+
 #endif
@@ -55,6 +55,9 @@ public:
 
 
 
+// Une variable enregistree, valide jusqu'a son dksvarUnregister
+class CSVType;
+typedef CSVType * dksvarHandle;
 
 // Les fonction du DKSVAR
 DLL_API(CMD_RET)		dksvarCommand(char * command);
@@ -76,6 +79,8 @@ DLL_API(void)			dksvarUnregister(const CString &screenName);
 DLL_API(void)			dksvarInit(CStringInterface * stringInterface);
 DLL_API(void)			dksvarGetFilteredVar(char * varName, char ** array, int size);
 DLL_API(void)			dksvarGetFormatedVar(char * varName, CString * formatedString);
+DLL_API(dksvarHandle)	dksvarFind(const char * varName);
+DLL_API(void)			dksvarGetFormatedVar(dksvarHandle var, CString * formatedString);
 
 
 
@@ -23,8 +23,10 @@
 #include "dkti.h"
 #include <math.h>
 #include <sys/stat.h>
+#include <algorithm>
 
 #include <CVector.h>
+#include <CBinaryReader.h>
 
 
 
@@ -33,8 +35,15 @@
 // Les trucs static
 //
 char *CDkt::lastErrorString = 0;
-std::vector<CTexture*> CDkt::textures;
-int CDkt::checkingUpdate = 0;
+std::unordered_map<unsigned int, CTexture*> CDkt::textures;
+std::unordered_map<std::string, CTexture*> CDkt::filenames;
+std::mutex CDkt::jobMutex;
+std::condition_variable CDkt::jobWakeUp;
+std::condition_variable CDkt::jobDone;
+std::deque<CTextureJob*> CDkt::toRead;
+std::deque<CTextureJob*> CDkt::toUpload;
+bool CDkt::quitting = false;
+std::vector<std::thread*> CDkt::workers;
 
 
 
@@ -44,59 +53,54 @@ int CDkt::checkingUpdate = 0;
 void			 dktBlurTexture(unsigned int textureID, int nbPass)
 {
 #ifndef _DX_
-	// On passe toute nos textures en loop
-	for (int k=0;k<(int)CDkt::textures.size();k++)
+	CTexture *texture = CDkt::findLoaded(textureID);
+	if (texture)
 	{
-		CTexture *texture = CDkt::textures.at(k);
-
-		if (texture->oglID == textureID)
-		{
-			unsigned char * imageData = new unsigned char [texture->size[0] * texture->size[1] * texture->bpp];
-			glBindTexture(GL_TEXTURE_2D, textureID);
-			glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, imageData);
+		unsigned char * imageData = new unsigned char [texture->size[0] * texture->size[1] * texture->bpp];
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, imageData);
 
-			int fw = texture->size[0]*texture->bpp;
-			int fh = texture->size[1];
-			//int px = 0;
-			//int py = 0;
+		int fw = texture->size[0]*texture->bpp;
+		int fh = texture->size[1];
+		//int px = 0;
+		//int py = 0;
 
-			int filter = 4;
+		int filter = 4;
 
-			// On va blurer la texture
-			for (int p=0;p<nbPass;p++)
+		// On va blurer la texture
+		for (int p=0;p<nbPass;p++)
+		{
+			for (int j=1;j<fh+1;j++)
 			{
-				for (int j=1;j<fh+1;j++)
+				for (int i=1;i<fw+1;i++)
 				{
-					for (int i=1;i<fw+1;i++)
-					{
-						imageData[((j)%fh)*fw + ((i)%fw)] = 
-							char((
-							imageData[((j  )%fh)*fw + ((i  )%fw)]*filter + 
-							imageData[((j  )%fh)*fw + ((i+1)%fw)] +
-							imageData[((j+1)%fh)*fw + ((i+1)%fw)] +
-							imageData[((j+1)%fh)*fw + ((i  )%fw)] +
-							imageData[((j  )%fh)*fw + ((i-1)%fw)] +
-							imageData[((j-1)%fh)*fw + ((i-1)%fw)] +
-							imageData[((j-1)%fh)*fw + ((i  )%fw)] +
-							imageData[((j-1)%fh)*fw + ((i+1)%fw)] +
-							imageData[((j+1)%fh)*fw + ((i-1)%fw)])/(8+filter));
-					}
+					imageData[((j)%fh)*fw + ((i)%fw)] = 
+						char((
+						imageData[((j  )%fh)*fw + ((i  )%fw)]*filter + 
+						imageData[((j  )%fh)*fw + ((i+1)%fw)] +
+						imageData[((j+1)%fh)*fw + ((i+1)%fw)] +
+						imageData[((j+1)%fh)*fw + ((i  )%fw)] +
+						imageData[((j  )%fh)*fw + ((i-1)%fw)] +
+						imageData[((j-1)%fh)*fw + ((i-1)%fw)] +
+						imageData[((j-1)%fh)*fw + ((i  )%fw)] +
+						imageData[((j-1)%fh)*fw + ((i+1)%fw)] +
+						imageData[((j+1)%fh)*fw + ((i-1)%fw)])/(8+filter));
 				}
 			}
+		}
 
-			// On construit les mipmaps
-			GLint level;
-			if (texture->bpp == 1) level = GL_LUMINANCE;
-			if (texture->bpp == 3) level = GL_RGB;
-			if (texture->bpp == 4) level = GL_RGBA;
-			//gluBuild2DMipmaps(GL_TEXTURE_2D, texture->bpp, texture->size[0], texture->size[1],
-			//				  GL_RGB, GL_UNSIGNED_BYTE, imageData);
+		// On construit les mipmaps
+		GLint level;
+		if (texture->bpp == 1) level = GL_LUMINANCE;
+		if (texture->bpp == 3) level = GL_RGB;
+		if (texture->bpp == 4) level = GL_RGBA;
+		//gluBuild2DMipmaps(GL_TEXTURE_2D, texture->bpp, texture->size[0], texture->size[1],
+		//				  GL_RGB, GL_UNSIGNED_BYTE, imageData);
             glTexImage2D(GL_TEXTURE_2D, 0, level, texture->size[0], texture->size[1], 0, level, GL_UNSIGNED_BYTE, imageData);
             glGenerateMipmapEXT(GL_TEXTURE_2D);
 
-			// On efface le data temporaire
-			delete [] imageData;
-		}
+		// On efface le data temporaire
+		delete [] imageData;
 	}
 #endif
 }
@@ -110,9 +114,9 @@ void			 dktChangeFilter(int filter)
 {
 #ifndef _DX_
 	// On passe toute nos textures en loop
-	for (int i=0;i<(int)CDkt::textures.size();i++)
+	for (std::unordered_map<unsigned int, CTexture*>::iterator it = CDkt::textures.begin(); it != CDkt::textures.end(); ++it)
 	{
-		CTexture *texture = CDkt::textures.at(i);
+		CTexture *texture = it->second;
 
 		if (texture)
 		{
@@ -160,73 +164,63 @@ void			 dktChangeFilter(int filter)
 
 
 //
-// Pour simplement reloader un TGA
+// Lire l'entte d'un TGA, retourne les pixels tels qu'ils sont dans le fichier
 //
-void reloadTGA(CTexture * texture)
-{
 #ifndef _DX_
-	// Les variables utilis pour tenir l'information load du Targa
-	unsigned char TGAcompare[12];
-	unsigned char header[6];
-	unsigned int bytesPerPixel;
-	unsigned int imageSize;
-	unsigned char temp;
-	unsigned char *imageData;
-	unsigned int bpp;
-	unsigned int width;
-	unsigned int height;
-
-	// On ouvre le fichier targa
-	FILE *file = fopen(texture->filename.s, "rb");
-
-	// Si a marche pas, oups, on returne 0 comme texture.
-	if (file == NULL) 
-	{
-		// on cris l'erreur dans le log
-		CDkt::updateLastError(CString("ERROR > Can not read file : \"%s\"", texture->filename.s).s);
-		return;
-	}
-
-	// On li le header du fichier (12 premiers byte)
-	fread(TGAcompare,1,sizeof(TGAcompare),file);
+static const unsigned char * readTGA(CBinaryReader & file, unsigned int & width, unsigned int & height,
+									 unsigned int & bytesPerPixel, GLint & Level, GLenum & format)
+{
+	if (!file.isValid()) return 0;
 
-	// On li la suite du header
-	fread(header,1,sizeof(header),file);
+	// Les 12 premiers byte puis la suite du header
+	file.skip(12);
+	const unsigned char *header = file.getSpan(6);
+	if (!header) return 0;
 
 	// On prend le width et le height du header
 	width  = header[1] * 256 + header[0];
 	height = header[3] * 256 + header[2];
-	texture->size.set(width, height);
-
-	// On prend le bbp (24bit ou 32bit)
-	bpp	= header[4];
 
 	// On le divise par 8 pour avoir 3 ou 4 bytes (RGB ou RGBA)
-	bytesPerPixel	= bpp/8;
-	texture->bpp = bytesPerPixel;
+	bytesPerPixel = header[4]/8;
+	if (bytesPerPixel != 3 && bytesPerPixel != 4) return 0;
 
-	// On calcul la grandeur de l'image en byte
-	imageSize		= width * height * bytesPerPixel;
+	// On dfini si c'est RGB ou RGBA. Le fichier est en BGR, GL fait le swap lui-mme
+	Level = (bytesPerPixel == 3) ? GL_RGB : GL_RGBA;
+	format = (bytesPerPixel == 3) ? GL_BGR_EXT : GL_BGRA_EXT;
 
-	// On alou alors autant de bytes qu'il faut pour tenir l'image
-	imageData = new unsigned char [imageSize];
+	// Le gros bloc de donnes, directement dans le fichier
+	return file.getSpan(width * height * bytesPerPixel);
+}
+#endif
 
-	// On li maintenant le gros bloc de donnes
-	fread(imageData, 1, imageSize, file);
 
-	// On dfini si c'est RGB ou RGBA
-	GLint Level = (bytesPerPixel == 3) ? GL_RGB : GL_RGBA;
 
-	// Ici c'est con, mais faut switcher le rouge avec le bleu
-	for(unsigned int i=0; i<imageSize; i+=bytesPerPixel){
+//
+// Pour simplement reloader un TGA
+//
+void reloadTGA(CTexture * texture)
+{
+#ifndef _DX_
+	unsigned int width;
+	unsigned int height;
+	unsigned int bytesPerPixel;
+	GLint Level;
+	GLenum format;
 
-		temp=imageData[i];
-		imageData[i] = imageData[i + 2];
-		imageData[i + 2] = temp;
-	}
+	// On map le fichier targa, les pixels sont lus sur place
+	CBinaryReader file(texture->filename.s);
+	const unsigned char *imageData = readTGA(file, width, height, bytesPerPixel, Level, format);
 
-	// On ferme maintenant le fichier
-	fclose (file);
+	// Si a marche pas, oups, on garde l'ancienne.
+	if (!imageData)
+	{
+		// on cris l'erreur dans le log
+		CDkt::updateLastError(CString("ERROR > Can not read file : \"%s\"", texture->filename.s).s);
+		return;
+	}
+	texture->size.set(width, height);
+	texture->bpp = bytesPerPixel;
 
 	// On bind cette texture au context
 	glBindTexture(GL_TEXTURE_2D, texture->oglID);
@@ -234,98 +228,72 @@ void reloadTGA(CTexture * texture)
 	// On construit les mipmaps
 	//gluBuild2DMipmaps(GL_TEXTURE_2D, bytesPerPixel, width, height,
 	//				  Level, GL_UNSIGNED_BYTE, imageData);
-    glTexImage2D(GL_TEXTURE_2D, 0, Level, width, height, 0, Level, GL_UNSIGNED_BYTE, imageData);
+    glTexImage2D(GL_TEXTURE_2D, 0, Level, width, height, 0, format, GL_UNSIGNED_BYTE, imageData);
     glGenerateMipmapEXT(GL_TEXTURE_2D);
+#endif
+}
+
 
-	// On delete notre Data qu'on n'a pus besoin
-	delete [] imageData;
+
+//
+// Mapper et lire le fichier. Tourne sur un worker, donc pas d'opengl ici
+//
+void CTextureJob::read()
+{
+#ifndef _DX_
+	file.open(filename.s);
+	imageData = readTGA(file, width, height, bytesPerPixel, Level, format);
+	if (!imageData) return;
+
+	// On touche chaque page pour que le disque soit lu ici, pas pendant le glTexImage2D
+	unsigned int size = width * height * bytesPerPixel;
+	volatile unsigned char touch = 0;
+	for (unsigned int i=0;i<size;i+=4096) touch += imageData[i];
+	if (size) touch += imageData[size-1];
 #endif
 }
 
 
 
 //
-// Loader un TGA
+// Loader un TGA, tout de suite ou par les workers
 //
-unsigned int createTextureTGA(char * filename, int filter){
+unsigned int createTextureTGA(char * filename, int filter, bool async){
 
 #ifndef _DX_
 	// Notre texture ID de ogl
 	unsigned int Texture = 0;
 
 		// On check quelle n'existe pas dj
-		for (int l=0;l<(int)CDkt::textures.size();l++)
+		std::string key = CDkt::getKey(filename);
+		std::unordered_map<std::string, CTexture*>::iterator found = CDkt::filenames.find(key);
+		if (found != CDkt::filenames.end())
 		{
-			CTexture *texture = CDkt::textures.at(l);
-			if (texture->filename == filename)
-			{
-				texture->nbInstance++;
-				return texture->oglID;
-			}
+			CTexture *texture = found->second;
+			texture->nbInstance++;
+			if (!async && texture->job) CDkt::finish(texture);
+			return texture->oglID;
 		}
 
-		// Les variables utilis pour tenir l'information load du Targa
-		unsigned char TGAcompare[12];
-		unsigned char header[6];
-		unsigned int bytesPerPixel;
-		unsigned int imageSize;
-		unsigned char temp;
-		unsigned char *imageData;
-		unsigned int bpp;
-		unsigned int width;
-		unsigned int height;
-
-		// On ouvre le fichier targa
-		FILE *file = fopen(filename, "rb");
-
-		// Si a marche pas, oups, on returne 0 comme texture.
-		if (file == NULL) 
+		// On se cr notre nouvelle texture
+		CTexture *texture = new CTexture;
+		CTextureJob *job = new CTextureJob(texture, filename);
+
+		struct stat attrib;
+		bool exists = (stat(filename, &attrib) == 0);
+
+		// En async on sait juste qu'il existe, les workers le liront
+		if (!async) job->read();
+		if (!exists || (!async && !job->imageData))
 		{
 			// on cris l'erreur dans le log
             printf("Cannot open texutre file: %s\n", filename);
 			CDkt::updateLastError(CString("ERROR > Can not read file : \"%s\"", filename).s);
+			delete job;
+			delete texture;
 			return 0;
 		}
 
-		// On li le header du fichier (12 premiers byte)
-		fread(TGAcompare,1,sizeof(TGAcompare),file);
-
-		// On li la suite du header
-		fread(header,1,sizeof(header),file);
-
-		// On prend le width et le height du header
-		width  = header[1] * 256 + header[0];
-		height = header[3] * 256 + header[2];
-
-		// On prend le bbp (24bit ou 32bit)
-		bpp	= header[4];
-
-		// On le divise par 8 pour avoir 3 ou 4 bytes (RGB ou RGBA)
-		bytesPerPixel	= bpp/8;
-
-		// On calcul la grandeur de l'image en byte
-		imageSize		= width * height * bytesPerPixel;
-
-		// On alou alors autant de bytes qu'il faut pour tenir l'image
-		imageData = new unsigned char [imageSize];
-
-		// On li maintenant le gros bloc de donnes
-		fread(imageData, 1, imageSize, file);
-
-		// On dfini si c'est RGB ou RGBA
-		GLint Level = (bytesPerPixel == 3) ? GL_RGB : GL_RGBA;
-
-		// Ici c'est con, mais faut switcher le rouge avec le bleu
-		for(unsigned int i=0; i<imageSize; i+=bytesPerPixel){
-
-			temp=imageData[i];
-			imageData[i] = imageData[i + 2];
-			imageData[i + 2] = temp;
-		}
-
-		// On ferme maintenant le fichier
-		fclose (file);
-
 		// On gnre une texture
 		glGenTextures(1, &Texture);
 
@@ -367,28 +335,28 @@ unsigned int createTextureTGA(char * filename, int filter){
 			}
 		}
 
-		// On construit les mipmaps
-		//gluBuild2DMipmaps(GL_TEXTURE_2D, bytesPerPixel, width, height,
-		//				  Level, GL_UNSIGNED_BYTE, imageData);
-        glTexImage2D(GL_TEXTURE_2D, 0, Level, width, height, 0, Level, GL_UNSIGNED_BYTE, imageData);
-        glGenerateMipmapEXT(GL_TEXTURE_2D);
-
-		// On delete notre Data qu'on n'a pus besoin
-		delete [] imageData;
-
-		// On se cr notre nouvelle texture
-		CTexture *texture = new CTexture;
 		texture->filename = filename;
 		texture->nbInstance = 1;
-		texture->size.set(width, height);
-		texture->bpp = bytesPerPixel;
 		texture->oglID = Texture;
-
-		struct stat attrib;
-		stat(filename, &attrib);
 		texture->modifDate = INT4(attrib.st_mtime);
 
-		CDkt::textures.push_back(texture);
+		CDkt::textures[Texture] = texture;
+		CDkt::filenames[key] = texture;
+
+		if (async)
+		{
+			// Un pixel blanc en attendant, la texture est utilisable tout de suite
+			const unsigned char white[4] = {255, 255, 255, 255};
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+			texture->size.set(1, 1);
+			texture->bpp = 4;
+			texture->job = job;
+			CDkt::startJob(job);
+		}
+		else
+		{
+			CDkt::upload(job);
+		}
 
 	// On retourne l'index de la texture
 	return Texture;
@@ -399,6 +367,150 @@ unsigned int createTextureTGA(char * filename, int filter){
 
 
 
+//
+// Trouver une texture par son ID opengl
+//
+CTexture *CDkt::find(unsigned int textureID)
+{
+	std::unordered_map<unsigned int, CTexture*>::iterator it = textures.find(textureID);
+	return (it != textures.end()) ? it->second : 0;
+}
+
+
+
+//
+// Trouver une texture et attendre qu'elle soit loade si elle est async
+//
+CTexture *CDkt::findLoaded(unsigned int textureID)
+{
+	CTexture *texture = find(textureID);
+	if (texture && texture->job) finish(texture);
+	return texture;
+}
+
+
+
+//
+// La cl d'un fichier, on ignore les majuscules comme avant
+//
+std::string CDkt::getKey(const char *filename)
+{
+	std::string key(filename);
+	for (size_t i=0;i<key.size();++i)
+	{
+		if (key[i] >= 'A' && key[i] <= 'Z') key[i] += 32;
+	}
+	return key;
+}
+
+
+
+//
+// Donner un TGA aux workers
+//
+void CDkt::startJob(CTextureJob *job)
+{
+	std::unique_lock<std::mutex> lock(jobMutex);
+
+	// On les part au premier besoin, un core reste au main thread
+	if (workers.empty())
+	{
+		int nbWorker = (int)std::thread::hardware_concurrency() - 1;
+		if (nbWorker > DKT_MAX_WORKER) nbWorker = DKT_MAX_WORKER;
+		if (nbWorker < 1) nbWorker = 1;
+		for (int i=0;i<nbWorker;++i) workers.push_back(new std::thread(worker));
+	}
+
+	toRead.push_back(job);
+	jobWakeUp.notify_one();
+}
+
+
+
+//
+// La boucle d'un worker, il lit les TGA un par un
+//
+void CDkt::worker()
+{
+	std::unique_lock<std::mutex> lock(jobMutex);
+	while (true)
+	{
+		jobWakeUp.wait(lock, []{ return quitting || !toRead.empty(); });
+		if (quitting) return;
+
+		CTextureJob *job = toRead.front();
+		toRead.pop_front();
+
+		lock.unlock();
+		job->read();
+		lock.lock();
+
+		toUpload.push_back(job);
+		jobDone.notify_all();
+	}
+}
+
+
+
+//
+// On a besoin de cette texture maintenant
+//
+void CDkt::finish(CTexture *texture)
+{
+	CTextureJob *job = texture->job;
+	{
+		std::unique_lock<std::mutex> lock(jobMutex);
+		std::deque<CTextureJob*>::iterator it = std::find(toRead.begin(), toRead.end(), job);
+		if (it != toRead.end())
+		{
+			// Aucun worker ne l'a pris, on le lit nous-mme
+			toRead.erase(it);
+			lock.unlock();
+			job->read();
+		}
+		else
+		{
+			jobDone.wait(lock, [job]{ return std::find(toUpload.begin(), toUpload.end(), job) != toUpload.end(); });
+			toUpload.erase(std::find(toUpload.begin(), toUpload.end(), job));
+		}
+	}
+	upload(job);
+}
+
+
+
+//
+// Envoyer les pixels  opengl, sur le main thread
+//
+void CDkt::upload(CTextureJob *job)
+{
+#ifndef _DX_
+	CTexture *texture = job->texture;
+	if (texture)
+	{
+		texture->job = 0;
+		if (job->imageData)
+		{
+			texture->size.set(job->width, job->height);
+			texture->bpp = job->bytesPerPixel;
+
+			// On construit les mipmaps
+			glBindTexture(GL_TEXTURE_2D, texture->oglID);
+			glTexImage2D(GL_TEXTURE_2D, 0, job->Level, job->width, job->height, 0, job->format, GL_UNSIGNED_BYTE, job->imageData);
+			glGenerateMipmapEXT(GL_TEXTURE_2D);
+		}
+		else
+		{
+			// On garde le pixel blanc
+			CDkt::updateLastError(CString("ERROR > Can not read file : \"%s\"", job->filename.s).s);
+		}
+	}
+#endif
+	delete job;
+}
+
+
+
 //
 // Pour crer une texture vide
 //
@@ -411,7 +523,6 @@ unsigned int	 dktCreateEmptyTexture(int w, int h, int bpp, int filter)
 	CTexture *texture = new CTexture;
 	texture->filename = "Custom";
 	texture->nbInstance = 1;
-	CDkt::textures.push_back(texture);
 	texture->size.set(w,h);
 
 	// On cr notre array
@@ -422,6 +533,7 @@ unsigned int	 dktCreateEmptyTexture(int w, int h, int bpp, int filter)
 	// On cr une texture ogl et on la bind
 	glGenTextures(1, &textureID);
 	texture->oglID = textureID;
+	CDkt::textures[textureID] = texture;
 	glBindTexture(GL_TEXTURE_2D, textureID);
 
 	// On check le level
@@ -495,11 +607,11 @@ void			 dktCreateTextureFromBuffer(unsigned int *textureID, unsigned char *buffe
 	CTexture *texture = new CTexture;
 	texture->filename = "Custom";
 	texture->nbInstance = 1;
-	CDkt::textures.push_back(texture);
 
 	// On cr une texture ogl et on la bind
 	glGenTextures(1, textureID);
 	texture->oglID = *textureID;
+	CDkt::textures[*textureID] = texture;
 	glBindTexture(GL_TEXTURE_2D, *textureID);
 
 	// On set le filter
@@ -564,7 +676,7 @@ unsigned int	 dktCreateTextureFromFile(char *mFilename, int filter)
 	if (strnicmp(&(mFilename[strlen(mFilename)-3]), "TGA", 3) == 0)
 
 	{
-		return createTextureTGA(mFilename, filter);
+		return createTextureTGA(mFilename, filter, false);
 	}
 	else
 	{
@@ -577,6 +689,25 @@ unsigned int	 dktCreateTextureFromFile(char *mFilename, int filter)
 
 
 
+//
+// Pareil, mais le fichier est lu par les workers et envoy plus tard par dktUpdate
+//
+unsigned int	 dktCreateTextureFromFileAsync(char *mFilename, int filter)
+{
+	if (strnicmp(&(mFilename[strlen(mFilename)-3]), "TGA", 3) == 0)
+	{
+		return createTextureTGA(mFilename, filter, true);
+	}
+	else
+	{
+		// Doit obligatoirement tre un TGA
+		CDkt::updateLastError("DKT : The image is not a TGA");
+		return 0;
+	}
+}
+
+
+
 //
 // On update la dernire erreur
 //
@@ -602,18 +733,19 @@ void CDkt::updateLastError(char *error)
 void			 dktDeleteTexture(unsigned int *textureID)
 {
 #ifndef _DX_
-	for (int i=0;i<(int)CDkt::textures.size();i++)
+	CTexture *texture = CDkt::find(*textureID);
+	if (texture)
 	{
-		CTexture *texture = CDkt::textures.at(i);
-		if (texture->oglID == *textureID) 
+		texture->nbInstance--;
+		if (texture->nbInstance <= 0)
 		{
-			texture->nbInstance--;
-			if (texture->nbInstance <= 0)
-			{
-				CDkt::textures.erase(CDkt::textures.begin() + i);
-				delete texture;
-			}
-			break;
+			CDkt::textures.erase(texture->oglID);
+			std::unordered_map<std::string, CTexture*>::iterator it = CDkt::filenames.find(CDkt::getKey(texture->filename.s));
+			if (it != CDkt::filenames.end() && it->second == texture) CDkt::filenames.erase(it);
+
+			// Son TGA n'est pas encore arriv, dktUpdate effacera le job
+			if (texture->job) texture->job->texture = 0;
+			delete texture;
 		}
 	}
 
@@ -639,14 +771,8 @@ char*			 dktGetLastError()
 int				 dktGetTextureBytePerPixel(unsigned int textureID)
 {
 #ifndef _DX_
-	for (int i=0;i<(int)CDkt::textures.size();i++)
-	{
-		CTexture *texture = CDkt::textures.at(i);
-		if (texture->oglID == textureID) 
-		{
-			return texture->bpp;
-		}
-	}
+	CTexture *texture = CDkt::findLoaded(textureID);
+	if (texture) return texture->bpp;
 #endif
 	return 0; // La texture n'est pas trouv
 }
@@ -659,14 +785,11 @@ int				 dktGetTextureBytePerPixel(unsigned int textureID)
 void			 dktGetTextureData(unsigned int textureID, unsigned char * data)
 {
 #ifndef _DX_
-	for (int i=0;i<(int)CDkt::textures.size();i++)
+	CTexture *texture = CDkt::findLoaded(textureID);
+	if (texture)
 	{
-		CTexture *texture = CDkt::textures.at(i);
-		if (texture->oglID == textureID) 
-		{
-			glBindTexture(GL_TEXTURE_2D, textureID);
-			glGetTexImage(GL_TEXTURE_2D, 0, (texture->bpp==3)?GL_RGB:GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glGetTexImage(GL_TEXTURE_2D, 0, (texture->bpp==3)?GL_RGB:GL_RGBA, GL_UNSIGNED_BYTE, data);
 	}
 #endif
 	data = 0;
@@ -680,14 +803,8 @@ void			 dktGetTextureData(unsigned int textureID, unsigned char * data)
 CVector2i		 dktGetTextureSize(unsigned int textureID)
 {
 #ifndef _DX_
-	for (int i=0;i<(int)CDkt::textures.size();i++)
-	{
-		CTexture *texture = CDkt::textures.at(i);
-		if (texture->oglID == textureID) 
-		{
-			return texture->size;
-		}
-	}
+	CTexture *texture = CDkt::findLoaded(textureID);
+	if (texture) return texture->size;
 #endif
 	return CVector2i();
 }
@@ -723,40 +840,56 @@ void			 dktRenderToTexture(unsigned int textureID, int x, int y, int w, int h, u
 //
 void			 dktShutDown()
 {
-	for (int i=0;i<(int)CDkt::textures.size();i++)
+	// On arrte les workers, ceux qui lisent finissent leur TGA
+	{
+		std::unique_lock<std::mutex> lock(CDkt::jobMutex);
+		CDkt::quitting = true;
+	}
+	CDkt::jobWakeUp.notify_all();
+	for (int i=0;i<(int)CDkt::workers.size();i++)
 	{
-		CTexture *texture = CDkt::textures.at(i);
+		CDkt::workers[i]->join();
+		delete CDkt::workers[i];
+	}
+	CDkt::workers.clear();
+	CDkt::quitting = false;
+	for (int i=0;i<(int)CDkt::toRead.size();i++) delete CDkt::toRead[i];
+	for (int i=0;i<(int)CDkt::toUpload.size();i++) delete CDkt::toUpload[i];
+	CDkt::toRead.clear();
+	CDkt::toUpload.clear();
+
+	for (std::unordered_map<unsigned int, CTexture*>::iterator it = CDkt::textures.begin(); it != CDkt::textures.end(); ++it)
+	{
+		CTexture *texture = it->second;
 		if (texture) delete texture;
 	}
 	CDkt::textures.clear();
+	CDkt::filenames.clear();
 	CDkt::updateLastError(0);
 }
 
 
 
 //
-// Pour updater, a check si une texture a t modifi  l'extrieur du programme pis a la replace si cest le cas
+// Pour envoyer  opengl les TGA que les workers ont fini de lire, un budget de bytes par frame
 //
 void			 dktUpdate()
 {
-/*	if (CDkt::checkingUpdate >= (int)CDkt::textures.size()) CDkt::checkingUpdate = 0;
-
-	if (CDkt::textures.size() > 0)
+#ifndef _DX_
+	int budget = DKT_UPLOAD_BUDGET;
+	while (budget > 0)
 	{
-		CTexture *texture = CDkt::textures.at(CDkt::checkingUpdate);
-
-		struct stat attrib;
-		stat(texture->filename.s, &attrib);
-		INT4 tmpModifDate = INT4(attrib.st_mtime);
-
-		// a fonctionne juste avec les .tga notre affaire
-		if (texture->filename.checkExtension("tga"))
+		CTextureJob *job;
 		{
-			reloadTGA(texture);
+			std::unique_lock<std::mutex> lock(CDkt::jobMutex);
+			if (CDkt::toUpload.empty()) break;
+			job = CDkt::toUpload.front();
+			CDkt::toUpload.pop_front();
 		}
 
-		texture->modifDate = tmpModifDate;
+		// Au moins une par frame, mme si elle dpasse le budget
+		if (job->texture && job->imageData) budget -= job->width * job->height * job->bytesPerPixel;
+		CDkt::upload(job);
 	}
-
-	CDkt::checkingUpdate++;*/
+#endif
 }
@@ -166,6 +166,18 @@ unsigned int	 dktCreateTextureFromFile(char *filename, int filter);
 
 
 
+/// \brief cre une texture  partir d'un fichier targa (TGA) sans attendre sa lecture
+///
+/// Cette fonction retourne tout de suite l'identifiant d'une texture d'un pixel blanc. Le fichier est lu par des threads en arrire-plan et son contenu est envoy  la texture par dktUpdate.
+/// Les fonctions qui ont besoin du contenu (dktGetTextureSize, dktGetTextureData, ...) attendent la fin de la lecture. Retourne 0 seulement si le fichier n'existe pas.
+///
+/// \param filename chemin menant au fichier TGA  charger depuis l'endroit o se situe le fichier EXE du programme.
+/// \param filter drapeau de filtre de texturage  tre utiliser
+/// \return identifiant unique de la texture cre
+unsigned int	 dktCreateTextureFromFileAsync(char *filename, int filter);
+
+
+
 /// \brief libre la mmoire alloue pour une texture
 ///
 /// Cette fonction libre la mmoire alloue pour une texture charg prcdemment.
@@ -241,11 +253,10 @@ void			 dktShutDown();
 
 
 
-/// \brief met  jour toutes les textures prsentement charges en mmoire
+/// \brief envoie  opengl les textures async dont le fichier a t lu
 ///
-/// Cette fonction vrifie si des changements ont t apports aux textures prsentement charge en mmoire et fait la mise  jour de leur contenu si ncessaire.
-/// La vrification est faite pour une seule texture  la fois par appel. Chaque appel successif fera la vrification pour la texture suivante. Lorsqu'on atteint la dernire texture, on recommence  vrifier la premire texture.
-/// Ceci est particulirement utile lorsque le module est utilis par plus d'une application : on peut modifier la texture avec un diteur et voir immdiatement le rsultat dans le jeu par exemple.
+/// Cette fonction doit tre appele une fois par frame par le thread qui possde le contexte opengl.
+/// Elle envoie les textures prtes jusqu' DKT_UPLOAD_BUDGET bytes par appel (au moins une), pour qu'aucun frame ne bloque sur un gros chargement.
 ///
 void			 dktUpdate();
 
@@ -40,9 +40,64 @@
 // pour devil
 //#include <IL/il.h>
 
+#include <string>
+#include <deque>
 #include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "CString.h"
 #include "CVector.h"
+#include "CBinaryReader.h"
+
+
+// Combien de bytes de textures dktUpdate envoie au maximum par frame
+const int DKT_UPLOAD_BUDGET = 4 * 1024 * 1024;
+
+// Le nombre max de threads pour lire les textures
+const int DKT_MAX_WORKER = 4;
+
+
+class CTexture;
+
+
+
+// Un TGA a lire par les workers puis a envoyer a opengl par le main thread
+class CTextureJob
+{
+public:
+	// La texture qui l'attend, 0 si elle a ete effacee entre temps (main thread seulement)
+	CTexture *texture;
+
+	// Le fichier, mappe par le worker
+	CString filename;
+	CBinaryReader file;
+
+	// Les pixels dans le fichier, 0 si on n'a pas pu le lire
+	const unsigned char *imageData;
+	unsigned int width;
+	unsigned int height;
+	unsigned int bytesPerPixel;
+	GLint Level;
+	GLenum format;
+
+public:
+	CTextureJob(CTexture *mTexture, const char *mFilename)
+	{
+		texture = mTexture;
+		filename = mFilename;
+		imageData = 0;
+		width = 0;
+		height = 0;
+		bytesPerPixel = 0;
+		Level = 0;
+		format = 0;
+	}
+
+	// Mapper et lire le fichier, sans toucher a opengl
+	void read();
+};
 
 
 
@@ -68,6 +123,9 @@ public:
 	// Le nombre de Byte per pixel de la texture
 	int bpp;
 
+	// Son TGA pas encore envoy, 0 quand elle est prte
+	CTextureJob *job;
+
 public:
 	// Constructeur / Destructeur
 	CTexture()
@@ -75,6 +133,8 @@ public:
 		oglID = 0;
 		nbInstance = 0;
 		modifDate = 0;
+		bpp = 0;
+		job = 0;
 	}
 	
 	virtual ~CTexture()
@@ -94,15 +154,47 @@ public:
 	// Pour tenir la dernire erreur
 	static char *lastErrorString;
 
-	// Le vector de nos textures initialis
-	static std::vector<CTexture*> textures;
+	// Nos textures, par ID opengl
+	static std::unordered_map<unsigned int, CTexture*> textures;
+
+	// Celles qui viennent d'un fichier, par nom en minuscule
+	static std::unordered_map<std::string, CTexture*> filenames;
+
+	// Les TGA a lire et ceux prets a etre envoyes, proteges par jobMutex
+	static std::mutex jobMutex;
+	static std::condition_variable jobWakeUp;
+	static std::condition_variable jobDone;
+	static std::deque<CTextureJob*> toRead;
+	static std::deque<CTextureJob*> toUpload;
+	static bool quitting;
 
-	// La texture qu'on check pour le auto updating
-	static int checkingUpdate;
+	// Les threads qui lisent les TGA, partis au premier load async
+	static std::vector<std::thread*> workers;
 
 public:
 	// Pour updater l'erreur
 	static void updateLastError(char *error);
+
+	// Trouver une texture par son ID opengl, 0 si on l'a pas
+	static CTexture *find(unsigned int textureID);
+
+	// Pareil, mais on attend son TGA si elle est encore en train de loader
+	static CTexture *findLoaded(unsigned int textureID);
+
+	// La cle d'un fichier dans filenames
+	static std::string getKey(const char *filename);
+
+	// Donner un TGA aux workers
+	static void startJob(CTextureJob *job);
+
+	// Attendre le TGA d'une texture et l'envoyer tout de suite
+	static void finish(CTexture *texture);
+
+	// Envoyer un TGA lu a opengl, sur le main thread. Efface le job
+	static void upload(CTextureJob *job);
+
+	// La boucle d'un worker
+	static void worker();
 };
 
 
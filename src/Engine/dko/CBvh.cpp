@@ -0,0 +1,490 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "CBvh.h"
+#include "dkoInner.h"
+
+
+// The queries walk with the dko_query of the caller
+static_assert(DKO_QUERY_STACK_SIZE >= BVH_STACK_SIZE, "dko_query stack too small for the BVH");
+static_assert(BVH_MAX_DEPTH + 2 <= BVH_STACK_SIZE, "BVH deeper than its query stack");
+
+
+
+//
+// La distance d'un point au plan du triangle
+//
+static inline float planeDistance(const bvh_triangle & t, const CVector & p)
+{
+	return t.a*p[0] + t.b*p[1] + t.c*p[2] - t.d;
+}
+
+
+
+//
+// Le point ou le segment traverse le plan, de l'avant vers l'arriere seulement
+//
+static inline bool planeIntersect(const bvh_triangle & t, const CVector & p1, const CVector & p2, CVector & intersect)
+{
+	float dis1 = planeDistance(t, p1);
+	float dis2 = planeDistance(t, p2);
+
+	if (dis1 > 0 && dis2 < -0)
+	{
+		float percent = fabsf(dis1) / (fabsf(dis1) + fabsf(dis2));
+		intersect = p1 + (p2-p1) * percent;
+		return true;
+	}
+
+	return false;
+}
+
+
+
+//
+// Savoir si le point du plan est dans le polygone (convexe, dans le plan du triangle)
+//
+static inline bool pointInPolygon(const bvh_triangle & t, const CVector & m, const CVector * polygon, int nbPoint)
+{
+	for (int i=0;i<nbPoint;++i)
+	{
+		// On fait le produit croise avec chaque cote
+		CVector u = polygon[i] - m;
+		CVector v = polygon[(i+1)%nbPoint] - m;
+		CVector norm = cross(u,v);
+
+		// Si on est derriere, le point n'est pas dans le polygone
+		if (planeDistance(t, m+norm) < 0) return false;
+	}
+
+	return true;
+}
+
+
+
+//
+// Les coins du triangle
+//
+static inline void trianglePoints(const bvh_triangle & t, CVector * points)
+{
+	for (int i=0;i<3;++i) points[i] = CVector(t.point[i][0], t.point[i][1], t.point[i][2]);
+}
+
+
+
+//
+// The triangle pushed out by the radius, 3 points per corner (edge before, corner, edge after)
+//
+static inline void sphereCollisionPoints(const bvh_triangle & t, float radius, CVector * points)
+{
+	static const int cornerOf[9] = {0, 1, 1, 1, 2, 2, 2, 0, 0};
+	for (int k=0;k<9;++k)
+	{
+		const float * point = t.point[cornerOf[k]];
+		const float * normal = (k%3 == 2) ? t.cornerNormal[(k/3+1)%3] : t.edgeNormal[k/3];
+		points[k] = CVector(
+			point[0] + normal[0] * radius,
+			point[1] + normal[1] * radius,
+			point[2] + normal[2] * radius);
+	}
+}
+
+
+
+//
+// Constructeur / Destructeur
+//
+CBvh::CBvh(CFace *faceArray, int nbFace)
+{
+	int i, j;
+	nbNode = 0;
+	nbTriangle = nbFace;
+	triangles = new bvh_triangle[(nbFace) ? nbFace : 1];
+
+	// A binary tree with at least a triangle per leaf
+	nodes = new bvh_node[(nbFace) ? nbFace * 2 : 1];
+
+	// On sort les faces par leur centre
+	int *indices = new int[(nbFace) ? nbFace : 1];
+	float *centroids = new float[(nbFace) ? nbFace * 3 : 1];
+	for (i=0;i<nbFace;++i)
+	{
+		indices[i] = i;
+		for (j=0;j<3;++j)
+		{
+			centroids[i*3+j] = (faceArray[i].point[0][j] + faceArray[i].point[1][j] + faceArray[i].point[2][j]) / 3.0f;
+		}
+	}
+
+	if (nbFace) build(faceArray, indices, centroids, 0, nbFace, 0);
+
+	delete [] indices;
+	delete [] centroids;
+}
+
+CBvh::~CBvh()
+{
+	if (nodes) delete [] nodes;
+	if (triangles) delete [] triangles;
+}
+
+
+
+//
+// Build a node, then its children
+//
+int CBvh::build(CFace *faceArray, int *indices, float *centroids, int first, int count, int depth)
+{
+	int i, j, k;
+	int index = nbNode++;
+	bvh_node & node = nodes[index];
+
+	// Sa boite, autour de toute ses faces
+	float cmin[3], cmax[3];
+	for (j=0;j<3;++j)
+	{
+		node.min[j] = node.max[j] = faceArray[indices[first]].point[0][j];
+		cmin[j] = cmax[j] = centroids[indices[first]*3+j];
+	}
+	for (i=first;i<first+count;++i)
+	{
+		CFace & face = faceArray[indices[i]];
+		for (j=0;j<3;++j)
+		{
+			for (k=0;k<3;++k)
+			{
+				if (face.point[k][j] < node.min[j]) node.min[j] = face.point[k][j];
+				if (face.point[k][j] > node.max[j]) node.max[j] = face.point[k][j];
+			}
+			if (centroids[indices[i]*3+j] < cmin[j]) cmin[j] = centroids[indices[i]*3+j];
+			if (centroids[indices[i]*3+j] > cmax[j]) cmax[j] = centroids[indices[i]*3+j];
+		}
+	}
+
+	// Une feuille, on copie ses triangles. Too deep and we keep them all here
+	if (count <= BVH_MAX_PER_LEAF || depth >= BVH_MAX_DEPTH)
+	{
+		node.offset = first;
+		node.count = count;
+		for (i=first;i<first+count;++i)
+		{
+			CFace & face = faceArray[indices[i]];
+			bvh_triangle & t = triangles[i];
+			for (k=0;k<3;++k)
+			{
+				for (j=0;j<3;++j)
+				{
+					t.point[k][j] = face.point[k][j];
+					t.edgeNormal[k][j] = face.normals[k*3][j];
+					t.cornerNormal[k][j] = face.normals[(k*3+8)%9][j];
+				}
+			}
+			t.a = face.a;
+			t.b = face.b;
+			t.c = face.c;
+			t.d = face.d;
+		}
+		return index;
+	}
+
+	// On coupe au milieu de son plus grand axe
+	int axis = 0;
+	if (cmax[1] - cmin[1] > cmax[axis] - cmin[axis]) axis = 1;
+	if (cmax[2] - cmin[2] > cmax[axis] - cmin[axis]) axis = 2;
+	float middle = (cmin[axis] + cmax[axis]) * .5f;
+	int split = first;
+	for (i=first;i<first+count;++i)
+	{
+		if (centroids[indices[i]*3+axis] < middle)
+		{
+			int tmp = indices[i];
+			indices[i] = indices[split];
+			indices[split] = tmp;
+			split++;
+		}
+	}
+
+	// They are all on the same side, we cut in half
+	if (split == first || split == first + count) split = first + count / 2;
+
+	node.count = 0;
+	build(faceArray, indices, centroids, first, split - first, depth + 1);
+	node.offset = build(faceArray, indices, centroids, split, first + count - split, depth + 1);
+
+	return index;
+}
+
+
+
+//
+// On va trouver le point d'intersection avec un ray tracing.
+// The closest child first, p2 comes closer at each hit so the far boxes get skipped.
+//
+bool CBvh::findRayIntersection(const CVector &p1, CVector &p2, float &dis, CVector &intersection, CVector &normal, int &n, int *stack) const
+{
+	if (!nbNode) return false;
+
+	bool found = false;
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top)
+	{
+		int index = stack[--top];
+		const bvh_node & node = nodes[index];
+		n++;
+
+		// On test avec sa boite
+		if (!SegmentToBox(p1, p2, CVector(node.min[0], node.min[1], node.min[2]), CVector(node.max[0], node.max[1], node.max[2]))) continue;
+
+		if (node.count)
+		{
+			// On test ses faces
+			for (int i=node.offset;i<node.offset+node.count;++i)
+			{
+				const bvh_triangle & t = triangles[i];
+				n++;
+				CVector intersect;
+				if (planeIntersect(t, p1, p2, intersect))
+				{
+					float disc = distanceFast(intersect, p1);
+					if (disc < dis)
+					{
+						CVector points[3];
+						trianglePoints(t, points);
+						if (pointInPolygon(t, intersect, points, 3))
+						{
+							p2 = intersect; // Shorter segment for the next tests
+							intersection = intersect;
+							normal = CVector(t.a, t.b, t.c);
+							dis = disc;
+							found = true;
+						}
+					}
+				}
+			}
+			continue;
+		}
+
+		// The one closer to p1 on the way is popped first
+		int left = index + 1;
+		int right = node.offset;
+		CVector dir = p2 - p1;
+		float disLeft = 
+			dir[0] * (nodes[left].min[0] + nodes[left].max[0] - p1[0] * 2) +
+			dir[1] * (nodes[left].min[1] + nodes[left].max[1] - p1[1] * 2) +
+			dir[2] * (nodes[left].min[2] + nodes[left].max[2] - p1[2] * 2);
+		float disRight = 
+			dir[0] * (nodes[right].min[0] + nodes[right].max[0] - p1[0] * 2) +
+			dir[1] * (nodes[right].min[1] + nodes[right].max[1] - p1[1] * 2) +
+			dir[2] * (nodes[right].min[2] + nodes[right].max[2] - p1[2] * 2);
+		if (disLeft < disRight)
+		{
+			stack[top++] = right;
+			stack[top++] = left;
+		}
+		else
+		{
+			stack[top++] = left;
+			stack[top++] = right;
+		}
+	}
+
+	return found;
+}
+
+
+
+//
+// Pour trouver un point d'intersection avec un sphere casting
+//
+bool CBvh::findSphereIntersection(const CVector &p1, CVector &p2, float rayon, float &dis, CVector &intersection, CVector &normal, int &n, int *stack) const
+{
+	if (!nbNode) return false;
+
+	bool found = false;
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top)
+	{
+		int index = stack[--top];
+		const bvh_node & node = nodes[index];
+		n++;
+
+		// On test avec sa boite, grossie du rayon
+		if (!SphereToBox(p1, p2, CVector(node.min[0], node.min[1], node.min[2]), CVector(node.max[0], node.max[1], node.max[2]), rayon)) continue;
+
+		if (node.count)
+		{
+			// On test ses faces
+			for (int i=node.offset;i<node.offset+node.count;++i)
+			{
+				const bvh_triangle & t = triangles[i];
+				n++;
+				CVector intersect;
+				CVector faceNormal(t.a, t.b, t.c);
+				if (planeIntersect(t, p1 - faceNormal*rayon, p2 - faceNormal*rayon, intersect))
+				{
+					float disc = distanceFast(intersect + faceNormal*rayon, p1);
+					if (disc < dis)
+					{
+						CVector points[9];
+						sphereCollisionPoints(t, rayon, points);
+						if (pointInPolygon(t, intersect, points, 9))
+						{
+							p2 = intersect + faceNormal*rayon; // Shorter segment for the next tests
+							intersection = p2;
+							normal = faceNormal;
+							dis = disc;
+							found = true;
+						}
+					}
+				}
+			}
+			continue;
+		}
+
+		// The one closer to p1 on the way is popped first
+		int left = index + 1;
+		int right = node.offset;
+		CVector dir = p2 - p1;
+		float disLeft = 
+			dir[0] * (nodes[left].min[0] + nodes[left].max[0] - p1[0] * 2) +
+			dir[1] * (nodes[left].min[1] + nodes[left].max[1] - p1[1] * 2) +
+			dir[2] * (nodes[left].min[2] + nodes[left].max[2] - p1[2] * 2);
+		float disRight = 
+			dir[0] * (nodes[right].min[0] + nodes[right].max[0] - p1[0] * 2) +
+			dir[1] * (nodes[right].min[1] + nodes[right].max[1] - p1[1] * 2) +
+			dir[2] * (nodes[right].min[2] + nodes[right].max[2] - p1[2] * 2);
+		if (disLeft < disRight)
+		{
+			stack[top++] = right;
+			stack[top++] = left;
+		}
+		else
+		{
+			stack[top++] = left;
+			stack[top++] = right;
+		}
+	}
+
+	return found;
+}
+
+
+
+//
+// Pour dessiner les boites
+//
+void CBvh::render() const
+{
+#ifndef DEDICATED_SERVER
+#ifndef _DX_
+	glPushAttrib(GL_CURRENT_BIT | GL_ENABLE_BIT);
+		glDisable(GL_TEXTURE_2D);
+		glDisable(GL_LIGHTING);
+		glLineWidth(1);
+		glColor3f(1,1,0);
+		glBegin(GL_LINES);
+		for (int i=0;i<nbNode;++i)
+		{
+			const float * b[2] = {nodes[i].min, nodes[i].max};
+
+			// Les 12 arretes, 4 sur chaque axe
+			for (int axis=0;axis<3;++axis)
+			{
+				int u = (axis+1)%3;
+				int v = (axis+2)%3;
+				for (int corner=0;corner<4;++corner)
+				{
+					float p[3];
+					p[u] = b[corner&1][u];
+					p[v] = b[corner>>1][v];
+					p[axis] = b[0][axis];
+					glVertex3fv(p);
+					p[axis] = b[1][axis];
+					glVertex3fv(p);
+				}
+			}
+		}
+		glEnd();
+	glPopAttrib();
+#endif
+#endif
+}
+
+
+
+//
+// On check segment-to-box
+//
+bool SegmentToBox(const CVector& p1, const CVector& p2, const CVector& min, const CVector& max)
+{
+    CVector d = (p2 - p1) * 0.5f;
+    CVector e = (max - min) * 0.5f;
+    CVector c = p1 + d - (min + max) * 0.5f;
+    CVector ad = CVector(fabsf(d[0]),fabsf(d[1]),fabsf(d[2]));; // Returns same vector with all components positive
+
+    if (fabsf(c[0]) > e[0] + ad[0])
+        return false;
+    if (fabsf(c[1]) > e[1] + ad[1])
+        return false;
+    if (fabsf(c[2]) > e[2] + ad[2])
+        return false;
+  
+    if (fabsf(d[1] * c[2] - d[2] * c[1]) > e[1] * ad[2] + e[2] * ad[1]/* + EPSILON*/)
+        return false;
+    if (fabsf(d[2] * c[0] - d[0] * c[2]) > e[2] * ad[0] + e[0] * ad[2]/* + EPSILON*/)
+        return false;
+    if (fabsf(d[0] * c[1] - d[1] * c[0]) > e[0] * ad[1] + e[1] * ad[0]/* + EPSILON*/)
+        return false;
+            
+    return true;
+}
+
+
+
+//
+// On check sphere-to-box
+//
+bool SphereToBox(const CVector& p1, const CVector& p2, const CVector& omin, const CVector& omax, float rayon)
+{
+ 	CVector min = omin - CVector(rayon, rayon, rayon);
+	CVector max = omax + CVector(rayon, rayon, rayon);
+    CVector d = (p2 - p1) * 0.5f;
+    CVector e = (max - min) * 0.5f;
+    CVector c = p1 + d - (min + max) * 0.5f;
+    CVector ad = CVector(fabsf(d[0]),fabsf(d[1]),fabsf(d[2]));; // Returns same vector with all components positive
+
+    if (fabsf(c[0]) > e[0] + ad[0])
+        return false;
+    if (fabsf(c[1]) > e[1] + ad[1])
+        return false;
+    if (fabsf(c[2]) > e[2] + ad[2])
+        return false;
+  
+    if (fabsf(d[1] * c[2] - d[2] * c[1]) > e[1] * ad[2] + e[2] * ad[1]/* + EPSILON*/)
+        return false;
+    if (fabsf(d[2] * c[0] - d[0] * c[2]) > e[2] * ad[0] + e[0] * ad[2]/* + EPSILON*/)
+        return false;
+    if (fabsf(d[0] * c[1] - d[1] * c[0]) > e[0] * ad[1] + e[1] * ad[0]/* + EPSILON*/)
+        return false;
+            
+    return true;
+}
@@ -0,0 +1,107 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef CBVH_H
+#define CBVH_H
+
+
+#include "CVector.h"
+#include "CFace.h"
+
+
+// Max triangles in a leaf
+#define BVH_MAX_PER_LEAF 4
+
+// The queries walk with the stack given by the caller (dko_query), it must hold that many
+#define BVH_STACK_SIZE 64
+
+// Past that depth a node is a leaf, whatever its triangle count. A query keeps at most one
+// node per level on its stack plus the two children it pushes, so it always fits.
+#define BVH_MAX_DEPTH (BVH_STACK_SIZE / 2 - 1)
+
+
+
+// A triangle, only what the collisions need
+struct bvh_triangle
+{
+	// Ses points
+	float point[3][3];
+
+	// La definition du plan de la face (normal incluse)
+	float a,b,c,d;
+
+	// Pushed out along each edge (point i to i+1) and at each corner, for the sphere casting
+	float edgeNormal[3][3];
+	float cornerNormal[3][3];
+};
+
+
+
+// A node of the tree. Its left child is right after it in the array
+struct bvh_node
+{
+	float min[3];
+	float max[3];
+
+	// Leaf : its first triangle. Otherwise : its right child
+	int offset;
+
+	// Triangles in the leaf, 0 if it has children
+	int count;
+};
+
+
+
+// Bounding volume hierarchy over the faces of a model, in two flat arrays
+class CBvh
+{
+public:
+	// Depth first, the root is 0
+	int nbNode;
+	bvh_node *nodes;
+
+	// In leaf order, each triangle is in one leaf only
+	int nbTriangle;
+	bvh_triangle *triangles;
+
+public:
+	// Constructeur / Destructeur
+	CBvh(CFace *faceArray, int nbFace);
+	virtual ~CBvh();
+
+	// Pour trouver le point d'intersection le plus proche avec un ray casting. p2 is moved to it.
+	// Nothing is written in the tree, stack is the caller's scratch of BVH_STACK_SIZE ints
+	bool findRayIntersection(const CVector &p1, CVector &p2, float &dis, CVector &intersection, CVector &normal, int &n, int *stack) const;
+
+	// Pour trouver le point d'intersection le plus proche avec un sphere casting. p2 is moved to it
+	bool findSphereIntersection(const CVector &p1, CVector &p2, float rayon, float &dis, CVector &intersection, CVector &normal, int &n, int *stack) const;
+
+	// Pour dessiner les boites
+	void render() const;
+
+private:
+	// Build the node of faces indices[first] to indices[first + count - 1], returns its index
+	int build(CFace *faceArray, int *indices, float *centroids, int first, int count, int depth);
+};
+
+
+// La fonction la plus importante de tous
+bool SegmentToBox(const CVector& p1, const CVector& p2, const CVector& min, const CVector& max);
+bool SphereToBox(const CVector& p1, const CVector& p2, const CVector& min, const CVector& max, float rayon);
+
+#endif
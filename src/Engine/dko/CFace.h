@@ -39,13 +39,9 @@ public:
 	// La d�inition du plan de la face (normal incluse)
 	float a,b,c,d;
 
-	// Son ID
-	INT4 frameID;
-
 	// Constructeur
 	CFace()
 	{
-		frameID = 0;
 		a = 0;
 		b = 0;
 		c = 1;
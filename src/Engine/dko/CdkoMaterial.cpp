@@ -237,10 +237,10 @@ void CdkoMaterial::setSelfIllPass()
 //
 // Pour loader le materiel
 //
-int CdkoMaterial::loadFromFile(FILE *ficIn, char *path)
+int CdkoMaterial::loadFromFile(CBinaryReader & file, char *path)
 {
 	// On load chunk par chunk jusqu' ce qu'on pogne le chunk End
-	short chunkID = readChunk(ficIn);
+	short chunkID = readChunk(file);
 
 	while (chunkID != CHUNK_DKO_END)
 	{
@@ -248,12 +248,12 @@ int CdkoMaterial::loadFromFile(FILE *ficIn, char *path)
 		{
 		case CHUNK_DKO_MATNAME:
 			{
-				matName = readString(ficIn);
+				matName = readString(file);
 				break;
 			}
 		case CHUNK_DKO_TEX_DKT:
 			{
-				char *dktFilename = readString(ficIn);
+				char *dktFilename = readString(file);
 				char strTMP[512];
 				sprintf(strTMP, "%s%s", path, dktFilename);
 				textureMat = new ePTexture();
@@ -263,7 +263,7 @@ int CdkoMaterial::loadFromFile(FILE *ficIn, char *path)
 			}
 		case CHUNK_DKO_TEX_DIFFUSE:
 			{
-				char *texFilename = readString(ficIn);
+				char *texFilename = readString(file);
 				char strTMP[512];
 				sprintf(strTMP, "%s%s", path, texFilename);
 #ifndef DEDICATED_SERVER
@@ -274,7 +274,7 @@ int CdkoMaterial::loadFromFile(FILE *ficIn, char *path)
 			}
 		case CHUNK_DKO_TEX_BUMP:
 			{
-				char *texFilename = readString(ficIn);
+				char *texFilename = readString(file);
 				char strTMP[512];
 				sprintf(strTMP, "%s%s", path, texFilename);
 #ifndef DEDICATED_SERVER
@@ -285,7 +285,7 @@ int CdkoMaterial::loadFromFile(FILE *ficIn, char *path)
 			}
 		case CHUNK_DKO_TEX_SPECULAR:
 			{
-				char *texFilename = readString(ficIn);
+				char *texFilename = readString(file);
 				char strTMP[512];
 				sprintf(strTMP, "%s%s", path, texFilename);
 #ifndef DEDICATED_SERVER
@@ -296,7 +296,7 @@ int CdkoMaterial::loadFromFile(FILE *ficIn, char *path)
 			}
 		case CHUNK_DKO_TEX_SELFILL:
 			{
-				char *texFilename = readString(ficIn);
+				char *texFilename = readString(file);
 				char strTMP[512];
 				sprintf(strTMP, "%s%s", path, texFilename);
 #ifndef DEDICATED_SERVER
@@ -307,56 +307,56 @@ int CdkoMaterial::loadFromFile(FILE *ficIn, char *path)
 			}
 		case CHUNK_DKO_AMBIENT:
 			{
-				fread(ambient, 4, sizeof(float), ficIn);
+				file.read(ambient, 4*sizeof(float));
 				break;
 			}
 		case CHUNK_DKO_DIFFUSE:
 			{
-				fread(diffuse, 4, sizeof(float), ficIn);
+				file.read(diffuse, 4*sizeof(float));
 				break;
 			}
 		case CHUNK_DKO_SPECULAR:
 			{
-				fread(specular, 4, sizeof(float), ficIn);
+				file.read(specular, 4*sizeof(float));
 				break;
 			}
 		case CHUNK_DKO_EMISSIVE:
 			{
-				fread(emissive, 4, sizeof(float), ficIn);
+				file.read(emissive, 4*sizeof(float));
 				break;
 			}
 		case CHUNK_DKO_SHININESS:
 			{
-				fread(&shininess, 1, sizeof(short), ficIn);
+				file.read(&shininess, sizeof(short));
 				break;
 			}
 		case CHUNK_DKO_TRANSPARENCY:
 			{
-				fread(&transparency, 1, sizeof(float), ficIn);
+				file.read(&transparency, sizeof(float));
 				break;
 			}
 		case CHUNK_DKO_TWO_SIDED:
 			{
 				char temp;
-				fread(&temp, 1, sizeof(char), ficIn);
+				file.read(&temp, sizeof(char));
 				twoSided = (temp) ? true : false;
 				break;
 			}
 		case CHUNK_DKO_WIRE_FRAME:
 			{
 				char temp;
-				fread(&temp, 1, sizeof(char), ficIn);
+				file.read(&temp, sizeof(char));
 				wire = (temp) ? true : false;
 				break;
 			}
 		case CHUNK_DKO_WIRE_WIDTH:
 			{
-				fread(&wireSize, 1, sizeof(float), ficIn);
+				file.read(&wireSize, sizeof(float));
 				break;
 			}
 		}
 
-		chunkID = readChunk(ficIn);
+		chunkID = readChunk(file);
 	}
 
 	// Tout est beau
@@ -21,6 +21,7 @@
 
 
 #include "ePTexture.h"
+#include "CBinaryReader.h"
 
 
 class CdkoMaterial
@@ -73,7 +74,7 @@ public:
 	void setDetailPass();
 
 	// Pour loader le materiel
-	int loadFromFile(FILE *ficIn, char *path);
+	int loadFromFile(CBinaryReader & file, char *path);
 };
 
 
@@ -46,11 +46,11 @@ CdkoMesh::~CdkoMesh()
 //
 // pour loader du fichier
 //
-int CdkoMesh::loadFromFile(FILE *ficIn, char *path)
+int CdkoMesh::loadFromFile(CBinaryReader & file, char *path)
 {
 	(void)path;
 	// On load chunk par chunk jusqu' ce qu'on pogne le chunk End
-	short chunkID = readChunk(ficIn);
+	short chunkID = readChunk(file);
 
 	while (chunkID != CHUNK_DKO_END)
 	{
@@ -59,22 +59,22 @@ int CdkoMesh::loadFromFile(FILE *ficIn, char *path)
 		case CHUNK_DKO_NAME:
 			{
 				if (name) delete [] name;
-				name = readString(ficIn);
+				name = readString(file);
 				break;
 			}
 		case CHUNK_DKO_POSITION:
 			{
-				fread(position, 3, sizeof(float), ficIn);
+				file.read(position, 3*sizeof(float));
 				break;
 			}
 		case CHUNK_DKO_MATRIX:
 			{
-				fread(matrix, 9, sizeof(float), ficIn);
+				file.read(matrix, 9*sizeof(float));
 				break;
 			}
 		case CHUNK_DKO_NB_MAT_GROUP:
 			{
-				fread(&nbMatGroup, 1, sizeof(short), ficIn);
+				file.read(&nbMatGroup, sizeof(short));
 
 				// On load les sous-objet
 				if (matGroupArray) delete [] matGroupArray;
@@ -84,14 +84,14 @@ int CdkoMesh::loadFromFile(FILE *ficIn, char *path)
 					if (matGroupArray[i].meshAtFrame) delete [] matGroupArray[i].meshAtFrame;
 					matGroupArray[i].meshAtFrame = new _typMeshAtFrame[parentModel->timeInfo[2]];
 					matGroupArray[i].parentModel = parentModel;
-					loadMatGroup(ficIn, &(matGroupArray[i]));
+					loadMatGroup(file, &(matGroupArray[i]));
 				}
 
 				break;
 			}
 		}
 
-		chunkID = readChunk(ficIn);
+		chunkID = readChunk(file);
 	}
 
 	// Tout est beau
@@ -103,10 +103,10 @@ int CdkoMesh::loadFromFile(FILE *ficIn, char *path)
 //
 // On load un sous-objet (sous-sous objet en fait :P)
 //
-int CdkoMesh::loadMatGroup(FILE *ficIn, _typMatGroup *matGroup)
+int CdkoMesh::loadMatGroup(CBinaryReader & file, _typMatGroup *matGroup)
 {
 	// On load chunk par chunk jusqu' ce qu'on pogne le chunk End
-	short chunkID = readChunk(ficIn);
+	short chunkID = readChunk(file);
 
 	while (chunkID != CHUNK_DKO_END)
 	{
@@ -115,13 +115,13 @@ int CdkoMesh::loadMatGroup(FILE *ficIn, _typMatGroup *matGroup)
 		case CHUNK_DKO_MAT_ID:
 			{
 				short MatID;
-				fread(&MatID, 1, sizeof(short), ficIn);
+				file.read(&MatID, sizeof(short));
 				matGroup->material = &(((CDkoModel*)parent)->materialArray[MatID]);
 				break;
 			}
 		case CHUNK_DKO_NB_VERTEX:
 			{
-				fread(&(matGroup->nbVertex), 1, sizeof(matGroup->nbVertex), ficIn);
+				file.read(&(matGroup->nbVertex), sizeof(matGroup->nbVertex));
                 printf("nbVertex: %ld\n", matGroup->nbVertex);
 				break;
 			}
@@ -134,7 +134,7 @@ int CdkoMesh::loadMatGroup(FILE *ficIn, _typMatGroup *matGroup)
 				{
 					if (matGroup->meshAtFrame[f].vertexArray) delete [] matGroup->meshAtFrame[f].vertexArray;
 					matGroup->meshAtFrame[f].vertexArray = new float [matGroup->nbVertex*3];
-					fread(matGroup->meshAtFrame[f].vertexArray, matGroup->nbVertex*3, sizeof(float), ficIn);
+					file.read(matGroup->meshAtFrame[f].vertexArray, matGroup->nbVertex*3*sizeof(float));
 				}
 
 				// On pogne son parent
@@ -189,7 +189,7 @@ int CdkoMesh::loadMatGroup(FILE *ficIn, _typMatGroup *matGroup)
 				{
 					if (matGroup->meshAtFrame[f].normalArray) delete [] matGroup->meshAtFrame[f].normalArray;
 					matGroup->meshAtFrame[f].normalArray = new float [matGroup->nbVertex*3];
-					fread(matGroup->meshAtFrame[f].normalArray, matGroup->nbVertex*3, sizeof(float), ficIn);
+					file.read(matGroup->meshAtFrame[f].normalArray, matGroup->nbVertex*3*sizeof(float));
 				}
 				break;
 			}
@@ -197,10 +197,10 @@ int CdkoMesh::loadMatGroup(FILE *ficIn, _typMatGroup *matGroup)
 			{
 				matGroup->animatedUV = false;
 			//	matGroup->texCoordArray = new float [matGroup->nbVertex*2];
-			//	fread(matGroup->texCoordArray, matGroup->nbVertex*2, sizeof(float), ficIn);
+			//	file.read(matGroup->texCoordArray, matGroup->nbVertex*2*sizeof(float));
 				if (matGroup->meshAtFrame[0].texCoordArray) delete [] matGroup->meshAtFrame[0].texCoordArray;
 				matGroup->meshAtFrame[0].texCoordArray = new float [matGroup->nbVertex*2];
-				fread(matGroup->meshAtFrame[0].texCoordArray, matGroup->nbVertex*2, sizeof(float), ficIn);
+				file.read(matGroup->meshAtFrame[0].texCoordArray, matGroup->nbVertex*2*sizeof(float));
 				break;
 			}
 		case CHUNK_DKO_TEXCOORD_ARRAY_ANIM:
@@ -213,13 +213,13 @@ int CdkoMesh::loadMatGroup(FILE *ficIn, _typMatGroup *matGroup)
 				{
 					if (matGroup->meshAtFrame[f].texCoordArray) delete [] matGroup->meshAtFrame[f].texCoordArray;
 					matGroup->meshAtFrame[f].texCoordArray = new float [matGroup->nbVertex*2];
-					fread(matGroup->meshAtFrame[f].texCoordArray, matGroup->nbVertex*2, sizeof(float), ficIn);
+					file.read(matGroup->meshAtFrame[f].texCoordArray, matGroup->nbVertex*2*sizeof(float));
 				}
 				break;
 			}
 		}
 
-		chunkID = readChunk(ficIn);
+		chunkID = readChunk(file);
 	}
 
 	// Tout est beau
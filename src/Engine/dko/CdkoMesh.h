@@ -135,10 +135,10 @@ public:
 	CdkoMesh(); virtual ~CdkoMesh();
 
 	// pour loader du fichier
-	int loadFromFile(FILE *ficIn, char *path);
+	int loadFromFile(CBinaryReader & file, char *path);
 
 	// pour loader un matgroup
-	int loadMatGroup(FILE *ficIn, _typMatGroup *matGroup);
+	int loadMatGroup(CBinaryReader & file, _typMatGroup *matGroup);
 
 	// Pour le dessiner
 	void drawIt();
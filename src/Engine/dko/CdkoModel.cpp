@@ -38,13 +38,16 @@ CDkoModel::CDkoModel()
 	firstVertex = true;
 	nbFace = 0;
 	faceArray = 0;
-	octree = 0;
+	bvh = 0;
 	timeInfo[0] = 0;
 	timeInfo[1] = 0;
 	timeInfo[2] = 1;
 	currentFrame = 0;
 	dumSize = 0;
 	framef=0;
+	cacheKey = 0;
+	modifDate = 0;
+	nbInstance = 0;
 	for (i=0;i<64;dummies[i++] = 0);
 }
 
@@ -52,12 +55,13 @@ CDkoModel::~CDkoModel()
 {
 	if (name) delete [] name;
 	if (materialArray) delete [] materialArray;
-	if (octree) delete octree;
+	if (bvh) delete bvh;
 
 	// On efface les dummy
 	for (int i=0;i<64;i++) if (dummies[i]) delete dummies[i];
 
 	if (faceArray) delete [] faceArray;
+	if (cacheKey) delete [] cacheKey;
 }
 
 
@@ -65,9 +69,9 @@ CDkoModel::~CDkoModel()
 //
 // pour loader un fichier 3ds
 //
-int CDkoModel::loadFromFile3DS(FILE *ficIn, char *path)
+int CDkoModel::loadFromFile3DS(CBinaryReader & file, char *path)
 {
-	(void)ficIn; (void)path;
+	(void)file; (void)path;
 	return 0;
 }
 
@@ -76,10 +80,10 @@ int CDkoModel::loadFromFile3DS(FILE *ficIn, char *path)
 //
 // pour loader du fichier
 //
-int CDkoModel::loadFromFile(FILE *ficIn, char *path)
+int CDkoModel::loadFromFile(CBinaryReader & file, char *path)
 {
 	// On load chunk par chunk jusqu' ce qu'on pogne le chunk End
-	short chunkID = readChunk(ficIn);
+	short chunkID = readChunk(file);
 
 	while (chunkID != CHUNK_DKO_END)
 	{
@@ -89,7 +93,7 @@ int CDkoModel::loadFromFile(FILE *ficIn, char *path)
 			{
 				// On check si on a la bonne version
 				short version;
-				fread(&version, 1, sizeof(short), ficIn);
+				file.read(&version, sizeof(short));
 				if (version > DKO_VERSION)
 				{
 					CDko::updateLastError("Incorrect version of file");
@@ -100,19 +104,19 @@ int CDkoModel::loadFromFile(FILE *ficIn, char *path)
 		case CHUNK_DKO_TIME_INFO:
 			{
 				// On importe le start frame, le end frame et la duration dans un ti array de short
-				fread(timeInfo, 1, sizeof(short)*3, ficIn);
+				file.read(timeInfo, sizeof(short)*3);
 
 				// a va nous servir pour allouer l'espace pour nos meshes
 				break;
 			}
 		case CHUNK_DKO_PROPERTIES:
 			{
-				loadProperties(ficIn);
+				loadProperties(file);
 				break;
 			}
 		case CHUNK_DKO_MATLIST:
 			{
-				fread(&nbMat, 1, sizeof(short), ficIn);
+				file.read(&nbMat, sizeof(short));
 				if (nbMat)
 				{
 					materialArray = new CdkoMaterial[nbMat];
@@ -120,7 +124,7 @@ int CDkoModel::loadFromFile(FILE *ficIn, char *path)
 					// On load tout les materiaux
 					for (int i=0;i<nbMat;i++)
 					{
-						if (!materialArray[nbMat-i-1].loadFromFile(ficIn, path))
+						if (!materialArray[nbMat-i-1].loadFromFile(file, path))
 						{
 							return 0;
 						}
@@ -138,17 +142,17 @@ int CDkoModel::loadFromFile(FILE *ficIn, char *path)
 				CdkoMesh *newMesh = new CdkoMesh();
 				addChild(newMesh);
 				newMesh->parentModel = this;
-				newMesh->loadFromFile(ficIn, path);
+				newMesh->loadFromFile(file, path);
 				break;
 			}
 		case CHUNK_DKO_DUMMY:
 			{
-				loadDummy(ficIn);
+				loadDummy(file);
 				break;
 			}
 		}
 
-		chunkID = readChunk(ficIn);
+		chunkID = readChunk(file);
 	}
 
 	// On calcul son OABB
@@ -167,13 +171,13 @@ int CDkoModel::loadFromFile(FILE *ficIn, char *path)
 //
 // Pour loader un dummy
 //
-void CDkoModel::loadDummy(FILE *ficIn)
+void CDkoModel::loadDummy(CBinaryReader & file)
 {
 	// On cr notre dummy
 	_typDummy *newDum = new _typDummy(timeInfo[2]);
 
 	// On load chunk par chunk jusqu' ce qu'on pogne le chunk End
-	short chunkID = readChunk(ficIn);
+	short chunkID = readChunk(file);
 
 	while (chunkID != CHUNK_DKO_END)
 	{
@@ -181,14 +185,14 @@ void CDkoModel::loadDummy(FILE *ficIn)
 		{
 		case CHUNK_DKO_NAME:
 			{
-				newDum->name = readString(ficIn);
+				newDum->name = readString(file);
 				break;
 			}
 		case CHUNK_DKO_POSITION:
 			{
 				for (int i=0;i<timeInfo[2];i++)
 				{
-					fread(newDum->position[i].v, 3, sizeof(float), ficIn);
+					file.read(newDum->position[i].v, 3*sizeof(float));
 				}
 				break;
 			}
@@ -196,13 +200,13 @@ void CDkoModel::loadDummy(FILE *ficIn)
 			{
 				for (int i=0;i<timeInfo[2];i++)
 				{
-					fread(newDum->matrix[i].m, 9, sizeof(float), ficIn);
+					file.read(newDum->matrix[i].m, 9*sizeof(float));
 				}
 				break;
 			}
 		}
 
-		chunkID = readChunk(ficIn);
+		chunkID = readChunk(file);
 	}
 
 	// On l'ajoute  notre liste
@@ -215,10 +219,10 @@ void CDkoModel::loadDummy(FILE *ficIn)
 //
 // Pour loader ses proprites
 //
-void CDkoModel::loadProperties(FILE *ficIn)
+void CDkoModel::loadProperties(CBinaryReader & file)
 {
 	// On load chunk par chunk jusqu' ce qu'on pogne le chunk End
-	short chunkID = readChunk(ficIn);
+	short chunkID = readChunk(file);
 
 	while (chunkID != CHUNK_DKO_END)
 	{
@@ -226,22 +230,22 @@ void CDkoModel::loadProperties(FILE *ficIn)
 		{
 		case CHUNK_DKO_NAME:
 			{
-				name = readString(ficIn);
+				name = readString(file);
 				break;
 			}
 		case CHUNK_DKO_POSITION:
 			{
-				fread(position, 3, sizeof(float), ficIn);
+				file.read(position, 3*sizeof(float));
 				break;
 			}
 		case CHUNK_DKO_MATRIX:
 			{
-				fread(matrix, 9, sizeof(float), ficIn);
+				file.read(matrix, 9*sizeof(float));
 				break;
 			}
 		}
 
-		chunkID = readChunk(ficIn);
+		chunkID = readChunk(file);
 	}
 }
 
@@ -250,11 +254,11 @@ void CDkoModel::loadProperties(FILE *ficIn)
 //
 // Pour lire un chunk
 //
-short readChunk(FILE *ficIn)
+short readChunk(CBinaryReader & file)
 {
-	short chunkID;
-	fread(&chunkID, 1, sizeof(short), ficIn);
-	return chunkID;
+	// Un fichier tronque finit comme s'il avait son chunk End
+	if (file.getRemaining() < (int)sizeof(short)) return CHUNK_DKO_END;
+	return (short)file.getInt();
 }
 
 
@@ -262,19 +266,15 @@ short readChunk(FILE *ficIn)
 //
 // Pour lire un string
 //
-char *readString(FILE *ficIn)
+char *readString(CBinaryReader & file)
 {
-	char tmp[256];
-	int i = 0;
-	fread(tmp, 1, 1, ficIn); // On li le premier caractre
-	while (*(tmp + i++) != 0)  // Tant qu'on pogne pas le caractre 0, NULL, '\0', toute la mme chose
-	{
-		fread(tmp + i, 1, 1, ficIn);	// On li le prochain caractre
-	}
-	
+	// Il est directement dans le fichier, on le copie d'un coup
+	const char *str = file.getString();
+	if (!str) str = "";
+
 	// On cr un string dynamique et on retourne a
-	char *newStr = new char [i];
-	strcpy(newStr, tmp);
+	char *newStr = new char [strlen(str)+1];
+	strcpy(newStr, str);
 
 	return newStr;
 }
@@ -308,28 +308,11 @@ void CDkoModel::buildVertexArray(float * vertexArray)
 
 
 //
-// On va crer un octree  partir de la facelist
+// On va crer l'arbre de collision  partir de la facelist
 //
-void CDkoModel::buildOctree()
+void CDkoModel::buildBvh()
 {
-	// On construit un array de pointeurs vers ses faces
-	CFace **ptrFaceArray = new CFace*[nbFace];
-	for (int i=0;i<nbFace;i++)
-		ptrFaceArray[i] = &(faceArray[i]);
-
-	// On trouve le ct le plus grand
-	float size = (OABB[3]>OABB[4])?OABB[3]:OABB[4];
-	size = (size>OABB[5])?size:OABB[5];
-
-	// On construit le octree
-	CVector3f v;
-	v[0] = OABB[0];
-	v[1] = OABB[1];
-	v[2] = OABB[2];
-	octree = new COctreeNode(ptrFaceArray, nbFace, v, size, 0);
-
-	// On efface la liste temporaire
-	delete [] ptrFaceArray;
+	bvh = new CBvh(faceArray, nbFace);
 }
 
 
@@ -27,7 +27,7 @@
 #include "eHierarchic.h"
 
 #include "CdkoMaterial.h"
-#include "COctree.h"
+#include "CBvh.h"
 
 //#include <vector>  // WTF CALISS JPEUX PAS L'INCLURE A CHI DUR
 
@@ -139,14 +139,24 @@ public:
 	int nbFace;
 	CFace *faceArray;
 
-	// Son octree pour les collisions
-	COctreeNode *octree;
+	// Son arbre pour les collisions
+	CBvh *bvh;
 
 	// L'animation courante
 	short timeInfo[3];
 	short currentFrame;
 	float framef;
 
+	// Le fichier d'o il vient, sa cl dans la cache (0 s'il n'y est pas)
+	char *cacheKey;
+
+	// La date de modification du fichier au load
+	INT4 modifDate;
+
+	// Combien d'IDs le partagent. Tout ce qui est ici est immuable aprs le load,
+	// currentFrame et framef sont remis par chaque appel avant d'tre utiliss
+	int nbInstance;
+
 	// ses dummies
 	int dumSize;
 	_typDummy* dummies[64]; // On a un max de 64 dummy l
@@ -156,21 +166,21 @@ public:
 	CDkoModel(); virtual ~CDkoModel();
 
 	// pour loader du fichier
-	int loadFromFile(FILE *ficIn, char *path);
-	int loadFromFile3DS(FILE *ficIn, char *path);
+	int loadFromFile(CBinaryReader & file, char *path);
+	int loadFromFile3DS(CBinaryReader & file, char *path);
 
 	// Pour loader ses proprites
-	void loadProperties(FILE *ficIn);
+	void loadProperties(CBinaryReader & file);
 
 	// Pour loader un dummy
-	void loadDummy(FILE *ficIn);
+	void loadDummy(CBinaryReader & file);
 
 	// On va crer sa facelist
 	void buildFaceList();
 	void buildVertexArray(float * vertexArray);
 
-	// On va crer un octree  partir de la facelist
-	void buildOctree();
+	// On va crer l'arbre de collision  partir de la facelist
+	void buildBvh();
 
 	// Pour loader une nouvelle animation dans ce fichier
 //	int addAnimationFromFile(unsigned int modelID, char* filename, char* animationName);
@@ -182,10 +192,10 @@ public:
 
 
 // pour lire un chunk
-short readChunk(FILE *ficIn);
+short readChunk(CBinaryReader & file);
 
 // Pour lire un string
-char *readString(FILE *ficIn);
+char *readString(CBinaryReader & file);
 
 
 #endif
\ No newline at end of file
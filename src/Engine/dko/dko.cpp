@@ -18,6 +18,8 @@
 
 #include "dkoInner.h"
 #include "CdkoMesh.h"
+#include <sys/stat.h>
+#include <algorithm>
 
 #ifndef WIN32
 	#include "LinuxHeader.h"
@@ -31,10 +33,14 @@
 //
 char *CDko::lastErrorString = 0;
 CDkoModel *CDko::modelArray[MAX_MODEL];
+unsigned int CDko::freeID[MAX_MODEL];
+int CDko::nbFreeID = 0;
+unsigned int CDko::nextID = 1;
+std::unordered_map<std::string, CDkoModel*> CDko::cache;
+std::vector<CDkoModel*> CDko::unused;
 bool CDko::inited = false;
 unsigned int CDko::renderStateBitField = 0;
 _typBitFieldPile *CDko::bitFieldPile = 0;
-INT4 CDko::globalFrameID = 0;
 
 
 
@@ -50,6 +56,68 @@ void CDko::updateLastError(char *error)
 
 
 
+//
+// Donner un ID a un model
+//
+unsigned int CDko::newID(CDkoModel *model)
+{
+	if (nbFreeID == 0 && nextID == MAX_MODEL)
+	{
+		updateLastError("Max number of models reached : 1024");
+		return 0;
+	}
+
+	// On reprend un ID libere avant d'en entamer un neuf
+	unsigned int ID = (nbFreeID > 0) ? freeID[--nbFreeID] : nextID++;
+	modelArray[ID] = model;
+	model->nbInstance++;
+	return ID;
+}
+
+
+
+//
+// Un ID de moins pour ce model
+//
+void CDko::release(CDkoModel *model)
+{
+	if (--model->nbInstance > 0) return;
+
+	if (!model->cacheKey)
+	{
+		delete model;
+		return;
+	}
+
+	// On le garde un peu, il va surement revenir au prochain changement de map
+	unused.push_back(model);
+	if ((int)unused.size() > DKO_CACHE_KEEP)
+	{
+		CDkoModel *oldest = unused.front();
+		unused.erase(unused.begin());
+		cache.erase(oldest->cacheKey);
+		delete oldest;
+	}
+}
+
+
+
+//
+// La cle d'un fichier, on ignore les majuscules et le sens des slash
+//
+std::string CDko::getCacheKey(const char *filename)
+{
+	std::string key(filename);
+	for (size_t i=0;i<key.size();++i)
+	{
+		if (key[i] == '\\') key[i] = '/';
+		else if (key[i] >= 'A' && key[i] <= 'Z') key[i] += 32;
+	}
+	return key;
+}
+
+
+
 //
 // Pour ajouter une animation �cet objet �partir d'un fichier 3ds
 //
@@ -82,7 +150,7 @@ void			dkoAddLight(unsigned int modelID, float *position, float *diffuse, float
 
 
 //
-// Pour construire l'arbre octal pour g�er rapidement les collisions avec ses faces
+// Pour construire l'arbre (BVH) pour gérer rapidement les collisions avec ses faces. Garde son vieux nom
 //
 void			dkoBuildOctree(unsigned int modelID)
 {
@@ -92,9 +160,9 @@ void			dkoBuildOctree(unsigned int modelID)
 		{
 			CDko::modelArray[modelID]->buildFaceList();
 		}
-		if (!CDko::modelArray[modelID]->octree && CDko::modelArray[modelID]->nbFace)
+		if (!CDko::modelArray[modelID]->bvh && CDko::modelArray[modelID]->nbFace)
 		{
-			CDko::modelArray[modelID]->buildOctree();
+			CDko::modelArray[modelID]->buildBvh();
 		}
 	}
 	else
@@ -131,10 +199,12 @@ void			dkoEnable(unsigned int renderFlags)
 //
 void			dkoDeleteModel(unsigned int *modelID)
 {
-	if (CDko::modelArray[*modelID])
+	if (*modelID < (unsigned int)MAX_MODEL && CDko::modelArray[*modelID])
 	{
-		delete CDko::modelArray[*modelID];
+		CDkoModel *model = CDko::modelArray[*modelID];
 		CDko::modelArray[*modelID] = 0;
+		CDko::freeID[CDko::nbFreeID++] = *modelID;
+		CDko::release(model);
 	}
 
 	*modelID = 0;
@@ -539,6 +609,10 @@ void			dkoInit()
 
 	for (int i=0;i<MAX_MODEL;i++) CDko::modelArray[i] = 0;
 
+	// L'ID 0 n'est jamais donne
+	CDko::nbFreeID = 0;
+	CDko::nextID = 1;
+
 	CDko::inited = true;
 
 	CDko::renderStateBitField = 0;
@@ -576,33 +650,57 @@ void			dkoInitLightList(unsigned int modelID)
 //
 unsigned int	dkoLoadFile(char* filename)
 {
+	// On l'a peut-etre deja, on partage alors le meme model
+	std::string key = CDko::getCacheKey(filename);
+	struct stat attrib;
+	INT4 modifDate = (stat(filename, &attrib) == 0) ? INT4(attrib.st_mtime) : 0;
+	std::unordered_map<std::string, CDkoModel*>::iterator cached = CDko::cache.find(key);
+	if (cached != CDko::cache.end())
+	{
+		CDkoModel *model = cached->second;
+		if (model->modifDate == modifDate)
+		{
+			if (CDko::nbFreeID == 0 && CDko::nextID == MAX_MODEL)
+			{
+				CDko::updateLastError("Max number of models reached : 1024");
+				return 0;
+			}
+			if (model->nbInstance == 0)
+			{
+				CDko::unused.erase(std::find(CDko::unused.begin(), CDko::unused.end(), model));
+			}
+			return CDko::newID(model);
+		}
+
+		// Le fichier a change, ceux qui ont encore l'ancien le gardent
+		CDko::cache.erase(cached);
+		delete [] model->cacheKey;
+		model->cacheKey = 0;
+		if (model->nbInstance == 0)
+		{
+			CDko::unused.erase(std::find(CDko::unused.begin(), CDko::unused.end(), model));
+			delete model;
+		}
+	}
 
-	FILE *ficIn = fopen(filename, "rb");
+	CBinaryReader file(filename);
 
 	// On check la validit�du fichier
-	if (!ficIn)
+	if (!file.isValid())
 	{
 		CDko::updateLastError("Invalide filename");
 		return 0;
 	}
 
-	// On une case dans le array vite avant tout
-	unsigned int ID;
-	for (ID=1;ID<MAX_MODEL;ID++)
-	{
-		if (!CDko::modelArray[ID]) break;
-	}
-
 	// Oups, il n'y a plus de place
-	if (ID == MAX_MODEL)
+	if (CDko::nbFreeID == 0 && CDko::nextID == MAX_MODEL)
 	{
 		CDko::updateLastError("Max number of models reached : 1024");
-		fclose(ficIn);
 		return 0;
 	}
 
 	// Parfait, on cr�un nouveau Model dko ici
-	CDko::modelArray[ID] = new CDkoModel();
+	CDkoModel *model = new CDkoModel();
 
 	// On efface le string jusqu'au /
 	size_t len = strlen(filename);
@@ -617,19 +715,20 @@ unsigned int	dkoLoadFile(char* filename)
 	bool _3dsFile = (stricmp(&(filename[strlen(filename)-4]), "3ds") == 0);
 	if (_3dsFile)
 	{
-		if (!CDko::modelArray[ID]->loadFromFile3DS(ficIn, path))
+		if (!model->loadFromFile3DS(file, path))
 		{
 			delete [] path;
-			fclose(ficIn);
+			delete model;
 			return 0;
 		}
 	}
 	else
 	{
-		if (!CDko::modelArray[ID]->loadFromFile(ficIn, path))
+		if (!model->loadFromFile(file, path) || !file.isOk())
 		{
+			if (!file.isOk()) CDko::updateLastError("Truncated file");
 			delete [] path;
-			fclose(ficIn);
+			delete model;
 			return 0;
 		}
 	}
@@ -637,9 +736,14 @@ unsigned int	dkoLoadFile(char* filename)
 	// On efface les cochoneries
 	delete [] path;
 
-	// On a fini dle loader, on close et retourne son ID
-	fclose(ficIn);
-	return ID;
+	// On le met dans la cache
+	model->cacheKey = new char [key.size()+1];
+	strcpy(model->cacheKey, key.c_str());
+	model->modifDate = modifDate;
+	CDko::cache[key] = model;
+
+	// On a fini dle loader, le fichier se ferme tout seul
+	return CDko::newID(model);
 }
 
 
@@ -649,7 +753,10 @@ unsigned int	dkoLoadFile(char* filename)
 //
 unsigned int	dkoLoadFile(unsigned int modelID)
 {
-	return modelID;
+	if (modelID >= MAX_MODEL || !CDko::modelArray[modelID]) return 0;
+
+	// Le model est partage, chaque ID a juste sa propre reference
+	return CDko::newID(CDko::modelArray[modelID]);
 }
 
 
@@ -716,42 +823,51 @@ void			dkoPushRenderState()
 //
 bool			dkoRayIntersection(unsigned int modelID, float *mp1, float *mp2, float *intersect, float *normal, int &n)
 {
-	if (CDko::modelArray[modelID]) 
+	dko_query query;
+	bool result = dkoRayIntersection(query, modelID, mp1, mp2, intersect, normal);
+	n += query.nbTested;
+	if (query.error) CDko::updateLastError((char*)query.error);
+	return result;
+}
+
+
+
+//
+// Same, with the caller's scratch. Reads the model only, so it can run on many threads at once
+//
+bool			dkoRayIntersection(dko_query & query, unsigned int modelID, float *mp1, float *mp2, float *intersect, float *normal)
+{
+	query.nbTested = 0;
+	query.error = 0;
+
+	CDkoModel *model = (modelID < MAX_MODEL) ? CDko::modelArray[modelID] : 0;
+	if (!model)
 	{
-		if (CDko::modelArray[modelID]->octree)
-		{
-			CVector mintersection;
-			CVector mnormal;
-			CVector p1(mp1[0], mp1[1], mp1[2]);
-			CVector p2(mp2[0], mp2[1], mp2[2]);
-			float dis = distanceFast(p1, p2);
-
-			// Voil�on est pret, on test � dans le octree
-			CDko::globalFrameID++;
-			if (CDko::modelArray[modelID]->octree->findRayIntersection(p1, p2, dis, mintersection, mnormal, n))
-			{
-				intersect[0] = mintersection[0];
-				intersect[1] = mintersection[1];
-				intersect[2] = mintersection[2];
-				normal[0] = mnormal[0];
-				normal[1] = mnormal[1];
-				normal[2] = mnormal[2];
-				return true;
-			}
-			else
-				return false;
-		}
-		else
-		{
-			CDko::updateLastError("Octree not built for that model");
-			return false;
-		}
+		query.error = "Invalide model ID";
+		return false;
 	}
-	else
+	if (!model->bvh)
 	{
-		CDko::updateLastError("Invalide model ID");
+		query.error = "Collision tree not built for that model";
 		return false;
 	}
+
+	CVector mintersection;
+	CVector mnormal;
+	CVector p1(mp1[0], mp1[1], mp1[2]);
+	CVector p2(mp2[0], mp2[1], mp2[2]);
+	float dis = distanceFast(p1, p2);
+
+	// Voilà on est pret, on test ça dans l'arbre
+	if (!model->bvh->findRayIntersection(p1, p2, dis, mintersection, mnormal, query.nbTested, query.stack)) return false;
+
+	intersect[0] = mintersection[0];
+	intersect[1] = mintersection[1];
+	intersect[2] = mintersection[2];
+	normal[0] = mnormal[0];
+	normal[1] = mnormal[1];
+	normal[2] = mnormal[2];
+	return true;
 }
 
 
@@ -805,7 +921,7 @@ void			dkoRender(unsigned int modelID)
 				}
 
 				// � c TELLEMENT temporaire
-				if (CDko::modelArray[modelID]->octree && CDko::renderStateBitField & DKO_RENDER_NODE) CDko::modelArray[modelID]->octree->render();
+				if (CDko::modelArray[modelID]->bvh && CDko::renderStateBitField & DKO_RENDER_NODE) CDko::modelArray[modelID]->bvh->render();
 			}
 
 			// On affiche sont BB
@@ -944,7 +1060,7 @@ void			dkoRender(unsigned int modelID, unsigned short frameID)
 				}
 
 				// � c TELLEMENT temporaire
-				if (CDko::modelArray[modelID]->octree && CDko::renderStateBitField & DKO_RENDER_NODE) CDko::modelArray[modelID]->octree->render();
+				if (CDko::modelArray[modelID]->bvh && CDko::renderStateBitField & DKO_RENDER_NODE) CDko::modelArray[modelID]->bvh->render();
 			}
 
 			// On affiche sont BB
@@ -1087,7 +1203,7 @@ void			dkoRender(unsigned int modelID, float frameID)
 				}
 
 				// � c TELLEMENT temporaire
-				if (CDko::modelArray[modelID]->octree && CDko::renderStateBitField & DKO_RENDER_NODE) CDko::modelArray[modelID]->octree->render();
+				if (CDko::modelArray[modelID]->bvh && CDko::renderStateBitField & DKO_RENDER_NODE) CDko::modelArray[modelID]->bvh->render();
 			}
 
 			// On affiche sont BB
@@ -1184,7 +1300,15 @@ void			dkoShutDown()
 {
 	if (CDko::lastErrorString) delete [] CDko::lastErrorString;
 
-	for (int i=0;i<MAX_MODEL;i++) if (CDko::modelArray[i]) delete CDko::modelArray[i];
+	// Chaque model une seule fois, peu importe combien d'IDs le partagent
+	for (unsigned int i=0;i<MAX_MODEL;i++)
+	{
+		unsigned int ID = i;
+		if (CDko::modelArray[ID]) dkoDeleteModel(&ID);
+	}
+	for (int i=0;i<(int)CDko::unused.size();i++) delete CDko::unused[i];
+	CDko::unused.clear();
+	CDko::cache.clear();
 
 	_typBitFieldPile* toKill;
 	for (_typBitFieldPile* ptrBitField = CDko::bitFieldPile; ptrBitField; delete toKill)
@@ -1205,40 +1329,49 @@ void			dkoShutDown()
 //
 bool			dkoSphereIntersection(unsigned int modelID, float *mp1, float *mp2, float rayon, float *intersect, float *normal, int &n)
 {
-	if (CDko::modelArray[modelID]) 
+	dko_query query;
+	bool result = dkoSphereIntersection(query, modelID, mp1, mp2, rayon, intersect, normal);
+	n += query.nbTested;
+	if (query.error) CDko::updateLastError((char*)query.error);
+	return result;
+}
+
+
+
+//
+// Same, with the caller's scratch. Reads the model only, so it can run on many threads at once
+//
+bool			dkoSphereIntersection(dko_query & query, unsigned int modelID, float *mp1, float *mp2, float rayon, float *intersect, float *normal)
+{
+	query.nbTested = 0;
+	query.error = 0;
+
+	CDkoModel *model = (modelID < MAX_MODEL) ? CDko::modelArray[modelID] : 0;
+	if (!model)
 	{
-		if (CDko::modelArray[modelID]->octree)
-		{
-			CVector mintersection;
-			CVector mnormal;
-			CVector p1(mp1[0], mp1[1], mp1[2]);
-			CVector p2(mp2[0], mp2[1], mp2[2]);
-			float dis = distanceFast(p1, p2);
-
-			// Voil�on est pret, on test � dans le octree
-			CDko::globalFrameID++;
-			if (CDko::modelArray[modelID]->octree->findSphereIntersection(p1, p2, rayon, dis, mintersection, mnormal, n))
-			{
-				intersect[0] = mintersection[0];
-				intersect[1] = mintersection[1];
-				intersect[2] = mintersection[2];
-				normal[0] = mnormal[0];
-				normal[1] = mnormal[1];
-				normal[2] = mnormal[2];
-				return true;
-			}
-			else
-				return false;
-		}
-		else
-		{
-			CDko::updateLastError("Octree not built for that model");
-			return false;
-		}
+		query.error = "Invalide model ID";
+		return false;
 	}
-	else
+	if (!model->bvh)
 	{
-		CDko::updateLastError("Invalide model ID");
+		query.error = "Collision tree not built for that model";
 		return false;
 	}
+
+	CVector mintersection;
+	CVector mnormal;
+	CVector p1(mp1[0], mp1[1], mp1[2]);
+	CVector p2(mp2[0], mp2[1], mp2[2]);
+	float dis = distanceFast(p1, p2);
+
+	// Voilà on est pret, on test ça dans l'arbre
+	if (!model->bvh->findSphereIntersection(p1, p2, rayon, dis, mintersection, mnormal, query.nbTested, query.stack)) return false;
+
+	intersect[0] = mintersection[0];
+	intersect[1] = mintersection[1];
+	intersect[2] = mintersection[2];
+	normal[0] = mnormal[0];
+	normal[1] = mnormal[1];
+	normal[2] = mnormal[2];
+	return true;
 }
@@ -48,6 +48,22 @@
 #define DKO_CLAMP_TEXTURE		0x2000
 
 
+// Scratch memory for the collision queries, owned by the caller.
+// The models are only read by the queries, so each thread can run its own with its own dko_query.
+#define DKO_QUERY_STACK_SIZE	64
+struct dko_query
+{
+	// The nodes still to visit
+	int stack[DKO_QUERY_STACK_SIZE];
+
+	// Nodes and faces tested by the last query
+	int nbTested;
+
+	// Why the last query failed, 0 if it did not
+	const char *error;
+};
+
+
 // Les fonction du DKO
 int				dkoAddAnimationFromFile(unsigned int modelID, char* filename, char* animationName);
 void			dkoAddLight(unsigned int modelID, float *position, float *diffuse, float *specular, float range);
@@ -80,11 +96,13 @@ void			dkoOutputDebugInfo(unsigned int modelID, char *filename);
 void			dkoPopRenderState();
 void			dkoPushRenderState();
 bool			dkoRayIntersection(unsigned int modelID, float *p1, float *p2, float *intersect, float *normal, int &n);
+bool			dkoRayIntersection(dko_query & query, unsigned int modelID, float *p1, float *p2, float *intersect, float *normal); // Thread safe
 void			dkoRender(unsigned int modelID); // Va renderer automatiquement le premier frame
 void			dkoRender(unsigned int modelID, unsigned short frameID); // Sp�ifions un frame
 void			dkoRender(unsigned int modelID, float frameID); // Avec interpolation (MaLaDe)
 void			dkoShutDown();
 bool			dkoSphereIntersection(unsigned int modelID, float *p1, float *p2, float rayon, float *intersect, float *normal, int &n);
+bool			dkoSphereIntersection(dko_query & query, unsigned int modelID, float *p1, float *p2, float rayon, float *intersect, float *normal); // Thread safe
 
 
 #endif
\ No newline at end of file
@@ -58,6 +58,22 @@
 #define DKO_CLAMP_TEXTURE		0x2000
 
 
+// Scratch memory for the collision queries, owned by the caller.
+// The models are only read by the queries, so each thread can run its own with its own dko_query.
+#define DKO_QUERY_STACK_SIZE	64
+struct dko_query
+{
+	// The nodes still to visit
+	int stack[DKO_QUERY_STACK_SIZE];
+
+	// Nodes and faces tested by the last query
+	int nbTested;
+
+	// Why the last query failed, 0 if it did not
+	const char *error;
+};
+
+
 // Les fonction du DKO
 DLL_API(int)				dkoAddAnimationFromFile(unsigned int modelID, char* filename, char* animationName);
 DLL_API(void)			dkoAddLight(unsigned int modelID, float *position, float *diffuse, float *specular, float range);
@@ -90,11 +106,13 @@ DLL_API(void)			dkoOutputDebugInfo(unsigned int modelID, char *filename);
 DLL_API(void)			dkoPopRenderState();
 DLL_API(void)			dkoPushRenderState();
 DLL_API(bool)			dkoRayIntersection(unsigned int modelID, float *p1, float *p2, float *intersect, float *normal, int &n);
+DLL_API(bool)			dkoRayIntersection(dko_query & query, unsigned int modelID, float *p1, float *p2, float *intersect, float *normal);
 DLL_API(void)			dkoRender(unsigned int modelID);
 DLL_API(void)			dkoRender(unsigned int modelID, unsigned short frameID); // Sp�ifions un frame
 DLL_API(void)			dkoRender(unsigned int modelID, float frameID); // Avec interpolation (MaLaDe)
 DLL_API(void)			dkoShutDown();
 DLL_API(bool)			dkoSphereIntersection(unsigned int modelID, float *p1, float *p2, float rayon, float *intersect, float *normal, int &n);
+DLL_API(bool)			dkoSphereIntersection(dko_query & query, unsigned int modelID, float *p1, float *p2, float rayon, float *intersect, float *normal);
 
 #ifdef WIN32
 #ifndef DEDICATED_SERVER
@@ -123,6 +141,9 @@ DLL_API(bool)			dkoSphereIntersection(unsigned int modelID, float *p1, float *p2
 // Directives de pr�ompilation
 #include "CdkoModel.h"
 #include "CdkoMaterial.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
 #ifndef DEDICATED_SERVER
 #include <dkt.h>
 #endif
@@ -130,6 +151,9 @@ DLL_API(bool)			dkoSphereIntersection(unsigned int modelID, float *p1, float *p2
 
 const int MAX_MODEL	= 1024;
 
+// Combien de models on garde en ram apres leur dernier dkoDeleteModel (changement de map)
+const int DKO_CACHE_KEEP = 16;
+
 
 // Pour la pile des push/pop
 struct _typBitFieldPile
@@ -164,9 +188,22 @@ public:
 	// Pour tenir la derni�e erreur
 	static char *lastErrorString;
 
-	// Le array des models
+	// Le array des models, plusieurs IDs peuvent pointer sur le meme model
 	static CDkoModel *modelArray[MAX_MODEL];
 
+	// Les IDs liberes, on prend sur le dessus
+	static unsigned int freeID[MAX_MODEL];
+	static int nbFreeID;
+
+	// Le prochain ID jamais donne
+	static unsigned int nextID;
+
+	// Les models loades par fichier
+	static std::unordered_map<std::string, CDkoModel*> cache;
+
+	// Ceux de la cache qui n'ont plus d'ID, du plus vieux au plus recent
+	static std::vector<CDkoModel*> unused;
+
 	// Si il a ��initialis�
 	static bool inited;
 
@@ -176,12 +213,19 @@ public:
 	// La pile pour le bitMaskField
 	static _typBitFieldPile *bitFieldPile;
 
-	// Le ID global utilis�pour incr�enter exemple pour les octrees
-	static INT4 globalFrameID;
 
 public:
 	// Pour updater l'erreur
 	static void updateLastError(char *error);
+
+	// Donner un ID a un model, 0 s'il n'en reste plus
+	static unsigned int newID(CDkoModel *model);
+
+	// Un ID de moins pour ce model, il part de la ram quand il n'est plus utile
+	static void release(CDkoModel *model);
+
+	// La cle d'un fichier dans la cache
+	static std::string getCacheKey(const char *filename);
 };
 
 
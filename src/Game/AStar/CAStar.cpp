@@ -20,13 +20,7 @@
 
 #include "CAStar.h"
 #include <memory.h>
-
-
-
-#define ASTAR_DELETE_LIST(head, type) {type *toKill; for (type *p = head[0]; p; delete toKill){toKill = p;p = p->next;}head[0]=0;head[1]=0;}
-#define ASTAR_PUSH_BACK(head, element) {if (!head[0]){head[0] = head[1] = element;}else{head[1]->next = element;element->previous = head[1];head[1] = element;}}
-#define ASTAR_PUSH_FRONT(head, element) {if (!head[0]){head[0] = head[1] = element;}else{head[0]->previous = element;element->next = head[0];head[0] = element;}}
-#define ASTAR_INSERT(head, element, frontOf){if (!frontOf){head[0] = element;head[1] = element;}else{if (frontOf->previous){frontOf->previous->next = element;element->previous = frontOf->previous;frontOf->previous = element;element->next = frontOf;}else{frontOf->previous = element;element->next = frontOf;head[0] = element;}}}
+#include <math.h>
 
 
 
@@ -38,9 +32,8 @@ void CAStar::InitMembers()
 	m_mapArray = 0;
 	m_sizeX = 0;
 	m_sizeY = 0;
-	m_lstNodes[0] = 0;
-	m_lstNodes[1] = 0;
 	m_mapNodesRef = 0;
+	m_heapSize = 0;
 	m_frameID = 1;
 }
 
@@ -83,24 +76,37 @@ CAStar& CAStar::operator=(const CAStar & in_aStar)
 	Clean();
 
 	//--- Copy our map data
-	if (m_mapArray)
+	m_maxPathSize = in_aStar.m_maxPathSize;
+	if (in_aStar.m_mapArray)
 	{
 		m_sizeX = in_aStar.m_sizeX;
 		m_sizeY = in_aStar.m_sizeY;
-		m_maxPathSize = in_aStar.m_maxPathSize;
 		m_mapArray = new unsigned char [m_sizeX * m_sizeY];
 		memcpy(m_mapArray, in_aStar.m_mapArray, m_sizeX * m_sizeY);
 
 		//--- Copy the m_mapNodesRef
-		m_mapNodesRef = new CPathNode * [m_sizeX * m_sizeY];
-		memcpy(m_mapNodesRef, in_aStar.m_mapNodesRef, m_sizeX * m_sizeY);
-
-		//--- Copy the CPathNodes.
-		for (CPathNode *p = in_aStar.m_lstNodes[0]; p; p = p->next)
+		m_mapNodesRef = new int [m_sizeX * m_sizeY];
+		memcpy(m_mapNodesRef, in_aStar.m_mapNodesRef, sizeof(int) * m_sizeX * m_sizeY);
+
+		//--- Copy the nodes and their neighbors, they refer to each other by index
+		m_nodes = in_aStar.m_nodes;
+		m_neighborStart = in_aStar.m_neighborStart;
+		m_neighbors = in_aStar.m_neighbors;
+		m_neighborCosts = in_aStar.m_neighborCosts;
+		m_heap.resize(m_nodes.size());
+
+		//--- The path links point in his nodes, we move them in ours
+		int nbNode = (int)m_nodes.size();
+		for (int i=0;i<nbNode;++i)
 		{
-			CPathNode *newNode = new CPathNode(*p);
-			ASTAR_PUSH_BACK(m_lstNodes, newNode);
+			CPathNode & node = m_nodes[i];
+			if (node.parentNode) node.parentNode = &(m_nodes[in_aStar.GetNodeIndex(node.parentNode)]);
+			if (node.nextPath) node.nextPath = &(m_nodes[in_aStar.GetNodeIndex(node.nextPath)]);
+			node.m_heapIndex = -1;
 		}
+
+		//--- The nodes keep their frame IDs, we must keep counting from there
+		m_frameID = in_aStar.m_frameID;
 	}
 
 	//--- return a reference on us
@@ -128,7 +134,11 @@ void CAStar::Clean()
 	if (m_mapNodesRef) delete [] m_mapNodesRef;
 
 	//--- Delete the nodes
-	ASTAR_DELETE_LIST(m_lstNodes, CPathNode);
+	m_nodes.clear();
+	m_neighborStart.clear();
+	m_neighbors.clear();
+	m_neighborCosts.clear();
+	m_heap.clear();
 
 	//--- We reinit the members now
 	InitMembers();
@@ -194,7 +204,7 @@ int CAStar::Build(const unsigned char * in_mapArray,
 	m_sizeY = in_sizeY;
 	m_mapArray = new unsigned char [m_sizeX * m_sizeY];
 	memcpy(m_mapArray, in_mapArray, m_sizeX * m_sizeY);
-	m_mapNodesRef = new CPathNode *[m_sizeX * m_sizeY];
+	m_mapNodesRef = new int [m_sizeX * m_sizeY];
 
 	//--- Alright, create the nodes recursively
 	int x,y;
@@ -206,12 +216,18 @@ int CAStar::Build(const unsigned char * in_mapArray,
 		}
 	}
 
-	//--- Ok, now create the neighborhood list.
+	//--- Ok, now create the neighborhood list. Node by node, they are packed in order.
 	CPathNode* p;
 	CPathNode* n;
 	int lastSize;
-	for (p = m_lstNodes[0]; p; p = p->next)
+	int nbNode = (int)m_nodes.size();
+	int i;
+	m_neighborStart.resize(nbNode + 1);
+	for (i = 0; i < nbNode; ++i)
 	{
+		p = &(m_nodes[i]);
+		m_neighborStart[i] = (int)m_neighbors.size();
+
 		//--- Top
 		y = p->m_y - 1;
 		lastSize = 1;
@@ -221,7 +237,7 @@ int CAStar::Build(const unsigned char * in_mapArray,
 			if (n)
 			{
 				lastSize = n->m_sizeX;
-				if (p->m_value == n->m_value && !CheckForDiagonalBlocker(p, n)) p->AddNeighbor(n);
+				if (p->m_value == n->m_value && !CheckForDiagonalBlocker(p, n)) AddNeighbor(i, m_mapNodesRef[y * m_sizeX + x]);
 			}
 			else
 			{
@@ -238,7 +254,7 @@ int CAStar::Build(const unsigned char * in_mapArray,
 			if (n)
 			{
 				lastSize = n->m_sizeX;
-				if (p->m_value == n->m_value && !CheckForDiagonalBlocker(p, n)) p->AddNeighbor(n);
+				if (p->m_value == n->m_value && !CheckForDiagonalBlocker(p, n)) AddNeighbor(i, m_mapNodesRef[y * m_sizeX + x]);
 			}
 			else
 			{
@@ -255,7 +271,7 @@ int CAStar::Build(const unsigned char * in_mapArray,
 			if (n)
 			{
 				lastSize = n->m_sizeY;
-				if (p->m_value == n->m_value && !CheckForDiagonalBlocker(p, n)) p->AddNeighbor(n);
+				if (p->m_value == n->m_value && !CheckForDiagonalBlocker(p, n)) AddNeighbor(i, m_mapNodesRef[y * m_sizeX + x]);
 			}
 			else
 			{
@@ -272,7 +288,7 @@ int CAStar::Build(const unsigned char * in_mapArray,
 			if (n)
 			{
 				lastSize = n->m_sizeY;
-				if (p->m_value == n->m_value && !CheckForDiagonalBlocker(p, n)) p->AddNeighbor(n);
+				if (p->m_value == n->m_value && !CheckForDiagonalBlocker(p, n)) AddNeighbor(i, m_mapNodesRef[y * m_sizeX + x]);
 			}
 			else
 			{
@@ -280,6 +296,10 @@ int CAStar::Build(const unsigned char * in_mapArray,
 			}
 		}
 	}
+	m_neighborStart[nbNode] = (int)m_neighbors.size();
+
+	//--- The open list can't be bigger than that
+	m_heap.resize(nbNode);
 	
 	//--- Successful
 	return 1;
@@ -317,23 +337,47 @@ void CAStar::CreateNodes(int in_x, int in_y, int in_size)
 	}
 
 	//--- If we didn't stop, we have our node!
-	CPathNode *newNode = new CPathNode();
-	newNode->m_x = in_x;
-	newNode->m_y = in_y;
-	newNode->m_sizeX = in_size;
-	newNode->m_sizeY = in_size;
-	newNode->m_value = value;
-	newNode->m_centerX = (float)in_x + (float)in_size * .5f;
-	newNode->m_centerY = (float)in_y + (float)in_size * .5f;
-	ASTAR_PUSH_BACK(m_lstNodes, newNode);
+	CPathNode newNode;
+	newNode.m_x = in_x;
+	newNode.m_y = in_y;
+	newNode.m_sizeX = in_size;
+	newNode.m_sizeY = in_size;
+	newNode.m_value = value;
+	newNode.m_centerX = (float)in_x + (float)in_size * .5f;
+	newNode.m_centerY = (float)in_y + (float)in_size * .5f;
+	int index = (int)m_nodes.size();
+	m_nodes.push_back(newNode);
 
 	//--- Fill the m_mapNodesRef
 	for (y=in_y;y<in_y+in_size;++y)
 	{
 		for (x=in_x;x<in_x+in_size;++x)
 		{
-			m_mapNodesRef[(y * m_sizeX) + x] = newNode;
+			m_mapNodesRef[(y * m_sizeX) + x] = index;
 		}
 	}
 }
+
+
+
+//
+//--- Add a neighbor to the node we are doing
+//
+void CAStar::AddNeighbor(int in_node, int in_neighbor)
+{
+	//--- Check if not already registered
+	int i;
+	for (i=m_neighborStart[in_node];i<(int)m_neighbors.size();++i)
+	{
+		if (m_neighbors[i] == in_neighbor) return; //--- Ok good
+	}
+
+	//--- Register it and compute his cost from center to center
+	const CPathNode & p = m_nodes[in_node];
+	const CPathNode & n = m_nodes[in_neighbor];
+	m_neighbors.push_back(in_neighbor);
+	m_neighborCosts.push_back(sqrtf(
+		(n.m_centerX - p.m_centerX) * (n.m_centerX - p.m_centerX) +
+		(n.m_centerY - p.m_centerY) * (n.m_centerY - p.m_centerY)));
+}
 #endif
@@ -35,7 +35,7 @@
 
 
 #include "CPathNode.h"
-#include <list>
+#include <vector>
 
 
 class CAStar
@@ -120,19 +120,30 @@ public:
 		}
 	}
 
-	/** Get the head list of the nodes */
-	CPathNode *GetNodes() const {return m_lstNodes[0];}
+	/** Get the node count */
+	int GetNodeCount() const {return (int)m_nodes.size();}
+
+	/** Get a node by its index, 0 to GetNodeCount() - 1 */
+	CPathNode *GetNode(int in_index) {return &(m_nodes[in_index]);}
+
+	/** Get the index of a node */
+	int GetNodeIndex(const CPathNode * in_node) const {return (int)(in_node - &(m_nodes[0]));}
 
 	/** Get a node at a certain position on the map */
-	CPathNode *GetNodeAt(int in_x, int in_y) const
+	CPathNode *GetNodeAt(int in_x, int in_y)
 	{
 		if (in_x < 0) return 0;
 		if (in_y < 0) return 0;
 		if (in_x >= m_sizeX) return 0;
 		if (in_y >= m_sizeY) return 0;
-		return m_mapNodesRef[in_y * m_sizeX + in_x];
+		return &(m_nodes[m_mapNodesRef[in_y * m_sizeX + in_x]]);
 	}
 
+	/** The neighbors of a node are from GetNeighborStart(in_index) to GetNeighborStart(in_index + 1) - 1 */
+	int GetNeighborStart(int in_index) const {return m_neighborStart[in_index];}
+	int GetNeighbor(int in_i) const {return m_neighbors[in_i];}
+	float GetNeighborCost(int in_i) const {return m_neighborCosts[in_i];}
+
 	/** Find the path !!! finally */
 	CPathNode *FindPath(CPathNode* in_start, CPathNode* in_end);
 	
@@ -151,19 +162,46 @@ private:
 	*/
 	void CreateNodes(int in_x, int in_y, int in_size);
 
+	/** Add a neighbor to the last node, if it's not already there.
+	* Nodes must be done in order, their neighbors are packed one after the other.
+	* @param in_node The node we are doing
+	* @param in_neighbor His neighbor
+	* @return Nothing.
+	*/
+	void AddNeighbor(int in_node, int in_neighbor);
+
+	/** The open list, a binary heap on fScore.
+	* Each node knows where it is in the heap, so we can move it up when its score drops.
+	*/
+	void HeapPush(int in_node);
+	int HeapPop();
+	void HeapUp(int in_position);
+	void HeapDown(int in_position);
+
 private:
 	/** A copy of the map array */
 	unsigned char* m_mapArray;
 
-	/** This is the array containing all the node */
-	CPathNode **m_mapNodesRef;
+	/** The node index of each cell of the map */
+	int *m_mapNodesRef;
 
 	/** The map dimensions */
 	int m_sizeX;
 	int m_sizeY;
 
-	/** Pathnode list */ // lol voir que jfais une liste  la old school
-	CPathNode * m_lstNodes[2];
+	/** All the nodes, one after the other */
+	std::vector<CPathNode> m_nodes;
+
+	/** The neighbors, packed. Those of node i are from m_neighborStart[i] to m_neighborStart[i + 1] - 1 */
+	std::vector<int> m_neighborStart;
+	std::vector<int> m_neighbors;
+
+	/** The cost to go to each of them, from center to center */
+	std::vector<float> m_neighborCosts;
+
+	/** The open list, node indices */
+	std::vector<int> m_heap;
+	int m_heapSize;
 
 	/** The maximum path size.
 	* Note that the minimum is always 1.
@@ -171,7 +209,7 @@ private:
 	int m_maxPathSize;
 
 public:
-	/** The current search frame ID */
+	/** The current search frame ID. A node is open at m_frameID and closed at m_frameID + 1 */
 	unsigned long m_frameID;
 };
 
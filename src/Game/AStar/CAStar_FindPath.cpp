@@ -23,6 +23,20 @@
 
 
 
+//
+//--- Straight distance between the centers, this is our H.
+//    The moves cost the same distance (see AddNeighbor), so H never says more than
+//    what is left to walk and a closed node never needs to be opened again.
+//
+static inline float AStarHeuristic(const CPathNode * in_from, const CPathNode * in_to)
+{
+	float dx = in_to->m_centerX - in_from->m_centerX;
+	float dy = in_to->m_centerY - in_from->m_centerY;
+	return sqrtf(dx * dx + dy * dy);
+}
+
+
+
 //
 //--- Find the path.
 //    Here we avoid recusivity for speed.
@@ -44,49 +58,29 @@ CPathNode *CAStar::FindPath(CPathNode* in_start, CPathNode* in_end)
 		return 0;
 	}
 
-	//--- Loop until we have next node to check.
-	unsigned int i, nbNeighbor;
-	CPathNode* current = in_start;
-	current->gScore = 0;
-	CPathNode* sorted = 0;
-	CPathNode* n;
-	CPathNode* p;
-	CPathNode* bestSoFar = in_start;
-	m_frameID += 2; // Increment frameID to initiate all the nodePath
-	float d1, d2;
+	//--- Increment frameID to initiate all the nodePath. m_frameID is open, m_frameID + 1 is closed
+	m_frameID += 2;
+	unsigned long closedID = m_frameID + 1;
+	m_heapSize = 0;
 
 	//--- Compute the initiate score
+	CPathNode* current = in_start;
+	CPathNode* bestSoFar = in_start;
+	CPathNode* n;
 	current->gScore = 0;
-	d1 = fabsf(in_end->m_centerX - current->m_centerX);
-	d2 = fabsf(in_end->m_centerY - current->m_centerY);
-	if (d1 > d2) current->hScore = d1 - d2 + d2 * 1.414214f;
-	else if (d2 > d1) current->hScore = d2 - d1 + d1 * 1.414214f;
-	else current->hScore = d1 * 1.414214f;
+	current->hScore = AStarHeuristic(current, in_end);
 	current->fScore = current->hScore + current->gScore;
+	current->m_frameID = m_frameID;
+	HeapPush((int)(current - &(m_nodes[0])));
 
-	while (current)
+	//--- Loop until we have next node to check.
+	while (m_heapSize)
 	{
-		//--- Invalidate that node for further search
-		current->m_frameID = m_frameID;
+		int index = HeapPop();
+		current = &(m_nodes[index]);
 
-		//--- Check if we don't have a more optimized parent
-		nbNeighbor = (unsigned int)current->m_neighbors.size();
-		if (current->parentNode)
-		{
-			for (i=0;i<nbNeighbor;++i)
-			{
-				n = current->m_neighbors[i];
-				if (n->m_frameID >= m_frameID && current->parentNode != n)
-				{
-					if (n->gScore + current->m_neighborsHeuristic[i] < current->gScore)
-					{
-						current->parentNode = n;
-						current->gScore = n->gScore + current->m_neighborsHeuristic[i];
-						current->fScore = current->gScore + current->hScore;
-					}
-				}
-			}
-		}
+		//--- Invalidate that node for further search
+		current->m_frameID = closedID;
 
 		//--- Update our best so far
 		if (current->hScore < bestSoFar->hScore) bestSoFar = current;
@@ -94,69 +88,112 @@ CPathNode *CAStar::FindPath(CPathNode* in_start, CPathNode* in_end)
 		//--- We found it?
 		if (current == in_end) return in_end; // !!!! yea!
 
-		//--- Register his neighbors to the sorted queue list
-		for (i=0;i<nbNeighbor;++i)
+		//--- Register his neighbors to the open list, or give them a shorter way
+		int last = m_neighborStart[index + 1];
+		for (int i=m_neighborStart[index];i<last;++i)
 		{
-			n = current->m_neighbors[i];
-			if (n->m_frameID < m_frameID)
+			n = &(m_nodes[m_neighbors[i]]);
+			if (n->m_frameID == closedID) continue;
+
+			//--- Compute G,H and F
+			//	  H = direct distance to arrival
+			//	  G = walked distance from start
+			//	  F = G + H, total score
+			float gScore = current->gScore + m_neighborCosts[i];
+			if (n->m_frameID != m_frameID)
 			{
-				//--- Compute G,H and F
-				//	  H = direct distance to arrival
-				//	  G = walked distance from start
-				//	  F = G + H, total score
-				n->gScore = current->gScore + current->m_neighborsHeuristic[i];
-				d1 = fabsf(in_end->m_centerX - n->m_centerX);
-				d2 = fabsf(in_end->m_centerY - n->m_centerY);
-				if (d1 > d2) n->hScore = d1 - d2 + d2 * 1.414214f;
-				else if (d2 > d1) n->hScore = d2 - d1 + d1 * 1.414214f;
-				else n->hScore = d1 * 1.414214f;
+				n->gScore = gScore;
+				n->hScore = AStarHeuristic(n, in_end);
 				n->fScore = n->hScore + n->gScore;
 				n->parentNode = current;
 				n->m_frameID = m_frameID;
-
-				//--- Add to list here (The slow way first, just to make it work)
-				for (p=sorted;p;p=p->sortedNext)
-				{
-					if (n->fScore <= p->fScore)
-					{
-						if (p->sortedPrevious) p->sortedPrevious->sortedNext = n;
-						n->sortedPrevious = p->sortedPrevious;
-						n->sortedNext = p;
-						p->sortedPrevious = n;
-						if (!n->sortedPrevious) sorted = n;
-						break;
-					}
-					else if (!p->sortedNext)
-					{
-						p->sortedNext = n;
-						n->sortedPrevious = p;
-						n->sortedNext = 0;
-						break;
-					}
-				}
-				if (!p)
-				{
-					sorted = n;
-					n->sortedNext = 0;
-					n->sortedPrevious = 0;
-				}
+				HeapPush(m_neighbors[i]);
+			}
+			else if (gScore < n->gScore)
+			{
+				n->gScore = gScore;
+				n->fScore = n->hScore + n->gScore;
+				n->parentNode = current;
+				HeapUp(n->m_heapIndex);
 			}
-		}
-
-		//--- Remove now the first from the list, and use it to check the next one
-		if (sorted)
-		{
-			current = sorted;
-			sorted = sorted->sortedNext;
-			if (sorted) sorted->sortedPrevious = 0;
-		}
-		else
-		{
-			//--- Finish, nothing found
-			current = 0;
 		}
 	}
 
+	//--- Finish, nothing found
 	return bestSoFar;
 }
+
+
+
+//
+//--- Add a node to the open list
+//
+void CAStar::HeapPush(int in_node)
+{
+	m_heap[m_heapSize] = in_node;
+	m_nodes[in_node].m_heapIndex = m_heapSize;
+	HeapUp(m_heapSize++);
+}
+
+
+
+//
+//--- Take out the node with the lowest fScore
+//
+int CAStar::HeapPop()
+{
+	int top = m_heap[0];
+	m_nodes[top].m_heapIndex = -1;
+	if (--m_heapSize)
+	{
+		m_heap[0] = m_heap[m_heapSize];
+		m_nodes[m_heap[0]].m_heapIndex = 0;
+		HeapDown(0);
+	}
+	return top;
+}
+
+
+
+//
+//--- Move a node up until his parent is better
+//
+void CAStar::HeapUp(int in_position)
+{
+	int node = m_heap[in_position];
+	float fScore = m_nodes[node].fScore;
+	while (in_position > 0)
+	{
+		int parent = (in_position - 1) / 2;
+		if (m_nodes[m_heap[parent]].fScore <= fScore) break;
+		m_heap[in_position] = m_heap[parent];
+		m_nodes[m_heap[in_position]].m_heapIndex = in_position;
+		in_position = parent;
+	}
+	m_heap[in_position] = node;
+	m_nodes[node].m_heapIndex = in_position;
+}
+
+
+
+//
+//--- Move a node down until his children are worst
+//
+void CAStar::HeapDown(int in_position)
+{
+	int node = m_heap[in_position];
+	float fScore = m_nodes[node].fScore;
+	while (true)
+	{
+		int child = in_position * 2 + 1;
+		if (child >= m_heapSize) break;
+		if (child + 1 < m_heapSize && m_nodes[m_heap[child + 1]].fScore < m_nodes[m_heap[child]].fScore) child++;
+		if (fScore <= m_nodes[m_heap[child]].fScore) break;
+		m_heap[in_position] = m_heap[child];
+		m_nodes[m_heap[in_position]].m_heapIndex = in_position;
+		in_position = child;
+	}
+	m_heap[in_position] = node;
+	m_nodes[node].m_heapIndex = in_position;
+}
 #endif
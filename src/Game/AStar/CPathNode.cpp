@@ -18,7 +18,6 @@
 
 #if defined(_PRO_)
 #include "CPathNode.h"
-#include <math.h>
 
 
 
@@ -27,8 +26,6 @@
 //
 CPathNode::CPathNode()
 {
-	next = 0;
-	previous = 0;
 	InitMembers();
 }
 
@@ -39,8 +36,6 @@ CPathNode::CPathNode()
 //
 CPathNode::CPathNode(const CPathNode & in_pathNode)
 {
-	next = 0;
-	previous = 0;
 	InitMembers();
 	*this = in_pathNode;
 }
@@ -63,14 +58,8 @@ CPathNode& CPathNode::operator=(const CPathNode & in_pathNode)
 	m_sizeX = in_pathNode.m_sizeX;
 	m_sizeY = in_pathNode.m_sizeY;
 	m_centerX = in_pathNode.m_centerX;
-	m_centerY = in_pathNode.m_centerX;
-
-	unsigned int i;
-	for (i=0;i<in_pathNode.m_neighbors.size();++i)
-	{
-		m_neighbors.push_back(in_pathNode.m_neighbors[i]);
-		m_neighborsHeuristic.push_back(in_pathNode.m_neighborsHeuristic[i]);
-	}
+	m_centerY = in_pathNode.m_centerY;
+	m_value = in_pathNode.m_value;
 
 	//--- Return a reference on us.
 	return *this;
@@ -93,34 +82,11 @@ CPathNode::~CPathNode()
 //
 void CPathNode::Clean()
 {
-	m_neighbors.clear();
-	m_neighborsHeuristic.clear();
 	InitMembers();
 }
 
 
 
-//
-//--- To add a pathNode neighbor
-//
-void CPathNode::AddNeighbor(CPathNode* in_neighbor)
-{
-	//--- Check if not already registered
-	unsigned int i;
-	for (i=0;i<m_neighbors.size();++i)
-	{
-		if (m_neighbors[i] == in_neighbor) return; //--- Ok good
-	}
-
-	//--- Register it and compute his heuristic from center to center
-	m_neighbors.push_back(in_neighbor);
-	m_neighborsHeuristic.push_back(sqrtf(
-		(in_neighbor->m_centerX - m_centerX) * (in_neighbor->m_centerX - m_centerX) +
-		(in_neighbor->m_centerY - m_centerY) * (in_neighbor->m_centerY - m_centerY)));
-}
-
-
-
 //
 //--- To init the members. Used by contructors and Clean function.
 //
@@ -139,7 +105,6 @@ void CPathNode::InitMembers()
 	fScore = 0;
 	gScore = 0;
 	hScore = 0;
-	sortedNext = 0;
-	sortedPrevious = 0;
+	m_heapIndex = -1;
 }
 #endif
@@ -21,10 +21,6 @@
 
 
 
-#include <vector>
-
-
-
 class CPathNode
 {
 public:
@@ -50,12 +46,6 @@ public:
 	*/
 	void Clean();
 
-	/** To add a pathNode neighbor
-	* @param in_neighbor The neighbor to pus in his neighbor's array.
-	* @return Nothing.
-	*/
-	void AddNeighbor(CPathNode* in_neighbor);
-
 private:
 	/** To init the members. Used by contructors and Clean function.
 	* @return Nothing.
@@ -63,33 +53,20 @@ private:
 	void InitMembers();
 
 public:
-	/** Next in the list */
-	CPathNode *next;
-
-	/** Previous in the list */
-	CPathNode *previous;
-
 	/** The next node in the path */
 	CPathNode *nextPath;
 
 	/** The node that is currently working it (his parent) */
 	CPathNode *parentNode;
 
-	/** The sorted list pointers */
-	CPathNode *sortedNext;
-	CPathNode *sortedPrevious;
+	/** Where he is in the open list heap, -1 if he's not in it */
+	int m_heapIndex;
 
 	/** The current Heuristic of this node */
 	float fScore;
 	float gScore;
 	float hScore;
 
-	/** The array of neighbors */
-	std::vector<CPathNode*> m_neighbors;
-
-	/** The heuristic array for the neighbors */
-	std::vector<float> m_neighborsHeuristic;
-
 	/** His position on the map - top left */
 	int m_x;
 	int m_y;
@@ -65,13 +65,13 @@ Client::Client(Game * pGame)
 	m_sfxOver = dksCreateSoundFromFile("main/Sounds/ControlOver.wav", false);
 
 	blink = 0;
-	tex_screenHit = dktCreateTextureFromFile("main/textures/screenHit.tga", DKT_FILTER_LINEAR);
-	tex_grenadeLeft = dktCreateTextureFromFile("main/textures/GrenadeIcon.tga", DKT_FILTER_LINEAR);
-	tex_shotgunLeft = dktCreateTextureFromFile("main/textures/CartridgeIcon.tga", DKT_FILTER_LINEAR);
-	tex_molotovLeft = dktCreateTextureFromFile("main/textures/molotovIcon.tga", DKT_FILTER_LINEAR);
-	tex_blueFlag = dktCreateTextureFromFile("main/textures/BlueFlag.tga", DKT_FILTER_LINEAR);
-	tex_redFlag = dktCreateTextureFromFile("main/textures/RedFlag.tga", DKT_FILTER_LINEAR);
-	tex_crossHit = dktCreateTextureFromFile("main/textures/CrossHit.tga", DKT_FILTER_LINEAR);
+	tex_screenHit = dktCreateTextureFromFileAsync("main/textures/screenHit.tga", DKT_FILTER_LINEAR);
+	tex_grenadeLeft = dktCreateTextureFromFileAsync("main/textures/GrenadeIcon.tga", DKT_FILTER_LINEAR);
+	tex_shotgunLeft = dktCreateTextureFromFileAsync("main/textures/CartridgeIcon.tga", DKT_FILTER_LINEAR);
+	tex_molotovLeft = dktCreateTextureFromFileAsync("main/textures/molotovIcon.tga", DKT_FILTER_LINEAR);
+	tex_blueFlag = dktCreateTextureFromFileAsync("main/textures/BlueFlag.tga", DKT_FILTER_LINEAR);
+	tex_redFlag = dktCreateTextureFromFileAsync("main/textures/RedFlag.tga", DKT_FILTER_LINEAR);
+	tex_crossHit = dktCreateTextureFromFileAsync("main/textures/CrossHit.tga", DKT_FILTER_LINEAR);
 	hitIndicator = 0;
 
 	// On hide la mouse
@@ -405,10 +405,11 @@ void Client::update(float delay)
 		// On recv les messages
 		char * buffer;
 		int messageID;
-		while (buffer = bb_clientReceive(uniqueClientID, &messageID))
+		int messageSize;
+		while (buffer = bb_clientReceive(uniqueClientID, &messageID, &messageSize))
 		{
 			// On g�re les messages re�u
-			recvPacket(buffer, messageID);
+			recvPacket(buffer, messageID, messageSize);
 		}
 
 		// Si on fait Esc, on spawn un menu
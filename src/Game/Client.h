@@ -20,9 +20,9 @@
 #define CLIENT_H
 
 #if defined(_PRO_)
-#define GAME_VERSION_CL 21100
+#define GAME_VERSION_CL 21101
 #else
-#define GAME_VERSION_CL 21000
+#define GAME_VERSION_CL 21001
 #endif
 
 #define MIN_TIME_BETWEEN_QMSG 0.9f
@@ -33,6 +33,7 @@
 #include "Button.h"
 #include "Writting.h"
 #include "CListener.h"
+#include "Snapshot.h"
 
 
 // Nos message qu'on affiche  l'cran
@@ -152,6 +153,9 @@ public:
 	//--- Le client ID
 	unsigned long uniqueClientID;
 
+	//--- The snapshots we received, our delta bases
+	CSnapshotHistory snapshotHistory;
+
 public:
 	// Constructeur
 	Client(Game * pGame);
@@ -176,7 +180,10 @@ public:
 	void printMessage(CString message);
 
 	// On a reu un message y !
-	void recvPacket(char * buffer, int typeID);
+	void recvPacket(char * buffer, int typeID, int size);
+
+	// Read a snapshot of the other players
+	void recvSnapshot(char * buffer, int size);
 
 	void MouseEnter(CControl * control);
 };
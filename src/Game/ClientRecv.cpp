@@ -33,7 +33,7 @@ extern Scene * scene;
 //
 // On a reu un message y !
 //
-void Client::recvPacket(char * buffer, int typeID)
+void Client::recvPacket(char * buffer, int typeID, int size)
 {
 #if defined(_PRO_)
    
@@ -355,6 +355,8 @@ void Client::recvPacket(char * buffer, int typeID)
 			if(isServer)
 				game->createMap();
 			game->gameType = serverInfo.gameType;
+			// The old snapshots can't be used as bases anymore. The server starts
+			// a new snapshot epoch for us, recvSnapshot drops them when it sees it
 			// On a fini de loader, on change notre status
 			if (game->thisPlayer)
 			{
@@ -488,6 +490,11 @@ void Client::recvPacket(char * buffer, int typeID)
 			}
 			break;
 		}
+	case NET_SVCL_SNAPSHOT:
+		{
+			recvSnapshot(buffer, size);
+			break;
+		}
 	case NET_CLSV_SVCL_PLAYER_COORD_FRAME:
 		{
 			net_clsv_svcl_player_coord_frame playerCoordFrame;
@@ -1233,6 +1240,106 @@ void Client::recvPacket(char * buffer, int typeID)
 
 	}
 }
+
+
+//
+// Read a snapshot of the other players
+//
+void Client::recvSnapshot(char * buffer, int size)
+{
+	if (size < (int)sizeof(net_svcl_snapshot)) return; // Corrupted
+	net_svcl_snapshot snapshot;
+	memcpy(&snapshot, buffer, sizeof(net_svcl_snapshot));
+	if (snapshot.nbEntity > SNAPSHOT_MAX_ENTITY) return;
+
+	// Out of order, we already have something newer in that slot
+	if (snapshot.snapshotID <= 0) return;
+
+	// The server dropped its bases, we drop ours. Late snapshots of the old epoch are older than what we have
+	if (snapshot.epoch != snapshotHistory.epoch)
+	{
+		if (snapshot.snapshotID <= snapshotHistory.lastSnapshotID) return;
+		snapshotHistory.startEpoch(snapshot.epoch);
+	}
+	const SSnapshotFrame & oldFrame = snapshotHistory.frames[snapshot.snapshotID % SNAPSHOT_BACKUP];
+	if (oldFrame.snapshotID >= snapshot.snapshotID) return;
+
+	// We need to read the entities before overwriting the slot, a base could be in it
+	SSnapshotState states[SNAPSHOT_MAX_ENTITY];
+	bool included[SNAPSHOT_MAX_ENTITY];
+	memset(included, 0, sizeof(included));
+	bool allValid = true;
+
+	int pos = sizeof(net_svcl_snapshot);
+	for (int i=0;i<(int)snapshot.nbEntity;++i)
+	{
+		net_svcl_snapshot_entity entity;
+		SSnapshotState state;
+		bool valid;
+		int read = snapshotReadEntity(buffer + pos, size - pos, snapshot.snapshotID, snapshotHistory, entity, state, valid);
+		if (read < 0) return; // Corrupted
+		pos += read;
+		if (entity.playerID < 0 || entity.playerID >= MAX_PLAYER) return; // Corrupted
+		if (!valid)
+		{
+			allValid = false;
+			continue;
+		}
+		states[entity.playerID] = state;
+		included[entity.playerID] = true;
+
+		Player * player = game->players[entity.playerID];
+		if (!player) continue;
+
+		player->ping = (int)state.ping;
+
+		if (entity.fields & SNAPSHOT_COORD)
+		{
+			net_clsv_svcl_player_coord_frame playerCoordFrame;
+			playerCoordFrame.playerID = entity.playerID;
+			playerCoordFrame.frameID = state.frameID;
+			memcpy(playerCoordFrame.position, state.position, sizeof(state.position));
+			memcpy(playerCoordFrame.vel, state.vel, sizeof(state.vel));
+			memcpy(playerCoordFrame.mousePos, state.mousePos, sizeof(state.mousePos));
+			playerCoordFrame.babonetID = state.babonetID;
+#if defined(_PRO_)
+			playerCoordFrame.camPosZ = 0;
+#endif
+			player->setCoordFrame(playerCoordFrame);
+		}
+#if defined(_PRO_) && defined(_MINIBOT_)
+		if (entity.fields & SNAPSHOT_MINIBOT)
+		{
+			net_svcl_minibot_coord_frame minibotCoordFrame;
+			minibotCoordFrame.playerID = entity.playerID;
+			minibotCoordFrame.frameID = state.frameID;
+			memcpy(minibotCoordFrame.position, state.botPosition, sizeof(state.botPosition));
+			memcpy(minibotCoordFrame.vel, state.botVel, sizeof(state.botVel));
+			memcpy(minibotCoordFrame.mousePos, state.botMousePos, sizeof(state.botMousePos));
+			minibotCoordFrame.babonetID = state.babonetID;
+			player->setCoordFrameMinibot(minibotCoordFrame);
+		}
+#endif
+	}
+
+	//--- Keep it, it will be the base of the next ones
+	SSnapshotFrame & frame = snapshotHistory.beginFrame(snapshot.snapshotID);
+	memcpy(frame.included, included, sizeof(included));
+	for (int i=0;i<SNAPSHOT_MAX_ENTITY;++i)
+	{
+		if (included[i]) frame.states[i] = states[i];
+	}
+	if (snapshot.snapshotID > snapshotHistory.lastSnapshotID) snapshotHistory.lastSnapshotID = snapshot.snapshotID;
+
+	// If we missed a base, the server will send these guys in full once it gets too old
+	if (allValid && game->thisPlayer)
+	{
+		net_clsv_snapshot_ack snapshotAck;
+		snapshotAck.playerID = game->thisPlayer->playerID;
+		snapshotAck.snapshotID = snapshot.snapshotID;
+		bb_clientSend(uniqueClientID, (char*)&snapshotAck, sizeof(net_clsv_snapshot_ack), NET_CLSV_SNAPSHOT_ACK, NET_UDP);
+	}
+}
 #endif
 
 
@@ -957,6 +957,7 @@ void Editor2::Click(CControl * control)
 				map->cells[index].splater[3] = 0.0f;
 			}
 		}
+		map->rebuildCollision();
 		map->regenTex();
 		map->reloadTheme();
 		map->reloadWeather();
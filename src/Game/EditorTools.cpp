@@ -52,6 +52,7 @@ unsigned int ITool::MapCellIndex(Map * map, const CVector2i & cell) const
 
 void ITool::RegenerateTextures(Map * map, const CVector2i & cell) const
 {
+	map->rebuildCollision();
 	map->regenTex();
 	map->regenCell(cell[0]-1, cell[1]+1);
 	map->regenCell(cell[0]-1, cell[1]);
@@ -639,6 +640,7 @@ void ToolAddLine::LeftClick(Editor2 * editor, float delay)
 			lastAction = 0.0f;
 			// Destroy old cells
 			delete[] temp;
+			editor->map->rebuildCollision();
 			editor->map->regenTex();
 			for(int j = 0; j < editor->map->size[1]; ++j)
 			{
@@ -710,6 +712,7 @@ void ToolAddLine::LeftClick(Editor2 * editor, float delay)
 			lastAction = 0.0f;
 			// Destroy old cells
 			delete[] temp;
+			editor->map->rebuildCollision();
 			editor->map->regenTex();
 			for(int j = 0; j < editor->map->size[1]; ++j)
 			{
@@ -859,6 +862,7 @@ void ToolRemoveLine::LeftClick(Editor2 * editor, float delay)
 			lastAction = 0.0f;
 			// Destroy old cells
 			delete[] temp;
+			editor->map->rebuildCollision();
 			editor->map->regenTex();
 			for(int j = 0; j < editor->map->size[1]; ++j)
 			{
@@ -920,6 +924,7 @@ void ToolRemoveLine::LeftClick(Editor2 * editor, float delay)
 			lastAction = 0.0f;
 			// Destroy old cells
 			delete[] temp;
+			editor->map->rebuildCollision();
 			editor->map->regenTex();
 			for(int j = 0; j < editor->map->size[1]; ++j)
 			{
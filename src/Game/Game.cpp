@@ -246,6 +246,13 @@ void Game::resetRound()
 void Game::createMap()
 {
 	ZEVEN_SAFE_DELETE(map);
+
+	//--- The frames of the last map mean nothing here
+	rewindClock.reset();
+	for (int i=0;i<MAX_PLAYER;++i)
+	{
+		if (players[i] && players[i]->positionHistory) players[i]->positionHistory->reset();
+	}
 	srand((unsigned int)time(0));//mapSeed); // Fuck le mapSeed, on l'utilise pus
 
 	if(scene->server) {
@@ -307,6 +314,10 @@ void Game::createMap()
 		}
 #endif
 	}
+
+	//--- The grid follows the map cells, the players fill it back on their next update
+	playerGrid.resize(map->size[0], map->size[1]);
+
 	dkcJumpToFrame(0);
 }
 
@@ -389,23 +400,33 @@ void Game::update(float delay)
 
 	if (roundState == GAME_PLAYING)
 	{
+		//--- Remember where everybody is, before they move, for the lag compensation
+		if (isServerGame) recordPositions(delay);
+
 		// On update les players
 		for (int i=0;i<MAX_PLAYER;++i) 
 		{
 			if (players[i])
 			{
 				players[i]->update(delay);
+				playerGrid.update(i, players[i]->currentCF.position);
 
 				if (players[i]->incShot > 0)
 				{
 					players[i]->incShot--;
 					if (players[i]->incShot%3 == 0)
 					{
+						//--- We test against the players where he saw them
+						long rewindFrame = getShooterFrame(players[i]);
+
 						// On test premirement si on touche un autre joueur!
 						Player * hitPlayer = 0;
 						CVector3f p3 = players[i]->p2;
-						for (int j=0;j<MAX_PLAYER;j++)
+						int nearPlayers[SPATIAL_MAX_ENTITY];
+						int nbNear = getPlayersOnSegment(players[i]->p1, p3, .35f, rewindFrame, nearPlayers);
+						for (int n=0;n<nbNear;n++)
 						{
+							int j = nearPlayers[n];
 							if (players[j])
 							{
 								if (j != i)
@@ -417,7 +438,8 @@ void Game::update(float delay)
 #endif
 									{
 										// Ray to sphere test
-										if (segmentToSphere(players[i]->p1, p3, players[j]->currentCF.position, .35f))
+										CVector3f targetPos = getRewoundPosition(players[j], rewindFrame);
+										if (segmentToSphere(players[i]->p1, p3, targetPos, .35f))
 										{
 											hitPlayer = players[j];
 											p3 = players[i]->p2; // Full length
@@ -1207,8 +1229,11 @@ void Game::shoot(const CVector3f & position, const CVector3f & direction, float
 //
 Player * Game::playerInRadius(CVector3f position, float radius, int ignore )
 {
-	for (int i=0;i<MAX_PLAYER;++i)
+	int nearPlayers[SPATIAL_MAX_ENTITY];
+	int nbNear = playerGrid.querySphere(position, radius+.25f, nearPlayers);
+	for (int n=0;n<nbNear;++n)
 	{
+		int i = nearPlayers[n];
 		if (players[i])
 		{
 			if (players[i]->status == PLAYER_STATUS_ALIVE && i != ignore)
@@ -1311,8 +1336,11 @@ void Game::shootMinibotSV(CMiniBot * minibot, float imp, CVector3f p1, CVector3f
 
 	// On test premirement si on touche un autre joueur!
 	Player * hitPlayer = 0;
-	for (int i=0;i<MAX_PLAYER;i++)
+	int nearPlayers[SPATIAL_MAX_ENTITY];
+	int nbNear = playerGrid.querySegment(p1, p2, .25f, nearPlayers);
+	for (int n=0;n<nbNear;n++)
 	{
+		int i = nearPlayers[n];
 		if (players[i])
 		{
 			if (i != minibot->owner->playerID)
@@ -1478,6 +1506,9 @@ void Game::shootSV(int playerID, int nuzzleID, float imp, CVector3f p1, CVector3
 		isCollision = true;
 	}
 
+	//--- The players are tested where he saw them
+	long rewindFrame = getShooterFrame(player);
+
 	if (player->weapon->weaponID == WEAPON_PHOTON_RIFLE || player->weapon->weaponID == WEAPON_FLAME_THROWER)
 	{
 		if (player->weapon->weaponID == WEAPON_PHOTON_RIFLE)
@@ -1487,10 +1518,13 @@ void Game::shootSV(int playerID, int nuzzleID, float imp, CVector3f p1, CVector3
 			player->incShot = 30;
 		}
 		CVector3f p3 = p2;
+		int nearPlayers[SPATIAL_MAX_ENTITY];
+		int nbNear = getPlayersOnSegment(p1, p3, (player->weapon->weaponID == WEAPON_FLAME_THROWER)?.50f:.25f, rewindFrame, nearPlayers);
 		// On test premirement si on touche un autre joueur!
 		Player * hitPlayer = 0;
-		for (int i=0;i<MAX_PLAYER;i++)
+		for (int n=0;n<nbNear;n++)
 		{
+			int i = nearPlayers[n];
 			if (players[i])
 			{
 				if (i != player->playerID)
@@ -1502,7 +1536,8 @@ void Game::shootSV(int playerID, int nuzzleID, float imp, CVector3f p1, CVector3
 #endif					
 					{
 						// Ray to sphere test
-						if (segmentToSphere(p1, p3, players[i]->currentCF.position, (player->weapon->weaponID == WEAPON_FLAME_THROWER)?.50f:.25f))
+						CVector3f targetPos = getRewoundPosition(players[i], rewindFrame);
+						if (segmentToSphere(p1, p3, targetPos, (player->weapon->weaponID == WEAPON_FLAME_THROWER)?.50f:.25f))
 						{
 							isCollision = true;
 							hitPlayer = players[i];
@@ -1537,10 +1572,13 @@ void Game::shootSV(int playerID, int nuzzleID, float imp, CVector3f p1, CVector3
 	}
 	else
 	{
+		int nearPlayers[SPATIAL_MAX_ENTITY];
+		int nbNear = getPlayersOnSegment(p1, p2, .25f, rewindFrame, nearPlayers);
 		// On test premirement si on touche un autre joueur!
 		Player * hitPlayer = 0;
-		for (int i=0;i<MAX_PLAYER;i++)
+		for (int n=0;n<nbNear;n++)
 		{
+			int i = nearPlayers[n];
 			if (players[i])
 			{
 				if (i != player->playerID)
@@ -1548,7 +1586,8 @@ void Game::shootSV(int playerID, int nuzzleID, float imp, CVector3f p1, CVector3
 					if (players[i]->status == PLAYER_STATUS_ALIVE)
 					{
 						// Ray to sphere test
-						if (segmentToSphere(p1, p2, players[i]->currentCF.position, .25f))
+						CVector3f targetPos = getRewoundPosition(players[i], rewindFrame);
+						if (segmentToSphere(p1, p2, targetPos, .25f))
 						{
 							isCollision = true;
 							hitPlayer = players[i];
@@ -1592,6 +1631,81 @@ void Game::shootSV(int playerID, int nuzzleID, float imp, CVector3f p1, CVector3
 
 
 
+//
+// Remember where every player is at this frame
+//
+void Game::recordPositions(float delay)
+{
+	rewindClock.advance(delay);
+
+	for (int i=0;i<MAX_PLAYER;++i)
+	{
+		if (players[i])
+		{
+			if (players[i]->status == PLAYER_STATUS_ALIVE)
+			{
+				if (!players[i]->positionHistory) players[i]->positionHistory = new CPositionHistory();
+
+				//--- How far he went since the last frame, to know how wide to look when rewinding
+				CVector3f lastPosition;
+				if (players[i]->positionHistory->getPosition(rewindClock.frameID - 1, lastPosition))
+				{
+					rewindClock.addStep(distance(lastPosition, players[i]->currentCF.position));
+				}
+
+				players[i]->positionHistory->record(rewindClock.frameID, players[i]->currentCF.position);
+			}
+			else if (players[i]->positionHistory)
+			{
+				//--- He will respawn somewhere else, his old positions are no good
+				players[i]->positionHistory->reset();
+			}
+		}
+	}
+}
+
+
+
+//
+// The frame the shooter was looking at
+//
+long Game::getShooterFrame(Player * shooter)
+{
+	//--- His ping is a round trip counted in frames, and both ways are behind us: the
+	//    positions he saw came to him one way, his shot came back the other way.
+	//    His interpolation then shows the others one snapshot interval late.
+	return rewindClock.getRewindFrame(shooter->ping + shooter->snapshotInterval, (float)gameVar.sv_maxRewind / 1000.0f);
+}
+
+
+
+//
+// Where was that player at that frame
+//
+CVector3f Game::getRewoundPosition(Player * target, long frame)
+{
+	CVector3f position;
+	if (frame >= rewindClock.frameID || !target->positionHistory ||
+		!target->positionHistory->getPosition(frame, position))
+	{
+		return target->currentCF.position;
+	}
+	return position;
+}
+
+
+
+//
+// The players near a ray
+//
+int Game::getPlayersOnSegment(const CVector3f & p1, const CVector3f & p2, float radius, long frame, int * result)
+{
+	//--- They may have been farther when the shooter saw them
+	return playerGrid.querySegment(p1, p2, radius + rewindClock.getTravel(frame), result);
+}
+
+
+
 //
 // Pour toucher les joueurs dans un rayon
 //
@@ -1604,8 +1718,18 @@ void Game::radiusHit(CVector3f & pos, float radius, char fromID, char weaponID,
 	// Est-ce que ce joueur existe toujours?
 	if (players[fromID])
 	{
-		for (int i=0;i<MAX_PLAYER;++i)
+		int nearPlayers[SPATIAL_MAX_ENTITY];
+		int nbNear = playerGrid.querySphere(position, radius, nearPlayers);
+
+		//--- Who is in the radius
+		Player * targets[SPATIAL_MAX_ENTITY];
+		float targetDis[SPATIAL_MAX_ENTITY];
+		CVector3f ends[SPATIAL_MAX_ENTITY];
+		bool hidden[SPATIAL_MAX_ENTITY];
+		int nbTarget = 0;
+		for (int n=0;n<nbNear;++n)
 		{
+			int i = nearPlayers[n];
 			if (fromID == i)
 			{
 				if (weaponID == WEAPON_KNIVES) continue;
@@ -1617,28 +1741,37 @@ void Game::radiusHit(CVector3f & pos, float radius, char fromID, char weaponID,
 				float dis = distance(player->currentCF.position, position);
 				if (dis < radius)
 				{
-					CVector3f p1 = position;
-					CVector3f p2 = player->currentCF.position;
-					CVector3f normal;
-					// On le touche si y a pas un mur qui intercept!
-					if (!map->rayTest(p1, p2, normal))
-					{
-						CVector3f dir = player->currentCF.position - position;
-						normalize(dir);
-					/*	net_svcl_player_hit playerHit;
-						playerHit.damage = (1 - (dis / radius)) * gameVar.weapons[weaponID]->damage;
-						playerHit.playerID = (char)i;
-						playerHit.fromID = fromID;
-						playerHit.weaponID = weaponID;
-						playerHit.vel[0] = (char)((dir[0] * playerHit.damage * 10) / 10.0f);
-						playerHit.vel[1] = (char)((dir[1] * playerHit.damage * 10) / 10.0f);
-						playerHit.vel[2] = (char)((dir[2] * playerHit.damage * 10) / 10.0f);
-						bb_serverSend((char*)&playerHit,sizeof(net_svcl_player_hit),NET_SVCL_PLAYER_HIT,0);*/
-						player->hitSV(gameVar.weapons[weaponID], players[fromID], ((sameDmg)?1:(1 - (dis / radius))) * gameVar.weapons[weaponID]->damage);
-					}
+					targets[nbTarget] = player;
+					targetDis[nbTarget] = dis;
+					ends[nbTarget] = player->currentCF.position;
+					nbTarget++;
 				}
 			}
 		}
+
+		// On le touche si y a pas un mur qui intercept! (all the rays in one go)
+		map->rayTestBatch(position, ends, nbTarget, hidden);
+
+		for (int t=0;t<nbTarget;++t)
+		{
+			if (!hidden[t])
+			{
+				Player * player = targets[t];
+				float dis = targetDis[t];
+				CVector3f dir = player->currentCF.position - position;
+				normalize(dir);
+				/*	net_svcl_player_hit playerHit;
+					playerHit.damage = (1 - (dis / radius)) * gameVar.weapons[weaponID]->damage;
+					playerHit.playerID = (char)i;
+					playerHit.fromID = fromID;
+					playerHit.weaponID = weaponID;
+					playerHit.vel[0] = (char)((dir[0] * playerHit.damage * 10) / 10.0f);
+					playerHit.vel[1] = (char)((dir[1] * playerHit.damage * 10) / 10.0f);
+					playerHit.vel[2] = (char)((dir[2] * playerHit.damage * 10) / 10.0f);
+					bb_serverSend((char*)&playerHit,sizeof(net_svcl_player_hit),NET_SVCL_PLAYER_HIT,0);*/
+				player->hitSV(gameVar.weapons[weaponID], players[fromID], ((sameDmg)?1:(1 - (dis / radius))) * gameVar.weapons[weaponID]->damage);
+			}
+		}
 	}
 }
 
@@ -26,6 +26,8 @@
 #include <map>
 #include "netPacket.h"
 #include "MemIO.h"
+#include "LagCompensation.h"
+#include "SpatialGrid.h"
 
 
 class Client;
@@ -461,6 +463,12 @@ public:
 #endif
 	bool isServerGame;
 
+	// Server only, the frames the player positions are recorded at
+	CRewindClock rewindClock;
+
+	// Where the players are on the map, for the hit and radius tests
+	CSpatialGrid playerGrid;
+
 	// Notre map
 	Map * map;
 
@@ -720,6 +728,18 @@ public:
 #endif
 private:
 	void shootSV(int playerID, int nuzzleID, float imp, CVector3f p1, CVector3f p2);
+
+	// Server only, remember where every player is at this frame
+	void recordPositions(float delay);
+
+	// Server only, the frame the shooter was looking at when he fired
+	long getShooterFrame(Player * shooter);
+
+	// Where target was at that frame, his current position if we don't know
+	CVector3f getRewoundPosition(Player * target, long frame);
+
+	// The players a ray may touch, where they were at that frame. Returns how many are in result.
+	int getPlayersOnSegment(const CVector3f & p1, const CVector3f & p2, float radius, long frame, int * result);
 };
 
 
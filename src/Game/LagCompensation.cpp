@@ -0,0 +1,155 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "LagCompensation.h"
+
+
+
+//
+// Constructeur
+//
+CRewindClock::CRewindClock()
+{
+	reset();
+}
+
+
+
+//
+// Forget everything
+//
+void CRewindClock::reset()
+{
+	frameID = 0;
+	for (int i=0;i<LAGCOMP_BACKUP;++i)
+	{
+		time[i] = 0;
+		maxStep[i] = 0;
+	}
+}
+
+
+
+//
+// One more frame
+//
+void CRewindClock::advance(float delay)
+{
+	float now = time[frameID % LAGCOMP_BACKUP] + delay;
+	frameID++;
+	time[frameID % LAGCOMP_BACKUP] = now;
+	maxStep[frameID % LAGCOMP_BACKUP] = 0;
+}
+
+
+
+//
+// The frame the shooter was seeing
+//
+long CRewindClock::getRewindFrame(int nbFrame, float maxRewind) const
+{
+	if (nbFrame <= 0 || maxRewind <= 0) return frameID;
+	if (nbFrame > LAGCOMP_BACKUP - 1) nbFrame = LAGCOMP_BACKUP - 1;
+
+	float now = time[frameID % LAGCOMP_BACKUP];
+	long frame = frameID;
+	for (int i=0;i<nbFrame && frame > 0;++i)
+	{
+		//--- Too far back, we stop at the last frame allowed
+		if (now - time[(frame - 1) % LAGCOMP_BACKUP] > maxRewind) break;
+		frame--;
+	}
+
+	return frame;
+}
+
+
+
+//
+// A player moved
+//
+void CRewindClock::addStep(float step)
+{
+	if (step > maxStep[frameID % LAGCOMP_BACKUP]) maxStep[frameID % LAGCOMP_BACKUP] = step;
+}
+
+
+
+//
+// How far since that frame
+//
+float CRewindClock::getTravel(long frame) const
+{
+	if (frame < frameID - (LAGCOMP_BACKUP - 1)) frame = frameID - (LAGCOMP_BACKUP - 1);
+
+	float travel = 0;
+	for (long i=frame+1;i<=frameID;++i) travel += maxStep[i % LAGCOMP_BACKUP];
+	return travel;
+}
+
+
+
+//
+// Constructeur
+//
+CPositionHistory::CPositionHistory()
+{
+	reset();
+}
+
+
+
+//
+// Forget everything
+//
+void CPositionHistory::reset()
+{
+	for (int i=0;i<LAGCOMP_BACKUP;++i) frameID[i] = -1;
+}
+
+
+
+//
+// Remember his position
+//
+void CPositionHistory::record(long frame, const CVector3f & position)
+{
+	int slot = frame % LAGCOMP_BACKUP;
+	frameID[slot] = frame;
+	posX[slot] = position[0];
+	posY[slot] = position[1];
+	posZ[slot] = position[2];
+}
+
+
+
+//
+// Where was he
+//
+bool CPositionHistory::getPosition(long frame, CVector3f & position) const
+{
+	if (frame < 0) return false;
+
+	int slot = frame % LAGCOMP_BACKUP;
+	if (frameID[slot] != frame) return false;
+
+	position[0] = posX[slot];
+	position[1] = posY[slot];
+	position[2] = posZ[slot];
+	return true;
+}
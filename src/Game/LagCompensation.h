@@ -0,0 +1,90 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef LAGCOMPENSATION_H
+#define LAGCOMPENSATION_H
+
+
+#include "CVector.h"
+
+// How many server frames we remember. 64 frames is 2 sec on a dedicated
+// server (30 fps) and half a second on a game hosted by a client (120 fps).
+#define LAGCOMP_BACKUP 64
+
+
+// The server clock the histories are indexed with. One frame per Game::update.
+class CRewindClock
+{
+public:
+	// The frame being played
+	long frameID;
+
+	// Time since the game started, for each of the last frames
+	float time[LAGCOMP_BACKUP];
+
+	// The farthest a player moved during each of the last frames
+	float maxStep[LAGCOMP_BACKUP];
+
+public:
+	// Constructeur
+	CRewindClock();
+
+	// Forget everything, on a new map
+	void reset();
+
+	// One more frame went by
+	void advance(float delay);
+
+	// The frame nbFrame frames ago, but never more than maxRewind
+	// seconds nor past the history.
+	long getRewindFrame(int nbFrame, float maxRewind) const;
+
+	// A player moved that much since the last frame
+	void addStep(float step);
+
+	// How far a player may have moved since that frame
+	float getTravel(long frame) const;
+};
+
+
+// The last positions of one player. Kept as separate arrays, the hit
+// tests only read the position of one frame for each player.
+class CPositionHistory
+{
+public:
+	long frameID[LAGCOMP_BACKUP];
+	float posX[LAGCOMP_BACKUP];
+	float posY[LAGCOMP_BACKUP];
+	float posZ[LAGCOMP_BACKUP];
+
+public:
+	// Constructeur
+	CPositionHistory();
+
+	// Forget everything, when he dies or respawns
+	void reset();
+
+	// Remember where he is at that frame
+	void record(long frame, const CVector3f & position);
+
+	// Where he was at that frame, false if we don't have it
+	bool getPosition(long frame, CVector3f & position) const;
+};
+
+
+#endif
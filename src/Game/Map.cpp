@@ -19,9 +19,11 @@
 #include "Map.h"
 #include "Helper.h"
 #include "FileIO.h"
+#include "CBinaryReader.h"
 #include "Console.h"
 #include "Game.h"
 #include "Scene.h"
+#include "MapIndex.h"
 
 #ifndef DEDICATED_SERVER
 #include "CRain.h"
@@ -90,6 +92,7 @@ Map::Map(CString mapFilename, Game * _game, unsigned int font, bool editor, int
 	zoom = 0;
 #endif
 	dko_mapLM = 0;
+	cells = 0;
 	game = _game;
 
 	if (game)
@@ -119,11 +122,11 @@ Map::Map(CString mapFilename, Game * _game, unsigned int font, bool editor, int
 #endif
 
 		// Les textures
-		tex_grass = dktCreateTextureFromFile("main/textures/grass.tga", DKT_FILTER_BILINEAR);
-		tex_dirt = dktCreateTextureFromFile("main/textures/dirt1.tga", DKT_FILTER_BILINEAR);
-		tex_wall = dktCreateTextureFromFile("main/textures/dirt2.tga", DKT_FILTER_BILINEAR);
+		tex_grass = dktCreateTextureFromFileAsync("main/textures/grass.tga", DKT_FILTER_BILINEAR);
+		tex_dirt = dktCreateTextureFromFileAsync("main/textures/dirt1.tga", DKT_FILTER_BILINEAR);
+		tex_wall = dktCreateTextureFromFileAsync("main/textures/dirt2.tga", DKT_FILTER_BILINEAR);
 	
-		tex_bombMark = dktCreateTextureFromFile("main/textures/BombMark.tga", DKT_FILTER_BILINEAR);
+		tex_bombMark = dktCreateTextureFromFileAsync("main/textures/BombMark.tga", DKT_FILTER_BILINEAR);
 
 		// Les models
 		dko_flag[0] = dkoLoadFile("main/models/BlueFlag.DKO");
@@ -151,18 +154,15 @@ Map::Map(CString mapFilename, Game * _game, unsigned int font, bool editor, int
 	CString fullName = CString("main/maps/") + mapName + ".bvm";
 
 #ifndef DEDICATED_SERVER
-	// Hosts will load from file since they are also the server
-	// Ugly code was required to avoid modification of the remaining code
-	FileIO	fileObj(fullName, "rb");
-	FileIO* fptr = 0;
+	// Hosts will load from file since they are also the server,
+	// clients read what they downloaded in place
+	CBinaryReader file;
 	if (scene->server || isEditor)
-		fptr = &fileObj;
+		file.open(fullName.s);
 	else
-		fptr = &_game->mapBuffer;
-	FileIO&	file = *fptr;
-	
+		file.setBuffer(_game->mapBuffer.getData(), (int)_game->mapBytesRecieved);
 #else
-	FileIO file(fullName, "rb");
+	CBinaryReader file(fullName.s);
 #endif
 
 
@@ -226,20 +226,7 @@ Map::Map(CString mapFilename, Game * _game, unsigned int font, bool editor, int
 					author_name = gameVar.cl_mapAuthorName;
 				}
 #endif
-				size[0] = file.getInt();
-				size[1] = file.getInt();
-				cells = new map_cell[size[0]*size[1]];
-				for (j=0;j<size[1];++j)
-				{
-					for (i=0;i<size[0];++i)
-					{
-						unsigned char data = file.getUByte();
-						cells[j*size[0]+i].passable = (data & 128)?true:false;
-						cells[j*size[0]+i].height = (data & 127);
-						data = file.getUByte();
-						setTileDirt(i,j,((float)data)/255.0f);
-					}
-				}
+				loadCells(file);
 				break;
 			}
 		case 10011:
@@ -251,20 +238,7 @@ Map::Map(CString mapFilename, Game * _game, unsigned int font, bool editor, int
 					author_name = gameVar.cl_mapAuthorName;
 				}
 #endif
-				size[0] = file.getInt();
-				size[1] = file.getInt();
-				cells = new map_cell[size[0]*size[1]];
-				for (j=0;j<size[1];++j)
-				{
-					for (i=0;i<size[0];++i)
-					{
-						unsigned char data = file.getUByte();
-						cells[j*size[0]+i].passable = (data & 128)?true:false;
-						cells[j*size[0]+i].height = (data & 127);
-						data = file.getUByte();
-						setTileDirt(i,j,((float)data)/255.0f);
-					}
-				}
+				loadCells(file);
 
 				// Les flag
 				flagPodPos[0] = file.getVector3f();
@@ -306,20 +280,7 @@ Map::Map(CString mapFilename, Game * _game, unsigned int font, bool editor, int
 				int theme = file.getInt();
 				int weather = file.getInt();
 #endif
-				size[0] = file.getInt();
-				size[1] = file.getInt();
-				cells = new map_cell[size[0]*size[1]];
-				for (j=0;j<size[1];++j)
-				{
-					for (i=0;i<size[0];++i)
-					{
-						unsigned char data = file.getUByte();
-						cells[j*size[0]+i].passable = (data & 128)?true:false;
-						cells[j*size[0]+i].height = (data & 127);
-						data = file.getUByte();
-						setTileDirt(i,j,((float)data)/255.0f);
-					}
-				}
+				loadCells(file);
 
 				// Les flag
 				flagPodPos[0] = file.getVector3f();
@@ -350,38 +311,23 @@ Map::Map(CString mapFilename, Game * _game, unsigned int font, bool editor, int
 		case 20202:
 			{
 				// Common map data
-				char * author_name_buffer = file.getByteArray(25);
+				const char * author_name_buffer = (const char *)file.getSpan(25);
 #ifndef DEDICATED_SERVER
-				author_name_buffer[24] = '\0';
-				author_name.set("%.24s", author_name_buffer);
+				if (author_name_buffer) author_name.set("%.24s", author_name_buffer);
 				// Note: we DO NOT want to overwrite the author field if it's being edited
 				theme = file.getInt();
 				weather = file.getInt();
 #else
+				(void)author_name_buffer;
 				int theme = file.getInt();
 				int weather = file.getInt();
 #endif
-				delete[] author_name_buffer;
-				author_name_buffer = 0;
 
 				// for gcc compliant code
 
 				int i=0;
 
-				size[0] = file.getInt();
-				size[1] = file.getInt();
-				cells = new map_cell[size[0]*size[1]];
-				for (j=0;j<size[1];++j)
-				{
-					for (i=0;i<size[0];++i)
-					{
-						unsigned char data = file.getUByte();
-						cells[j*size[0]+i].passable = (data & 128)?true:false;
-						cells[j*size[0]+i].height = (data & 127);
-						data = file.getUByte();
-						setTileDirt(i,j,((float)data)/255.0f);
-					}
-				}
+				loadCells(file);
 				// common spawns
 				int nbSpawn = file.getInt();
 				for (i=0;i<nbSpawn;++i)
@@ -432,6 +378,8 @@ Map::Map(CString mapFilename, Game * _game, unsigned int font, bool editor, int
 				break;
 			}
 		}
+
+		if (!file.isOk()) console->add("\x4> Map file is truncated");
 	}
 
 
@@ -475,6 +423,9 @@ Map::Map(CString mapFilename, Game * _game, unsigned int font, bool editor, int
 		delete dkoFile;
 	}
 
+	//--- Pack the cells for the collisions
+	rebuildCollision();
+
 #if defined(_PRO_)
 	//--- Create the A* path
 	if (aStar) delete aStar;
@@ -996,16 +947,16 @@ void Map::reloadTheme()
 	tex_dirt = dktCreateTextureFromFile("main/textures/dirt1.tga", DKT_FILTER_BILINEAR);
 	tex_wall = dktCreateTextureFromFile("main/textures/dirt2.tga", DKT_FILTER_BILINEAR);*/
 
-	tex_grass = dktCreateTextureFromFile(CString("main/textures/themes/%s/tex_floor.tga", themeStr.s).s, DKT_FILTER_BILINEAR);
+	tex_grass = dktCreateTextureFromFileAsync(CString("main/textures/themes/%s/tex_floor.tga", themeStr.s).s, DKT_FILTER_BILINEAR);
 	if(tex_grass == 0)
-		tex_grass = dktCreateTextureFromFile(CString("main/textures/themes/grass/tex_floor.tga").s, DKT_FILTER_BILINEAR);
-	tex_dirt = dktCreateTextureFromFile(CString("main/textures/themes/%s/tex_floor_dirt.tga", themeStr.s).s, DKT_FILTER_BILINEAR);
+		tex_grass = dktCreateTextureFromFileAsync(CString("main/textures/themes/grass/tex_floor.tga").s, DKT_FILTER_BILINEAR);
+	tex_dirt = dktCreateTextureFromFileAsync(CString("main/textures/themes/%s/tex_floor_dirt.tga", themeStr.s).s, DKT_FILTER_BILINEAR);
 	if(tex_dirt == 0)
-		tex_dirt = dktCreateTextureFromFile(CString("main/textures/themes/grass/tex_floor_dirt.tga").s, DKT_FILTER_BILINEAR);
+		tex_dirt = dktCreateTextureFromFileAsync(CString("main/textures/themes/grass/tex_floor_dirt.tga").s, DKT_FILTER_BILINEAR);
 //	tex_wall_bottom = dktCreateTextureFromFile((CString("main/textures/themes/") + themeStr + "/tex_wall_bottom.tga").s, DKT_FILTER_BILINEAR);
-	tex_wall = dktCreateTextureFromFile(CString("main/textures/themes/%s/tex_wall_center.tga", themeStr.s).s, DKT_FILTER_BILINEAR);
+	tex_wall = dktCreateTextureFromFileAsync(CString("main/textures/themes/%s/tex_wall_center.tga", themeStr.s).s, DKT_FILTER_BILINEAR);
 	if(tex_wall == 0)
-		tex_wall = dktCreateTextureFromFile(CString("main/textures/themes/grass/tex_wall_center.tga").s, DKT_FILTER_BILINEAR);
+		tex_wall = dktCreateTextureFromFileAsync(CString("main/textures/themes/grass/tex_wall_center.tga").s, DKT_FILTER_BILINEAR);
 //	tex_wall_up = dktCreateTextureFromFile((CString("main/textures/themes/") + themeStr + "/tex_wall_up.tga").s, DKT_FILTER_BILINEAR);
 //	tex_wall_top = dktCreateTextureFromFile((CString("main/textures/themes/") + themeStr + "/tex_wall_top.tga").s, DKT_FILTER_BILINEAR);
 //	tex_wall_both = dktCreateTextureFromFile((CString("main/textures/themes/") + themeStr + "/tex_wall_both.tga").s, DKT_FILTER_BILINEAR);
@@ -1024,6 +975,32 @@ void Map::reloadTheme()
 
 
 
+//
+// Les cells, deux bytes par cell
+//
+void Map::loadCells(CBinaryReader & file)
+{
+	size[0] = file.getInt();
+	size[1] = file.getInt();
+	cells = new map_cell[size[0]*size[1]];
+
+	// The whole grid at once, a short file leaves the defaults
+	const unsigned char * data = file.getSpan(size[0]*size[1]*2);
+	if (!data) return;
+	for (int j=0;j<size[1];++j)
+	{
+		for (int i=0;i<size[0];++i)
+		{
+			unsigned char passable = *(data++);
+			cells[j*size[0]+i].passable = (passable & 128)?true:false;
+			cells[j*size[0]+i].height = (passable & 127);
+			setTileDirt(i,j,((float)*(data++))/255.0f);
+		}
+	}
+}
+
+
+
 //
 // Destructeur
 //
@@ -1424,10 +1401,21 @@ void Map::updateDummies()
 }
 
 
-#define TEST_DIR_X 0
-#define TEST_DIR_X_NEG 1
-#define TEST_DIR_Y 2
-#define TEST_DIR_Y_NEG 3
+//
+// The cells were loaded or edited
+//
+void Map::rebuildCollision()
+{
+	if (!cells) return;
+	collision.resize(size[0], size[1]);
+	for (int i=0;i<size[0]*size[1];++i)
+	{
+		collision.setCell(i, cells[i].passable, cells[i].height);
+	}
+	collision.buildWallDistance();
+}
+
+
 
 //
 // Pour faire un ray tracing
@@ -1462,162 +1450,55 @@ bool Map::rayTest(CVector3f & p1, CVector3f & p2, CVector3f & normal)
 		return result;
 	}
 
-	// On pogne notre cell de dpart
-	int i = (int)p1[0];
-	int j = (int)p1[1];
+	return collision.rayTest(p1, p2, normal);
+}
 
-	// On check que notre tuile n'est pas dj occup
-	if (i >= 0 &&
-		i < size[0] &&
-		j >= 0 &&
-		j < size[1])
-	{
-		if (!cells[j*size[0]+i].passable && p1[2] < cells[j*size[0]+i].height) 
-		{
-			p2 = p1;
-			return true;
-		}
-	}
-	else
-	{
-		return false;
-	}
 
 
-	// On dfini dans quel sens on va voyager (4 sens)
-	int sens;
-	if (fabsf(p2[0] - p1[0]) > fabsf(p2[1] - p1[1]))
-	{
-		if (p2[0] > p1[0])
-		{
-			sens = TEST_DIR_X;
-		}
-		else
-		{
-			sens = TEST_DIR_X_NEG;
-		}
-	}
-	else
-	{
-		if (p2[1] > p1[1])
-		{
-			sens = TEST_DIR_Y;
-		}
-		else
-		{
-			sens = TEST_DIR_Y_NEG;
-		}
-	}
+//
+// Many rays from the same point
+//
+int Map::rayTestBatch(const CVector3f & origin, CVector3f * ends, int count, bool * hits, CVector3f * normals)
+{
+	int nbHit = 0;
+	CVector3f normal;
 
-	// On while tant qu'on ne l'a pas trouv
-	float percent;
-	while (true)
+	if (dko_mapLM)
 	{
-		// On check qu'on n'a pas dpass
-		if (i < 0 ||
-			i >= size[0] ||
-			j < 0 ||
-			j >= size[1] ||
-			(sens == TEST_DIR_X && i > (int)p2[0]) ||
-			(sens == TEST_DIR_X_NEG && i < (int)p2[0]) ||
-			(sens == TEST_DIR_Y && j > (int)p2[1]) ||
-			(sens == TEST_DIR_Y_NEG && j < (int)p2[1]))
+		for (int k=0;k<count;++k)
 		{
-			return false;
-		}
-
-		switch (sens)
-		{
-		case TEST_DIR_X:
-			// On test nos 3 tuiles
-			if (rayTileTest(i, j, p1, p2, normal)) return true;
-			if (rayTileTest(i, j-1, p1, p2, normal)) return true;
-			if (rayTileTest(i, j+1, p1, p2, normal)) return true;
-
-			// On incrmente  la prochaine tuile
-			i++;
-			percent = ((float)i - p1[0]) / fabsf(p2[0] - p1[0]);
-			j = (int)(p1[1] + (p2[1] - p1[1]) * percent);
-			break;
-
-		case TEST_DIR_X_NEG:
-			// On test nos 3 tuiles
-			if (rayTileTest(i, j, p1, p2, normal)) return true;
-			if (rayTileTest(i, j-1, p1, p2, normal)) return true;
-			if (rayTileTest(i, j+1, p1, p2, normal)) return true;
-
-			// On incrmente  la prochaine tuile
-			i--;
-			percent = (p1[0] - (float)(i+1)) / fabsf(p2[0] - p1[0]);
-			j = (int)(p1[1] + (p2[1] - p1[1]) * percent);
-			break;
-
-		case TEST_DIR_Y:
-			// On test nos 3 tuiles
-			if (rayTileTest(i, j, p1, p2, normal)) return true;
-			if (rayTileTest(i-1, j, p1, p2, normal)) return true;
-			if (rayTileTest(i+1, j, p1, p2, normal)) return true;
-
-			// On incrmente  la prochaine tuile
-			j++;
-			percent = ((float)j - p1[1]) / fabsf(p2[1] - p1[1]);
-			i = (int)(p1[0] + (p2[0] - p1[0]) * percent);
-			break;
-
-		case TEST_DIR_Y_NEG:
-			// On test nos 3 tuiles
-			if (rayTileTest(i, j, p1, p2, normal)) return true;
-			if (rayTileTest(i-1, j, p1, p2, normal)) return true;
-			if (rayTileTest(i+1, j, p1, p2, normal)) return true;
-
-			// On incrmente  la prochaine tuile
-			j--;
-			percent = (p1[1] - (float)(j+1)) / fabsf(p2[1] - p1[1]);
-			i = (int)(p1[0] + (p2[0] - p1[0]) * percent);
-			break;
+			CVector3f p1 = origin;
+			hits[k] = rayTest(p1, ends[k], (normals) ? normals[k] : normal);
+			if (hits[k]) nbHit++;
 		}
+		return nbHit;
 	}
 
-	return false;
+	return collision.rayTestBatch(origin, ends, count, hits, normals);
 }
 
 #ifndef DEDICATED_SERVER
 
 void GetMapList(std::vector< CString > & maps)
 {
-	maps.clear();
-	WIN32_FIND_DATA FindFileData;
-	HANDLE hFind = INVALID_HANDLE_VALUE;
-	char DirSpec[MAX_PATH];  // directory specification
-	char appPath[MAX_PATH];
-
-	// Chercher le path du "current working directory".
-	_getcwd(appPath, MAX_PATH);
-
-	strncpy(DirSpec, appPath, strlen(appPath) + 1);
-	strncat(DirSpec, "\\main\\maps\\*.bvm", strlen("\\main\\maps\\*.bvm") + 1);
+	CMapIndex::listMapFiles(maps);
+}
 
-	hFind = FindFirstFile(DirSpec, &FindFileData);
-	if(hFind != INVALID_HANDLE_VALUE)
+bool ReadMapCells(CBinaryReader & file, map_cell * cells, int count)
+{
+	const unsigned char * data = file.getSpan(count*2);
+	if (!data) return false;
+	for (int i=0;i<count;++i)
 	{
-		CString filename ("%s", FindFileData.cFileName);
-		// Drop the extension
-		filename.resize(filename.len() - 4);
-		maps.push_back(filename);
-		while(FindNextFile(hFind, &FindFileData) != 0)
-		{
-			CString filename ("%s", FindFileData.cFileName);
-			// Drop the extension
-			filename.resize(filename.len() - 4);
-			maps.push_back(filename);
-		}
-		FindClose(hFind);
+		cells[i].passable = (data[i*2] & 128)?true:false;
+		cells[i].height = (data[i*2] & 127);
 	}
+	return true;
 }
 
 bool GetMapData(CString name, unsigned int & texture, CVector2i & textureSize, CVector2i & size, CString & author)
 {
-	FileIO file(CString("main\\maps\\%s.bvm", name.s), "rb");
+	CBinaryReader file(CString("main/maps/%s.bvm", name.s).s);
 	if(file.isValid())
 	{
 		map_cell * cells = 0;
@@ -1629,31 +1510,13 @@ bool GetMapData(CString name, unsigned int & texture, CVector2i & textureSize, C
 			size[0] = file.getInt();
 			size[1] = file.getInt();
 			cells = new map_cell[size[0] * size[1]];
-			for (int j = 0; j < size[1]; ++j)
-			{
-				for (int i = 0; i < size[0]; ++i)
-				{
-					unsigned char data = file.getUByte();
-					cells[j * size[0] + i].passable = (data & 128) ? true : false;
-					cells[j * size[0] + i].height = (data & 127);
-					data = file.getUByte();
-				}
-			}
+			ReadMapCells(file, cells, size[0]*size[1]);
 			break;
 		case 10011:
 			size[0] = file.getInt();
 			size[1] = file.getInt();
 			cells = new map_cell[size[0] * size[1]];
-			for (int j = 0; j < size[1]; ++j)
-			{
-				for (int i = 0; i < size[0]; ++i)
-				{
-					unsigned char data = file.getUByte();
-					cells[j * size[0] + i].passable = (data & 128) ? true : false;
-					cells[j * size[0] + i].height = (data & 127);
-					data = file.getUByte();
-				}
-			}
+			ReadMapCells(file, cells, size[0]*size[1]);
 			break;
 		case 20201:
 			{
@@ -1662,39 +1525,19 @@ bool GetMapData(CString name, unsigned int & texture, CVector2i & textureSize, C
 				size[0] = file.getInt();
 				size[1] = file.getInt();
 				cells = new map_cell[size[0] * size[1]];
-				for (int j = 0; j < size[1]; ++j)
-				{
-					for (int i = 0; i < size[0]; ++i)
-					{
-						unsigned char data = file.getUByte();
-						cells[j * size[0] + i].passable = (data & 128) ? true : false;
-						cells[j * size[0] + i].height = (data & 127);
-						data = file.getUByte();
-					}
-				}
+				ReadMapCells(file, cells, size[0]*size[1]);
 				break;
 			}
 		case 20202:
 			{
-				char * author_name_buffer = file.getByteArray(25);
-				author_name_buffer[24] = '\0';
-				author.set("%s", author_name_buffer);
-				delete[] author_name_buffer;
+				const char * author_name_buffer = (const char *)file.getSpan(25);
+				if (author_name_buffer) author.set("%.24s", author_name_buffer);
 				int theme = file.getInt();
 				int weather = file.getInt();
 				size[0] = file.getInt();
 				size[1] = file.getInt();
 				cells = new map_cell[size[0] * size[1]];
-				for (int j = 0; j < size[1]; ++j)
-				{
-					for (int i = 0; i < size[0]; ++i)
-					{
-						unsigned char data = file.getUByte();
-						cells[j * size[0] + i].passable = (data & 128) ? true : false;
-						cells[j * size[0] + i].height = (data & 127);
-						data = file.getUByte();
-					}
-				}
+				ReadMapCells(file, cells, size[0]*size[1]);
 				break;
 			}
 		}
@@ -1739,6 +1582,12 @@ bool GetMapData(CString name, unsigned int & texture, CVector2i & textureSize, C
 #endif
 
 bool IsMapValid(const Map & map, int gameType)
+{
+	return IsMapValid((int)map.dm_spawns.size(), (int)map.blue_spawns.size(), (int)map.red_spawns.size(),
+		map.flagPodPos, map.objective, gameType);
+}
+
+bool IsMapValid(int nbDmSpawn, int nbBlueSpawn, int nbRedSpawn, const CVector3f * flagPodPos, const CVector3f * objective, int gameType)
 {
 	bool isGoodMap = true;
 	//--- game type specific map-check
@@ -1747,25 +1596,25 @@ bool IsMapValid(const Map & map, int gameType)
 	case GAME_TYPE_DM: 
 	case GAME_TYPE_TDM:
 		// there must be at least 1 item in dm_spawns
-		isGoodMap = (map.dm_spawns.size() >= 1);
+		isGoodMap = (nbDmSpawn >= 1);
 		break;
 	case GAME_TYPE_CTF:
 		// there must be at least 1 item in dm_spawns,
 		// both flags must be set
-		isGoodMap = (map.dm_spawns.size() >= 1)
-			&& (map.flagPodPos[0] != CVector3f(0.0f, 0.0f, 0.0f))
-			&& (map.flagPodPos[1] != CVector3f(0.0f, 0.0f, 0.0f));
+		isGoodMap = (nbDmSpawn >= 1)
+			&& (flagPodPos[0] != CVector3f(0.0f, 0.0f, 0.0f))
+			&& (flagPodPos[1] != CVector3f(0.0f, 0.0f, 0.0f));
 		break;
 	case GAME_TYPE_SND:
 		// there must be at least 1 item in blue_spawns
 		// there must be at least 1 item in red_spawns
 		// both objectives (bombs) must be set
 #if defined(_PRO_)
-      isGoodMap = (map.dm_spawns.size() >= 1);
+		isGoodMap = (nbDmSpawn >= 1);
 #else
-		isGoodMap = (map.blue_spawns.size() >= 1) && (map.red_spawns.size() >= 1)
-			&& (map.objective[0] != CVector3f(0.0f, 0.0f, 0.0f))
-			&& (map.objective[1] != CVector3f(0.0f, 0.0f, 0.0f));
+		isGoodMap = (nbBlueSpawn >= 1) && (nbRedSpawn >= 1)
+			&& (objective[0] != CVector3f(0.0f, 0.0f, 0.0f))
+			&& (objective[1] != CVector3f(0.0f, 0.0f, 0.0f));
 #endif
 		break;
 	}
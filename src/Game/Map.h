@@ -24,10 +24,13 @@
 #include <vector>
 #include "GameVar.h"
 #include "Player.h"
+#include "MapCollision.h"
 #if defined(_PRO_)
 #include "CAStar.h"
 #endif
 
+class CBinaryReader;
+
 #ifndef DEDICATED_SERVER
 #include "CMeshBuilder.h"
 #include "CWeather.h"
@@ -119,30 +122,32 @@ struct map_cell
 	// La liste d'objet que cette cellule contient
 	bool passable;
 
-	// Notre splater
-	float splater[4];
-
 	// Sa hauteur
 	int height;
 
+	//--- Render only, the dedicated server doesn't carry them
 #ifndef DEDICATED_SERVER
+	// Notre splater
+	float splater[4];
+
 	unsigned int dl;
 #endif
 
 	map_cell()
 	{
+		passable = true;
+		height = 1; // Par default un wall est 1 de haut
+#ifndef DEDICATED_SERVER
 		splater[0] = 0;
 		splater[1] = 0;
 		splater[2] = 0;
 		splater[3] = 0;
-		passable = true;
-		height = 1; // Par default un wall est 1 de haut
-#ifndef DEDICATED_SERVER
 		dl = 0;
 #endif
 	}
 
-	virtual ~map_cell()
+	// Nothing derives from a cell, no vtable in there
+	~map_cell()
 	{
 #ifndef DEDICATED_SERVER
 #ifndef _DX_
@@ -180,6 +185,10 @@ public:
 #endif
 	// Ses cells
 	map_cell * cells;
+
+	// The passable flags and heights of the cells, packed for the collisions and ray tests.
+	// Rebuilt with rebuildCollision() when the cells change.
+	CMapCollision collision;
 #ifndef DEDICATED_SERVER
 	// La position de la camera
 	CVector3f camPos;
@@ -333,6 +342,16 @@ public:
 	// Pour faire un ray tracing
 	bool rayTest(CVector3f & p1, CVector3f & p2, CVector3f & normal);
 
+	// Trace count rays from origin, like rayTest. Each end is moved to the hit if there is one
+	// and hits tells which ones hit. normals can be 0. Returns how many hit.
+	int rayTestBatch(const CVector3f & origin, CVector3f * ends, int count, bool * hits, CVector3f * normals = 0);
+
+	// The cells were loaded or edited
+	void rebuildCollision();
+
+	// Read the size and the cells of a map file
+	void loadCells(CBinaryReader & file);
+
 	// Pour gnrer la texture de la minimap
 #ifndef DEDICATED_SERVER
 	void regenTex();
@@ -341,6 +360,7 @@ public:
 	// Pour ajouter du dirt
 	inline void setTileDirt(int x, int y, float value)
 	{
+#ifndef DEDICATED_SERVER
 		if (x < 0) return;
 		if (y < 0) return;
 		if (x >= size[0]) return;
@@ -361,7 +381,9 @@ public:
 		{
 			cells[(y-1)*size[0]+x].splater[0] = cells[y*size[0]+x].splater[1];
 		}
+#endif
 	}
+#ifndef DEDICATED_SERVER
 	inline void addTileDirt(int x, int y, float value)
 	{
 		if (x < 0) return;
@@ -410,115 +432,7 @@ public:
 			cells[(y-1)*size[0]+x].splater[0] = cells[y*size[0]+x].splater[1];
 		}
 	}
-
-	// Pour tester une tuile (inline celle l)
-	inline bool rayTileTest(int x, int y, CVector3f & p1, CVector3f & p2, CVector3f & normal)
-	{
-		if (x>=0 && x<size[0] && y>=0 && y<size[1])
-		{
-			float x1 = (float)x;
-			float x2 = (float)x+1;
-			float y1 = (float)y;
-			float y2 = (float)y+1;
-			float percent;
-			float height = (float)cells[y*size[0]+x].height;
-			CVector3f p;
-
-			if (cells[y*size[0]+x].passable) 
-			{
-				// On check juste si on pogne le plancher !
-				if (p1[2] > 0 && p2[2] <= 0)
-				{
-					percent = p1[2] / fabsf(p2[2] - p1[2]);
-					p = p1 + (p2 - p1) * percent;
-					if (p[0] >= x1 && p[0] <= x2 &&
-						p[1] >= y1 && p[1] <= y2)
-					{
-						p2 = p;
-						normal.set(0,0,1);
-						return true;
-					}
-					return false;
-				}
-				else
-				{
-					return false;
-				}
-			}
-
-			if (!cells[y*size[0]+x].passable) 
-			{
-				// On check si on pogne le plafond
-				if (p1[2] > height && p2[2] <= height)
-				{
-					percent = (p1[2]-height) / fabsf((p2[2]-height) - (p1[2]-height));
-					p = p1 + (p2 - p1) * percent;
-					if (p[0] >= x1 && p[0] <= x2 &&
-						p[1] >= y1 && p[1] <= y2)
-					{
-						p2 = p;
-						normal.set(0,0,1);
-						return true;
-					}
-				}
-			}
-
-			// Le ct x1 en premier
-			if (p1[0] <= x1 && p2[0] > x1)
-			{
-				percent = fabsf(x1 - p1[0]) / fabsf(p2[0] - p1[0]);
-				p = p1 + (p2 - p1) * percent;
-				if (p[1] <= y2 && p[1] >= y1 && p[2] < height)
-				{
-					p2 = p;
-					normal.set(-1,0,0);
-					return true;
-				}
-			}
-
-			// Le ct opos
-			if (p1[0] >= x2 && p2[0] < x2)
-			{
-				percent = fabsf(p1[0] - x2) / fabsf(p2[0] - p1[0]);
-				p = p1 + (p2 - p1) * percent;
-				if (p[1] <= y2 && p[1] >= y1 && p[2] < height)
-				{
-					p2 = p;
-					normal.set(1,0,0);
-					return true;
-				}
-			}
-
-			// Le ct y1
-			if (p1[1] <= y1 && p2[1] > y1)
-			{
-				percent = fabsf(y1 - p1[1]) / fabsf(p2[1] - p1[1]);
-				p = p1 + (p2 - p1) * percent;
-				if (p[0] <= x2 && p[0] >= x1 && p[2] < height)
-				{
-					p2 = p;
-					normal.set(0,-1,0);
-					return true;
-				}
-			}
-
-			// Le ct opos
-			if (p1[1] >= y2 && p2[1] < y2)
-			{
-				percent = fabsf(p1[1] - y2) / fabsf(p2[1] - p1[1]);
-				p = p1 + (p2 - p1) * percent;
-				if (p[0] <= x2 && p[0] >= x1 && p[2] < height)
-				{
-					p2 = p;
-					normal.set(0,1,0);
-					return true;
-				}
-			}
-
-		}
-
-		return false;
-	}
+#endif
 
 #ifndef DEDICATED_SERVER
 	//--- To reload the theme
@@ -532,11 +446,15 @@ public:
 // Returns the names of all existing maps
 void GetMapList(std::vector< CString > & maps);
 
+// Read the passable flags and heights of count cells, the dirt is skipped
+bool ReadMapCells(CBinaryReader & file, map_cell * cells, int count);
+
 // Returns basic info about the map
 bool GetMapData(CString name, unsigned int & texture, CVector2i & textureSize, CVector2i & size, CString & author);
 
 // Tells if a map has everything that is needed for a given game-type
 bool IsMapValid(const Map & map, int gameType);
+bool IsMapValid(int nbDmSpawn, int nbBlueSpawn, int nbRedSpawn, const CVector3f * flagPodPos, const CVector3f * objective, int gameType);
 
 #endif
 
@@ -0,0 +1,320 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "MapCollision.h"
+#include <string.h>
+#include <float.h>
+#ifdef MAPCOLLISION_SSE2
+	#include <emmintrin.h>
+#endif
+
+
+
+//
+// Constructeur
+//
+CMapCollision::CMapCollision()
+{
+	width = 0;
+	height = 0;
+	passableBits = 0;
+	heights = 0;
+	wallDistance = 0;
+}
+
+
+
+//
+// Destructeur
+//
+CMapCollision::~CMapCollision()
+{
+	delete [] passableBits;
+	delete [] heights;
+	delete [] wallDistance;
+}
+
+
+
+//
+// Allocate the grid, every cell starts as a wall
+//
+void CMapCollision::resize(int in_width, int in_height)
+{
+	if (in_width != width || in_height != height || !heights)
+	{
+		delete [] passableBits;
+		delete [] heights;
+		delete [] wallDistance;
+
+		width = in_width;
+		height = in_height;
+		passableBits = new unsigned int [(width * height + 31) / 32 + 1];
+		heights = new unsigned char [width * height + 1];
+		wallDistance = new unsigned char [width * height + 1];
+	}
+
+	memset(passableBits, 0, sizeof(unsigned int) * ((width * height + 31) / 32 + 1));
+	memset(heights, 0, width * height + 1);
+}
+
+
+
+//
+// Once every cell is set
+//
+void CMapCollision::buildWallDistance()
+{
+	//--- Distance to the walls, two passes over the grid (chessboard distance).
+	//    The first one comes from the top left, the second one from the bottom right.
+	for (int y=0;y<height;++y)
+	{
+		for (int x=0;x<width;++x)
+		{
+			int i = y * width + x;
+			if (!isPassable(x, y))
+			{
+				wallDistance[i] = 0;
+				continue;
+			}
+
+			// The map border is a wall too
+			int dis = MAP_WALL_DISTANCE_MAX;
+			if (x + 1 < dis) dis = x + 1;
+			if (y + 1 < dis) dis = y + 1;
+			if (width - x < dis) dis = width - x;
+			if (height - y < dis) dis = height - y;
+
+			if (x > 0 && wallDistance[i-1] + 1 < dis) dis = wallDistance[i-1] + 1;
+			if (y > 0)
+			{
+				if (wallDistance[i-width] + 1 < dis) dis = wallDistance[i-width] + 1;
+				if (x > 0 && wallDistance[i-width-1] + 1 < dis) dis = wallDistance[i-width-1] + 1;
+				if (x < width-1 && wallDistance[i-width+1] + 1 < dis) dis = wallDistance[i-width+1] + 1;
+			}
+			wallDistance[i] = (unsigned char)dis;
+		}
+	}
+	for (int y=height-1;y>=0;--y)
+	{
+		for (int x=width-1;x>=0;--x)
+		{
+			int i = y * width + x;
+			int dis = wallDistance[i];
+			if (dis == 0) continue;
+
+			if (x < width-1 && wallDistance[i+1] + 1 < dis) dis = wallDistance[i+1] + 1;
+			if (y < height-1)
+			{
+				if (wallDistance[i+width] + 1 < dis) dis = wallDistance[i+width] + 1;
+				if (x > 0 && wallDistance[i+width-1] + 1 < dis) dis = wallDistance[i+width-1] + 1;
+				if (x < width-1 && wallDistance[i+width+1] + 1 < dis) dis = wallDistance[i+width+1] + 1;
+			}
+			wallDistance[i] = (unsigned char)dis;
+		}
+	}
+}
+
+
+
+//
+// Pour faire un ray tracing
+//
+bool CMapCollision::rayTest(CVector3f & p1, CVector3f & p2, CVector3f & normal) const
+{
+	// On pogne notre cell de depart
+	int i = (int)p1[0];
+	int j = (int)p1[1];
+
+	// On check que notre tuile n'est pas deja occupee
+	if (i < 0 || i >= width || j < 0 || j >= height) return false;
+	if (!isPassable(i, j) && p1[2] < getHeight(i, j))
+	{
+		p2 = p1;
+		return true;
+	}
+
+	return rayTraverse(i, j, p1, p2, normal);
+}
+
+
+
+//
+// Many rays from the same point. The start cell is checked once, and the
+// border crossings of 4 rays are set up together when we have SSE2.
+// The results are the same as calling rayTest on each ray.
+//
+int CMapCollision::rayTestBatch(const CVector3f & origin, CVector3f * ends, int count, bool * hits, CVector3f * normals) const
+{
+	int nbHit = 0;
+	CVector3f normal;
+
+	int i = (int)origin[0];
+	int j = (int)origin[1];
+	if (i < 0 || i >= width || j < 0 || j >= height)
+	{
+		for (int k=0;k<count;++k) hits[k] = false;
+		return 0;
+	}
+	if (!isPassable(i, j) && origin[2] < getHeight(i, j))
+	{
+		for (int k=0;k<count;++k)
+		{
+			ends[k] = origin;
+			hits[k] = true;
+		}
+		return count;
+	}
+
+	int k = 0;
+#ifdef MAPCOLLISION_SSE2
+	//--- Distance from the origin to the cell borders, depending on the direction
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 fltMax = _mm_set1_ps(FLT_MAX);
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	const __m128 ox = _mm_set1_ps(origin[0]);
+	const __m128 oy = _mm_set1_ps(origin[1]);
+	const __m128 borderPosX = _mm_set1_ps((float)(i+1) - origin[0]);
+	const __m128 borderNegX = _mm_set1_ps(origin[0] - (float)i);
+	const __m128 borderPosY = _mm_set1_ps((float)(j+1) - origin[1]);
+	const __m128 borderNegY = _mm_set1_ps(origin[1] - (float)j);
+
+	for (;k+4<=count;k+=4)
+	{
+		__m128 dx = _mm_sub_ps(_mm_setr_ps(ends[k][0], ends[k+1][0], ends[k+2][0], ends[k+3][0]), ox);
+		__m128 dy = _mm_sub_ps(_mm_setr_ps(ends[k][1], ends[k+1][1], ends[k+2][1], ends[k+3][1]), oy);
+
+		__m128 posX = _mm_cmpgt_ps(dx, zero);
+		__m128 negX = _mm_cmplt_ps(dx, zero);
+		__m128 posY = _mm_cmpgt_ps(dy, zero);
+		__m128 negY = _mm_cmplt_ps(dy, zero);
+		__m128 nonZeroX = _mm_or_ps(posX, negX);
+		__m128 nonZeroY = _mm_or_ps(posY, negY);
+
+		// tDelta = |1 / d|, FLT_MAX when we don't move on that axis
+		__m128 tDeltaX = _mm_and_ps(_mm_div_ps(one, dx), absMask);
+		__m128 tDeltaY = _mm_and_ps(_mm_div_ps(one, dy), absMask);
+		tDeltaX = _mm_or_ps(_mm_and_ps(nonZeroX, tDeltaX), _mm_andnot_ps(nonZeroX, fltMax));
+		tDeltaY = _mm_or_ps(_mm_and_ps(nonZeroY, tDeltaY), _mm_andnot_ps(nonZeroY, fltMax));
+
+		// tMax = distance to the first border * tDelta
+		__m128 borderX = _mm_or_ps(_mm_and_ps(posX, borderPosX), _mm_and_ps(negX, borderNegX));
+		__m128 borderY = _mm_or_ps(_mm_and_ps(posY, borderPosY), _mm_and_ps(negY, borderNegY));
+		__m128 tMaxX = _mm_mul_ps(borderX, tDeltaX);
+		__m128 tMaxY = _mm_mul_ps(borderY, tDeltaY);
+		tMaxX = _mm_or_ps(_mm_and_ps(nonZeroX, tMaxX), _mm_andnot_ps(nonZeroX, fltMax));
+		tMaxY = _mm_or_ps(_mm_and_ps(nonZeroY, tMaxY), _mm_andnot_ps(nonZeroY, fltMax));
+
+		float tMaxXs[4], tMaxYs[4], tDeltaXs[4], tDeltaYs[4];
+		_mm_storeu_ps(tMaxXs, tMaxX);
+		_mm_storeu_ps(tMaxYs, tMaxY);
+		_mm_storeu_ps(tDeltaXs, tDeltaX);
+		_mm_storeu_ps(tDeltaYs, tDeltaY);
+
+		//--- The walk itself branches on every cell, it stays one ray at a time
+		for (int r=0;r<4;++r)
+		{
+			CVector3f p1 = origin;
+			hits[k+r] = rayWalk(i, j, tMaxXs[r], tMaxYs[r], tDeltaXs[r], tDeltaYs[r],
+				p1, ends[k+r], (normals) ? normals[k+r] : normal);
+			if (hits[k+r]) nbHit++;
+		}
+	}
+#endif
+
+	for (;k<count;++k)
+	{
+		CVector3f p1 = origin;
+		hits[k] = rayTraverse(i, j, p1, ends[k], (normals) ? normals[k] : normal);
+		if (hits[k]) nbHit++;
+	}
+
+	return nbHit;
+}
+
+
+
+//
+// Walk the cells crossed by the ray, in order, starting in cell i, j (Amanatides & Woo).
+// Every cell is tested once, the first hit is the closest one.
+//
+bool CMapCollision::rayTraverse(int i, int j, CVector3f & p1, CVector3f & p2, CVector3f & normal) const
+{
+	float dx = p2[0] - p1[0];
+	float dy = p2[1] - p1[1];
+
+	//--- How much of the ray it takes to cross one cell
+	float tDeltaX = (dx != 0) ? fabsf(1.0f / dx) : FLT_MAX;
+	float tDeltaY = (dy != 0) ? fabsf(1.0f / dy) : FLT_MAX;
+
+	//--- Where on the ray we cross the first cell border
+	float tMaxX = FLT_MAX;
+	float tMaxY = FLT_MAX;
+	if (dx > 0) tMaxX = ((float)(i+1) - p1[0]) * tDeltaX;
+	else if (dx < 0) tMaxX = (p1[0] - (float)i) * tDeltaX;
+	if (dy > 0) tMaxY = ((float)(j+1) - p1[1]) * tDeltaY;
+	else if (dy < 0) tMaxY = (p1[1] - (float)j) * tDeltaY;
+
+	return rayWalk(i, j, tMaxX, tMaxY, tDeltaX, tDeltaY, p1, p2, normal);
+}
+
+
+
+//
+// The walk, once we know where the ray crosses the borders
+//
+bool CMapCollision::rayWalk(int i, int j, float tMaxX, float tMaxY, float tDeltaX, float tDeltaY,
+							CVector3f & p1, CVector3f & p2, CVector3f & normal) const
+{
+	//--- Which way we step
+	int stepX = (p2[0] - p1[0] > 0) ? 1 : -1;
+	int stepY = (p2[1] - p1[1] > 0) ? 1 : -1;
+
+	while (true)
+	{
+		if (rayTileTest(i, j, p1, p2, normal)) return true;
+
+		//--- The end of the ray is in this cell
+		if (tMaxX > 1 && tMaxY > 1) return false;
+
+		if (fabsf(tMaxX - tMaxY) < 0.00001f)
+		{
+			//--- Right through a corner, we don't skip the cells on the sides
+			if (rayTileTest(i+stepX, j, p1, p2, normal)) return true;
+			if (rayTileTest(i, j+stepY, p1, p2, normal)) return true;
+			i += stepX;
+			j += stepY;
+			tMaxX += tDeltaX;
+			tMaxY += tDeltaY;
+		}
+		else if (tMaxX < tMaxY)
+		{
+			i += stepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			j += stepY;
+			tMaxY += tDeltaY;
+		}
+
+		//--- Out of the map
+		if (i < 0 || i >= width || j < 0 || j >= height) return false;
+	}
+}
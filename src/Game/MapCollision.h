@@ -0,0 +1,217 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MAPCOLLISION_H
+#define MAPCOLLISION_H
+
+
+#include "CVector.h"
+#include <math.h>
+
+// Distances to the walls are kept in a byte
+#define MAP_WALL_DISTANCE_MAX 255
+
+// The batched ray setup does 4 rays per SSE register when we have SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define MAPCOLLISION_SSE2
+#endif
+
+
+// What the collisions need to know about the map cells, packed tight:
+// one bit per cell for the passable flag, one byte for the height
+// and one byte for the distance to the closest wall.
+// Even a big map holds in a few KB, it stays in the cache.
+class CMapCollision
+{
+public:
+	// Size in cells, same as the map
+	int width;
+	int height;
+
+	// Passable flags, 32 cells per int, row by row
+	unsigned int * passableBits;
+
+	// Wall heights (0 to 127)
+	unsigned char * heights;
+
+	// How many cells to the closest wall or map border, in any direction (diagonals count as 1).
+	// 0 on a wall, 2 or more means the 8 cells around are free.
+	unsigned char * wallDistance;
+
+public:
+	// Constructeur
+	CMapCollision();
+
+	// Destructeur
+	virtual ~CMapCollision();
+
+	// Pack the cells, after the map is loaded or edited :
+	// resize, set every cell, then buildWallDistance
+	void resize(int in_width, int in_height);
+	inline void setCell(int i, bool passable, int cellHeight)
+	{
+		if (passable) passableBits[i >> 5] |= 1u << (i & 31);
+		else passableBits[i >> 5] &= ~(1u << (i & 31));
+		heights[i] = (unsigned char)cellHeight;
+	}
+	void buildWallDistance();
+
+	// One cell, the bounds are not checked
+	inline bool isPassable(int x, int y) const
+	{
+		int i = y * width + x;
+		return (passableBits[i >> 5] & (1u << (i & 31))) != 0;
+	}
+	inline int getHeight(int x, int y) const
+	{
+		return heights[y * width + x];
+	}
+
+	// Outside the map we are always on a wall
+	inline int getWallDistance(int x, int y) const
+	{
+		if (x < 0 || y < 0 || x >= width || y >= height) return 0;
+		return wallDistance[y * width + x];
+	}
+
+	// Pour faire un ray tracing dans les cellules. p2 is moved to the hit if there is one
+	bool rayTest(CVector3f & p1, CVector3f & p2, CVector3f & normal) const;
+
+	// Trace count rays from origin, like rayTest. Each end is moved to the hit if there is one
+	// and hits tells which ones hit. normals can be 0. Returns how many hit.
+	int rayTestBatch(const CVector3f & origin, CVector3f * ends, int count, bool * hits, CVector3f * normals = 0) const;
+
+	// Walk the cells of a ray that starts in a free part of cell i, j
+	bool rayTraverse(int i, int j, CVector3f & p1, CVector3f & p2, CVector3f & normal) const;
+
+	// Same walk, with the border crossings already known (see rayTestBatch)
+	bool rayWalk(int i, int j, float tMaxX, float tMaxY, float tDeltaX, float tDeltaY,
+				 CVector3f & p1, CVector3f & p2, CVector3f & normal) const;
+
+	// Pour tester une tuile (inline celle la)
+	inline bool rayTileTest(int x, int y, CVector3f & p1, CVector3f & p2, CVector3f & normal) const
+	{
+		if (x>=0 && x<width && y>=0 && y<height)
+		{
+			float x1 = (float)x;
+			float x2 = (float)x+1;
+			float y1 = (float)y;
+			float y2 = (float)y+1;
+			float percent;
+			float wallHeight = (float)getHeight(x, y);
+			CVector3f p;
+
+			if (isPassable(x, y)) 
+			{
+				// On check juste si on pogne le plancher !
+				if (p1[2] > 0 && p2[2] <= 0)
+				{
+					percent = p1[2] / fabsf(p2[2] - p1[2]);
+					p = p1 + (p2 - p1) * percent;
+					if (p[0] >= x1 && p[0] <= x2 &&
+						p[1] >= y1 && p[1] <= y2)
+					{
+						p2 = p;
+						normal.set(0,0,1);
+						return true;
+					}
+					return false;
+				}
+				else
+				{
+					return false;
+				}
+			}
+
+			if (!isPassable(x, y)) 
+			{
+				// On check si on pogne le plafond
+				if (p1[2] > wallHeight && p2[2] <= wallHeight)
+				{
+					percent = (p1[2]-wallHeight) / fabsf((p2[2]-wallHeight) - (p1[2]-wallHeight));
+					p = p1 + (p2 - p1) * percent;
+					if (p[0] >= x1 && p[0] <= x2 &&
+						p[1] >= y1 && p[1] <= y2)
+					{
+						p2 = p;
+						normal.set(0,0,1);
+						return true;
+					}
+				}
+			}
+
+			// Le cote x1 en premier
+			if (p1[0] <= x1 && p2[0] > x1)
+			{
+				percent = fabsf(x1 - p1[0]) / fabsf(p2[0] - p1[0]);
+				p = p1 + (p2 - p1) * percent;
+				if (p[1] <= y2 && p[1] >= y1 && p[2] < wallHeight)
+				{
+					p2 = p;
+					normal.set(-1,0,0);
+					return true;
+				}
+			}
+
+			// Le cote opose
+			if (p1[0] >= x2 && p2[0] < x2)
+			{
+				percent = fabsf(p1[0] - x2) / fabsf(p2[0] - p1[0]);
+				p = p1 + (p2 - p1) * percent;
+				if (p[1] <= y2 && p[1] >= y1 && p[2] < wallHeight)
+				{
+					p2 = p;
+					normal.set(1,0,0);
+					return true;
+				}
+			}
+
+			// Le cote y1
+			if (p1[1] <= y1 && p2[1] > y1)
+			{
+				percent = fabsf(y1 - p1[1]) / fabsf(p2[1] - p1[1]);
+				p = p1 + (p2 - p1) * percent;
+				if (p[0] <= x2 && p[0] >= x1 && p[2] < wallHeight)
+				{
+					p2 = p;
+					normal.set(0,-1,0);
+					return true;
+				}
+			}
+
+			// Le cote opose
+			if (p1[1] >= y2 && p2[1] < y2)
+			{
+				percent = fabsf(p1[1] - y2) / fabsf(p2[1] - p1[1]);
+				p = p1 + (p2 - p1) * percent;
+				if (p[0] <= x2 && p[0] >= x1 && p[2] < wallHeight)
+				{
+					p2 = p;
+					normal.set(0,1,0);
+					return true;
+				}
+			}
+
+		}
+
+		return false;
+	}
+};
+
+
+#endif
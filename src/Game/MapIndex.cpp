@@ -0,0 +1,423 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "MapIndex.h"
+#include "Map.h"
+#include "Game.h"
+#include "CBinaryReader.h"
+#include <sys/stat.h>
+#include <algorithm>
+#ifdef WIN32
+	#include <windows.h>
+	#include <process.h>
+#else
+	#include <dirent.h>
+	#include <unistd.h>
+#endif
+
+
+CMapIndex mapIndex;
+
+
+
+//
+// Reads a spawn list, returns how many
+//
+static int skipSpawns(CBinaryReader & file)
+{
+	int nbSpawn = file.getInt();
+	file.skip(nbSpawn * (int)sizeof(float) * 3);
+	return nbSpawn;
+}
+
+
+
+//
+// Constructeur
+//
+CMapIndex::CMapIndex()
+{
+	m_loaded = false;
+}
+
+
+
+//
+// Binary search by name
+//
+int CMapIndex::indexOf(const char * mapName) const
+{
+	int first = 0;
+	int last = (int)m_maps.size() - 1;
+	while (first <= last)
+	{
+		int middle = (first + last) / 2;
+		int cmp = stricmp(m_maps[middle].mapName, mapName);
+		if (cmp == 0) return middle;
+		if (cmp < 0) first = middle + 1;
+		else last = middle - 1;
+	}
+	return -1;
+}
+
+
+
+static bool sortByName(const map_meta & a, const map_meta & b)
+{
+	return stricmp(a.mapName, b.mapName) < 0;
+}
+
+
+
+//
+// Read what we knew at the last run
+//
+void CMapIndex::load()
+{
+	m_loaded = true;
+
+	FILE * fic = fopen(MAP_INDEX_FILE, "r");
+	if (!fic) return;
+
+	// One map per line, the name up to the tab (it can have spaces) then the numbers.
+	// A line we can't read is skipped, the map will be scanned again
+	char line[256];
+	map_meta meta;
+	while (fgets(line, sizeof(line), fic))
+	{
+		char * tab = strchr(line, '\t');
+		if (!tab || tab == line || tab - line >= (int)sizeof(meta.mapName)) continue;
+		memcpy(meta.mapName, line, tab - line);
+		meta.mapName[tab - line] = '\0';
+
+		if (sscanf(tab + 1, "%i %i %i %i %i %i %i %u %li %li",
+			&meta.size[0], &meta.size[1], &meta.mapArea,
+			&meta.nbSpawn[0], &meta.nbSpawn[1], &meta.nbSpawn[2], &meta.gameTypes,
+			&meta.checksum, &meta.mtime, &meta.fileSize) == 10)
+		{
+			m_maps.push_back(meta);
+		}
+	}
+	fclose(fic);
+
+	std::sort(m_maps.begin(), m_maps.end(), sortByName);
+}
+
+
+
+//
+// Write the index. Many server instances can share the directory, so we write
+// a temporary file and move it
+//
+void CMapIndex::save(const std::vector<map_meta> & maps)
+{
+	CString tmpName("%s.%i", MAP_INDEX_FILE, (int)getpid());
+	FILE * fic = fopen(tmpName.s, "w");
+	if (!fic) return;
+
+	for (int i = 0; i < (int)maps.size(); ++i)
+	{
+		const map_meta & meta = maps[i];
+		if (strpbrk(meta.mapName, "\t\r\n")) continue; // Can't be read back, scanned each time
+		fprintf(fic, "%s\t%i %i %i %i %i %i %i %u %li %li\n",
+			meta.mapName, meta.size[0], meta.size[1], meta.mapArea,
+			meta.nbSpawn[0], meta.nbSpawn[1], meta.nbSpawn[2], meta.gameTypes,
+			meta.checksum, meta.mtime, meta.fileSize);
+	}
+	fclose(fic);
+
+	remove(MAP_INDEX_FILE);
+	rename(tmpName.s, MAP_INDEX_FILE);
+}
+
+
+
+//
+// The .bvm in main/maps
+//
+void CMapIndex::listMapFiles(std::vector<CString> & maps)
+{
+	maps.clear();
+#ifdef WIN32
+	WIN32_FIND_DATA FindFileData;
+	HANDLE hFind = FindFirstFile("main\\maps\\*.bvm", &FindFileData);
+	if (hFind != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			if (!(FindFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+			{
+				CString filename("%s", FindFileData.cFileName);
+				// Drop the extension
+				filename.resize(filename.len() - 4);
+				maps.push_back(filename);
+			}
+		} while (FindNextFile(hFind, &FindFileData) != 0);
+		FindClose(hFind);
+	}
+#else
+	DIR * hFile = opendir("main/maps");
+	if (hFile)
+	{
+		dirent * file;
+		while ((file = readdir(hFile)) != 0)
+		{
+			char * extension = strrchr(file->d_name, '.');
+			if (extension && !strcasecmp(extension, ".bvm"))
+			{
+				CString filename("%s", file->d_name);
+				// Drop the extension
+				filename.resize(filename.len() - 4);
+				maps.push_back(filename);
+			}
+		}
+		closedir(hFile);
+	}
+#endif
+}
+
+
+
+//
+// Read the header of a map, the same way Map::Map does
+//
+bool CMapIndex::scanFile(const CString & mapName, map_meta & meta)
+{
+	memset(&meta, 0, sizeof(map_meta));
+	if (mapName.len() <= 0 || mapName.len() >= (int)sizeof(meta.mapName)) return false;
+	strcpy(meta.mapName, mapName.s);
+
+	CString filename("main/maps/%s.bvm", mapName.s);
+	struct stat fileStat;
+	if (stat(filename.s, &fileStat) != 0) return false;
+	meta.mtime = (long)fileStat.st_mtime;
+	meta.fileSize = (long)fileStat.st_size;
+
+	CBinaryReader file(filename.s);
+	if (!file.isValid()) return false;
+
+	meta.checksum = 2166136261u;
+	const unsigned char * data = file.getData();
+	for (int i = 0; i < file.getSize(); ++i)
+	{
+		meta.checksum = (meta.checksum ^ data[i]) * 16777619u;
+	}
+
+	CVector3f flagPodPos[2];
+	CVector3f objective[2];
+
+	uint32_t mapVersion = file.getULong();
+	switch (mapVersion)
+	{
+	case 10010:
+	case 10011:
+		break;
+	case 20201:
+		file.getInt(); // theme
+		file.getInt(); // weather
+		break;
+	case 20202:
+		file.skip(25); // author
+		file.getInt(); // theme
+		file.getInt(); // weather
+		break;
+	default:
+		return false;
+	}
+
+	meta.size[0] = file.getInt();
+	meta.size[1] = file.getInt();
+	if (meta.size[0] <= 0 || meta.size[1] <= 0) return false;
+	// Two bytes per cell, passable is the high bit of the first one
+	const unsigned char * cells = file.getSpan(meta.size[0] * meta.size[1] * 2);
+	if (!cells) return false;
+	for (int j = 1; j < meta.size[1] - 1; ++j)
+	{
+		for (int i = 1; i < meta.size[0] - 1; ++i)
+		{
+			if (cells[(j * meta.size[0] + i) * 2] & 128) meta.mapArea++;
+		}
+	}
+
+	if (mapVersion == 10011 || mapVersion == 20201)
+	{
+		flagPodPos[0] = file.getVector3f();
+		flagPodPos[1] = file.getVector3f();
+		objective[0] = file.getVector3f();
+		objective[1] = file.getVector3f();
+		meta.nbSpawn[0] = skipSpawns(file);
+		meta.nbSpawn[1] = skipSpawns(file);
+		meta.nbSpawn[2] = skipSpawns(file);
+	}
+	else if (mapVersion == 20202)
+	{
+		meta.nbSpawn[0] = skipSpawns(file);
+
+		// One section per game type
+		for (int gtnum = 0; gtnum < GAME_TYPE_COUNT && file.isOk(); ++gtnum)
+		{
+			switch (file.getInt())
+			{
+			case GAME_TYPE_CTF:
+				flagPodPos[0] = file.getVector3f();
+				flagPodPos[1] = file.getVector3f();
+				break;
+			case GAME_TYPE_SND:
+				objective[0] = file.getVector3f();
+				objective[1] = file.getVector3f();
+				meta.nbSpawn[1] = skipSpawns(file);
+				meta.nbSpawn[2] = skipSpawns(file);
+				break;
+			}
+		}
+	}
+	if (!file.isOk()) return false;
+
+	for (int gameType = 0; gameType < GAME_TYPE_COUNT; ++gameType)
+	{
+		if (IsMapValid(meta.nbSpawn[0], meta.nbSpawn[1], meta.nbSpawn[2], flagPodPos, objective, gameType))
+		{
+			meta.gameTypes |= (1 << gameType);
+		}
+	}
+
+	return true;
+}
+
+
+
+//
+// Rescan in the background
+//
+void CMapIndex::refresh()
+{
+	if (isRunning()) return;
+	start(0, CTHREAD_PRIORITY_LOW);
+}
+
+
+
+//
+// The scanning thread. Only the files that changed are read again
+//
+void CMapIndex::execute(void* pArg)
+{
+	std::vector<map_meta> known;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (!m_loaded) load();
+		known = m_maps;
+	}
+
+	std::vector<CString> files;
+	listMapFiles(files);
+
+	std::vector<map_meta> maps;
+	for (int i = 0; i < (int)files.size(); ++i)
+	{
+		map_meta meta;
+		bool upToDate = false;
+		struct stat fileStat;
+		if (stat(CString("main/maps/%s.bvm", files[i].s).s, &fileStat) == 0)
+		{
+			for (int k = 0; k < (int)known.size(); ++k)
+			{
+				if (stricmp(known[k].mapName, files[i].s) == 0)
+				{
+					upToDate = (known[k].mtime == (long)fileStat.st_mtime && known[k].fileSize == (long)fileStat.st_size);
+					if (upToDate) meta = known[k];
+					break;
+				}
+			}
+		}
+		if (upToDate || scanFile(files[i], meta)) maps.push_back(meta);
+	}
+	std::sort(maps.begin(), maps.end(), sortByName);
+
+	save(maps);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_maps.swap(maps);
+}
+
+
+
+//
+// Get a map, scan it now if needed
+//
+bool CMapIndex::find(const CString & mapName, map_meta & meta)
+{
+	CString filename("main/maps/%s.bvm", mapName.s);
+	struct stat fileStat;
+	if (stat(filename.s, &fileStat) != 0) return false;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (!m_loaded) load();
+		int index = indexOf(mapName.s);
+		if (index >= 0 && m_maps[index].mtime == (long)fileStat.st_mtime && m_maps[index].fileSize == (long)fileStat.st_size)
+		{
+			meta = m_maps[index];
+			return true;
+		}
+	}
+
+	// New or changed, only that file is read
+	if (!scanFile(mapName, meta)) return false;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	int index = indexOf(mapName.s);
+	if (index >= 0)
+	{
+		m_maps[index] = meta;
+	}
+	else
+	{
+		m_maps.insert(std::upper_bound(m_maps.begin(), m_maps.end(), meta, sortByName), meta);
+	}
+	return true;
+}
+
+
+
+//
+// Can that map be played in that game type
+//
+bool CMapIndex::supports(const CString & mapName, int gameType)
+{
+	map_meta meta;
+	if (!find(mapName, meta)) return false;
+	return (meta.gameTypes & (1 << gameType)) ? true : false;
+}
+
+
+
+//
+// The names of the indexed maps
+//
+std::vector<CString> CMapIndex::getMapNames()
+{
+	std::vector<CString> maps;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (!m_loaded) load();
+	for (int i = 0; i < (int)m_maps.size(); ++i)
+	{
+		maps.push_back(m_maps[i].mapName);
+	}
+	return maps;
+}
@@ -0,0 +1,109 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MAPINDEX_H
+#define MAPINDEX_H
+
+
+#include "Zeven.h"
+#include "CThread.h"
+#include <vector>
+#include <mutex>
+
+
+// Where the index is kept between runs
+#define MAP_INDEX_FILE "main/maps/maps.idx"
+
+
+// What we know of a .bvm without loading it
+struct map_meta
+{
+	char mapName[32]; // Without the extension
+
+	int size[2];
+
+	// Passable cells, the borders excluded
+	int mapArea;
+
+	// dm, blue and red spawns
+	int nbSpawn[3];
+
+	// Bit (1 << GAME_TYPE_xxx) for each game type the map has everything for
+	int gameTypes;
+
+	// FNV-1a of the whole file
+	uint32_t checksum;
+
+	// To know when the file changed
+	long mtime;
+	long fileSize;
+};
+
+
+// The metadata of every map in main/maps. A thread scans the directory and reads
+// the headers only (no textures, no models, no A*), the entries that didn't change
+// since the last run are taken from MAP_INDEX_FILE.
+class CMapIndex : public CThread
+{
+private:
+	// Sorted by name, protected by m_mutex
+	std::mutex m_mutex;
+	std::vector<map_meta> m_maps;
+	bool m_loaded;
+
+	// Read MAP_INDEX_FILE, with m_mutex locked
+	void load();
+
+	// Write it, from the scanning thread
+	void save(const std::vector<map_meta> & maps);
+
+	// Binary search, -1 if not there. m_mutex locked
+	int indexOf(const char * mapName) const;
+
+protected:
+	// The scanning thread
+	void execute(void* pArg);
+
+public:
+	// Constructeur
+	CMapIndex();
+
+	// Rescan the directory in the background, does nothing if already scanning
+	void refresh();
+
+	// Get a map. A map not indexed yet or changed on disk is scanned right away
+	bool find(const CString & mapName, map_meta & meta);
+
+	// Can that map be played in that game type
+	bool supports(const CString & mapName, int gameType);
+
+	// The names of the indexed maps
+	std::vector<CString> getMapNames();
+
+	// The .bvm in main/maps, without their extension
+	static void listMapFiles(std::vector<CString> & maps);
+
+	// Read the header of a map, false if it's not a map we can read
+	static bool scanFile(const CString & mapName, map_meta & meta);
+};
+
+
+extern CMapIndex mapIndex;
+
+
+#endif
@@ -378,8 +378,9 @@ void Map::renderGround()
 		glPushAttrib(GL_ENABLE_BIT);
 		glDisable(GL_LIGHTING);
 		glLineWidth(1);
-		for (CPathNode * p = aStar->GetNodes();p;p=p->next)
+		for (int i=0;i<aStar->GetNodeCount();++i)
 		{
+			CPathNode * p = aStar->GetNode(i);
 			glColor3f(1, 1, 0);
 			glBegin(GL_LINE_LOOP);
 				glVertex2f(p->m_centerX - (float)p->m_sizeX * .45f, p->m_centerY + (float)p->m_sizeY * .45f);
@@ -471,10 +472,18 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 			x = size[0] - 2;
 		if (y >= size[1] - 1)
 			y = size[1] - 2;
+
+		//--- No wall in the 8 cells around, most of the time
+		if (collision.getWallDistance(x, y) >= 2)
+		{
+			lastCF.position = CF.position;
+			return;
+		}
+
 		//prevents high velocity objects(minibots) from going into outer walls and causing a crash, they should still bounce correctly
 		if (CF.vel[1] < 0)
 		{
-			if (!cells[(y-1)*size[0]+(x)].passable)
+			if (!collision.isPassable(x, y-1))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (lastCF.position[0] - radius <= (float)(x)+1 &&
@@ -487,7 +496,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 					CF.vel[1] = -CF.vel[1] * BOUNCE_FACTOR; // On le fait rebondir ! Bedong!
 				}
 			}
-			if (!cells[(y-1)*size[0]+(x-1)].passable)
+			if (!collision.isPassable(x-1, y-1))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (lastCF.position[0] - radius <= (float)(x-1)+1 &&
@@ -500,7 +509,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 					CF.vel[1] = -CF.vel[1] * BOUNCE_FACTOR; // On le fait rebondir ! Bedong!
 				}
 			}
-			if (!cells[(y-1)*size[0]+(x+1)].passable)
+			if (!collision.isPassable(x+1, y-1))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (lastCF.position[0] - radius <= (float)(x+1)+1 &&
@@ -516,7 +525,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 		}
 		else if (CF.vel[1] > 0)
 		{
-			if (!cells[(y+1)*size[0]+(x)].passable)
+			if (!collision.isPassable(x, y+1))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (lastCF.position[0] - radius <= (float)(x)+1 &&
@@ -529,7 +538,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 					CF.vel[1] = -CF.vel[1] * BOUNCE_FACTOR; // On le fait rebondir ! Bedong!
 				}
 			}
-			if (!cells[(y+1)*size[0]+(x-1)].passable)
+			if (!collision.isPassable(x-1, y+1))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (lastCF.position[0] - radius <= (float)(x-1)+1 &&
@@ -542,7 +551,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 					CF.vel[1] = -CF.vel[1] * BOUNCE_FACTOR; // On le fait rebondir ! Bedong!
 				}
 			}
-			if (!cells[(y+1)*size[0]+(x+1)].passable)
+			if (!collision.isPassable(x+1, y+1))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (lastCF.position[0] - radius <= (float)(x+1)+1 &&
@@ -560,7 +569,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 		// On check en X asteur (sti c sketch comme technique, mais bon, c juste babo l!)
 		if (CF.vel[0] < 0)
 		{
-			if (!cells[(y)*size[0]+(x-1)].passable)
+			if (!collision.isPassable(x-1, y))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (CF.position[0] - radius <= (float)(x-1)+1 &&
@@ -573,7 +582,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 					CF.vel[0] = -CF.vel[0] * BOUNCE_FACTOR; // On le fait rebondir ! Bedong!
 				}
 			}
-			if (!cells[(y-1)*size[0]+(x-1)].passable)
+			if (!collision.isPassable(x-1, y-1))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (CF.position[0] - radius <= (float)(x-1)+1 &&
@@ -586,7 +595,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 					CF.vel[0] = -CF.vel[0] * BOUNCE_FACTOR; // On le fait rebondir ! Bedong!
 				}
 			}
-			if (!cells[(y+1)*size[0]+(x-1)].passable)
+			if (!collision.isPassable(x-1, y+1))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (CF.position[0] - radius <= (float)(x-1)+1 &&
@@ -602,7 +611,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 		}
 		else if (CF.vel[0] > 0)
 		{
-			if (!cells[(y)*size[0]+(x+1)].passable)
+			if (!collision.isPassable(x+1, y))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (CF.position[0] - radius <= (float)(x+1)+1 &&
@@ -615,7 +624,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 					CF.vel[0] = -CF.vel[0] * BOUNCE_FACTOR; // On le fait rebondir ! Bedong!
 				}
 			}
-			if (!cells[(y-1)*size[0]+(x+1)].passable)
+			if (!collision.isPassable(x+1, y-1))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (CF.position[0] - radius <= (float)(x+1)+1 &&
@@ -628,7 +637,7 @@ void Map::performCollision(CoordFrame & lastCF, CoordFrame & CF, float radius)
 					CF.vel[0] = -CF.vel[0] * BOUNCE_FACTOR; // On le fait rebondir ! Bedong!
 				}
 			}
-			if (!cells[(y+1)*size[0]+(x+1)].passable)
+			if (!collision.isPassable(x+1, y+1))
 			{
 				// Est-ce qu'on entre en collision avec
 				if (CF.position[0] - radius <= (float)(x+1)+1 &&
@@ -653,26 +662,29 @@ void Map::collisionClip(CoordFrame & CF, float radius)
 
 	int x = (int)CF.position[0];
 	int y = (int)CF.position[1];
+
+	//--- No wall in the 8 cells around and not on the border, nothing to clip
+	if (x > 0 && y > 0 && x < size[0]-1 && y < size[1]-1 && collision.getWallDistance(x, y) >= 2) return;
 	
 	// L c simple, on check les 8 cases autour, pis on clip (pour viter de se faire pousser dans le mur
 	if (cells)
 	{
-		if (CF.position[0]+radius+COLLISION_EPSILON > (float)x+1 && !cells[(y)*size[0]+(x+1)].passable)
+		if (CF.position[0]+radius+COLLISION_EPSILON > (float)x+1 && !collision.isPassable(x+1, y))
 		{
 			// On clip
 			CF.position[0] = (float)x+1-radius-COLLISION_EPSILON;
 		}
-		if (CF.position[0]-radius-COLLISION_EPSILON < (float)x && !cells[(y)*size[0]+(x-1)].passable)
+		if (CF.position[0]-radius-COLLISION_EPSILON < (float)x && !collision.isPassable(x-1, y))
 		{
 			// On clip
 			CF.position[0] = (float)x+radius+COLLISION_EPSILON;
 		}
-		if (CF.position[1]+radius+COLLISION_EPSILON > (float)y+1 && !cells[(y+1)*size[0]+(x)].passable)
+		if (CF.position[1]+radius+COLLISION_EPSILON > (float)y+1 && !collision.isPassable(x, y+1))
 		{
 			// On clip
 			CF.position[1] = (float)y+1-radius-COLLISION_EPSILON;
 		}
-		if (CF.position[1]-radius-COLLISION_EPSILON < (float)y && !cells[(y-1)*size[0]+(x)].passable)
+		if (CF.position[1]-radius-COLLISION_EPSILON < (float)y && !collision.isPassable(x, y-1))
 		{
 			// On clip
 			CF.position[1] = (float)y+radius+COLLISION_EPSILON;
@@ -686,23 +698,23 @@ void Map::collisionClip(CoordFrame & CF, float radius)
 	if (y >= size[1]-1) CF.position[1] = size[1]-1 - radius - COLLISION_EPSILON;
 
 	// check if we are in a cell, move to the next allowed cells
-	if (!cells[y * size[0] + x].passable)
+	if (!collision.isPassable(x, y))
 	{
 		bool possible[4] = {false,false,false,false};
 
-		if (cells[(y) * size[0] + (x - 1)].passable)
+		if (collision.isPassable(x - 1, y))
 		{
 			possible[0] = true;
 		}
-		if (cells[(y) * size[0] + (x + 1)].passable)
+		if (collision.isPassable(x + 1, y))
 		{
 			possible[1] = true;
 		}
-		if (cells[(y-1) * size[0] + (x)].passable)
+		if (collision.isPassable(x, y-1))
 		{
 			possible[2] = true;
 		}
-		if (cells[(y+1) * size[0] + (x )].passable)
+		if (collision.isPassable(x, y+1))
 		{
 			possible[3] = true;
 		}
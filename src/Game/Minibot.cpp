@@ -71,8 +71,11 @@ void CMiniBot::Think(float delay)
 	CVector3f p1;
 	CVector3f p2;
 	CVector3f normal;
-	for (i=0;i<MAX_PLAYER;++i)
+	int nearPlayers[SPATIAL_MAX_ENTITY];
+	int nbNear = game->playerGrid.querySphere(currentCF.position, 6, nearPlayers);
+	for (int n=0;n<nbNear;++n)
 	{
+		i = nearPlayers[n];
 		if (game->players[i])
 		{
 			if (game->players[i]->status == PLAYER_STATUS_ALIVE)
@@ -22,6 +22,8 @@
 #include "Map.h"
 #include "Game.h"
 #include "Scene.h"
+#include "Snapshot.h"
+#include "LagCompensation.h"
 #include <limits>
 
 extern Scene * scene;
@@ -129,6 +131,9 @@ Player::Player(char pPlayerID, Map * pMap, Game * pGame): pingLogInterval(0.05f)
 	timePlayedCurGame = 0.0f;
 	waitForPong = false;
 	sendPosFrame=0;
+	snapshotInterval = 0;
+	snapshotHistory = 0;
+	positionHistory = 0;
 #ifndef DEDICATED_SERVER
 #ifndef _DX_
 	//qObj = gluNewQuadric();
@@ -193,6 +198,10 @@ Player::~Player()
 #if defined(_PRO_)
 	if (minibot) delete minibot;
 #endif
+	ZEVEN_SAFE_DELETE(snapshotHistory);
+	ZEVEN_SAFE_DELETE(positionHistory);
+	//--- He leaves the grid, his ID will be given to someone else
+	if (game) game->playerGrid.remove(playerID);
 	//--- Est-ce qu'on est server et que ce player poc�e le flag???
 	if (scene->server)
 	{
@@ -408,7 +417,7 @@ void Player::render()
 #endif
 		//--- TEMP render path with his bot
 #if defined(_PRO_)
-		if (minibot && gameVar.d_showPath)
+		if (minibot && gameVar.d_showPath && game->map->aStar)
 		{
 #ifndef _DX_
 			glColor3f(1, 1, 0);
@@ -841,6 +850,7 @@ void Player::spawn(const CVector3f & spawnPoint)
 	currentCF.position = spawnPoint;
 	currentCF.vel.set(0,0,0);
 	currentCF.angle = 0;
+	if (game) game->playerGrid.update(playerID, currentCF.position);
 
 	lastCF = currentCF;
 	netCF0 = currentCF;
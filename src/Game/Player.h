@@ -42,6 +42,8 @@
 
 class Map;
 class Game;
+class CSnapshotHistory;
+class CPositionHistory;
 
 // Notre coordframe
 struct CoordFrame
@@ -328,6 +330,15 @@ public:
 
 	// To send the position at each x frame
 	int sendPosFrame;
+
+	// Server only, frames between the last two snapshots we sent him
+	int snapshotInterval;
+
+	// Server only, the snapshots we sent to this player
+	CSnapshotHistory * snapshotHistory;
+
+	// Server only, where he was in the last frames (lag compensation)
+	CPositionHistory * positionHistory;
 #ifndef DEDICATED_SERVER
 #ifndef _DX_
 	// Pour dessiner notre sphere
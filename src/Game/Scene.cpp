@@ -21,6 +21,7 @@
 #include "GameVar.h"
 #include "Helper.h"
 #include "CStatus.h"
+#include "Database.h"
 
 
 extern char* bbNetVersion;
@@ -115,23 +116,14 @@ Scene::Scene()
 //	dksPlayMusic("main/sounds/menu.ogg", -1);
 
 	//--- Query from data base if we sent the survey already
-	sqlite3 *DB=0;
-	sqlite3_open("bv2.db",&DB);
-
-	//some infos to load the data
-	char	*zErrMsg;		// holds error msg if any
-	char	**azResult;		// contains the actual returned data
-	int	nRow;			// number of record
-	int	nColumn;		// number of column
-	char	SQL[256];		// the query
-
-	// Get infos of master servers and choose the one with the lowest Score
-	sprintf(SQL,"Select Value From LauncherSettings where Name = 'DidSurvey';");
-	sqlite3_get_table(DB,SQL,&azResult,&nRow,&nColumn,&zErrMsg);
-
-	int didSurvey = atoi(azResult[1]);
-	sqlite3_free_table(azResult);
-	sqlite3_close( DB );
+	int didSurvey = 0;
+	sqlite3_stmt *stmt = database.prepare(DB_SELECT_LAUNCHER_SETTING);
+	if (stmt)
+	{
+		sqlite3_bind_text(stmt, 1, "DidSurvey", -1, SQLITE_STATIC);
+		if (sqlite3_step(stmt) == SQLITE_ROW) didSurvey = sqlite3_column_int(stmt, 0);
+		sqlite3_reset(stmt);
+	}
 	
 	surveySent = (didSurvey == 0 ? false : true);
 
@@ -22,15 +22,11 @@
 #include "RemoteAdminPackets.h"
 #include "CCurl.h"
 #include "ReportGen.h"
+#include "Database.h"
+#include "MapIndex.h"
 #include <time.h>
 #include <fstream>
 #include <algorithm>
-#ifdef WIN32
-	#include <direct.h>
-#else
-	#include <dirent.h>
-    #include <unistd.h>
-#endif
 
 
 
@@ -47,6 +43,7 @@ Server::Server(Game * pGame): maxTimeOverMaxPing(5.0f)//, maxIdleTime(180.0f)
 	needToShutDown = false;
 	pingDelay = 0;
 	changeMapDelay = 0;
+	mapUploadCredit = 0;
 	frameID = 0;
 	autoBalanceTimer = 0;
 	infoSendDelay = 15;
@@ -103,6 +100,13 @@ Server::~Server()
 
     mapList.clear();
 	banList.clear();
+	for (std::size_t i = 0; i < mapFiles.size(); ++i)
+	{
+		delete [] mapFiles[i]->data;
+		delete mapFiles[i];
+	}
+	mapFiles.clear();
+	mapTransfers.clear();
 #ifndef DEDICATED_SERVER
 	dkfDeleteFont(&font);
 #endif
@@ -134,6 +138,10 @@ bool Server::validateVote(CString vote)
 	// Not case sensitive
 	command.toLower();
 
+	// A map vote has to name a map we can play in this game type
+	if (command == "changemap" && var != "" && !mapIndex.supports(var, gameVar.sv_gameType))
+		return false;
+
 	// Compare against allowed commands
 	for (std::vector<CString>::iterator i = voteList.begin(); i != voteList.end(); ++i)
 		if (*i == command)
@@ -157,6 +165,9 @@ int Server::host()
 	}
 	else 
 	{
+		// Index the maps in the background, for the rotation and the votes
+		mapIndex.refresh();
+
 		srand((unsigned int)time(0));
 		game->mapSeed = rand()%1000000; // Quin, 1000000 maps, c tu assez �?
 		game->createMap();
@@ -210,17 +221,12 @@ void Server::changeMap(CString & mapName)
 				mapName = queryNextMap();
 			}
 			//--- Check first is that map exist.
-			CString filename("main/maps/%s.bvm", mapName.s);
-			FILE* fic = fopen(filename.s, "rb");
-			if (!fic)
+			map_meta meta;
+			if (!mapIndex.find(mapName, meta))
 			{
 				console->add(CString("\x9> Warning, map not found %s", mapName.s));
 				return;
 			}
-			else
-			{
-				fclose(fic);
-			}
 			clearStatsCache();
 			nextMap = mapName;
 			changeMapDelay = 10;
@@ -236,17 +242,12 @@ void Server::changeMap(CString & mapName)
 void Server::addmap(CString & mapName)
 {
 	//--- Check first is that map exist.
-	CString filename("main/maps/%s.bvm", mapName.s);
-	FILE* fic = fopen(filename.s, "rb");
-	if (!fic)
+	map_meta meta;
+	if (!mapIndex.find(mapName, meta))
 	{
 		console->add(CString("\x9> Warning, map not found %s", mapName.s), true);
 		return;
 	}
-	else
-	{
-		fclose(fic);
-	}
 
 	// Un map ne peut pas �re l�2 fois (c poche mais c hot)
 	for (int i=0;i<(int)mapList.size();++i)
@@ -282,77 +283,12 @@ void Server::removemap(CString & mapName)
 
 std::vector<CString> Server::populateMapList(bool all)
 {
-	std::vector<CString> maps;
 	if (all == false)
-		maps = mapList;
-	else
-	{
-#ifdef WIN32
-		WIN32_FIND_DATA FindFileData;
-		HANDLE hFind = INVALID_HANDLE_VALUE;
-		char DirSpec[MAX_PATH]; // directory specification
-		DWORD dwError;
-		char appPath[_MAX_PATH];
-
-		// Chercher le path du "current working directory".
-		_getcwd(appPath, _MAX_PATH);
-
-		strncpy(DirSpec, appPath, strlen(appPath)+1);
-		strncat(DirSpec, "\\main\\maps\\*.bvm", strlen("\\main\\maps\\*.bvm")+1);
-
-		hFind = FindFirstFile(DirSpec, &FindFileData);
-
-		if (hFind == INVALID_HANDLE_VALUE)
-		{
-			// Si on ne trouve pas le rA©pertoire dA©sirA©.
-		}
-		else
-		{
-			CString filename = CString(FindFileData.cFileName);
-			filename.resize(filename.len() - 4);
-			maps.push_back(filename);
-
-			while (FindNextFile(hFind, &FindFileData) != 0)
-			{
-				if(!(FindFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
-				{
-					CString filename = CString(FindFileData.cFileName);
-					filename.resize(filename.len() - 4);
-					maps.push_back(filename);
-				}
-			}
-
-			dwError = GetLastError();
-			FindClose(hFind);
-			if (dwError != ERROR_NO_MORE_FILES)
-			{
-				// Si il y a une error en dA©tectant qu'il n'y a plus de fichiers.
-			}
-		}
-#else
-		dirent* file;
-		DIR* hFile;
-        char dirspec[256];
-        getcwd(dirspec, sizeof(dirspec));
-        strcat(dirspec, "/main/maps");
-		hFile = opendir(dirspec);
-		if(hFile)
-		{
-			while(file = readdir(hFile))
-			{
-				char *extension = strrchr(file->d_name, '.');
-				if(extension)
-				{
-					if(!strcasecmp(extension, ".bvm"))
-						maps.push_back(file->d_name);
-				}
-			}
-			closedir(hFile);
-		}
+		return mapList;
 
-#endif
-	}
-	return maps;
+	// Picks up the maps added since the last time
+	mapIndex.refresh();
+	return mapIndex.getMapNames();
 }
 
 
@@ -365,26 +301,12 @@ CString Server::queryNextMap()
 	CString currentName = game->mapName;
 	int lengthDif = mapList.size() - mapInfoList.size();
 	for(int i = (int)mapList.size() - lengthDif; i < (int)mapList.size(); i++)
-	{//because generating the map info requires creating the map and we dont want to do this midgame with the addmap command for fear of bugs, this is kept separately in map list
-		game->mapName = mapList[i];
-		game->createMap();//we just create and add any maps in maplist that arent also in the info list
-		int mapArea = 0;
-		for (int j = 1; j < game->map->size[0] - 1; j++)
-			for (int k = 1; k < game->map->size[1] - 1; k++)
-			{//get the total area
-				if(game->map->cells[k*game->map->size[0] + j].passable)
-				{
-					mapArea++;
-				}
-			}
-		mapInfo mInfo = {game->mapName, mapArea, 1000000000};
+	{//the maps added to mapList since the last time, their area comes from the map index
+		map_meta meta;
+		int mapArea = mapIndex.find(mapList[i], meta) ? meta.mapArea : 0;
+		mapInfo mInfo = {mapList[i], mapArea, 1000000000};
 		mapInfoList.push_back(mInfo);
 	}
-	if (lengthDif > 0)
-	{
-		game->mapName = currentName;
-		game->createMap();//since we're done with the game's map and other functions might not be, we put it back the way we found it, who needs proper OOP when you've got manners anyways?
-	}
 	int indexOfMax = -1;
 	for (int i = 0; i < (int)mapInfoList.size(); ++i)
 	{
@@ -1049,6 +971,7 @@ void Server::update(float delay)
 						long saveFrame = game->players[i]->currentCF.frameID;
 						game->players[i]->currentCF = game->players[i]->netCF1; // Pour les autres joueurs
 						game->players[i]->currentCF.frameID = saveFrame;
+						game->playerGrid.update(i, game->players[i]->currentCF.position);
 						game->players[i]->connectionInterrupted = true;
 						game->players[i]->sendPosFrame = 0; // On interrupt sont envoit de data non important (coordFrame), pour al�er le tout
 					}
@@ -1123,10 +1046,6 @@ void Server::update(float delay)
 		// On check pour sender les coordframes des players au autres players s'il en ont le temps
 		if (game->roundState == GAME_PLAYING)
 		{
-			net_clsv_svcl_player_coord_frame playerCoordFrame;
-#if defined(_PRO_)
-			net_svcl_minibot_coord_frame minibotCoordFrame;
-#endif
 			for (int i=0;i<MAX_PLAYER;i++)
 			{
 				if (game->players[i])
@@ -1134,64 +1053,11 @@ void Server::update(float delay)
 					game->players[i]->sendPosFrame++;
 					if (game->players[i]->sendPosFrame >= game->players[i]->avgPing && game->players[i]->sendPosFrame >= gameVar.sv_minSendInterval + nbPlayers/8)
 					{
+						game->players[i]->snapshotInterval = game->players[i]->sendPosFrame;
 						game->players[i]->sendPosFrame = 0;
 
-						// Lui il est ready �se faire envoyer les coordFrames
-						for (int j=0;j<MAX_PLAYER;++j)
-						{
-							if (game->players[j])
-							{
-								if (j != i && game->players[j]->status == PLAYER_STATUS_ALIVE)
-								{
-									playerCoordFrame.playerID = (char)j;
-									playerCoordFrame.babonetID = game->players[j]->babonetID;
-									playerCoordFrame.frameID = game->players[j]->currentCF.frameID;
-									playerCoordFrame.mousePos[0] = (short)(game->players[j]->currentCF.mousePosOnMap[0] * 100);
-									playerCoordFrame.mousePos[1] = (short)(game->players[j]->currentCF.mousePosOnMap[1] * 100);
-									playerCoordFrame.mousePos[2] = (short)(game->players[j]->currentCF.mousePosOnMap[2] * 100);
-									playerCoordFrame.position[0] = (short)(game->players[j]->currentCF.position[0] * 100);
-									playerCoordFrame.position[1] = (short)(game->players[j]->currentCF.position[1] * 100);
-									playerCoordFrame.position[2] = (short)(game->players[j]->currentCF.position[2] * 100);
-									playerCoordFrame.vel[0] = (char)(game->players[j]->currentCF.vel[0] * 10);
-									playerCoordFrame.vel[1] = (char)(game->players[j]->currentCF.vel[1] * 10);
-									playerCoordFrame.vel[2] = (char)(game->players[j]->currentCF.vel[2] * 10);
-#if defined(_PRO_)
-									playerCoordFrame.camPosZ = 0;
-#endif
-									bb_serverSend((char*)&playerCoordFrame, sizeof(net_clsv_svcl_player_coord_frame), NET_CLSV_SVCL_PLAYER_COORD_FRAME, game->players[i]->babonetID, NET_UDP);
-								}
-
-#if defined(_PRO_)
-								if (game->players[j]->status == PLAYER_STATUS_ALIVE)
-								{
-									//--- Mini bot?
-									if (game->players[j]->minibot)
-									{
-										minibotCoordFrame.playerID = (char)j;
-										minibotCoordFrame.babonetID = game->players[j]->babonetID;
-										minibotCoordFrame.frameID = game->players[j]->currentCF.frameID;
-										minibotCoordFrame.mousePos[0] = (short)(game->players[j]->minibot->currentCF.mousePosOnMap[0] * 100);
-										minibotCoordFrame.mousePos[1] = (short)(game->players[j]->minibot->currentCF.mousePosOnMap[1] * 100);
-										minibotCoordFrame.mousePos[2] = (short)(game->players[j]->minibot->currentCF.mousePosOnMap[2] * 100);
-										minibotCoordFrame.position[0] = (short)(game->players[j]->minibot->currentCF.position[0] * 100);
-										minibotCoordFrame.position[1] = (short)(game->players[j]->minibot->currentCF.position[1] * 100);
-										minibotCoordFrame.position[2] = (short)(game->players[j]->minibot->currentCF.position[2] * 100);
-										minibotCoordFrame.vel[0] = (char)(game->players[j]->minibot->currentCF.vel[0] * 10);
-										minibotCoordFrame.vel[1] = (char)(game->players[j]->minibot->currentCF.vel[1] * 10);
-										minibotCoordFrame.vel[2] = (char)(game->players[j]->minibot->currentCF.vel[2] * 10);
-										
-										bb_serverSend((char*)&minibotCoordFrame, sizeof(net_svcl_minibot_coord_frame), NET_SVCL_MINIBOT_COORD_FRAME, game->players[i]->babonetID, NET_UDP);
-									}
-								}
-#endif
-
-								// On shoot aussi le ping de ce joueur
-								net_svcl_player_ping playerPing;
-								playerPing.playerID = (char)j;
-								playerPing.ping = (short)game->players[j]->ping;
-								bb_serverSend((char*)&playerPing,sizeof(net_svcl_player_ping),NET_SVCL_PLAYER_PING, game->players[i]->babonetID, NET_UDP);
-							}
-						}
+						// He is ready to get the coord frames, minibots and pings of the others
+						sendSnapshot(i);
 
 				/*		for (j=0;j<(int)game->projectiles.size();++j)
 						{
@@ -1340,57 +1206,136 @@ void Server::update(float delay)
 	}
 
 	// Transfer maps
-	int bytesSent = 0;
-	int bytesPerFrame = int(gameVar.sv_maxUploadRate * 1024 / 30);
-	std::vector<SMapTransfer> temp;
+	updateMapTransfers(delay);
+
+
+	frameID++;
+}
+
+
+
+//
+// Start sending a map, the file is read once for everyone downloading it
+//
+bool Server::startMapTransfer(CString mapName, unsigned long bbnetID)
+{
+	if (mapName == "") return false;
 
-	for(std::size_t i = 0; i < mapTransfers.size(); ++i)
+	SMapFile * file = 0;
+	for (std::size_t i = 0; i < mapFiles.size(); ++i)
 	{
-		// Limit upload rate
-		if(bytesSent > bytesPerFrame)
+		if (mapFiles[i]->mapName == mapName)
 		{
-			// If a player can't get a chunk this time, make sure
-			// the transfer is kept
-			temp.push_back(mapTransfers[i]);
-			continue;
+			file = mapFiles[i];
+			break;
 		}
+	}
 
-		// Open map
-        if (mapTransfers[i].mapName != "") {
-            CString filename("main/maps/%s.bvm", mapTransfers[i].mapName.s);
-            FILE* fic = fopen(filename.s, "rb");
+	if (!file)
+	{
+		CString filename("main/maps/%s.bvm", mapName.s);
+		FILE* fic = fopen(filename.s, "rb");
+		if (!fic) return false;
+
+		fseek(fic, 0, SEEK_END);
+		int size = (int)ftell(fic);
+		fseek(fic, 0, SEEK_SET);
+
+		file = new SMapFile;
+		file->mapName = mapName;
+		file->size = 0;
+		file->nbTransfer = 0;
+		file->data = new char[size > 0 ? size : 1];
+		if (size > 0) file->size = (int)fread(file->data, 1, size, fic);
+		fclose(fic);
 
-            if (fic)
-            {
-                net_svcl_map_chunk chunk;
+		mapFiles.push_back(file);
+	}
 
-                // Read in a chunk
-                fseek(fic, 250 * mapTransfers[i].chunkNum, SEEK_SET);
-                chunk.size = (unsigned short)fread(chunk.data, 1, 250, fic);
+	SMapTransfer mtrans;
+	mtrans.uniqueClientID = bbnetID;
+	mtrans.file = file;
+	mtrans.offset = 0;
+	file->nbTransfer++;
 
-                // Send chunk
-                bb_serverSend((char*)&chunk, sizeof(net_svcl_map_chunk), NET_SVCL_MAP_CHUNK, mapTransfers[i].uniqueClientID);
+	mapTransfers.push_back(mtrans);
+	return true;
+}
 
-                // Accumulate bytes sent
-                bytesSent += 250;
 
-                // If some data was sent, keep this transfer
-                if(chunk.size != 0) 
-                {
-                    mapTransfers[i].chunkNum++;
-                    temp.push_back(mapTransfers[i]);
-                }
-            }
 
-            fclose(fic);
-        }
+//
+// Send the next chunks. Each player gets one chunk per round, so they all move
+// at the same speed, until the upload rate is used or they all got MAP_CHUNK_PIPELINE
+//
+void Server::updateMapTransfers(float delay)
+{
+	if (mapTransfers.empty())
+	{
+		mapUploadCredit = 0;
+		return;
 	}
 
-	// Replace old transfer list
-	mapTransfers.swap(temp);
+	// 0 = unlimited
+	bool unlimited = (gameVar.sv_maxUploadRate <= 0);
+	float ratePerSecond = gameVar.sv_maxUploadRate * 1024;
+	mapUploadCredit += ratePerSecond * delay;
+	if (mapUploadCredit > ratePerSecond) mapUploadCredit = ratePerSecond; // No big burst after a lag
 
+	net_svcl_map_chunk chunk;
+	for (int round = 0; round < MAP_CHUNK_PIPELINE; ++round)
+	{
+		bool sent = false;
+		for (std::size_t i = 0; i < mapTransfers.size(); ++i)
+		{
+			if (!unlimited && mapUploadCredit <= 0) break;
 
-	frameID++;
+			SMapTransfer & mtrans = mapTransfers[i];
+			if (!mtrans.file) continue; // Done
+
+			// The last chunk is empty, that's how the client knows it's over
+			int size = mtrans.file->size - mtrans.offset;
+			if (size > MAP_CHUNK_SIZE) size = MAP_CHUNK_SIZE;
+			chunk.size = (unsigned short)size;
+			if (size > 0) memcpy(chunk.data, mtrans.file->data + mtrans.offset, size);
+
+			// Send chunk
+			bb_serverSend((char*)&chunk, sizeof(net_svcl_map_chunk), NET_SVCL_MAP_CHUNK, mtrans.uniqueClientID);
+			mapUploadCredit -= (float)sizeof(net_svcl_map_chunk);
+			mtrans.offset += size;
+			sent = true;
+
+			if (size == 0)
+			{
+				mtrans.file->nbTransfer--;
+				mtrans.file = 0;
+			}
+		}
+		if (!sent) break;
+	}
+
+	// Forget the finished transfers and the maps nobody downloads anymore
+	std::size_t nbTransfer = 0;
+	for (std::size_t i = 0; i < mapTransfers.size(); ++i)
+	{
+		if (mapTransfers[i].file) mapTransfers[nbTransfer++] = mapTransfers[i];
+	}
+	mapTransfers.resize(nbTransfer);
+
+	std::size_t nbFile = 0;
+	for (std::size_t i = 0; i < mapFiles.size(); ++i)
+	{
+		if (mapFiles[i]->nbTransfer > 0)
+		{
+			mapFiles[nbFile++] = mapFiles[i];
+		}
+		else
+		{
+			delete [] mapFiles[i]->data;
+			delete mapFiles[i];
+		}
+	}
+	mapFiles.resize(nbFile);
 }
 
 bool Server::filterMapFromRotation(const mapInfo & map)
@@ -1406,6 +1351,11 @@ bool Server::filterMapFromRotation(const mapInfo & map)
 	}
 	if(nbPlayer < 2)
 		nbPlayer = 2;
+
+	// The next map is played in sv_gameType, don't pick one that can't be
+	if (!mapIndex.supports(map.mapName, gameVar.sv_gameType))
+		return false;
+
 	float tilesPerBabo = map.mapArea/(float)nbPlayer;
 	if (tilesPerBabo < gameVar.sv_minTilesPerBabo || (tilesPerBabo > gameVar.sv_maxTilesPerBabo && gameVar.sv_maxTilesPerBabo != 0))
 		return false;
@@ -1588,39 +1538,31 @@ void Server::sayall(CString message)
 
 std::vector<invalidChecksumEntity> Server::getInvalidChecksums(unsigned long bbnetID, int number, int offsetFromEnd)
 {
-	sqlite3 *DB=0;
-	sqlite3_open("./bv2.db",&DB);
-
 	std::vector<invalidChecksumEntity> list;
-	//some infos to load the data
-	char	*zErrMsg;		// holds error msg if any
-	char	**azResult;		// contains the actual returned data
-	int	nRow;			// number of record
-	int	nColumn;		// number of column
-	char	SQL[256];		// the query
 	int maxRows = 50;
 
 	if (number > maxRows)
 		number = maxRows;
-	//sprintf(SQL, CString("Select IP, Name From BadChecksum limit %i", maxRows).s);
-	sprintf(SQL, CString("Select IP, Name From BadChecksum limit %i offset (select count(*) from BadChecksum) - %i",
-		number, offsetFromEnd).s);
-	sqlite3_get_table(DB,SQL,&azResult,&nRow,&nColumn,&zErrMsg);
+
+	// The inserts and the delete are queued, we want to see them
+	database.flush();
+	sqlite3_stmt *stmt = database.prepare(DB_SELECT_BAD_CHECKSUMS);
+	if (!stmt) return list;
+	sqlite3_bind_int(stmt, 1, number);
+	sqlite3_bind_int(stmt, 2, offsetFromEnd);
+
+	for (int i = 0; sqlite3_step(stmt) == SQLITE_ROW; i++)
 	{
-		for (int i = 0; i < nRow; i++)
-		{
-			invalidChecksumEntity tmp;
-			char* ip = azResult[(i + 1) * nColumn];
-			char* name = azResult[(i + 1) * nColumn + 1];
-			int minLen = static_cast<int>( (strlen(name) < 31) ? strlen(name) : 31 );
-			tmp.id = i + 1;
-			strncpy(tmp.name, name, minLen);
-			strncpy(tmp.playerIP, ip, 16);
-			list.push_back(tmp);
-		}
-		sqlite3_free_table(azResult);
+		invalidChecksumEntity tmp;
+		memset(&tmp, 0, sizeof(invalidChecksumEntity));
+		const char* ip = (const char*)sqlite3_column_text(stmt, 0);
+		const char* name = (const char*)sqlite3_column_text(stmt, 1);
+		tmp.id = i + 1;
+		if (name) strncpy(tmp.name, name, 31);
+		if (ip) strncpy(tmp.playerIP, ip, 15);
+		list.push_back(tmp);
 	}
-	sqlite3_close( DB );
+	sqlite3_reset(stmt);
 	return list;
 }
 
@@ -1663,33 +1605,19 @@ std::vector<invalidChecksumEntity> Server::getInvalidChecksums(unsigned long bbn
 
 void Server::deleteInvalidChecksums()
 {
-	sqlite3 *DB=0;
-	sqlite3_open("./bv2.db",&DB);
-	
-	sqlite3_exec(DB,"delete from BadChecksum",0,0,0);
-	
-	sqlite3_close(DB);
+	database.write(DB_DELETE_BAD_CHECKSUMS);
 }
 
 int Server::getNumberOfInvalidChecksums()
 {
-	sqlite3 *DB=0;
-	sqlite3_open("./bv2.db",&DB);
-
-	//some infos to load the data
-	char	*zErrMsg;		// holds error msg if any
-	char	**azResult;		// contains the actual returned data
-	int	nRow;			// number of record
-	int	nColumn;		// number of column
-	char	SQL[256];		// the query
 	int num = 0;
 
-	sprintf(SQL, "select count(*) as Number from BadChecksum");
-	sqlite3_get_table(DB,SQL,&azResult,&nRow,&nColumn,&zErrMsg);
-	if (nRow == 1)
-		num = atoi(azResult[1]);
-	sqlite3_free_table(azResult);
-	sqlite3_close( DB );
+	database.flush();
+	sqlite3_stmt *stmt = database.prepare(DB_COUNT_BAD_CHECKSUMS);
+	if (!stmt) return num;
+	if (sqlite3_step(stmt) == SQLITE_ROW)
+		num = sqlite3_column_int(stmt, 0);
+	sqlite3_reset(stmt);
 	return num;
 }
 
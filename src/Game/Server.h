@@ -30,9 +30,9 @@
 #if defined(_PRO_)
 	#include "ChecksumQuery.h"
 	#include <vector>
-   #define GAME_VERSION_SV 21100
+   #define GAME_VERSION_SV 21101
 #else
-   #define GAME_VERSION_SV 21000
+   #define GAME_VERSION_SV 21001
 #endif
 
 #define GAME_UPDATE_DELAY 20
@@ -96,15 +96,28 @@ public:
 	int			 CachedIndex; // what index are we going to use for next client
 	cachedPlayer CachedPlayers[50];
 
+	// A map being sent, read once and shared by everyone downloading it
+	struct SMapFile
+	{
+		CString	mapName;
+		char	*data;
+		int		size;
+		int		nbTransfer;	// Freed when it gets to 0
+	};
+	std::vector<SMapFile*> mapFiles;
+
 	// List of players downloading maps (playerID,map)
 	struct SMapTransfer
 	{
 		unsigned long	uniqueClientID;
-		CString	mapName;
-		int		chunkNum;
+		SMapFile	*file;
+		int		offset;		// Next byte to send
 	};
 	std::vector<SMapTransfer> mapTransfers;
 
+	// Bytes we can still upload, refilled at sv_maxUploadRate
+	float mapUploadCredit;
+
 	// List of commands that can be used with vote
 	std::vector<CString> voteList;
 
@@ -138,6 +151,9 @@ public:
 	void updateSnD(float delay);
 	void sendServerInfo();
 
+	// Send the snapshot of every player to one player
+	void sendSnapshot(int playerID);
+
 	// Pour changer la map
 	void changeMap(CString & mapName);
 	void addmap(CString & mapName);
@@ -172,6 +188,12 @@ public:
 	// Send player list to a remote admin
 	void SendPlayerList( long in_peerId );
 
+	// Start sending a map to a player, false if we don't have it
+	bool startMapTransfer(CString mapName, unsigned long bbnetID);
+
+	// Send the next chunks of the map transfers
+	void updateMapTransfers(float delay);
+
 	// Pour aller chercher la prochaine map � loader
 	CString queryNextMap();
 
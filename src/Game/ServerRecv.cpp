@@ -22,7 +22,9 @@
 #include "netPacket.h"
 #include "Console.h"
 #include "Scene.h"
+#include "Snapshot.h"
 #include "CCurl.h"
+#include "Database.h"
 #include <stdio.h>
 #include <string.h>
 extern Scene* scene;
@@ -46,15 +48,10 @@ void Server::recvPacket(char * buffer, int typeID, unsigned long bbnetID)
 		{
 			net_clsv_map_request request;
 			memcpy(&request, buffer, sizeof(net_clsv_map_request));
+			request.mapName[15] = '\0';
 
-			SMapTransfer mtrans;
-            mtrans.chunkNum = 0;
-			mtrans.mapName = request.mapName;
-			mtrans.uniqueClientID = bbnetID;
-
-			// Add to list, server will send chunks on each update
-			mapTransfers.push_back(mtrans);
-            
+			// Server will send chunks on each update
+			startMapTransfer(request.mapName, bbnetID);
 			break;
 		};
 	case NET_CLSV_VOTE:
@@ -326,6 +323,12 @@ void Server::recvPacket(char * buffer, int typeID, unsigned long bbnetID)
 				serverInfo.gameType = game->gameType;
 				bb_serverSend((char*)&serverInfo, sizeof(net_svcl_server_info), NET_SVCL_SERVER_INFO, game->players[gameVersionAccepted.playerID]->babonetID);
 
+				// He starts over, his next snapshots begin a new epoch without bases
+				if (game->players[gameVersionAccepted.playerID]->snapshotHistory)
+				{
+					game->players[gameVersionAccepted.playerID]->snapshotHistory->forgetBases();
+				}
+
 				// On lui envoit l'info sur le round
 				net_svcl_round_state roundState;
 				roundState.newState = game->roundState;
@@ -664,6 +667,20 @@ void Server::recvPacket(char * buffer, int typeID, unsigned long bbnetID)
 			}
 			break;
 		}
+	case NET_CLSV_SNAPSHOT_ACK:
+		{
+			net_clsv_snapshot_ack snapshotAck;
+			memcpy(&snapshotAck, buffer, sizeof(net_clsv_snapshot_ack));
+			if (snapshotAck.playerID >= 0 && snapshotAck.playerID < MAX_PLAYER)
+			{
+				Player * player = game->players[snapshotAck.playerID];
+				if (player && player->babonetID == bbnetID && player->snapshotHistory)
+				{
+					player->snapshotHistory->acknowledge(snapshotAck.snapshotID);
+				}
+			}
+			break;
+		}
 	case NET_CLSV_SPAWN_REQUEST:
 		{
 			// Tout respawn sera refussi on a fini le round ou la game
@@ -1193,14 +1210,7 @@ void Server::recvPacket(char * buffer, int typeID, unsigned long bbnetID)
 					{
 						console->add(CString("\x9> Player %s was NOT successfully authenticated", game->players[m_checksumQueries[y]->GetID()]->name.s));
 						// this client isnt good, log IP + Name in the local database
-						sqlite3 *DB=0;
-						sqlite3_open("bv2.db",&DB);
-						char	SQL[300];
-						
-						sprintf(SQL,"Insert into BadChecksum(IP,Name) Values('%s','%s')", game->players[m_checksumQueries[y]->GetID()]->playerIP,game->players[m_checksumQueries[y]->GetID()]->name.s);
-						sqlite3_exec(DB,SQL,0,0,0);
-						
-						sqlite3_close(DB);						
+						database.write(DB_INSERT_BAD_CHECKSUM, game->players[m_checksumQueries[y]->GetID()]->playerIP, game->players[m_checksumQueries[y]->GetID()]->name.s);
 					}
 					delete m_checksumQueries[y];
 					m_checksumQueries.erase( m_checksumQueries.begin() + y );
@@ -0,0 +1,118 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "Server.h"
+#include "Console.h"
+#include "Snapshot.h"
+
+
+// The history has one entity slot per player
+static_assert(SNAPSHOT_MAX_ENTITY >= MAX_PLAYER, "SNAPSHOT_MAX_ENTITY must hold every player");
+
+
+
+//
+// Send the state of every player to one player. Each entity is
+// delta compressed against the last snapshot he acknowledged.
+//
+void Server::sendSnapshot(int receiverID)
+{
+	Player * receiver = game->players[receiverID];
+	if (!receiver) return;
+	if (!receiver->snapshotHistory) receiver->snapshotHistory = new CSnapshotHistory();
+	CSnapshotHistory * history = receiver->snapshotHistory;
+
+	char buffer[SNAPSHOT_MAX_SIZE + SNAPSHOT_MAX_ENTITY_SIZE];
+	net_svcl_snapshot snapshot;
+	SSnapshotFrame * frame = 0;
+	int size = sizeof(net_svcl_snapshot);
+	snapshot.nbEntity = 0;
+
+	for (int j=0;j<MAX_PLAYER;++j)
+	{
+		Player * player = game->players[j];
+		if (!player) continue;
+
+		//--- Quantize it like the old coord frames
+		SSnapshotState current;
+		current.reset();
+		current.frameID = (int32_t)player->currentCF.frameID;
+		current.position[0] = (short)(player->currentCF.position[0] * 100);
+		current.position[1] = (short)(player->currentCF.position[1] * 100);
+		current.position[2] = (short)(player->currentCF.position[2] * 100);
+		current.vel[0] = (char)(player->currentCF.vel[0] * 10);
+		current.vel[1] = (char)(player->currentCF.vel[1] * 10);
+		current.vel[2] = (char)(player->currentCF.vel[2] * 10);
+		current.mousePos[0] = (short)(player->currentCF.mousePosOnMap[0] * 100);
+		current.mousePos[1] = (short)(player->currentCF.mousePosOnMap[1] * 100);
+		current.mousePos[2] = (short)(player->currentCF.mousePosOnMap[2] * 100);
+		current.ping = (short)player->ping;
+		current.babonetID = (int32_t)player->babonetID;
+
+		unsigned short present = 0;
+		if (j != receiverID && player->status == PLAYER_STATUS_ALIVE) present |= SNAPSHOT_COORD;
+#if defined(_PRO_)
+		//--- Mini bot?
+		if (player->status == PLAYER_STATUS_ALIVE && player->minibot)
+		{
+			present |= SNAPSHOT_MINIBOT;
+			current.botPosition[0] = (short)(player->minibot->currentCF.position[0] * 100);
+			current.botPosition[1] = (short)(player->minibot->currentCF.position[1] * 100);
+			current.botPosition[2] = (short)(player->minibot->currentCF.position[2] * 100);
+			current.botVel[0] = (char)(player->minibot->currentCF.vel[0] * 10);
+			current.botVel[1] = (char)(player->minibot->currentCF.vel[1] * 10);
+			current.botVel[2] = (char)(player->minibot->currentCF.vel[2] * 10);
+			current.botMousePos[0] = (short)(player->minibot->currentCF.mousePosOnMap[0] * 100);
+			current.botMousePos[1] = (short)(player->minibot->currentCF.mousePosOnMap[1] * 100);
+			current.botMousePos[2] = (short)(player->minibot->currentCF.mousePosOnMap[2] * 100);
+		}
+#endif
+
+		//--- Full? We send that part and start a new snapshot
+		if (frame && size + (int)SNAPSHOT_MAX_ENTITY_SIZE > SNAPSHOT_MAX_SIZE)
+		{
+			memcpy(buffer, &snapshot, sizeof(net_svcl_snapshot));
+			bb_serverSend(buffer, size, NET_SVCL_SNAPSHOT, receiver->babonetID, NET_UDP);
+			frame = 0;
+			size = sizeof(net_svcl_snapshot);
+			snapshot.nbEntity = 0;
+		}
+		if (!frame)
+		{
+			snapshot.snapshotID = ++history->lastSnapshotID;
+			snapshot.epoch = history->epoch;
+			frame = &(history->beginFrame(snapshot.snapshotID));
+		}
+
+		unsigned char baseDelta;
+		const SSnapshotState * base = history->getBase(snapshot.snapshotID, j, baseDelta);
+		int written = snapshotWriteEntity(buffer + size, (char)j, baseDelta, base, current, present, frame->states[j]);
+		if (written)
+		{
+			frame->included[j] = true;
+			size += written;
+			snapshot.nbEntity++;
+		}
+	}
+
+	if (frame && snapshot.nbEntity > 0)
+	{
+		memcpy(buffer, &snapshot, sizeof(net_svcl_snapshot));
+		bb_serverSend(buffer, size, NET_SVCL_SNAPSHOT, receiver->babonetID, NET_UDP);
+	}
+}
@@ -0,0 +1,365 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "Snapshot.h"
+#include <string.h>
+
+
+
+void SSnapshotState::reset()
+{
+	memset(this, 0, sizeof(SSnapshotState));
+}
+
+
+
+//
+// Constructeur
+//
+CSnapshotHistory::CSnapshotHistory()
+{
+	reset();
+}
+
+
+
+//
+// Forget everything
+//
+void CSnapshotHistory::reset()
+{
+	lastSnapshotID = 0;
+	epoch = 0;
+	minAckID = 0;
+	for (int i=0;i<SNAPSHOT_MAX_ENTITY;++i) ackedID[i] = 0;
+	for (int i=0;i<SNAPSHOT_BACKUP;++i)
+	{
+		frames[i].snapshotID = 0;
+		memset(frames[i].included, 0, sizeof(frames[i].included));
+	}
+}
+
+
+
+//
+// Start recording a snapshot
+//
+SSnapshotFrame & CSnapshotHistory::beginFrame(int32_t snapshotID)
+{
+	SSnapshotFrame & frame = frames[snapshotID % SNAPSHOT_BACKUP];
+	frame.snapshotID = snapshotID;
+	memset(frame.included, 0, sizeof(frame.included));
+	return frame;
+}
+
+
+
+//
+// The state of a player in an old snapshot
+//
+const SSnapshotState * CSnapshotHistory::getState(int32_t snapshotID, int playerID) const
+{
+	if (snapshotID <= 0 || playerID < 0 || playerID >= SNAPSHOT_MAX_ENTITY) return 0;
+
+	const SSnapshotFrame & frame = frames[snapshotID % SNAPSHOT_BACKUP];
+	if (frame.snapshotID != snapshotID || !frame.included[playerID]) return 0;
+
+	return &(frame.states[playerID]);
+}
+
+
+
+//
+// The base to use for a player
+//
+const SSnapshotState * CSnapshotHistory::getBase(int32_t snapshotID, int playerID, unsigned char & baseDelta) const
+{
+	baseDelta = 0;
+
+	// The slot of a base that old has been reused by now
+	int32_t baseID = ackedID[playerID];
+	if (baseID <= 0 || snapshotID - baseID <= 0 || snapshotID - baseID >= SNAPSHOT_BACKUP) return 0;
+
+	const SSnapshotState * base = getState(baseID, playerID);
+	if (base) baseDelta = (unsigned char)(snapshotID - baseID);
+	return base;
+}
+
+
+
+//
+// The client got that snapshot
+//
+void CSnapshotHistory::acknowledge(int32_t snapshotID)
+{
+	if (snapshotID <= 0 || snapshotID > lastSnapshotID) return;
+	if (snapshotID < minAckID) return; // From the previous epoch
+
+	const SSnapshotFrame & frame = frames[snapshotID % SNAPSHOT_BACKUP];
+	if (frame.snapshotID != snapshotID) return; // Too old
+
+	for (int i=0;i<SNAPSHOT_MAX_ENTITY;++i)
+	{
+		if (frame.included[i] && snapshotID > ackedID[i])
+		{
+			ackedID[i] = snapshotID;
+		}
+	}
+}
+
+
+
+//
+// Start a new epoch on the server
+//
+void CSnapshotHistory::forgetBases()
+{
+	for (int i=0;i<SNAPSHOT_MAX_ENTITY;++i) ackedID[i] = 0;
+	minAckID = lastSnapshotID + 1;
+	epoch++;
+}
+
+
+
+//
+// Follow the server in its new epoch. lastSnapshotID is kept so the
+// late snapshots of the old epoch are still dropped as out of order.
+//
+void CSnapshotHistory::startEpoch(unsigned char newEpoch)
+{
+	for (int i=0;i<SNAPSHOT_BACKUP;++i)
+	{
+		frames[i].snapshotID = 0;
+		memset(frames[i].included, 0, sizeof(frames[i].included));
+	}
+	epoch = newEpoch;
+}
+
+
+
+//
+// Size of the fields that follow an entity header
+//
+static int snapshotFieldsSize(unsigned short fields)
+{
+	int size = 0;
+	if (fields & SNAPSHOT_FRAMEID_DELTA) size += 1;
+	if (fields & SNAPSHOT_FRAMEID) size += sizeof(int32_t);
+	if (fields & SNAPSHOT_POSITION) size += sizeof(short) * 3;
+	if (fields & SNAPSHOT_VEL) size += sizeof(char) * 3;
+	if (fields & SNAPSHOT_MOUSEPOS) size += sizeof(short) * 3;
+	if (fields & SNAPSHOT_PING) size += sizeof(short);
+	if (fields & SNAPSHOT_BABONETID) size += sizeof(int32_t);
+	if (fields & SNAPSHOT_MINIBOT_POSITION) size += sizeof(short) * 3;
+	if (fields & SNAPSHOT_MINIBOT_VEL) size += sizeof(char) * 3;
+	if (fields & SNAPSHOT_MINIBOT_MOUSEPOS) size += sizeof(short) * 3;
+	return size;
+}
+
+
+
+//
+// Write one entity
+//
+int snapshotWriteEntity(char * buffer, char playerID, unsigned char baseDelta, const SSnapshotState * base,
+						const SSnapshotState & current, unsigned short present, SSnapshotState & result)
+{
+	SSnapshotState empty;
+	empty.reset();
+	if (!base)
+	{
+		base = &empty;
+		baseDelta = 0;
+	}
+	result = *base;
+
+	net_svcl_snapshot_entity entity;
+	entity.playerID = playerID;
+	entity.baseDelta = baseDelta;
+	entity.fields = present & (SNAPSHOT_COORD | SNAPSHOT_MINIBOT);
+
+	//--- The minibot uses the frameID of his owner
+	if (present & (SNAPSHOT_COORD | SNAPSHOT_MINIBOT))
+	{
+		int32_t frameDelta = current.frameID - base->frameID;
+		if (frameDelta > 0 && frameDelta < 256 && baseDelta) entity.fields |= SNAPSHOT_FRAMEID_DELTA;
+		else if (frameDelta != 0) entity.fields |= SNAPSHOT_FRAMEID;
+	}
+	if (present & SNAPSHOT_COORD)
+	{
+		if (memcmp(current.position, base->position, sizeof(current.position))) entity.fields |= SNAPSHOT_POSITION;
+		if (memcmp(current.vel, base->vel, sizeof(current.vel))) entity.fields |= SNAPSHOT_VEL;
+		if (memcmp(current.mousePos, base->mousePos, sizeof(current.mousePos))) entity.fields |= SNAPSHOT_MOUSEPOS;
+	}
+	if (current.ping != base->ping) entity.fields |= SNAPSHOT_PING;
+	if (current.babonetID != base->babonetID) entity.fields |= SNAPSHOT_BABONETID;
+	if (present & SNAPSHOT_MINIBOT)
+	{
+		if (memcmp(current.botPosition, base->botPosition, sizeof(current.botPosition))) entity.fields |= SNAPSHOT_MINIBOT_POSITION;
+		if (memcmp(current.botVel, base->botVel, sizeof(current.botVel))) entity.fields |= SNAPSHOT_MINIBOT_VEL;
+		if (memcmp(current.botMousePos, base->botMousePos, sizeof(current.botMousePos))) entity.fields |= SNAPSHOT_MINIBOT_MOUSEPOS;
+	}
+
+	// Nothing new for that guy
+	if (!entity.fields) return 0;
+
+	int size = 0;
+	memcpy(buffer + size, &entity, sizeof(net_svcl_snapshot_entity));
+	size += sizeof(net_svcl_snapshot_entity);
+
+	if (entity.fields & SNAPSHOT_FRAMEID_DELTA)
+	{
+		unsigned char frameDelta = (unsigned char)(current.frameID - base->frameID);
+		buffer[size++] = (char)frameDelta;
+		result.frameID = current.frameID;
+	}
+	if (entity.fields & SNAPSHOT_FRAMEID)
+	{
+		memcpy(buffer + size, &current.frameID, sizeof(current.frameID));
+		size += sizeof(current.frameID);
+		result.frameID = current.frameID;
+	}
+	if (entity.fields & SNAPSHOT_POSITION)
+	{
+		memcpy(buffer + size, current.position, sizeof(current.position));
+		size += sizeof(current.position);
+		memcpy(result.position, current.position, sizeof(current.position));
+	}
+	if (entity.fields & SNAPSHOT_VEL)
+	{
+		memcpy(buffer + size, current.vel, sizeof(current.vel));
+		size += sizeof(current.vel);
+		memcpy(result.vel, current.vel, sizeof(current.vel));
+	}
+	if (entity.fields & SNAPSHOT_MOUSEPOS)
+	{
+		memcpy(buffer + size, current.mousePos, sizeof(current.mousePos));
+		size += sizeof(current.mousePos);
+		memcpy(result.mousePos, current.mousePos, sizeof(current.mousePos));
+	}
+	if (entity.fields & SNAPSHOT_PING)
+	{
+		memcpy(buffer + size, &current.ping, sizeof(current.ping));
+		size += sizeof(current.ping);
+		result.ping = current.ping;
+	}
+	if (entity.fields & SNAPSHOT_BABONETID)
+	{
+		memcpy(buffer + size, &current.babonetID, sizeof(current.babonetID));
+		size += sizeof(current.babonetID);
+		result.babonetID = current.babonetID;
+	}
+	if (entity.fields & SNAPSHOT_MINIBOT_POSITION)
+	{
+		memcpy(buffer + size, current.botPosition, sizeof(current.botPosition));
+		size += sizeof(current.botPosition);
+		memcpy(result.botPosition, current.botPosition, sizeof(current.botPosition));
+	}
+	if (entity.fields & SNAPSHOT_MINIBOT_VEL)
+	{
+		memcpy(buffer + size, current.botVel, sizeof(current.botVel));
+		size += sizeof(current.botVel);
+		memcpy(result.botVel, current.botVel, sizeof(current.botVel));
+	}
+	if (entity.fields & SNAPSHOT_MINIBOT_MOUSEPOS)
+	{
+		memcpy(buffer + size, current.botMousePos, sizeof(current.botMousePos));
+		size += sizeof(current.botMousePos);
+		memcpy(result.botMousePos, current.botMousePos, sizeof(current.botMousePos));
+	}
+
+	return size;
+}
+
+
+
+//
+// Read one entity
+//
+int snapshotReadEntity(const char * buffer, int sizeLeft, int32_t snapshotID, const CSnapshotHistory & history,
+					   net_svcl_snapshot_entity & entity, SSnapshotState & result, bool & valid)
+{
+	valid = false;
+	if (sizeLeft < (int)sizeof(net_svcl_snapshot_entity)) return -1;
+
+	int size = 0;
+	memcpy(&entity, buffer + size, sizeof(net_svcl_snapshot_entity));
+	size += sizeof(net_svcl_snapshot_entity);
+	if (size + snapshotFieldsSize(entity.fields) > sizeLeft) return -1;
+
+	valid = true;
+	result.reset();
+	if (entity.baseDelta)
+	{
+		const SSnapshotState * base = history.getState(snapshotID - entity.baseDelta, entity.playerID);
+		if (base) result = *base;
+		else valid = false; // We still have to walk over the fields
+	}
+
+	if (entity.fields & SNAPSHOT_FRAMEID_DELTA)
+	{
+		result.frameID += (unsigned char)buffer[size++];
+	}
+	if (entity.fields & SNAPSHOT_FRAMEID)
+	{
+		memcpy(&result.frameID, buffer + size, sizeof(result.frameID));
+		size += sizeof(result.frameID);
+	}
+	if (entity.fields & SNAPSHOT_POSITION)
+	{
+		memcpy(result.position, buffer + size, sizeof(result.position));
+		size += sizeof(result.position);
+	}
+	if (entity.fields & SNAPSHOT_VEL)
+	{
+		memcpy(result.vel, buffer + size, sizeof(result.vel));
+		size += sizeof(result.vel);
+	}
+	if (entity.fields & SNAPSHOT_MOUSEPOS)
+	{
+		memcpy(result.mousePos, buffer + size, sizeof(result.mousePos));
+		size += sizeof(result.mousePos);
+	}
+	if (entity.fields & SNAPSHOT_PING)
+	{
+		memcpy(&result.ping, buffer + size, sizeof(result.ping));
+		size += sizeof(result.ping);
+	}
+	if (entity.fields & SNAPSHOT_BABONETID)
+	{
+		memcpy(&result.babonetID, buffer + size, sizeof(result.babonetID));
+		size += sizeof(result.babonetID);
+	}
+	if (entity.fields & SNAPSHOT_MINIBOT_POSITION)
+	{
+		memcpy(result.botPosition, buffer + size, sizeof(result.botPosition));
+		size += sizeof(result.botPosition);
+	}
+	if (entity.fields & SNAPSHOT_MINIBOT_VEL)
+	{
+		memcpy(result.botVel, buffer + size, sizeof(result.botVel));
+		size += sizeof(result.botVel);
+	}
+	if (entity.fields & SNAPSHOT_MINIBOT_MOUSEPOS)
+	{
+		memcpy(result.botMousePos, buffer + size, sizeof(result.botMousePos));
+		size += sizeof(result.botMousePos);
+	}
+
+	return size;
+}
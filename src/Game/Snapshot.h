@@ -0,0 +1,123 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+
+#include "netPacket.h"
+
+// How many snapshots we remember. A base older than that is forgotten
+// and the entity is sent in full again.
+#define SNAPSHOT_BACKUP 32
+
+// One entry per player slot, must hold MAX_PLAYER (checked in ServerSnapshot.cpp)
+#define SNAPSHOT_MAX_ENTITY 32
+
+// Biggest snapshot message. Bigger snapshots are split in many messages,
+// each with its own snapshotID. cClient::SendUDP packs up to ~500 bytes per datagram.
+#define SNAPSHOT_MAX_SIZE 480
+
+// Worst case size of one entity, header + every field
+#define SNAPSHOT_MAX_ENTITY_SIZE (sizeof(net_svcl_snapshot_entity) + 4 + 6 + 3 + 6 + 2 + 4 + 6 + 3 + 6)
+
+
+// The quantized state of one player, exactly what goes on the wire
+struct SSnapshotState
+{
+	int32_t frameID;
+	short position[3];
+	char vel[3];
+	short mousePos[3];
+	short ping;
+	int32_t babonetID;
+	short botPosition[3];
+	char botVel[3];
+	short botMousePos[3];
+
+	void reset();
+};
+
+// What a snapshot contained, server side what we sent, client side what we received
+struct SSnapshotFrame
+{
+	int32_t snapshotID;
+	bool included[SNAPSHOT_MAX_ENTITY];
+	SSnapshotState states[SNAPSHOT_MAX_ENTITY];
+};
+
+
+class CSnapshotHistory
+{
+public:
+	// Server : the last snapshotID emitted. Client : the last one received
+	int32_t lastSnapshotID;
+
+	// Server only : newest acknowledged snapshot that carried each player
+	int32_t ackedID[SNAPSHOT_MAX_ENTITY];
+
+	// Bumped by the server each time it drops its bases, sent in every snapshot.
+	// The client starts over when it sees a new one, so both sides agree.
+	unsigned char epoch;
+
+	// Server only : acks older than that are from before the last forgetBases()
+	int32_t minAckID;
+
+	SSnapshotFrame frames[SNAPSHOT_BACKUP];
+
+public:
+	// Constructeur
+	CSnapshotHistory();
+
+	// Forget everything, on a new game state
+	void reset();
+
+	// Start recording a snapshot, this reuses the oldest slot
+	SSnapshotFrame & beginFrame(int32_t snapshotID);
+
+	// The state of a player in a snapshot we still have, 0 if we don't
+	const SSnapshotState * getState(int32_t snapshotID, int playerID) const;
+
+	// The base to delta against for a player in the snapshot being built (server)
+	const SSnapshotState * getBase(int32_t snapshotID, int playerID, unsigned char & baseDelta) const;
+
+	// The client received that snapshot (server)
+	void acknowledge(int32_t snapshotID);
+
+	// Stop delta'ing against what the client had, a new epoch starts (server)
+	void forgetBases();
+
+	// The server started a new epoch, drop the old bases but keep the sequence (client)
+	void startEpoch(unsigned char newEpoch);
+};
+
+
+// Write one entity, only the fields that changed since base (0 = no base).
+// present holds SNAPSHOT_COORD and/or SNAPSHOT_MINIBOT.
+// result receives the state the client will rebuild. Returns the size written, 0 if nothing changed.
+int snapshotWriteEntity(char * buffer, char playerID, unsigned char baseDelta, const SSnapshotState * base,
+						const SSnapshotState & current, unsigned short present, SSnapshotState & result);
+
+// Read back one entity of snapshot snapshotID, the base is taken from history.
+// valid is false if we don't have the base anymore. Returns the size read,
+// -1 if the entity doesn't fit in the size bytes left in the message.
+int snapshotReadEntity(const char * buffer, int size, int32_t snapshotID, const CSnapshotHistory & history,
+					   net_svcl_snapshot_entity & entity, SSnapshotState & result, bool & valid);
+
+
+#endif
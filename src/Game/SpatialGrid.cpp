@@ -0,0 +1,241 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "SpatialGrid.h"
+#include <math.h>
+
+
+// The border cells also hold everything outside the map
+#define SPATIAL_FAR 1000000.0f
+
+
+
+//
+// Constructeur
+//
+CSpatialGrid::CSpatialGrid()
+{
+	width = 0;
+	height = 0;
+	cellHead = 0;
+	resize(0, 0);
+}
+
+
+
+//
+// Destructeur
+//
+CSpatialGrid::~CSpatialGrid()
+{
+	if (cellHead) delete [] cellHead;
+}
+
+
+
+//
+// Cover the map
+//
+void CSpatialGrid::resize(int mapWidth, int mapHeight)
+{
+	if (cellHead) delete [] cellHead;
+
+	//--- At least one cell, so an empty map still works
+	width = (mapWidth + SPATIAL_CELL_SIZE - 1) / SPATIAL_CELL_SIZE;
+	height = (mapHeight + SPATIAL_CELL_SIZE - 1) / SPATIAL_CELL_SIZE;
+	if (width < 1) width = 1;
+	if (height < 1) height = 1;
+
+	cellHead = new int [width * height];
+	for (int i=0;i<width*height;++i) cellHead[i] = -1;
+	for (int i=0;i<SPATIAL_MAX_ENTITY;++i)
+	{
+		next[i] = -1;
+		prev[i] = -1;
+		cell[i] = -1;
+	}
+}
+
+
+
+//
+// The cell of a point
+//
+int CSpatialGrid::getCellX(float x) const
+{
+	int cx = (int)floorf(x / (float)SPATIAL_CELL_SIZE);
+	if (cx < 0) return 0;
+	if (cx >= width) return width - 1;
+	return cx;
+}
+
+int CSpatialGrid::getCellY(float y) const
+{
+	int cy = (int)floorf(y / (float)SPATIAL_CELL_SIZE);
+	if (cy < 0) return 0;
+	if (cy >= height) return height - 1;
+	return cy;
+}
+
+
+
+//
+// The entity moved
+//
+void CSpatialGrid::update(int id, const CVector3f & position)
+{
+	if (id < 0 || id >= SPATIAL_MAX_ENTITY) return;
+
+	int cellID = getCellY(position[1]) * width + getCellX(position[0]);
+	if (cellID == cell[id]) return; // Still in the same cell, most of the time
+
+	remove(id);
+
+	cell[id] = cellID;
+	prev[id] = -1;
+	next[id] = cellHead[cellID];
+	if (next[id] != -1) prev[next[id]] = id;
+	cellHead[cellID] = id;
+}
+
+
+
+//
+// The entity is gone
+//
+void CSpatialGrid::remove(int id)
+{
+	if (id < 0 || id >= SPATIAL_MAX_ENTITY) return;
+	if (cell[id] == -1) return;
+
+	if (prev[id] != -1) next[prev[id]] = next[id];
+	else cellHead[cell[id]] = next[id];
+	if (next[id] != -1) prev[next[id]] = prev[id];
+
+	next[id] = -1;
+	prev[id] = -1;
+	cell[id] = -1;
+}
+
+
+
+//
+// Add the entities of a cell
+//
+int CSpatialGrid::addCell(int cellID, int * result, int nbResult) const
+{
+	for (int id=cellHead[cellID];id!=-1;id=next[id])
+	{
+		//--- Sorted insert, the callers expect the same order as a loop on the IDs
+		int i = nbResult++;
+		while (i > 0 && result[i-1] > id)
+		{
+			result[i] = result[i-1];
+			--i;
+		}
+		result[i] = id;
+	}
+	return nbResult;
+}
+
+
+
+//
+// The entities in a box
+//
+int CSpatialGrid::queryAABB(float minX, float minY, float maxX, float maxY, int * result) const
+{
+	int x1 = getCellX(minX - SPATIAL_MARGIN);
+	int y1 = getCellY(minY - SPATIAL_MARGIN);
+	int x2 = getCellX(maxX + SPATIAL_MARGIN);
+	int y2 = getCellY(maxY + SPATIAL_MARGIN);
+
+	int nbResult = 0;
+	for (int y=y1;y<=y2;++y)
+	{
+		for (int x=x1;x<=x2;++x)
+		{
+			nbResult = addCell(y * width + x, result, nbResult);
+		}
+	}
+	return nbResult;
+}
+
+
+
+//
+// The entities near a point
+//
+int CSpatialGrid::querySphere(const CVector3f & center, float radius, int * result) const
+{
+	return queryAABB(center[0] - radius, center[1] - radius, center[0] + radius, center[1] + radius, result);
+}
+
+
+
+//
+// The entities near a segment
+//
+int CSpatialGrid::querySegment(const CVector3f & p1, const CVector3f & p2, float radius, int * result) const
+{
+	radius += SPATIAL_MARGIN;
+
+	int x1 = getCellX(((p1[0] < p2[0]) ? p1[0] : p2[0]) - radius);
+	int y1 = getCellY(((p1[1] < p2[1]) ? p1[1] : p2[1]) - radius);
+	int x2 = getCellX(((p1[0] > p2[0]) ? p1[0] : p2[0]) + radius);
+	int y2 = getCellY(((p1[1] > p2[1]) ? p1[1] : p2[1]) + radius);
+
+	float dir[2] = {p2[0] - p1[0], p2[1] - p1[1]};
+
+	int nbResult = 0;
+	for (int y=y1;y<=y2;++y)
+	{
+		for (int x=x1;x<=x2;++x)
+		{
+			int cellID = y * width + x;
+			if (cellHead[cellID] == -1) continue;
+
+			//--- The cell grown by radius, does the segment cross it? (slab test)
+			float boxMin[2] = {(x == 0) ? -SPATIAL_FAR : (float)(x * SPATIAL_CELL_SIZE) - radius,
+							   (y == 0) ? -SPATIAL_FAR : (float)(y * SPATIAL_CELL_SIZE) - radius};
+			float boxMax[2] = {(x == width-1) ? SPATIAL_FAR : (float)((x+1) * SPATIAL_CELL_SIZE) + radius,
+							   (y == height-1) ? SPATIAL_FAR : (float)((y+1) * SPATIAL_CELL_SIZE) + radius};
+			float tMin = 0;
+			float tMax = 1;
+			bool crossing = true;
+			for (int i=0;i<2 && crossing;++i)
+			{
+				if (fabsf(dir[i]) < 0.0001f)
+				{
+					if (p1[i] < boxMin[i] || p1[i] > boxMax[i]) crossing = false;
+				}
+				else
+				{
+					float t1 = (boxMin[i] - p1[i]) / dir[i];
+					float t2 = (boxMax[i] - p1[i]) / dir[i];
+					if (t1 > t2) {float t = t1; t1 = t2; t2 = t;}
+					if (t1 > tMin) tMin = t1;
+					if (t2 < tMax) tMax = t2;
+					if (tMin > tMax) crossing = false;
+				}
+			}
+			if (crossing) nbResult = addCell(cellID, result, nbResult);
+		}
+	}
+	return nbResult;
+}
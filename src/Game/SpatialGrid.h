@@ -0,0 +1,92 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+
+#include "CVector.h"
+
+// One grid cell covers that many map cells on each side
+#define SPATIAL_CELL_SIZE 4
+
+// One entry per player slot (same as MAX_PLAYER)
+#define SPATIAL_MAX_ENTITY 32
+
+// Entities can move a bit between their last update and a query
+// (the players are updated one after the other during the frame)
+#define SPATIAL_MARGIN 1.0f
+
+
+// Uniform grid over the map, to only test the entities near a shot or an explosion.
+// The queries are a broad phase, the caller still does the exact test.
+class CSpatialGrid
+{
+private:
+	// Size in grid cells
+	int width;
+	int height;
+
+	// First entity of each cell, -1 if empty
+	int * cellHead;
+
+	// Linked list of the entities in a cell, cell is -1 if not in the grid
+	int next[SPATIAL_MAX_ENTITY];
+	int prev[SPATIAL_MAX_ENTITY];
+	int cell[SPATIAL_MAX_ENTITY];
+
+	// No copy, we own cellHead
+	CSpatialGrid(const CSpatialGrid &);
+	CSpatialGrid & operator=(const CSpatialGrid &);
+
+	// The cell containing that point, clamped on the border cells
+	int getCellX(float x) const;
+	int getCellY(float y) const;
+
+	// Add the entities of the cell to result, returns the new count
+	int addCell(int cellID, int * result, int nbResult) const;
+
+public:
+	// Constructeur
+	CSpatialGrid();
+
+	// Destructeur
+	virtual ~CSpatialGrid();
+
+	// Cover a map of that size (in map cells). This empties the grid.
+	void resize(int mapWidth, int mapHeight);
+
+	// The entity moved (or appeared)
+	void update(int id, const CVector3f & position);
+
+	// The entity is gone
+	void remove(int id);
+
+	// The entities that may be inside that box, in result (SPATIAL_MAX_ENTITY big).
+	// They are sorted by ID. Returns how many.
+	int queryAABB(float minX, float minY, float maxX, float maxY, int * result) const;
+
+	// The entities that may be within radius of center
+	int querySphere(const CVector3f & center, float radius, int * result) const;
+
+	// The entities that may be within radius of the segment p1 p2
+	int querySegment(const CVector3f & p1, const CVector3f & p2, float radius, int * result) const;
+};
+
+
+#endif
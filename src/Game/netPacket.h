@@ -103,6 +103,14 @@ struct net_clsv_map_list_request
 	bool all;
 };
 
+// The client got a snapshot, the server can now use it as a delta base
+#define NET_CLSV_SNAPSHOT_ACK 9
+struct net_clsv_snapshot_ack
+{
+	char playerID;
+	int32_t snapshotID; // The snapshot we received
+};
+
 // Le server accept une new connection, il envoit � tout le monde le ID du joueur
 #define NET_SVCL_NEWPLAYER 101
 struct net_svcl_newplayer
@@ -428,6 +436,40 @@ struct net_svcl_bad_checksum_info
 	int number;
 };
 
+// Snapshot of all the players for one client, replaces the coord frames,
+// minibot coord frames and player pings that were sent one by one.
+// Followed by nbEntity net_svcl_snapshot_entity, each followed by the fields
+// set in its mask, in the order of the SNAPSHOT_ flags below.
+// Every field is delta'd against the snapshot (snapshotID - baseDelta) that the
+// client acknowledged, baseDelta = 0 means there is no base, all fields are sent.
+#define NET_SVCL_SNAPSHOT 136
+struct net_svcl_snapshot
+{
+	int32_t snapshotID; // Sequence number, per client
+	unsigned char epoch; // Bases from another epoch are gone, see CSnapshotHistory::forgetBases
+	unsigned char nbEntity; // How many entities follow
+};
+
+struct net_svcl_snapshot_entity
+{
+	char playerID;
+	unsigned char baseDelta;
+	unsigned short fields;
+};
+
+#define SNAPSHOT_COORD				0x0001 // Player is alive, his coord frame is in there
+#define SNAPSHOT_FRAMEID_DELTA		0x0002 // unsigned char, added to the base frameID
+#define SNAPSHOT_FRAMEID			0x0004 // int32_t
+#define SNAPSHOT_POSITION			0x0008 // short[3]
+#define SNAPSHOT_VEL				0x0010 // char[3]
+#define SNAPSHOT_MOUSEPOS			0x0020 // short[3]
+#define SNAPSHOT_PING				0x0040 // short
+#define SNAPSHOT_BABONETID			0x0080 // int32_t
+#define SNAPSHOT_MINIBOT			0x0100 // Player has a living minibot
+#define SNAPSHOT_MINIBOT_POSITION	0x0200 // short[3]
+#define SNAPSHOT_MINIBOT_VEL		0x0400 // char[3]
+#define SNAPSHOT_MINIBOT_MOUSEPOS	0x0800 // short[3]
+
 
 // Le client recois son ID, il envoit ses info (player name, etc), 
 // et le server le renvois aux autres
@@ -547,10 +589,17 @@ struct net_clsv_map_request
 
 // On request map
 #define NET_SVCL_MAP_CHUNK 210
+
+// A chunk and its headers fit in one ethernet frame (1500 bytes MTU)
+#define MAP_CHUNK_SIZE 1360
+
+// Most chunks sent to one player in a frame
+#define MAP_CHUNK_PIPELINE 8
+
 struct net_svcl_map_chunk
 {
-	unsigned short	size;
-	char			data[250]; //250 bytes chunks
+	unsigned short	size; // 0 for the last one
+	char			data[MAP_CHUNK_SIZE];
 };
 
 // On map list request
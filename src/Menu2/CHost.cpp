@@ -22,6 +22,7 @@
 #include <direct.h>
 #include "Map.h"
 #include "FileIO.h"
+#include "CBinaryReader.h"
 #include "Scene.h"
 #include "Console.h"
 
@@ -41,7 +42,7 @@ unsigned int loadMapPreview(CString mapFilename)
 	map_cell * cells = 0;
 
 	// On essaye d'abords de lire la map
-	FileIO file(CString("main/maps/%s.bvm", mapFilename.s), "rb");
+	CBinaryReader file(CString("main/maps/%s.bvm", mapFilename.s).s);
 	if (!file.isValid())
 	{
 		return 0;
@@ -57,31 +58,13 @@ unsigned int loadMapPreview(CString mapFilename)
 			g_size[0] = file.getInt();
 			g_size[1] = file.getInt();
 			cells = new map_cell[g_size[0]*g_size[1]];
-			for (int j=0;j<g_size[1];++j)
-			{
-				for (int i=0;i<g_size[0];++i)
-				{
-					unsigned char data = file.getUByte();
-					cells[j*g_size[0]+i].passable = (data & 128)?true:false;
-					cells[j*g_size[0]+i].height = (data & 127);
-					data = file.getUByte();
-				}
-			}
+			ReadMapCells(file, cells, g_size[0]*g_size[1]);
 			break;
 		case 10011:
 			g_size[0] = file.getInt();
 			g_size[1] = file.getInt();
 			cells = new map_cell[g_size[0]*g_size[1]];
-			for (int j=0;j<g_size[1];++j)
-			{
-				for (int i=0;i<g_size[0];++i)
-				{
-					unsigned char data = file.getUByte();
-					cells[j*g_size[0]+i].passable = (data & 128)?true:false;
-					cells[j*g_size[0]+i].height = (data & 127);
-					data = file.getUByte();
-				}
-			}
+			ReadMapCells(file, cells, g_size[0]*g_size[1]);
 			break;
 		case 20201:
 			{
@@ -90,37 +73,18 @@ unsigned int loadMapPreview(CString mapFilename)
 				g_size[0] = file.getInt();
 				g_size[1] = file.getInt();
 				cells = new map_cell[g_size[0]*g_size[1]];
-				for (int j=0;j<g_size[1];++j)
-				{
-					for (int i=0;i<g_size[0];++i)
-					{
-						unsigned char data = file.getUByte();
-						cells[j*g_size[0]+i].passable = (data & 128)?true:false;
-						cells[j*g_size[0]+i].height = (data & 127);
-						data = file.getUByte();
-					}
-				}
+				ReadMapCells(file, cells, g_size[0]*g_size[1]);
 				break;
 			}
 		case 20202:
 			{
-				char * author_name_buffer = file.getByteArray(25);
-				delete[] author_name_buffer;
+				file.skip(25); // author
 				int theme = file.getInt();
 				int weather = file.getInt();
 				g_size[0] = file.getInt();
 				g_size[1] = file.getInt();
 				cells = new map_cell[g_size[0]*g_size[1]];
-				for (int j=0;j<g_size[1];++j)
-				{
-					for (int i=0;i<g_size[0];++i)
-					{
-						unsigned char data = file.getUByte();
-						cells[j*g_size[0]+i].passable = (data & 128)?true:false;
-						cells[j*g_size[0]+i].height = (data & 127);
-						data = file.getUByte();
-					}
-				}
+				ReadMapCells(file, cells, g_size[0]*g_size[1]);
 				break;
 			}
 		}
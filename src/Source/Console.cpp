@@ -629,524 +629,575 @@ void Console::sendCommand(CString commandLine, bool isAdmin, unsigned long bbnet
 		}
 	}
 #endif
-	
 
+	runCommand(commandLine, isAdmin, bbnetID);
+}
+
+
+
+//
+// La table des commandes. Les noms sont en minuscule, comme le == de CString ignore la case
+//
+const std::unordered_map<std::string, Console::CommandHandler> & Console::getCommands()
+{
+	static const std::pair<const char *, CommandHandler> table[] =
+	{
+		{"help", &Console::cmdHelp},
+		{"?", &Console::cmdHelp},
+		{"execute", &Console::cmdExecute},
+		{"admin", &Console::cmdAdmin},
+		{"info", &Console::cmdInfo},
+		{"remoteadmin", &Console::cmdRemoteAdmin},
+		{"-", &Console::cmdRemoteConsole},
+		{"set", &Console::cmdSet},
+		{"quit", &Console::cmdQuit},
+#ifndef DEDICATED_SERVER
+		{"host", &Console::cmdHost},
+#endif
+		{"dedicate", &Console::cmdDedicate},
+		{"voteon", &Console::cmdVoteOn},
+		{"novote", &Console::cmdNoVote},
+		{"addmap", &Console::cmdAddMap},
+		{"playerlist", &Console::cmdPlayerList},
+		{"move", &Console::cmdMove},
+		{"moveid", &Console::cmdMoveID},
+		{"nukeall", &Console::cmdNukeAll},
+		{"nuke", &Console::cmdNuke},
+		{"nukeid", &Console::cmdNukeID},
+		{"allwatch", &Console::cmdAllWatch},
+		{"addreporturl", &Console::cmdAddReportURL},
+		{"removereporturl", &Console::cmdRemoveReportURL},
+		{"removeallreporturls", &Console::cmdRemoveAllReportURLs},
+		{"listreporturls", &Console::cmdListReportURLs},
+		{"approveall", &Console::cmdApproveAll},
+		{"approveplayer", &Console::cmdApprovePlayer},
+		{"rejectplayer", &Console::cmdRejectPlayer},
+		{"rejectallplayers", &Console::cmdRejectAllPlayers},
+		{"listapprovedplayers", &Console::cmdListApprovedPlayers},
+		{"savemap", &Console::cmdSaveMap},
+		{"savemapforce", &Console::cmdSaveMapForce},
+		{"vote", &Console::cmdVote},
+		{"maplist", &Console::cmdMapList},
+		{"maplistall", &Console::cmdMapListAll},
+		{"removemap", &Console::cmdRemoveMap},
+		{"changemap", &Console::cmdChangeMap},
+#ifndef DEDICATED_SERVER
+		{"connect", &Console::cmdConnect},
+#endif
+		{"disconnect", &Console::cmdDisconnect},
+		{"sayall", &Console::cmdSayAll},
+#ifdef DEDICATED_SERVER
+		{"sayid", &Console::cmdSayID},
+#endif
+#ifndef DEDICATED_SERVER
+		{"sayteam", &Console::cmdSayTeam},
+		{"edit", &Console::cmdEdit},
+#endif
+#ifdef DEDICATED_SERVER
+		{"playerinfo", &Console::cmdPlayerInfo},
+		{"playersinfo", &Console::cmdPlayersInfo},
+		{"forceplayerspawn", &Console::cmdForcePlayerSpawn},
+		{"blueteamscore", &Console::cmdBlueTeamScore},
+		{"redteamscore", &Console::cmdRedTeamScore},
+		{"redflagreturn", &Console::cmdRedFlagReturn},
+		{"blueflagreturn", &Console::cmdBlueFlagReturn},
+		{"mapinfos", &Console::cmdMapInfos},
+		{"listbluespawns", &Console::cmdListBlueSpawns},
+		{"listredspawns", &Console::cmdListRedSpawns},
+		{"allplayerpos", &Console::cmdAllPlayerPos},
+#endif
+#ifndef DEDICATED_SERVER
+		{"rebuildmap", &Console::cmdRebuildMap},
+#endif
+		{"restart", &Console::cmdRestart},
+		{"kick", &Console::cmdKick},
+		{"kickid", &Console::cmdKickID},
+		{"banlist", &Console::cmdBanList},
+		{"ban", &Console::cmdBan},
+		{"banip", &Console::cmdBanIP},
+		{"banid", &Console::cmdBanID},
+		{"unban", &Console::cmdUnban},
+		{"cachelist", &Console::cmdCacheList},
+		{"cacheban", &Console::cmdCacheBan},
+		{"cachebanned", &Console::cmdCacheBanned},
+		{"cacheunban", &Console::cmdCacheUnban},
+		{"cachelistremote", &Console::cmdCacheListRemote},
+		{"cachebanremote", &Console::cmdCacheBanRemote},
+#if defined(_PRO_)
+		{"getinvalidchecksums", &Console::cmdGetInvalidChecksums},
+		{"deleteinvalidchecksums", &Console::cmdDeleteInvalidChecksums},
+		{"invalidchecksumsinfo", &Console::cmdInvalidChecksumsInfo},
+#endif
+#ifdef _DEBUG
+#ifndef DEDICATED_SERVER
+		{"status", &Console::cmdStatus},
+#endif
+#endif
+	};
+	static const std::unordered_map<std::string, CommandHandler> commands(table, table + sizeof(table) / sizeof(table[0]));
+	return commands;
+}
+
+
+
+//
+// Trouve la commande dans la table et l'execute
+//
+void Console::runCommand(CString commandLine, bool isAdmin, unsigned long bbnetID)
+{
 	commandLine.trim('\n');
 
 	CString tokenize = commandLine;
 
 	// On va chercher le premier token, ? va nous donner la commande
 	CString command = tokenize.getFirstToken(' ');
+	command.toLower();
 
-	// On fait un if sur toute les commandes possibles
-	if (command == "help" || command == "?")
+	const std::unordered_map<std::string, CommandHandler> & commands = getCommands();
+	std::unordered_map<std::string, CommandHandler>::const_iterator it = commands.find(command.s);
+	if (it == commands.end())
 	{
-		add("help ? info admin - set quit host dedicate voteon novote");
-		add("playerlist maplist addmap removemap changemap connect");
-		add("disconnect sayall sayteam edit restart kick kickid");
-		add("banlist ban banid banip unban move moveid allwatch");
+		unknownCommand(commandLine);
 		return;
 	}
 
-	// File script
-	if (command == "execute")
-	{
-		int i;
-		FileIO file(CString("main/LaunchScript/%s.cfg", tokenize.s), "r");
-		if (file.isValid())
-		{
-			// Clear previous vote settings
-			sendCommand("novote");
+	(this->*(it->second))(tokenize, commandLine, isAdmin, bbnetID);
+}
 
-			CString line = file.getLine();
 
-			//--- We remove the \n at the end of the string
-			line.trim('\n');
 
-			//making sure win32 and linux have the same line feed
-			line.trim('\r');
+//
+// Le message quand on ne connait pas la commande
+//
+void Console::unknownCommand(CString commandLine)
+{
+	CString command = commandLine.getFirstToken(' ');
+	add(CString("\x3> Unkown command : \"%s\"", command.s));
+	add(CString("\x3> Type \"?\" for commands list", command.s));
+}
 
-			while (line != "endscript")
-			{
-				//--- Put the ^color code.
-				int len = line.len();
-				CString newText;
-				for (i=0;i<len;++i)
-				{
-					if (line[i] == '^' && i < len - 1)
-					{
-						int number = line[i+1] - '0';
-						switch(number)
-						{
-						case 1:newText += "\x1";break;
-						case 2:newText += "\x2";break;
-						case 3:newText += "\x3";break;
-						case 4:newText += "\x4";break;
-						case 5:newText += "\x5";break;
-						case 6:newText += "\x6";break;
-						case 7:newText += "\x7";break;
-						case 8:newText += "\x8";break;
-						case 9:newText += "\x9";break;
-						}
-						++i;
-					}
-					else
-					{
-						newText += CString("%c", line[i]);
-					}
-				}
-				line = newText;
 
-				for (;;)
-				{
-					if (strnicmp("//", line.s, 2) == 0) break;
-					if (line.s[0] == ' ' || line.s[0] == '\0' || line.s[0] == '\n') break;
 
-					//--- Send to consoles
-					if(line.len() > 0)
-					{
-					sendCommand(line);
-					}
-					break;
-				}
-				line = file.getLine();
+//
+// Pour lister les commandes
+//
+void Console::cmdHelp(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	add("help ? info admin - set quit host dedicate voteon novote");
+	add("playerlist maplist addmap removemap changemap connect");
+	add("disconnect sayall sayteam edit restart kick kickid");
+	add("banlist ban banid banip unban move moveid allwatch");
+}
+
 
-				//--- We remove the \n at the end of the string
-				line.trim('\n');
 
-				//making sure win32 and linux have the same line feed
-				line.trim('\r');
+//
+// File script, on le lit au complet avant de l'executer
+//
+void Console::cmdExecute(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	FileIO file(CString("main/LaunchScript/%s.cfg", tokenize.s), "r");
+	if (!file.isValid()) return;
+
+	std::vector<CString> lines;
+	for (;;)
+	{
+		CString line = file.getLine();
+
+		//--- End of file without endscript
+		if (line.isNull()) break;
+
+		//--- We remove the \n at the end of the string
+		line.trim('\n');
+
+		//making sure win32 and linux have the same line feed
+		line.trim('\r');
+
+		if (line == "endscript") break;
+
+		//--- Put the ^color code.
+		int len = line.len();
+		CString newText;
+		for (int i=0;i<len;++i)
+		{
+			if (line[i] == '^' && i < len - 1)
+			{
+				char number = line[i+1] - '0';
+				if (number >= 1 && number <= 9) newText.append(&number, 1);
+				++i;
+			}
+			else
+			{
+				newText.append(line.s + i, 1);
 			}
 		}
-		return;
+
+		//--- Comments and empty lines are skipped
+		if (strnicmp("//", newText.s, 2) == 0) continue;
+		if (newText.s[0] == ' ' || newText.s[0] == '\0' || newText.s[0] == '\n') continue;
+
+		lines.push_back(newText);
 	}
 
-	// Admin request
-	if (command == "admin")
+	// Clear previous vote settings
+	runCommand("novote", false, -1);
+
+	//--- Send to consoles
+	for (int i=0;i<(int)lines.size();++i)
 	{
-		if (scene->server)
-		{
-			add(CString("\x9> You are already server"));
-			return;
-		}
+		runCommand(lines[i], false, -1);
+	}
+}
+
+
+
+//
+// Admin request
+//
+void Console::cmdAdmin(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
+	{
+		add(CString("\x9> You are already server"));
+		return;
+	}
 #ifndef DEDICATED_SERVER
 #if defined(_PRO_)
-		if (scene->client)
+	if (scene->client)
+	{
+		CString login = tokenize.getFirstToken(' ');
+		CString pwd = tokenize.getFirstToken(' ');
+		if (login != "" && pwd != "")
 		{
-			CString login = tokenize.getFirstToken(' ');
-			CString pwd = tokenize.getFirstToken(' ');
-			if (login != "" && pwd != "")
-			{
-				net_clsv_admin_request adminRequest;
-				memset(&adminRequest, 0, sizeof(net_clsv_admin_request));
-				RSA::MD5 login_((unsigned char*)login.s);
-				char* hex_digest = login_.hex_digest();
-				memcpy(adminRequest.login, hex_digest, 32);
+			net_clsv_admin_request adminRequest;
+			memset(&adminRequest, 0, sizeof(net_clsv_admin_request));
+			RSA::MD5 login_((unsigned char*)login.s);
+			char* hex_digest = login_.hex_digest();
+			memcpy(adminRequest.login, hex_digest, 32);
 
-				RSA::MD5 pwd_((unsigned char*)pwd.s);
-				hex_digest = pwd_.hex_digest();
-				memcpy(adminRequest.password, hex_digest, 32);
+			RSA::MD5 pwd_((unsigned char*)pwd.s);
+			hex_digest = pwd_.hex_digest();
+			memcpy(adminRequest.password, hex_digest, 32);
 
-				/*add(CString("\x9> L: %s", adminRequest.login));
-				add(CString("\x9> P: %s", adminRequest.password));*/
+			/*add(CString("\x9> L: %s", adminRequest.login));
+			add(CString("\x9> P: %s", adminRequest.password));*/
 
-				bb_clientSend(scene->client->uniqueClientID, (char*)(&adminRequest), sizeof(net_clsv_admin_request), NET_CLSV_ADMIN_REQUEST);
-			}
-			else
-			{
-				scene->client->isAdmin = false;
-				add(CString("\x9> Invalid arguments"));
-			}
+			bb_clientSend(scene->client->uniqueClientID, (char*)(&adminRequest), sizeof(net_clsv_admin_request), NET_CLSV_ADMIN_REQUEST);
 		}
-#else
-		if (scene->client)
+		else
 		{
-			if (tokenize.isNull())
-			{
-				scene->client->isAdmin = false;
-			}
-			bb_clientSend(scene->client->uniqueClientID, tokenize.s, tokenize.len() + 1, NET_CLSV_ADMIN_REQUEST);
+			scene->client->isAdmin = false;
+			add(CString("\x9> Invalid arguments"));
 		}
-#endif //_PRO_
-#endif
-		return;
 	}
-
-	if (command == "info")
+#else
+	if (scene->client)
 	{
-		if(scene->server && scene->server->game)
+		if (tokenize.isNull())
 		{
-			add(CString("\x9[Server Info] Game Type: %d - Port: %d - Name: %s", gameVar.sv_gameType, gameVar.sv_port, gameVar.sv_gameName.s), true);
+			scene->client->isAdmin = false;
 		}
-		return;
+		bb_clientSend(scene->client->uniqueClientID, tokenize.s, tokenize.len() + 1, NET_CLSV_ADMIN_REQUEST);
 	}
+#endif //_PRO_
+#endif
+}
+
+
 
-	// Remote admin request
-	if (command == "remoteAdmin")
+//
+// Server info
+//
+void Console::cmdInfo(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if(scene->server && scene->server->game)
 	{
-		// On join une game en cours y??!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-		CString IPAddress = tokenize.getFirstToken(' ');
-		int port = tokenize.getFirstToken(' ').toInt();
-		if (port == 0) port = 3333; // Try on the regular port
+		add(CString("\x9[Server Info] Game Type: %d - Port: %d - Name: %s", gameVar.sv_gameType, gameVar.sv_port, gameVar.sv_gameName.s), true);
+	}
+}
+
+
+
+//
+// Remote admin request
+//
+void Console::cmdRemoteAdmin(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	// On join une game en cours y??!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+	CString IPAddress = tokenize.getFirstToken(' ');
+	int port = tokenize.getFirstToken(' ').toInt();
+	if (port == 0) port = 3333; // Try on the regular port
 
 #ifndef DEDICATED_SERVER
-		//--- The rest of the token is the user + pass :)
-		scene->join(IPAddress, port/*, tokenize*/);
-		m_isActive = false;
+	//--- The rest of the token is the user + pass :)
+	scene->join(IPAddress, port/*, tokenize*/);
+	m_isActive = false;
 #endif
-		return;
-	}
+}
 
-	// On envoit un message console au server
-	if (command == "-")
-	{
+
+
+//
+// On envoit un message console au server
+//
+void Console::cmdRemoteConsole(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
 #ifndef DEDICATED_SERVER
-		if (scene->client)
+	if (scene->client)
+	{
+		if (scene->client->isAdmin)
 		{
-			if (scene->client->isAdmin)
-			{
-				bb_clientSend(scene->client->uniqueClientID, tokenize.s, tokenize.len() + 1, NET_SVCL_CONSOLE);
-			}
-			else
-			{
-				add(CString("\x9> You need to be admin for this command"));
-			}
+			bb_clientSend(scene->client->uniqueClientID, tokenize.s, tokenize.len() + 1, NET_SVCL_CONSOLE);
+		}
+		else
+		{
+			add(CString("\x9> You need to be admin for this command"));
 		}
-#endif
-		return;
 	}
+#endif
+}
 
-	// Le set
-	if (command == "set")
-	{
-		command = tokenize.getFirstToken(' ');
 
-		// only set to true when changing sv_gameTimeLimit
-		bool updateTimer = (command == "sv_gameTimeLimit");
-		
-		// only set true when changing weather effects setting
-		bool reloadWeather = (command == "r_weatherEffects");
 
-		if (strnicmp(command.s, "sv_", 3) == 0)
-		{
+//
+// Le set
+//
+void Console::cmdSet(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	CString command = tokenize.getFirstToken(' ');
+
+	// only set to true when changing sv_gameTimeLimit
+	bool updateTimer = (command == "sv_gameTimeLimit");
+	
+	// only set true when changing weather effects setting
+	bool reloadWeather = (command == "r_weatherEffects");
+
+	if (strnicmp(command.s, "sv_", 3) == 0)
+	{
 #ifndef DEDICATED_SERVER
-			if (scene->server)
-			{
+		if (scene->server)
+		{
 #endif
-				// Ensure password is no longer than 15 characters
-				CString val = CString(commandLine);
-				val.getFirstToken(' ');
-				CString svar = val.getFirstToken(' ');
+			// Ensure password is no longer than 15 characters
+			CString val = CString(commandLine);
+			val.getFirstToken(' ');
+			CString svar = val.getFirstToken(' ');
 
-				if(svar == "sv_password" && val.len() > 15)
-				{
-					val.resize(15);
-					commandLine = "set sv_password ";
-					commandLine += val;
-					console->add(CString("Max password length is 15 characters, password changed to '%s'", val.s), true);
-				}
+			if(svar == "sv_password" && val.len() > 15)
+			{
+				val.resize(15);
+				commandLine = "set sv_password ";
+				commandLine += val;
+				console->add(CString("Max password length is 15 characters, password changed to '%s'", val.s), true);
+			}
 
-				// Il faut envoyer le changement de variable sur le r?eau
-				scene->server->sendSVChange(commandLine);
+			// Il faut envoyer le changement de variable sur le r?eau
+			scene->server->sendSVChange(commandLine);
 
-				if (command == "set sv_port")
-				{
-				//	bb_serverChangePort(gameVar.sv_port);
-				}
-#ifndef DEDICATED_SERVER
-			}
-			else
+			if (command == "set sv_port")
 			{
-				add(CString("\x9> This command is reserved to the server"));
-				return;
+			//	bb_serverChangePort(gameVar.sv_port);
 			}
-#endif
+#ifndef DEDICATED_SERVER
 		}
-
-		// On check, si cest une variable touche, on va chercher sa valeur avec notre keyManager
-		if (command[0] == 'k')
+		else
 		{
-#ifndef DEDICATED_SERVER // Si console on ignore ?
-			CString keyName = tokenize;
-			CString keyCommand = CString("set ") + command + " " + keyManager.getKeyByName(keyName);
-			dksvarCommand(keyCommand.s);
-			add(CString("\x3> %s", keyCommand.s));
-#endif
+			add(CString("\x9> This command is reserved to the server"));
 			return;
 		}
+#endif
+	}
 
-		// On donne la job ?dksvar pour ?
-		CMD_RET cr = dksvarCommand(commandLine.s);
-		if (cr == CR_NOSUCHVAR)
-			add(CString("\x4> Unknown variable"));
-		else if (cr == CR_INVALIDARGS)
-			add(CString("\x4> Invalid arguments"));
-		else if (cr == CR_NOTSUPPORTED)
-			add(CString("\x4> Unknown command"));
-		else
-			add(CString("\x3> %s", command.s));
+	// On check, si cest une variable touche, on va chercher sa valeur avec notre keyManager
+	if (command[0] == 'k')
+	{
+#ifndef DEDICATED_SERVER // Si console on ignore ?
+		CString keyName = tokenize;
+		CString keyCommand = CString("set ") + command + " " + keyManager.getKeyByName(keyName);
+		dksvarCommand(keyCommand.s);
+		add(CString("\x3> %s", keyCommand.s));
+#endif
+		return;
+	}
+
+	// On donne la job ?dksvar pour ?
+	CMD_RET cr = dksvarCommand(commandLine.s);
+	if (cr == CR_NOSUCHVAR)
+		add(CString("\x4> Unknown variable"));
+	else if (cr == CR_INVALIDARGS)
+		add(CString("\x4> Invalid arguments"));
+	else if (cr == CR_NOTSUPPORTED)
+		add(CString("\x4> Unknown command"));
+	else
+		add(CString("\x3> %s", command.s));
 
-		// Do we need to update current game time?
-		if (updateTimer)
+	// Do we need to update current game time?
+	if (updateTimer)
+	{
+		if (scene)
 		{
-			if (scene)
+			if (scene->server)
 			{
-				if (scene->server)
+				if (scene->server->game)
 				{
-					if (scene->server->game)
-					{
-						scene->server->game->gameTimeLeft = gameVar.sv_gameTimeLimit;
-					}
+					scene->server->game->gameTimeLeft = gameVar.sv_gameTimeLimit;
 				}
 			}
+		}
 #ifndef DEDICATED_SERVER
-		} else if (reloadWeather && scene && scene->client && scene->client->game && scene->client->game->map) {
-			scene->client->game->map->reloadWeather();
+	} else if (reloadWeather && scene && scene->client && scene->client->game && scene->client->game->map) {
+		scene->client->game->map->reloadWeather();
 #endif
-		}
-
-		return;
 	}
+}
+
+
+
+//
+// Le quit
+//
+void Console::cmdQuit(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	// On quit le jeu de force !!
+	dkwForceQuit();
+	add(CString("\x3> Quitting application..."));
+}
+
+
 
-	// Le quit
-	if (command == "quit")
-	{
-		// On quit le jeu de force !!
-		dkwForceQuit();
-		add(CString("\x3> Quitting application..."));
-		return;
-	}
 #ifndef DEDICATED_SERVER
-	// Pour hoster une game
-	if (command == "host")
-	{
-		// On cr?le server
-		scene->host(tokenize);
-		m_isActive = false;
-		return;
-	}
+//
+// Pour hoster une game
+//
+void Console::cmdHost(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	// On cr?le server
+	scene->host(tokenize);
+	m_isActive = false;
+}
 #endif
-	// Pour hoster une game
-	if (command == "dedicate")
-	{
-		// If already running, only change map, since if the server recieves an 
-		if(scene->server && scene->server->isRunning)
-			 scene->server->changeMap(tokenize);
-		else
-			scene->dedicate(tokenize);
-		return;
-	}
 
-	// Allow command to be voted on
-	if (command == "voteon")
-	{
-		// Not case sensitive
-		CString command("%s", tokenize.getFirstToken(' ').s);
-		command.toLower();
 
-		if(scene->server) 
-		{
-			scene->server->voteList.push_back(command);
-			add(CString("\x3> %s can now be voted on", command.s), true);
-		}
 
-		return;
-	}
+//
+// Pour hoster une game
+//
+void Console::cmdDedicate(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	// If already running, only change map, since if the server recieves an 
+	if(scene->server && scene->server->isRunning)
+		 scene->server->changeMap(tokenize);
+	else
+		scene->dedicate(tokenize);
+}
 
-	// Remove all commands from vote list
-	if (command == "novote")
-	{
-		if(scene->server) 
-		{
-			// Clear list
-			std::vector<CString> temp;
-			scene->server->voteList.swap(temp);
 
-			add("\x3> All commands are no longer votable", true);
-		}
-		return;
-	}
 
-	// Pour ajouter une map ?la queue
-	if (command == "addmap")
+//
+// Allow command to be voted on
+//
+void Console::cmdVoteOn(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	// Not case sensitive
+	CString command("%s", tokenize.getFirstToken(' ').s);
+	command.toLower();
+
+	if(scene->server) 
 	{
-		if (scene->server) scene->server->addmap(tokenize);
-		return;
+		scene->server->voteList.push_back(command);
+		add(CString("\x3> %s can now be voted on", command.s), true);
 	}
+}
 
-	// Lister les player et leur IP !
-	if (command == "playerlist")
+
+
+//
+// Remove all commands from vote list
+//
+void Console::cmdNoVote(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if(scene->server) 
 	{
-		if (scene->server)
-		{
-			if (scene->server->game)
-			{
-				for (int i=0;i<MAX_PLAYER;++i)
-				{
-					if (scene->server->game->players[i])
-					{
-						add(CString("[%02i] %s - IP:%s", i,
-							scene->server->game->players[i]->name.s,
-							scene->server->game->players[i]->playerIP), true);
-					}
-				}
-			}
-		}
-#ifndef DEDICATED_SERVER
-		else if (scene->client && scene->client->game)
-		{
-			for (int i=0;i<MAX_PLAYER;++i)
-			{
-				if (scene->client->game->players[i])
-				{
-					if(scene->client->game->players[i] != scene->client->game->thisPlayer)
-						add(CString("[%02i] %s - IP:%s", i,
-							scene->client->game->players[i]->name.s,
-							scene->client->game->players[i]->playerIP));
-					else
-						add(CString("\x9[%02i]\x8 %s - IP:%s", i,
-							scene->client->game->players[i]->name.s,
-							bb_getMyIP()));
-				}
-			}
-		}
-#endif
-		return;
+		// Clear list
+		std::vector<CString> temp;
+		scene->server->voteList.swap(temp);
+
+		add("\x3> All commands are no longer votable", true);
 	}
+}
 
-	// Put player on a specified team
-	if (command == "move")
+
+
+//
+// Pour ajouter une map ?la queue
+//
+void Console::cmdAddMap(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server) scene->server->addmap(tokenize);
+}
+
+
+
+//
+// Lister les player et leur IP !
+//
+void Console::cmdPlayerList(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		if (scene->server->game)
 		{
-			if (scene->server->game)
+			for (int i=0;i<MAX_PLAYER;++i)
 			{
-				int teamID = tokenize.getFirstToken(' ').toInt();
-				int playerID = -1;
-				if ((teamID < -1) || (teamID > 1))
+				if (scene->server->game->players[i])
 				{
-					add(CString("Error: team ID must be one of the following:\n    -1 for spectator, 0 for blue or 1 for red."), true);
-				}
-				else
-				{
-					for (int i = 0; i < MAX_PLAYER; ++i)
-					{
-						if(scene->server->game->players[i] && (textColorLess(tokenize) == textColorLess(scene->server->game->players[i]->name)))
-						{
-							playerID = i;
-							break;
-						}
-					}
-					if (playerID == -1)
-					{
-						add(CString("Error: No players were found with given name"), true);
-					}
-					else
-					{
-						scene->server->game->assignPlayerTeam(playerID, teamID, 0);
-						net_clsv_svcl_team_request teamRequest;
-						teamRequest.playerID = playerID;
-						teamRequest.teamRequested = teamID;
-						bb_serverSend((char*)&teamRequest, sizeof(net_clsv_svcl_team_request), NET_CLSV_SVCL_TEAM_REQUEST, 0);
-					}
+					add(CString("[%02i] %s - IP:%s", i,
+						scene->server->game->players[i]->name.s,
+						scene->server->game->players[i]->playerIP), true);
 				}
 			}
 		}
-		return;
 	}
-
-	// Put player on a specified team
-	if (command == "moveid")
+#ifndef DEDICATED_SERVER
+	else if (scene->client && scene->client->game)
 	{
-		if (scene->server)
+		for (int i=0;i<MAX_PLAYER;++i)
 		{
-			if (scene->server->game)
+			if (scene->client->game->players[i])
 			{
-				int teamID = tokenize.getFirstToken(' ').toInt();
-				int playerID = tokenize.getNextToken(' ').toInt();
-				if ((teamID < -1) || (teamID > 1))
-				{
-					add(CString("Error: team ID must be one of the following:\n    -1 for spectator, 0 for blue or 1 for red."), true);
-				}
-				else if ((playerID < -1) || (playerID >= MAX_PLAYER) || !scene->server->game->players[playerID])
-				{
-					add(CString("Error: Bad player ID (use playerlist command to obtain the correct ID)"), true);
-				}
+				if(scene->client->game->players[i] != scene->client->game->thisPlayer)
+					add(CString("[%02i] %s - IP:%s", i,
+						scene->client->game->players[i]->name.s,
+						scene->client->game->players[i]->playerIP));
 				else
-				{
-					if( playerID == -1 )
-					{
-						// move everyone to the selected team
-						for( int i=0; i<MAX_PLAYER; i++ )
-						{
-							if( scene->server->game->players[i] )
-							{
-								if(scene->server->game->map->flagState[0] == scene->server->game->players[i]->playerID)
-								{
-									scene->server->game->map->flagState[0] = -1; // Le server va nous communiquer la position du flag exacte
-									scene->server->game->map->flagPos[0] =  scene->server->game->players[i]->currentCF.position;
-									scene->server->game->map->flagPos[0][2] = 0;
-								}
-								if(scene->server->game->map->flagState[1] == scene->server->game->players[i]->playerID)
-								{
-									scene->server->game->map->flagState[1] = -1; // Le server va nous communiquer la position du flag exacte
-									scene->server->game->map->flagPos[1] =  scene->server->game->players[i]->currentCF.position;
-									scene->server->game->map->flagPos[1][2] = 0;
-								}
-								scene->server->game->players[i]->currentCF.position.set(-999,-999,0);
-								scene->server->game->assignPlayerTeam(i, teamID, 0);
-								net_clsv_svcl_team_request teamRequest;
-								teamRequest.playerID = i;
-								teamRequest.teamRequested = teamID;
-								bb_serverSend((char*)&teamRequest, sizeof(net_clsv_svcl_team_request), NET_CLSV_SVCL_TEAM_REQUEST, 0);
-							}
-						}
-					}
-					else
-					{
-						// move only the specified player
-						if( scene->server->game->players[playerID] )
-						{
-							if(scene->server->game->map->flagState[0] == scene->server->game->players[playerID]->playerID)
-							{
-								scene->server->game->map->flagState[0] = -1; // Le server va nous communiquer la position du flag exacte
-								scene->server->game->map->flagPos[0] =  scene->server->game->players[playerID]->currentCF.position;
-								scene->server->game->map->flagPos[0][2] = 0;
-							}
-							if(scene->server->game->map->flagState[1] == scene->server->game->players[playerID]->playerID)
-							{
-								scene->server->game->map->flagState[1] = -1; // Le server va nous communiquer la position du flag exacte
-								scene->server->game->map->flagPos[1] =  scene->server->game->players[playerID]->currentCF.position;
-								scene->server->game->map->flagPos[1][2] = 0;
-							}
-							scene->server->game->players[playerID]->currentCF.position.set(-999,-999,0);
-						}
-						scene->server->game->assignPlayerTeam(playerID, teamID, 0);
-						net_clsv_svcl_team_request teamRequest;
-						teamRequest.playerID = playerID;
-						teamRequest.teamRequested = teamID;
-						bb_serverSend((char*)&teamRequest, sizeof(net_clsv_svcl_team_request), NET_CLSV_SVCL_TEAM_REQUEST, 0);
-					}
-				}
+					add(CString("\x9[%02i]\x8 %s - IP:%s", i,
+						scene->client->game->players[i]->name.s,
+						bb_getMyIP()));
 			}
 		}
-		return;
-	}
-
-	if (command == "nukeall")
-	{
-		if(scene->server)
-			if(scene->server->game)
-				scene->server->nukeAll();
-		return;
 	}
+#endif
+}
 
-	if (command == "nuke")
+
+
+//
+// Put player on a specified team
+//
+void Console::cmdMove(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if(scene->server)
-			if(scene->server->game)
+		if (scene->server->game)
+		{
+			int teamID = tokenize.getFirstToken(' ').toInt();
+			int playerID = -1;
+			if ((teamID < -1) || (teamID > 1))
+			{
+				add(CString("Error: team ID must be one of the following:\n    -1 for spectator, 0 for blue or 1 for red."), true);
+			}
+			else
 			{
-				int playerID;
 				for (int i = 0; i < MAX_PLAYER; ++i)
 				{
 					if(scene->server->game->players[i] && (textColorLess(tokenize) == textColorLess(scene->server->game->players[i]->name)))
@@ -1161,970 +1212,1242 @@ void Console::sendCommand(CString commandLine, bool isAdmin, unsigned long bbnet
 				}
 				else
 				{
-					scene->server->nukePlayer(playerID);
+					scene->server->game->assignPlayerTeam(playerID, teamID, 0);
+					net_clsv_svcl_team_request teamRequest;
+					teamRequest.playerID = playerID;
+					teamRequest.teamRequested = teamID;
+					bb_serverSend((char*)&teamRequest, sizeof(net_clsv_svcl_team_request), NET_CLSV_SVCL_TEAM_REQUEST, 0);
 				}
 			}
-		return;
+		}
 	}
+}
+
 
-	if (command == "nukeid")
+
+//
+// Put player on a specified team
+//
+void Console::cmdMoveID(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if(scene->server)
-			if(scene->server->game)
+		if (scene->server->game)
+		{
+			int teamID = tokenize.getFirstToken(' ').toInt();
+			int playerID = tokenize.getNextToken(' ').toInt();
+			if ((teamID < -1) || (teamID > 1))
+			{
+				add(CString("Error: team ID must be one of the following:\n    -1 for spectator, 0 for blue or 1 for red."), true);
+			}
+			else if ((playerID < -1) || (playerID >= MAX_PLAYER) || !scene->server->game->players[playerID])
+			{
+				add(CString("Error: Bad player ID (use playerlist command to obtain the correct ID)"), true);
+			}
+			else
 			{
-				int playerID = tokenize.getFirstToken(' ').toInt();
-				if ((playerID < -1) || (playerID >= MAX_PLAYER) || !scene->server->game->players[playerID])
+				if( playerID == -1 )
 				{
-					add(CString("Error: Bad player ID (use playerlist command to obtain the correct ID)"), true);
+					// move everyone to the selected team
+					for( int i=0; i<MAX_PLAYER; i++ )
+					{
+						if( scene->server->game->players[i] )
+						{
+							if(scene->server->game->map->flagState[0] == scene->server->game->players[i]->playerID)
+							{
+								scene->server->game->map->flagState[0] = -1; // Le server va nous communiquer la position du flag exacte
+								scene->server->game->map->flagPos[0] =  scene->server->game->players[i]->currentCF.position;
+								scene->server->game->map->flagPos[0][2] = 0;
+							}
+							if(scene->server->game->map->flagState[1] == scene->server->game->players[i]->playerID)
+							{
+								scene->server->game->map->flagState[1] = -1; // Le server va nous communiquer la position du flag exacte
+								scene->server->game->map->flagPos[1] =  scene->server->game->players[i]->currentCF.position;
+								scene->server->game->map->flagPos[1][2] = 0;
+							}
+							scene->server->game->players[i]->currentCF.position.set(-999,-999,0);
+							scene->server->game->assignPlayerTeam(i, teamID, 0);
+							net_clsv_svcl_team_request teamRequest;
+							teamRequest.playerID = i;
+							teamRequest.teamRequested = teamID;
+							bb_serverSend((char*)&teamRequest, sizeof(net_clsv_svcl_team_request), NET_CLSV_SVCL_TEAM_REQUEST, 0);
+						}
+					}
 				}
 				else
 				{
-					if( playerID == -1 )
+					// move only the specified player
+					if( scene->server->game->players[playerID] )
 					{
-						scene->server->nukeAll();
-					}
-					else
-					{
-						scene->server->nukePlayer(playerID);
+						if(scene->server->game->map->flagState[0] == scene->server->game->players[playerID]->playerID)
+						{
+							scene->server->game->map->flagState[0] = -1; // Le server va nous communiquer la position du flag exacte
+							scene->server->game->map->flagPos[0] =  scene->server->game->players[playerID]->currentCF.position;
+							scene->server->game->map->flagPos[0][2] = 0;
+						}
+						if(scene->server->game->map->flagState[1] == scene->server->game->players[playerID]->playerID)
+						{
+							scene->server->game->map->flagState[1] = -1; // Le server va nous communiquer la position du flag exacte
+							scene->server->game->map->flagPos[1] =  scene->server->game->players[playerID]->currentCF.position;
+							scene->server->game->map->flagPos[1][2] = 0;
+						}
+						scene->server->game->players[playerID]->currentCF.position.set(-999,-999,0);
 					}
+					scene->server->game->assignPlayerTeam(playerID, teamID, 0);
+					net_clsv_svcl_team_request teamRequest;
+					teamRequest.playerID = playerID;
+					teamRequest.teamRequested = teamID;
+					bb_serverSend((char*)&teamRequest, sizeof(net_clsv_svcl_team_request), NET_CLSV_SVCL_TEAM_REQUEST, 0);
 				}
 			}
-
-		return;
+		}
 	}
+}
 
-	// Everyone spec!
-	if (command == "allwatch")
-	{
-		if (scene->server)
+
+
+//
+// Nuke everyone
+//
+void Console::cmdNukeAll(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if(scene->server)
+		if(scene->server->game)
+			scene->server->nukeAll();
+}
+
+
+
+//
+// Nuke a player by name
+//
+void Console::cmdNuke(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if(scene->server)
+		if(scene->server->game)
 		{
-			if (scene->server->game)
+			int playerID;
+			for (int i = 0; i < MAX_PLAYER; ++i)
 			{
-				for(int playerID = 0; playerID < MAX_PLAYER; ++playerID)
+				if(scene->server->game->players[i] && (textColorLess(tokenize) == textColorLess(scene->server->game->players[i]->name)))
 				{
-					if(scene->server->game->players[playerID])
-					{
-						scene->server->game->assignPlayerTeam(playerID, PLAYER_TEAM_SPECTATOR, 0);
-						net_clsv_svcl_team_request teamRequest;
-						teamRequest.playerID = playerID;
-						teamRequest.teamRequested = PLAYER_TEAM_SPECTATOR;
-						bb_serverSend((char*)&teamRequest, sizeof(net_clsv_svcl_team_request), NET_CLSV_SVCL_TEAM_REQUEST, 0);
-					}
+					playerID = i;
+					break;
 				}
 			}
+			if (playerID == -1)
+			{
+				add(CString("Error: No players were found with given name"), true);
+			}
+			else
+			{
+				scene->server->nukePlayer(playerID);
+			}
 		}
-		return;
-	}
+}
 
-	if (command == "addreporturl")
-	{
-		if (scene->server)
+
+
+//
+// Nuke a player by ID (-1 for everyone)
+//
+void Console::cmdNukeID(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if(scene->server)
+		if(scene->server->game)
 		{
-			CString url = tokenize.getFirstToken(' ');
-			if (url == "")
-				add("\x3> Invalid arguments", true);
+			int playerID = tokenize.getFirstToken(' ').toInt();
+			if ((playerID < -1) || (playerID >= MAX_PLAYER) || !scene->server->game->players[playerID])
+			{
+				add(CString("Error: Bad player ID (use playerlist command to obtain the correct ID)"), true);
+			}
 			else
 			{
-				if (std::find(scene->server->reportUploadURLs.begin(),
-						scene->server->reportUploadURLs.end(),
-						url.s) != scene->server->reportUploadURLs.end())\
+				if( playerID == -1 )
 				{
-					add("\x3> URL already on list", true);
+					scene->server->nukeAll();
 				}
 				else
 				{
-					scene->server->reportUploadURLs.push_back(url.s);
-					CString str("\x3> URL '%s' added to list", url.s);
-					add(str, true);
+					scene->server->nukePlayer(playerID);
+				}
+			}
+		}
+}
+
+
+
+//
+// Everyone spec!
+//
+void Console::cmdAllWatch(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
+	{
+		if (scene->server->game)
+		{
+			for(int playerID = 0; playerID < MAX_PLAYER; ++playerID)
+			{
+				if(scene->server->game->players[playerID])
+				{
+					scene->server->game->assignPlayerTeam(playerID, PLAYER_TEAM_SPECTATOR, 0);
+					net_clsv_svcl_team_request teamRequest;
+					teamRequest.playerID = playerID;
+					teamRequest.teamRequested = PLAYER_TEAM_SPECTATOR;
+					bb_serverSend((char*)&teamRequest, sizeof(net_clsv_svcl_team_request), NET_CLSV_SVCL_TEAM_REQUEST, 0);
 				}
 			}
 		}
-		return;
 	}
+}
+
+
 
-	if (command == "removereporturl")
+//
+// Add an URL where game reports are uploaded
+//
+void Console::cmdAddReportURL(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		CString url = tokenize.getFirstToken(' ');
+		if (url == "")
+			add("\x3> Invalid arguments", true);
+		else
 		{
-			int id = tokenize.getFirstToken(' ').toInt();
-			if (id >= 0 && id < (int)scene->server->reportUploadURLs.size())
+			if (std::find(scene->server->reportUploadURLs.begin(),
+					scene->server->reportUploadURLs.end(),
+					url.s) != scene->server->reportUploadURLs.end())\
 			{
-				scene->server->reportUploadURLs.erase(scene->server->reportUploadURLs.begin() + id);
-				add("\x3> URL removed from list", true);
+				add("\x3> URL already on list", true);
 			}
 			else
 			{
-				add("\x3> Invalid URL id", true);
+				scene->server->reportUploadURLs.push_back(url.s);
+				CString str("\x3> URL '%s' added to list", url.s);
+				add(str, true);
 			}
 		}
-		return;
 	}
+}
+
 
-	if (command == "removeallreporturls")
+
+//
+// Remove a report URL
+//
+void Console::cmdRemoveReportURL(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		int id = tokenize.getFirstToken(' ').toInt();
+		if (id >= 0 && id < (int)scene->server->reportUploadURLs.size())
 		{
-			scene->server->reportUploadURLs.clear();
-			add("\x3> All report URLs removed", true);
+			scene->server->reportUploadURLs.erase(scene->server->reportUploadURLs.begin() + id);
+			add("\x3> URL removed from list", true);
+		}
+		else
+		{
+			add("\x3> Invalid URL id", true);
 		}
-		return;
 	}
+}
+
+
 
-	if (command == "listreporturls")
+//
+// Remove every report URL
+//
+void Console::cmdRemoveAllReportURLs(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		scene->server->reportUploadURLs.clear();
+		add("\x3> All report URLs removed", true);
+	}
+}
+
+
+
+//
+// List the report URLs
+//
+void Console::cmdListReportURLs(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
+	{
+		CString str("\x3> %d URLs on list", (int)scene->server->reportUploadURLs.size());
+		add(str, true);
+		for (int i = 0; i < (int)scene->server->reportUploadURLs.size(); i++)
 		{
-			CString str("\x3> %d URLs on list", (int)scene->server->reportUploadURLs.size());
-			add(str, true);
-			for (int i = 0; i < (int)scene->server->reportUploadURLs.size(); i++)
-			{
-				CString str1("\x3 %d: %s", i, scene->server->reportUploadURLs[i].c_str());
-				add(str1, true);
-			}
+			CString str1("\x3 %d: %s", i, scene->server->reportUploadURLs[i].c_str());
+			add(str1, true);
 		}
-		return;
 	}
+}
+
 
-	// approve players to join selected or all teams
-	if (command == "approveall")
+
+//
+// approve players to join selected or all teams
+//
+void Console::cmdApproveAll(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		if (scene->server->game)
 		{
-			if (scene->server->game)
+			int teamid;
+			CString strteamid = tokenize.getFirstToken(' ');
+			if (strteamid != "")
 			{
-				int teamid;
-				CString strteamid = tokenize.getFirstToken(' ');
-				if (strteamid != "")
-				{
-					teamid = atoi(strteamid.s);
-					scene->server->game->approveAll(teamid);
-				}
-				else
-					scene->server->game->approveAll();
+				teamid = atoi(strteamid.s);
+				scene->server->game->approveAll(teamid);
 			}
+			else
+				scene->server->game->approveAll();
 		}
-		return;
 	}
+}
+
 
-	if (command == "approveplayer")
+
+//
+// approve a player to join selected or all teams
+//
+void Console::cmdApprovePlayer(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		if (scene->server->game)
 		{
-			if (scene->server->game)
+			int id;
+			CString strid = tokenize.getFirstToken(' ');
+			int teamid;
+			CString strteamid = tokenize.getFirstToken(' ');
+			if (strid != "" && strteamid != "")
 			{
-				int id;
-				CString strid = tokenize.getFirstToken(' ');
-				int teamid;
-				CString strteamid = tokenize.getFirstToken(' ');
-				if (strid != "" && strteamid != "")
-				{
-					id = atoi(strid.s);
-					teamid = atoi(strteamid.s);
-					if (scene->server->game->approvePlayer(id, teamid) == false)
-						add("\x3> Command failed", true);
-				}
-				else
-					add("\x3> Invalid arguments, usage: approveplayer userid team", true);
+				id = atoi(strid.s);
+				teamid = atoi(strteamid.s);
+				if (scene->server->game->approvePlayer(id, teamid) == false)
+					add("\x3> Command failed", true);
 			}
+			else
+				add("\x3> Invalid arguments, usage: approveplayer userid team", true);
 		}
-		return;
 	}
+}
+
 
-	// removes player from the list of approved players (of all teams or selected)
-	// only works if player was approved to some team before
-	if (command == "rejectplayer")
+
+//
+// removes player from the list of approved players (of all teams or selected)
+// only works if player was approved to some team before
+//
+void Console::cmdRejectPlayer(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		if (scene->server->game)
 		{
-			if (scene->server->game)
+			CString strid = tokenize.getFirstToken(' ');
+			CString strteamid = tokenize.getFirstToken(' ');
+			if (strid != "")
 			{
-				CString strid = tokenize.getFirstToken(' ');
-				CString strteamid = tokenize.getFirstToken(' ');
-				if (strid != "")
-				{
-					if (strteamid == "")
-						scene->server->game->rejectPlayer(atoi(strid.s));
-					else
-						scene->server->game->rejectPlayer(atoi(strid.s), (char)atoi(strteamid.s));
-				}
+				if (strteamid == "")
+					scene->server->game->rejectPlayer(atoi(strid.s));
 				else
-					add("\x3> Invalid arguments, usage: rejectplayer userid [teamid]", true);
+					scene->server->game->rejectPlayer(atoi(strid.s), (char)atoi(strteamid.s));
 			}
+			else
+				add("\x3> Invalid arguments, usage: rejectplayer userid [teamid]", true);
 		}
-		return;
 	}
+}
+
+
+
+//
+// rejects all players from joining a team
+//
+void Console::cmdRejectAllPlayers(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
+		if (scene->server->game)
+		{
+			scene->server->game->rejectAllPlayers();
+			sendCommand("allwatch", true);
+		}
+}
 
-	// rejects all players from joining a team
-	if (command == "rejectallplayers")
-	{
-		if (scene->server)
-			if (scene->server->game)
-			{
-				scene->server->game->rejectAllPlayers();
-				sendCommand("allwatch", true);
-			}
-		return;
-	}
 
-	// printout of approved players
-	if (command == "listapprovedplayers")
+
+//
+// printout of approved players
+//
+void Console::cmdListApprovedPlayers(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		if (scene->server->game)
 		{
-			if (scene->server->game)
+			add("\x3> Approved players:", true);
+			int teams[2] = { PLAYER_TEAM_RED, PLAYER_TEAM_BLUE };
+			CString strplayer;
+			CString strteam;
+			for (int i = 0; i < 2; i++)
 			{
-				add("\x3> Approved players:", true);
-				int teams[2] = { PLAYER_TEAM_RED, PLAYER_TEAM_BLUE };
-				CString strplayer;
-				CString strteam;
-				for (int i = 0; i < 2; i++)
+				strteam.set("\x3 Team %d", teams[i]);
+				add(strteam, true);
+				if (scene->server->game->teamApproveAll[teams[i]] == true)
+					add("\x3 - All", true);
+				else
 				{
-					strteam.set("\x3 Team %d", teams[i]);
-					add(strteam, true);
-					if (scene->server->game->teamApproveAll[teams[i]] == true)
-						add("\x3 - All", true);
-					else
+					const std::vector<int>& userids = scene->server->game->approvedPlayers[teams[i]];
+					for (int j = 0; j < (int)userids.size(); j++)
 					{
-						const std::vector<int>& userids = scene->server->game->approvedPlayers[teams[i]];
-						for (int j = 0; j < (int)userids.size(); j++)
-						{
-							strplayer.set("\x3 - %d", userids[j]);
-							add(strplayer, true);
-						}
+						strplayer.set("\x3 - %d", userids[j]);
+						add(strplayer, true);
 					}
 				}
 			}
 		}
-		return;
 	}
+}
 
-	if (command == "savemap")
-	{
+
+
+//
+// Save the map we are playing on
+//
+void Console::cmdSaveMap(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
 #ifndef DEDICATED_SERVER
-		if (scene->client)
+	if (scene->client)
+	{
+		if (scene->client->game && scene->client->game->map && scene->client->game->mapBytesRecieved != 0)
 		{
-			if (scene->client->game && scene->client->game->map && scene->client->game->mapBytesRecieved != 0)
+			if (scene->client->game->thisPlayer)
 			{
-				if (scene->client->game->thisPlayer)
+				CString fileName = tokenize.getFirstToken(' ');
+				CString path;
+				if (fileName == "")
 				{
-					CString fileName = tokenize.getFirstToken(' ');
-					CString path;
-					if (fileName == "")
+					if (scene->client->game->map->mapName == "")
 					{
-						if (scene->client->game->map->mapName == "")
-						{
-							add("\x3> Could not save map");
-							return;
-						}
-						fileName.set("%s.bvm", scene->client->game->map->mapName.s);
+						add("\x3> Could not save map");
+						return;
 					}
-					else
+					fileName.set("%s.bvm", scene->client->game->map->mapName.s);
+				}
+				else
+				{
+					int id = 0;
+					if (fileName.find(".bvm", id))
 					{
-						int id = 0;
-						if (fileName.find(".bvm", id))
+						if (id == 0)
 						{
-							if (id == 0)
-							{
-								add("\x3> Invalid map name");
-								return;
-							}
-							else if (id != fileName.len() - 4)
-								fileName = fileName + ".bvm";
+							add("\x3> Invalid map name");
+							return;
 						}
-						else
+						else if (id != fileName.len() - 4)
 							fileName = fileName + ".bvm";
 					}
-					path.set("./main/maps/%s", fileName.s);
-					FileIO file(path, "r");
-					if (file.isValid())
-					{
-						add("\x3> Map with same name exists already");
-						file.Close();
-						return;
-					}
-					
-					file.Open(path, "wb");
-					if (file.isValid())
-					{
-						scene->client->game->mapBuffer.reset();
-						file.put(scene->client->game->mapBuffer.getByteArray(scene->client->game->mapBytesRecieved),
-							scene->client->game->mapBytesRecieved);
-						file.Close();
-						add(CString("\x3> Map saved as '%s'", fileName.s));
-					}
 					else
-						add(CString("\x3> Error while saving map '%s'", fileName.s));
+						fileName = fileName + ".bvm";
+				}
+				path.set("./main/maps/%s", fileName.s);
+				FileIO file(path, "r");
+				if (file.isValid())
+				{
+					add("\x3> Map with same name exists already");
+					file.Close();
+					return;
 				}
+				
+				file.Open(path, "wb");
+				if (file.isValid())
+				{
+					scene->client->game->mapBuffer.reset();
+					file.put(scene->client->game->mapBuffer.getByteArray(scene->client->game->mapBytesRecieved),
+						scene->client->game->mapBytesRecieved);
+					file.Close();
+					add(CString("\x3> Map saved as '%s'", fileName.s));
+				}
+				else
+					add(CString("\x3> Error while saving map '%s'", fileName.s));
 			}
 		}
-#endif
-		return;
 	}
+#endif
+}
 
-	if (command == "savemapforce")
-	{
+
+
+//
+// Save the map we are playing on, even over an existing file
+//
+void Console::cmdSaveMapForce(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
 #ifndef DEDICATED_SERVER
-		if (scene->client)
+	if (scene->client)
+	{
+		if (scene->client->game && scene->client->game->map && scene->client->game->mapBytesRecieved != 0)
 		{
-			if (scene->client->game && scene->client->game->map && scene->client->game->mapBytesRecieved != 0)
+			if (scene->client->game->thisPlayer)
 			{
-				if (scene->client->game->thisPlayer)
+				CString fileName = tokenize.getFirstToken(' ');
+				CString path;
+				if (fileName == "")
 				{
-					CString fileName = tokenize.getFirstToken(' ');
-					CString path;
-					if (fileName == "")
-					{
-						if (scene->client->game->map->mapName == "")
-						{
-							add("\x3> Could not save map");
-							return;
-						}
-						fileName.set("%s.bvm", scene->client->game->map->mapName.s);
-					}
-					path.set("./main/maps/%s", fileName.s);
-					FileIO file(path, "r");
-					if (file.isValid())
+					if (scene->client->game->map->mapName == "")
 					{
-						file.Close();
-						if(remove(path.s) == -1)
-							add(CString("\x3> Could not delete old map '%s'", path.s));
+						add("\x3> Could not save map");
+						return;
 					}
-					sendCommand(CString("savemap %s", fileName.s));
-				}
-			}
-		}
-#endif
-		return;
-	}
-
-	// Pour lancer un vote (? c hot)
-	if (command == "vote")
-	{
-#ifndef DEDICATED_SERVER
-		if (scene->client)
-		{
-			if (scene->client->game)
-			{
-				if (scene->client->game->thisPlayer)
+					fileName.set("%s.bvm", scene->client->game->map->mapName.s);
+				}
+				path.set("./main/maps/%s", fileName.s);
+				FileIO file(path, "r");
+				if (file.isValid())
 				{
-					//--- On send le token au server pour lancer le vote
-					if (tokenize.len() > 79) tokenize.resize(79);
-					net_clsv_svcl_vote_request voteRequest;
-					strcpy(voteRequest.vote, tokenize.s);
-					voteRequest.playerID = scene->client->game->thisPlayer->playerID;
-					bb_clientSend(scene->client->uniqueClientID, (char*)(&voteRequest), sizeof(net_clsv_svcl_vote_request), NET_CLSV_SVCL_VOTE_REQUEST);
+					file.Close();
+					if(remove(path.s) == -1)
+						add(CString("\x3> Could not delete old map '%s'", path.s));
 				}
+				sendCommand(CString("savemap %s", fileName.s));
 			}
 		}
-#endif
-		return;
 	}
+#endif
+}
 
-	// Pour voir la queue des map
-	if (command == "maplist")
-	{
-		if (scene->server)
-		{
-			for (int i=0;i<(int)scene->server->mapList.size();++i)
-			{
-				add(scene->server->mapList[i], false);
-			}
 
-			if(scene->server->mapList.size() == 0)
-				add("\x3> No maps on list", false);
-		}
+
+//
+// Pour lancer un vote (? c hot)
+//
+void Console::cmdVote(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
 #ifndef DEDICATED_SERVER
-		else if (scene->client)
+	if (scene->client)
+	{
+		if (scene->client->game)
 		{
-			if (scene->client->game)
+			if (scene->client->game->thisPlayer)
 			{
-				if (scene->client->game->thisPlayer)
-				{
-					net_clsv_map_list_request maplRequest;
-					maplRequest.playerID = scene->client->game->thisPlayer->playerID;
-					maplRequest.all = false;
-					bb_clientSend(scene->client->uniqueClientID, (char*)(&maplRequest), sizeof(net_clsv_map_list_request), NET_CLSV_MAP_LIST_REQUEST);
-				}
+				//--- On send le token au server pour lancer le vote
+				if (tokenize.len() > 79) tokenize.resize(79);
+				net_clsv_svcl_vote_request voteRequest;
+				strcpy(voteRequest.vote, tokenize.s);
+				voteRequest.playerID = scene->client->game->thisPlayer->playerID;
+				bb_clientSend(scene->client->uniqueClientID, (char*)(&voteRequest), sizeof(net_clsv_svcl_vote_request), NET_CLSV_SVCL_VOTE_REQUEST);
 			}
 		}
-#endif
-		return;
 	}
+#endif
+}
+
+
 
-	if (command == "maplistall")
+//
+// Pour voir la queue des map
+//
+void Console::cmdMapList(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		for (int i=0;i<(int)scene->server->mapList.size();++i)
 		{
-			std::vector<CString> maps;
-			maps = scene->server->populateMapList(true);
-			for (int i=0;i<(int)maps.size();++i)
-			{
-				add(maps[i], false);
-			}
-
-			if(maps.size() == 0)
-				add("\x3> No maps on server", false);
+			add(scene->server->mapList[i], false);
 		}
+
+		if(scene->server->mapList.size() == 0)
+			add("\x3> No maps on list", false);
+	}
 #ifndef DEDICATED_SERVER
-		else if (scene->client)
+	else if (scene->client)
+	{
+		if (scene->client->game)
 		{
-			if (scene->client->game)
+			if (scene->client->game->thisPlayer)
 			{
-				if (scene->client->game->thisPlayer)
-				{
-					net_clsv_map_list_request maplRequest;
-					maplRequest.playerID = scene->client->game->thisPlayer->playerID;
-					maplRequest.all = true;
-					bb_clientSend(scene->client->uniqueClientID, (char*)(&maplRequest), sizeof(net_clsv_map_list_request), NET_CLSV_MAP_LIST_REQUEST);
-				}
+				net_clsv_map_list_request maplRequest;
+				maplRequest.playerID = scene->client->game->thisPlayer->playerID;
+				maplRequest.all = false;
+				bb_clientSend(scene->client->uniqueClientID, (char*)(&maplRequest), sizeof(net_clsv_map_list_request), NET_CLSV_MAP_LIST_REQUEST);
 			}
 		}
-#endif
-		return;
 	}
+#endif
+}
 
-	// Pour enlever une map du queue
-	if (command == "removemap")
-	{
-		if (scene->server) scene->server->removemap(tokenize);
-		return;
-	}
 
-	// Pour changer la map, si on est server
-	if (command == "changemap")
-	{
-		if (scene->server) scene->server->changeMap(tokenize);
-		return;
-	}
-#ifndef DEDICATED_SERVER
-	// Pour rejoindre une game
-	if (command == "connect")
-	{
-		// On join une game en cours y??!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-		CString IPAddress = tokenize.getFirstToken(' ');
-		int port = tokenize.getFirstToken(' ').toInt();
-		CString password = tokenize;
-		if (port == 0) port = 3333; // Try on the regular port
-		scene->join(IPAddress, port, password);
-		m_isActive = false;
-		return;
-	}
-#endif
-	// Le quit
-	if (command == "disconnect")
-	{
-		// On disconnect si c'est bien le cas
-		scene->disconnect();
-		return;
-	}
 
-	// Pour chatter
-	if (command == "sayall")
+//
+// List every map the server has
+//
+void Console::cmdMapListAll(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		scene->sayall(tokenize);
-		return;
-	}
+		std::vector<CString> maps;
+		maps = scene->server->populateMapList(true);
+		for (int i=0;i<(int)maps.size();++i)
+		{
+			add(maps[i], false);
+		}
 
-#ifdef DEDICATED_SERVER
-	// Say to only one person (Console only)
-	if (command == "sayid")
+		if(maps.size() == 0)
+			add("\x3> No maps on server", false);
+	}
+#ifndef DEDICATED_SERVER
+	else if (scene->client)
 	{
-		if (scene->server)
+		if (scene->client->game)
 		{
-			if (scene->server->game)
+			if (scene->client->game->thisPlayer)
 			{
-				int playerID = tokenize.getFirstToken(' ').toInt();
-				if ((0 <= playerID) && (playerID < MAX_PLAYER) && scene->server->game->players[playerID])
-				{
-					net_clsv_svcl_chat chat_message;
-					chat_message.teamID = -3;// -3 == private message
-					CString message ("\x08Server: %s", tokenize.s);
-					if(message.len() > 49+80)
-						message.resize(49+80);
-					memset(chat_message.message, 0, sizeof(char) * (message.len() + 1));
-					memcpy(chat_message.message, message.s, sizeof(char) * (message.len() + 1));
-					bb_serverSend((char*)&chat_message, sizeof(net_clsv_svcl_chat), NET_CLSV_SVCL_CHAT, scene->server->game->players[playerID]->babonetID);
-				}
-				else
-				{
-					add(CString("Error: Bad player ID"), true);
-				}
+				net_clsv_map_list_request maplRequest;
+				maplRequest.playerID = scene->client->game->thisPlayer->playerID;
+				maplRequest.all = true;
+				bb_clientSend(scene->client->uniqueClientID, (char*)(&maplRequest), sizeof(net_clsv_map_list_request), NET_CLSV_MAP_LIST_REQUEST);
 			}
 		}
-		return;
 	}
 #endif
+}
+
+
+
+//
+// Pour enlever une map du queue
+//
+void Console::cmdRemoveMap(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server) scene->server->removemap(tokenize);
+}
+
+
+
+//
+// Pour changer la map, si on est server
+//
+void Console::cmdChangeMap(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server) scene->server->changeMap(tokenize);
+}
+
+
 
 #ifndef DEDICATED_SERVER
-	// Pour chatter
-	if (command == "sayteam")
-	{
-		scene->sayteam(tokenize);
-		return;
-	}
-	// Pour modifier ou cr?r une map
-	if (command == "edit")
-	{
-		scene->edit(tokenize);
-		m_isActive = false;
-		return;
-	}
+//
+// Pour rejoindre une game
+//
+void Console::cmdConnect(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	// On join une game en cours y??!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+	CString IPAddress = tokenize.getFirstToken(' ');
+	int port = tokenize.getFirstToken(' ').toInt();
+	CString password = tokenize;
+	if (port == 0) port = 3333; // Try on the regular port
+	scene->join(IPAddress, port, password);
+	m_isActive = false;
+}
 #endif
 
 
-#ifdef DEDICATED_SERVER
 
-	// output to console infos about a player
-	if (command == "playerinfo")
+//
+// Le quit
+//
+void Console::cmdDisconnect(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	// On disconnect si c'est bien le cas
+	scene->disconnect();
+}
+
+
+
+//
+// Pour chatter
+//
+void Console::cmdSayAll(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	scene->sayall(tokenize);
+}
+
+
+
+#ifdef DEDICATED_SERVER
+//
+// Say to only one person (Console only)
+//
+void Console::cmdSayID(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		int playerId = tokenize.toInt();
-		if( playerId < MAX_PLAYER )
+		if (scene->server->game)
 		{
-			if( scene->server->game->players[playerId] )
+			int playerID = tokenize.getFirstToken(' ').toInt();
+			if ((0 <= playerID) && (playerID < MAX_PLAYER) && scene->server->game->players[playerID])
 			{
-				CString strInfo = "Player ";
-				strInfo += playerId;
-				strInfo += " WeaponID:";
-				strInfo += (scene->server->game->players[playerId]->weapon ? scene->server->game->players[playerId]->weapon->weaponID : -1);
-				strInfo += " SecondaryID:";
-				strInfo += (scene->server->game->players[playerId]->meleeWeapon ? scene->server->game->players[playerId]->meleeWeapon->weaponID : -1);
-				strInfo += " TeamID:";
-				strInfo += scene->server->game->players[playerId]->teamID;
-				strInfo += " Position:";
-				strInfo += scene->server->game->players[playerId]->currentCF.position.x();
-				strInfo += ",";
-				strInfo += scene->server->game->players[playerId]->currentCF.position.y();
-				add( strInfo );
+				net_clsv_svcl_chat chat_message;
+				chat_message.teamID = -3;// -3 == private message
+				CString message ("\x08Server: %s", tokenize.s);
+				if(message.len() > 49+80)
+					message.resize(49+80);
+				memset(chat_message.message, 0, sizeof(char) * (message.len() + 1));
+				memcpy(chat_message.message, message.s, sizeof(char) * (message.len() + 1));
+				bb_serverSend((char*)&chat_message, sizeof(net_clsv_svcl_chat), NET_CLSV_SVCL_CHAT, scene->server->game->players[playerID]->babonetID);
 			}
 			else
 			{
-				add("that player id is not valid");
+				add(CString("Error: Bad player ID"), true);
 			}
 		}
+	}
+}
+#endif
+
+
+
+#ifndef DEDICATED_SERVER
+//
+// Pour chatter
+//
+void Console::cmdSayTeam(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	scene->sayteam(tokenize);
+}
+
+
+
+//
+// Pour modifier ou cr?r une map
+//
+void Console::cmdEdit(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	scene->edit(tokenize);
+	m_isActive = false;
+}
+#endif
+
+
+
+#ifdef DEDICATED_SERVER
+//
+// output to console infos about a player
+//
+void Console::cmdPlayerInfo(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	int playerId = tokenize.toInt();
+	if( playerId < MAX_PLAYER )
+	{
+		if( scene->server->game->players[playerId] )
+		{
+			CString strInfo = "Player ";
+			strInfo += playerId;
+			strInfo += " WeaponID:";
+			strInfo += (scene->server->game->players[playerId]->weapon ? scene->server->game->players[playerId]->weapon->weaponID : -1);
+			strInfo += " SecondaryID:";
+			strInfo += (scene->server->game->players[playerId]->meleeWeapon ? scene->server->game->players[playerId]->meleeWeapon->weaponID : -1);
+			strInfo += " TeamID:";
+			strInfo += scene->server->game->players[playerId]->teamID;
+			strInfo += " Position:";
+			strInfo += scene->server->game->players[playerId]->currentCF.position.x();
+			strInfo += ",";
+			strInfo += scene->server->game->players[playerId]->currentCF.position.y();
+			add( strInfo );
+		}
 		else
 		{
 			add("that player id is not valid");
 		}
-		return;
 	}
+	else
+	{
+		add("that player id is not valid");
+	}
+}
+
+
 
-	// output to console infos about a player
-	if (command == "playersinfo")
+//
+// output to console infos about a player
+//
+void Console::cmdPlayersInfo(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	for( int i=0; i<MAX_PLAYER; i++ )
 	{
-		for( int i=0; i<MAX_PLAYER; i++ )
+		if( scene->server->game->players[i] )
 		{
-			if( scene->server->game->players[i] )
-			{
-				CString strInfo = "Player ";
-				strInfo += i;
-				strInfo += " WeaponID:";
-				strInfo += (scene->server->game->players[i]->weapon ? scene->server->game->players[i]->weapon->weaponID : -1);
-				strInfo += " SecondaryID:";
-				strInfo += (scene->server->game->players[i]->meleeWeapon ? scene->server->game->players[i]->meleeWeapon->weaponID : -1);
-				strInfo += " TeamID:";
-				strInfo += scene->server->game->players[i]->teamID;
-				strInfo += " Position:";
-				strInfo += scene->server->game->players[i]->currentCF.position.x();
-				strInfo += ",";
-				strInfo += scene->server->game->players[i]->currentCF.position.y();
-				add( strInfo );
-			}
+			CString strInfo = "Player ";
+			strInfo += i;
+			strInfo += " WeaponID:";
+			strInfo += (scene->server->game->players[i]->weapon ? scene->server->game->players[i]->weapon->weaponID : -1);
+			strInfo += " SecondaryID:";
+			strInfo += (scene->server->game->players[i]->meleeWeapon ? scene->server->game->players[i]->meleeWeapon->weaponID : -1);
+			strInfo += " TeamID:";
+			strInfo += scene->server->game->players[i]->teamID;
+			strInfo += " Position:";
+			strInfo += scene->server->game->players[i]->currentCF.position.x();
+			strInfo += ",";
+			strInfo += scene->server->game->players[i]->currentCF.position.y();
+			add( strInfo );
 		}
-		return;
 	}
+}
+
 
-	if (command == "forceplayerspawn")
+
+//
+// Respawn a player at a given position with the given weapons
+//
+void Console::cmdForcePlayerSpawn(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	CString strID = tokenize.getFirstToken(' ');
+	int playerid = strID.toInt();
+	if( playerid < MAX_PLAYER )
 	{
-		CString strID = tokenize.getFirstToken(' ');
-		int playerid = strID.toInt();
-		if( playerid < MAX_PLAYER )
+		if( scene->server->game->players[playerid] )
 		{
-			if( scene->server->game->players[playerid] )
-			{
 
-				CString strX = tokenize.getFirstToken(' ');
-				CString strY = tokenize.getFirstToken(' ');
-				float newX = strX.toFloat();
-				float newY = strY.toFloat();
-
-				CString newWeapon = tokenize.getFirstToken(' ');
-				int newWeaponId = scene->server->game->players[playerid]->weapon ? scene->server->game->players[playerid]->weapon->weaponID : 0;
-				if( newWeapon.len() > 0 )
-				{
-					newWeaponId = newWeapon.toInt();
-					scene->server->game->players[playerid]->nextSpawnWeapon = newWeaponId;
-				}
+			CString strX = tokenize.getFirstToken(' ');
+			CString strY = tokenize.getFirstToken(' ');
+			float newX = strX.toFloat();
+			float newY = strY.toFloat();
 
-				CString newSecondary = tokenize.getFirstToken(' ');
-				int newSecondaryId = scene->server->game->players[playerid]->meleeWeapon ? scene->server->game->players[playerid]->meleeWeapon->weaponID : 10;
-				if( newSecondary.len() > 0 )
-				{
-					newSecondaryId = newSecondary.toInt();
-					scene->server->game->players[playerid]->nextMeleeWeapon = newSecondaryId;
-				}
+			CString newWeapon = tokenize.getFirstToken(' ');
+			int newWeaponId = scene->server->game->players[playerid]->weapon ? scene->server->game->players[playerid]->weapon->weaponID : 0;
+			if( newWeapon.len() > 0 )
+			{
+				newWeaponId = newWeapon.toInt();
+				scene->server->game->players[playerid]->nextSpawnWeapon = newWeaponId;
+			}
 
-				scene->server->game->players[playerid]->spawn( CVector3f( newX, newY, 0 ) );
-
-				net_svcl_player_spawn playerSpawn;
-				memcpy(playerSpawn.skin, scene->server->game->players[playerid]->skin.s, 7);
-				memcpy(playerSpawn.blueDecal, scene->server->game->players[playerid]->blueDecal.s, 3);
-				memcpy(playerSpawn.greenDecal, scene->server->game->players[playerid]->greenDecal.s, 3);
-				memcpy(playerSpawn.redDecal, scene->server->game->players[playerid]->redDecal.s, 3);
-				playerSpawn.weaponID = newWeaponId;
-				playerSpawn.meleeID = newSecondaryId;
-				playerSpawn.playerID = scene->server->game->players[playerid]->playerID;
-				playerSpawn.position[0] = (short)(newX*10);
-				playerSpawn.position[1] = (short)(newY*10);
-				playerSpawn.position[2] = (short)(scene->server->game->players[playerid]->currentCF.position[2]*10);
-				bb_serverSend((char*)&playerSpawn, sizeof(net_svcl_player_spawn), NET_SVCL_PLAYER_SPAWN, 0);
+			CString newSecondary = tokenize.getFirstToken(' ');
+			int newSecondaryId = scene->server->game->players[playerid]->meleeWeapon ? scene->server->game->players[playerid]->meleeWeapon->weaponID : 10;
+			if( newSecondary.len() > 0 )
+			{
+				newSecondaryId = newSecondary.toInt();
+				scene->server->game->players[playerid]->nextMeleeWeapon = newSecondaryId;
 			}
+
+			scene->server->game->players[playerid]->spawn( CVector3f( newX, newY, 0 ) );
+
+			net_svcl_player_spawn playerSpawn;
+			memcpy(playerSpawn.skin, scene->server->game->players[playerid]->skin.s, 7);
+			memcpy(playerSpawn.blueDecal, scene->server->game->players[playerid]->blueDecal.s, 3);
+			memcpy(playerSpawn.greenDecal, scene->server->game->players[playerid]->greenDecal.s, 3);
+			memcpy(playerSpawn.redDecal, scene->server->game->players[playerid]->redDecal.s, 3);
+			playerSpawn.weaponID = newWeaponId;
+			playerSpawn.meleeID = newSecondaryId;
+			playerSpawn.playerID = scene->server->game->players[playerid]->playerID;
+			playerSpawn.position[0] = (short)(newX*10);
+			playerSpawn.position[1] = (short)(newY*10);
+			playerSpawn.position[2] = (short)(scene->server->game->players[playerid]->currentCF.position[2]*10);
+			bb_serverSend((char*)&playerSpawn, sizeof(net_svcl_player_spawn), NET_SVCL_PLAYER_SPAWN, 0);
 		}
-		return;
 	}
+}
+
+
 
-	if( command == "blueTeamScore" )
+//
+// Score the blue flag for a player
+//
+void Console::cmdBlueTeamScore(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	int playerId = tokenize.toInt();
+	if( playerId < MAX_PLAYER )
 	{
-		int playerId = tokenize.toInt();
-		if( playerId < MAX_PLAYER )
+		if( scene->server->game->players[playerId] )
 		{
-			if( scene->server->game->players[playerId] )
-			{
-				scene->server->game->map->flagState[1] = -2;
-
-				// On le dis au autres
-				net_svcl_change_flag_state flagState;
-				flagState.flagID = 1;
-				flagState.newFlagState = -3;
-				flagState.playerID = playerId;
-				bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
-				flagState.newFlagState = -2;
-				bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
-
-				//CString message("\x03> \x01%s \x08scores for the Blue team! ID:", scene->server->game->players[playerId]->name.s,playerId);
-				//console->add(message);
-				scene->server->game->players[playerId]->score++;
-				scene->server->game->blueWin++;
-				scene->server->game->blueScore = scene->server->game->blueWin;
-			}
+			scene->server->game->map->flagState[1] = -2;
+
+			// On le dis au autres
+			net_svcl_change_flag_state flagState;
+			flagState.flagID = 1;
+			flagState.newFlagState = -3;
+			flagState.playerID = playerId;
+			bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
+			flagState.newFlagState = -2;
+			bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
+
+			//CString message("\x03> \x01%s \x08scores for the Blue team! ID:", scene->server->game->players[playerId]->name.s,playerId);
+			//console->add(message);
+			scene->server->game->players[playerId]->score++;
+			scene->server->game->blueWin++;
+			scene->server->game->blueScore = scene->server->game->blueWin;
 		}
-		return;
 	}
+}
+
 
-	if( command == "redTeamScore" )
+
+//
+// Score the red flag for a player
+//
+void Console::cmdRedTeamScore(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	int playerId = tokenize.toInt();
+	if( playerId < MAX_PLAYER )
 	{
-		int playerId = tokenize.toInt();
-		if( playerId < MAX_PLAYER )
+		if( scene->server->game->players[playerId] )
 		{
-			if( scene->server->game->players[playerId] )
-			{
-				scene->server->game->map->flagState[0] = -2;
-
-				// On le dis au autres
-				net_svcl_change_flag_state flagState;
-				flagState.flagID = 0;
-				flagState.newFlagState = -3;
-				flagState.playerID = playerId;
-				bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
-				flagState.newFlagState = -2;
-				bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
-
-				//CString message("\x03> \x01%s \x08scores for the Red team! ID:%i", scene->server->game->players[playerId]->name.s,playerId);
-				//console->add(message);
-				scene->server->game->players[playerId]->score++;
-				scene->server->game->redWin++;
-				scene->server->game->redScore = scene->server->game->redWin;
-			}
+			scene->server->game->map->flagState[0] = -2;
+
+			// On le dis au autres
+			net_svcl_change_flag_state flagState;
+			flagState.flagID = 0;
+			flagState.newFlagState = -3;
+			flagState.playerID = playerId;
+			bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
+			flagState.newFlagState = -2;
+			bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
+
+			//CString message("\x03> \x01%s \x08scores for the Red team! ID:%i", scene->server->game->players[playerId]->name.s,playerId);
+			//console->add(message);
+			scene->server->game->players[playerId]->score++;
+			scene->server->game->redWin++;
+			scene->server->game->redScore = scene->server->game->redWin;
 		}
-		return;
 	}
+}
 
-	if( command == "redFlagReturn" )
+
+
+//
+// Return the red flag, as if a player did
+//
+void Console::cmdRedFlagReturn(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	int playerId = tokenize.toInt();
+	if( playerId < MAX_PLAYER )
 	{
-		int playerId = tokenize.toInt();
-		if( playerId < MAX_PLAYER )
+		if( scene->server->game->players[playerId] )
 		{
-			if( scene->server->game->players[playerId] )
-			{
-				scene->server->game->map->flagState[1] = -2;
-
-				// On le dis au autres
-				net_svcl_change_flag_state flagState;
-				flagState.flagID = 1;
-				flagState.newFlagState = -1;
-				flagState.playerID = playerId;
-				bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
-				flagState.newFlagState = -2;
-				bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
-
-				//CString message("\x03> \x01%s \x08 returned the blue flag ID:%i", scene->server->game->players[playerId]->name.s,playerId);
-				//console->add(message);
-				//scene->server->game->players[playerId]->score++;
-				//scene->server->game->redWin++;
-				//scene->server->game->redScore = scene->server->game->blueWin;
-			}
+			scene->server->game->map->flagState[1] = -2;
+
+			// On le dis au autres
+			net_svcl_change_flag_state flagState;
+			flagState.flagID = 1;
+			flagState.newFlagState = -1;
+			flagState.playerID = playerId;
+			bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
+			flagState.newFlagState = -2;
+			bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
+
+			//CString message("\x03> \x01%s \x08 returned the blue flag ID:%i", scene->server->game->players[playerId]->name.s,playerId);
+			//console->add(message);
+			//scene->server->game->players[playerId]->score++;
+			//scene->server->game->redWin++;
+			//scene->server->game->redScore = scene->server->game->blueWin;
 		}
-		return;
 	}
+}
+
 
-	if( command == "blueFlagReturn" )
+
+//
+// Return the blue flag, as if a player did
+//
+void Console::cmdBlueFlagReturn(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	int playerId = tokenize.toInt();
+	if( playerId < MAX_PLAYER )
 	{
-		int playerId = tokenize.toInt();
-		if( playerId < MAX_PLAYER )
+		if( scene->server->game->players[playerId] )
 		{
-			if( scene->server->game->players[playerId] )
-			{
-				scene->server->game->map->flagState[0] = -2;
-
-				// On le dis au autres
-				net_svcl_change_flag_state flagState;
-				flagState.flagID = 0;
-				flagState.newFlagState = -1;
-				flagState.playerID = playerId;
-				bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
-				flagState.newFlagState = -2;
-				bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
-
-				//CString message("\x03> \x01%s \x08 returned the blue flag ID:%i", scene->server->game->players[playerId]->name.s,playerId);
-				//console->add(message);
-				//scene->server->game->players[playerId]->score++;
-				//scene->server->game->redWin++;
-				//scene->server->game->redScore = scene->server->game->blueWin;
-			}
+			scene->server->game->map->flagState[0] = -2;
+
+			// On le dis au autres
+			net_svcl_change_flag_state flagState;
+			flagState.flagID = 0;
+			flagState.newFlagState = -1;
+			flagState.playerID = playerId;
+			bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
+			flagState.newFlagState = -2;
+			bb_serverSend((char*)&flagState, sizeof(net_svcl_change_flag_state), NET_SVCL_CHANGE_FLAG_STATE, 0);
+
+			//CString message("\x03> \x01%s \x08 returned the blue flag ID:%i", scene->server->game->players[playerId]->name.s,playerId);
+			//console->add(message);
+			//scene->server->game->players[playerId]->score++;
+			//scene->server->game->redWin++;
+			//scene->server->game->redScore = scene->server->game->blueWin;
 		}
-		return;
 	}
+}
 
-	if( command == "mapinfos" )
-	{
-		if( !scene ) return;
-		if( !scene->server ) return;
-		if( !scene->server->game ) return;
-		if( !scene->server->game->map ) return;
 
-		// list all map infos we have
-		CString str = "Map Infos, name:";
-		str += scene->server->game->map->mapName;
-		str += " size:";
-		str += scene->server->game->map->size.x();
-		str += ",";
-		str += scene->server->game->map->size.y();
-		str += " nbSpawn:";
-		str += (int)scene->server->game->map->dm_spawns.size();
 
+//
+// Send the map infos to the remote admin
+//
+void Console::cmdMapInfos(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if( !scene ) return;
+	if( !scene->server ) return;
+	if( !scene->server->game ) return;
+	if( !scene->server->game->map ) return;
+
+	// list all map infos we have
+	CString str = "Map Infos, name:";
+	str += scene->server->game->map->mapName;
+	str += " size:";
+	str += scene->server->game->map->size.x();
+	str += ",";
+	str += scene->server->game->map->size.y();
+	str += " nbSpawn:";
+	str += (int)scene->server->game->map->dm_spawns.size();
+
+	add( str );
+
+	// list spawn points
+	for( unsigned int i=0; i<scene->server->game->map->dm_spawns.size(); i++ )
+	{
+		str = "Spawn ";
+		str += (int)i;
+		str += ":";
+		str += scene->server->game->map->dm_spawns[i].x();
+		str += ",";
+		str += scene->server->game->map->dm_spawns[i].y();
 		add( str );
+	}
+}
 
-		// list spawn points
-		for( unsigned int i=0; i<scene->server->game->map->dm_spawns.size(); i++ )
-		{
-			str = "Spawn ";
-			str += (int)i;
-			str += ":";
-			str += scene->server->game->map->dm_spawns[i].x();
-			str += ",";
-			str += scene->server->game->map->dm_spawns[i].y();
-			add( str );
-		}
 
-		
-		return;
-	}
 
-	if( command == "listbluespawns" )
-	{
-		if( !scene ) return;
-		if( !scene->server ) return;
-		if( !scene->server->game ) return;
-		if( !scene->server->game->map ) return;
+//
+// Send the blue spawn points to the remote admin
+//
+void Console::cmdListBlueSpawns(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if( !scene ) return;
+	if( !scene->server ) return;
+	if( !scene->server->game ) return;
+	if( !scene->server->game->map ) return;
 
-		// list all map infos we have
-		CString str;
+	// list all map infos we have
+	CString str;
 
-		// list blue spawn points
-		for( unsigned int i=0; i<scene->server->game->map->blue_spawns.size(); i++ )
-		{
-			str = "Blue Spawn #";
-			str += (int)i;
-			str += ":";
-			str += scene->server->game->map->blue_spawns[i].x();
-			str += ",";
-			str += scene->server->game->map->blue_spawns[i].y();
-			add( str );
-		}
-		return;
+	// list blue spawn points
+	for( unsigned int i=0; i<scene->server->game->map->blue_spawns.size(); i++ )
+	{
+		str = "Blue Spawn #";
+		str += (int)i;
+		str += ":";
+		str += scene->server->game->map->blue_spawns[i].x();
+		str += ",";
+		str += scene->server->game->map->blue_spawns[i].y();
+		add( str );
 	}
+}
+
+
 
-	if( command == "listredspawns" )
+//
+// Send the red spawn points to the remote admin
+//
+void Console::cmdListRedSpawns(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if( !scene ) return;
+	if( !scene->server ) return;
+	if( !scene->server->game ) return;
+	if( !scene->server->game->map ) return;
+
+	// list all map infos we have
+	CString str;
+
+	// list blue spawn points
+	for( unsigned int i=0; i<scene->server->game->map->red_spawns.size(); i++ )
 	{
-		if( !scene ) return;
-		if( !scene->server ) return;
-		if( !scene->server->game ) return;
-		if( !scene->server->game->map ) return;
+		str = "Red Spawn #";
+		str += (int)i;
+		str += ":";
+		str += scene->server->game->map->red_spawns[i].x();
+		str += ",";
+		str += scene->server->game->map->red_spawns[i].y();
+		add( str );
+	}
+}
 
-		// list all map infos we have
-		CString str;
 
-		// list blue spawn points
-		for( unsigned int i=0; i<scene->server->game->map->red_spawns.size(); i++ )
-		{
-			str = "Red Spawn #";
-			str += (int)i;
-			str += ":";
-			str += scene->server->game->map->red_spawns[i].x();
-			str += ",";
-			str += scene->server->game->map->red_spawns[i].y();
-			add( str );
-		}
-		return;
-	}
 
-	if( command == "allplayerpos" )
+//
+// Send every player position to the remote admin
+//
+void Console::cmdAllPlayerPos(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if( !scene ) return;
+	if( !scene->server ) return;
+	if( !scene->server->game ) return;
+	if( !master ) return;
+	
+	
+	// send to remote admin all player positions (compressed to shorts)
+	for( unsigned int i=0; i<MAX_PLAYER; i++ )
 	{
-		if( !scene ) return;
-		if( !scene->server ) return;
-		if( !scene->server->game ) return;
-		if( !master ) return;
-		
-		
-		// send to remote admin all player positions (compressed to shorts)
-		for( unsigned int i=0; i<MAX_PLAYER; i++ )
+		if( scene->server->game->players[i] )
 		{
-			if( scene->server->game->players[i] )
+			if( scene->server->game->players[i]->teamID > -1 )
 			{
-				if( scene->server->game->players[i]->teamID > -1 )
-				{
-					long id = (long)i;
-					short x = (short)(scene->server->game->players[i]->currentCF.position.x() * 100);
-					short y = (short)(scene->server->game->players[i]->currentCF.position.y() * 100);
-					master->RA_PositionBroadcast( id, x, y );
-				}
+				long id = (long)i;
+				short x = (short)(scene->server->game->players[i]->currentCF.position.x() * 100);
+				short y = (short)(scene->server->game->players[i]->currentCF.position.y() * 100);
+				master->RA_PositionBroadcast( id, x, y );
 			}
 		}
-		return;
 	}
-
+}
 #endif
 
 
+
 #ifndef DEDICATED_SERVER
-	if(command == "rebuildmap")
+//
+// Rebuild the map geometry
+//
+void Console::cmdRebuildMap(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if(scene && scene->client && scene->client->game && scene->client->game->map)
 	{
-		if(scene && scene->client && scene->client->game && scene->client->game->map)
-		{
-			scene->client->game->map->buildAll();
-		}
+		scene->client->game->map->buildAll();
 	}
+}
 #endif
 
-	// Pour carr?ent restarter toute la patente
-	if (command == "restart")
-	{
-		ZEVEN_SAFE_DELETE(scene);
-		scene = new Scene();
-		return;
-	}
 
-	// KICK UN CRISS DE CHEATEUX ?MARDE
-	if (command == "kick")
-	{
-		scene->kick(tokenize);
-		return;
-	}
 
-	// KICK LE CHEATER PAR PLAYER ID
-	if (command == "kickid")
+//
+// Pour carr?ent restarter toute la patente
+//
+void Console::cmdRestart(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	ZEVEN_SAFE_DELETE(scene);
+	scene = new Scene();
+}
+
+
+
+//
+// KICK UN CRISS DE CHEATEUX ?MARDE
+//
+void Console::cmdKick(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	scene->kick(tokenize);
+}
+
+
+
+//
+// KICK LE CHEATER PAR PLAYER ID
+//
+void Console::cmdKickID(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	int playerID = tokenize.toInt();
+	if (playerID >= 0 && playerID < MAX_PLAYER)
 	{
-		int playerID = tokenize.toInt();
-		if (playerID >= 0 && playerID < MAX_PLAYER)
-		{
-			scene->kick(playerID);
-		}
-		return;
+		scene->kick(playerID);
 	}
+}
+
 
-	// List bans
-	if (command == "banlist")
+
+//
+// List bans
+//
+void Console::cmdBanList(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		for (int i=0;i<(int)scene->server->banList.size();++i)
 		{
-			for (int i=0;i<(int)scene->server->banList.size();++i)
-			{
-				add(CString("[%02i] %s \x8- %s", i,
-					scene->server->banList[i].first.s,
-					scene->server->banList[i].second.s), true);
-			}
+			add(CString("[%02i] %s \x8- %s", i,
+				scene->server->banList[i].first.s,
+				scene->server->banList[i].second.s), true);
 		}
-		return;
 	}
+}
 
-	// Ban by name
-	if (command == "ban")
-	{
-		scene->ban(tokenize);
-		return;
-	}
 
-	// Ban by IP
-	if (command == "banip")
-	{
-		scene->banIP(tokenize);
-		return;
-	}
 
-	// Ban by player ID
-	if (command == "banid")
+//
+// Ban by name
+//
+void Console::cmdBan(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	scene->ban(tokenize);
+}
+
+
+
+//
+// Ban by IP
+//
+void Console::cmdBanIP(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	scene->banIP(tokenize);
+}
+
+
+
+//
+// Ban by player ID
+//
+void Console::cmdBanID(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	int playerID = tokenize.toInt();
+	if (playerID >= 0 && playerID < MAX_PLAYER)
 	{
-		int playerID = tokenize.toInt();
-		if (playerID >= 0 && playerID < MAX_PLAYER)
-		{
-			scene->ban(playerID);
-		}
-		return;
+		scene->ban(playerID);
 	}
+}
 
-	// Unban
-	if(command == "unban") {
-		unsigned int banID = tokenize.toInt();
-		if(scene->server) {
-			if(banID >= 0 && banID < scene->server->banList.size())
-				scene->unban(banID);
-		}
-		return;
+
+
+//
+// Unban
+//
+void Console::cmdUnban(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	unsigned int banID = tokenize.toInt();
+	if(scene->server) {
+		if(banID >= 0 && banID < scene->server->banList.size())
+			scene->unban(banID);
 	}
+}
 
-	// List Cached players
-	if (command == "cachelist")
+
+
+//
+// List Cached players
+//
+void Console::cmdCacheList(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		for (int i=0;i<50;i++)
 		{
-			for (int i=0;i<50;i++)
+			if( scene->server->CachedPlayers[i].Valid )
 			{
-				if( scene->server->CachedPlayers[i].Valid )
+				//if a parameter was entered after the list, onlyshow those who fits
+				if( tokenize != "" )
 				{
-					//if a parameter was entered after the list, onlyshow those who fits
-					if( tokenize != "" )
-					{
-						tokenize.toLower();
-						CString name( scene->server->CachedPlayers[i].NickName );
-						name.toLower();
+					tokenize.toLower();
+					CString name( scene->server->CachedPlayers[i].NickName );
+					name.toLower();
 
-						if( strstr( name.s , tokenize.s ) )
-						{
-							add(CString("[%02i] %s \x8- %s  %s", i,
-								scene->server->CachedPlayers[i].NickName,
-								scene->server->CachedPlayers[i].IP,
-								scene->server->CachedPlayers[i].macAddr),
-								true);
-						}
-						else if( strstr( scene->server->CachedPlayers[i].IP , tokenize.s ) )
-						{
-							add(CString("[%02i] %s \x8- %s  %s", i,
-								scene->server->CachedPlayers[i].NickName,
-								scene->server->CachedPlayers[i].IP,
-								scene->server->CachedPlayers[i].macAddr),
-								true);
-						}
+					if( strstr( name.s , tokenize.s ) )
+					{
+						add(CString("[%02i] %s \x8- %s  %s", i,
+							scene->server->CachedPlayers[i].NickName,
+							scene->server->CachedPlayers[i].IP,
+							scene->server->CachedPlayers[i].macAddr),
+							true);
 					}
-					else
+					else if( strstr( scene->server->CachedPlayers[i].IP , tokenize.s ) )
 					{
 						add(CString("[%02i] %s \x8- %s  %s", i,
 							scene->server->CachedPlayers[i].NickName,
@@ -2133,247 +2456,276 @@ void Console::sendCommand(CString commandLine, bool isAdmin, unsigned long bbnet
 							true);
 					}
 				}
+				else
+				{
+					add(CString("[%02i] %s \x8- %s  %s", i,
+						scene->server->CachedPlayers[i].NickName,
+						scene->server->CachedPlayers[i].IP,
+						scene->server->CachedPlayers[i].macAddr),
+						true);
+				}
 			}
 		}
-		return;
 	}
+}
+
 
-	// ban a cached player
-	// parameter are : password Id DurationInDays( 0 = unlimited ban )
-	if (command == "cacheban")
+
+//
+// ban a cached player
+// parameter are : password Id DurationInDays( 0 = unlimited ban )
+//
+void Console::cmdCacheBan(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
-		{
-			CString strPass = tokenize.getFirstToken(' ');
+		CString strPass = tokenize.getFirstToken(' ');
 // 			if( strPass != "roxbabo" )
 // 			{
 // 				return;
 // 			}
-				
-			CString strID = tokenize.getFirstToken(' ');
-			if( strID == "" )
-			{
-				return;
-			}
+			
+		CString strID = tokenize.getFirstToken(' ');
+		if( strID == "" )
+		{
+			return;
+		}
 
-			int ID = strID.toInt();
-			if( ID >= 50 || ID < 0 || !scene->server->CachedPlayers[ID].Valid )
-			{
-				return;
-			}
+		int ID = strID.toInt();
+		if( ID >= 50 || ID < 0 || !scene->server->CachedPlayers[ID].Valid )
+		{
+			return;
+		}
 
-			CString strDuration = tokenize.getFirstToken(' ');
+		CString strDuration = tokenize.getFirstToken(' ');
             int duration = 0;
-			if( strDuration != "" )
-			{
-				duration = strDuration.toInt();
-				if( duration < 0 ) duration = 1;
-			}
-
-			stCacheBan cb;
-			cb.Duration		=	duration;
-			cb.ID			=	ID;
-			sprintf( cb.IP , "%s", scene->server->CachedPlayers[ID].IP );
-			sprintf( cb.MAC , "%s", scene->server->CachedPlayers[ID].macAddr );
-			sprintf( cb.Nick , "%s", scene->server->CachedPlayers[ID].NickName );
-			memcpy( cb.Pass, strPass.s, 7 );
-			cb.Pass[7] = '\0';
-			
-			// we have everything, tell the master server to ban him!
-			master->sendPacket( (char*)&cb , sizeof(stCacheBan) , CACHE_BAN );
-
+		if( strDuration != "" )
+		{
+			duration = strDuration.toInt();
+			if( duration < 0 ) duration = 1;
 		}
 
-		return;
+		stCacheBan cb;
+		cb.Duration		=	duration;
+		cb.ID			=	ID;
+		sprintf( cb.IP , "%s", scene->server->CachedPlayers[ID].IP );
+		sprintf( cb.MAC , "%s", scene->server->CachedPlayers[ID].macAddr );
+		sprintf( cb.Nick , "%s", scene->server->CachedPlayers[ID].NickName );
+		memcpy( cb.Pass, strPass.s, 7 );
+		cb.Pass[7] = '\0';
+		
+		// we have everything, tell the master server to ban him!
+		master->sendPacket( (char*)&cb , sizeof(stCacheBan) , CACHE_BAN );
+
 	}
+}
 
-	// see who was cachebanned by the master server
-	// parameter is a filter if we want to only list those containing some characters in the nick name
-	if (command == "cachebanned")
-	{
-		if (scene->server)
-		{
-			CString strFilter = tokenize.getFirstToken(' ');
-			stCacheList cl;
-			sprintf( cl.Filter , "%s", strFilter.s );
-			
-			// we have everything, tell the master server to send us the cachebanned
-			master->sendPacket( (char*)&cl , sizeof(stCacheList) , CACHE_BAN_LIST );
 
-		}
 
-		return;
+//
+// see who was cachebanned by the master server
+// parameter is a filter if we want to only list those containing some characters in the nick name
+//
+void Console::cmdCacheBanned(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
+	{
+		CString strFilter = tokenize.getFirstToken(' ');
+		stCacheList cl;
+		sprintf( cl.Filter , "%s", strFilter.s );
+		
+		// we have everything, tell the master server to send us the cachebanned
+		master->sendPacket( (char*)&cl , sizeof(stCacheList) , CACHE_BAN_LIST );
+
 	}
+}
 
 
-	// unban someone from master server
-	// parameter is the pass + ID of the guy
-	if (command == "cacheunban")
+
+//
+// unban someone from master server
+// parameter is the pass + ID of the guy
+//
+void Console::cmdCacheUnban(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server)
+		CString strPass = tokenize.getFirstToken(' ');
+		if( strPass == "" )
 		{
-			CString strPass = tokenize.getFirstToken(' ');
-			if( strPass == "" )
-			{
-				return;
-			}
+			return;
+		}
 
-			CString strID = tokenize.getFirstToken(' ');
-			if( strID == "" )
-			{
-				return;
-			}
-			short ID = strID.toInt();
+		CString strID = tokenize.getFirstToken(' ');
+		if( strID == "" )
+		{
+			return;
+		}
+		short ID = strID.toInt();
+
+		stCacheUnban cu;
+		cu.ID	=	ID;
+		memcpy( cu.Pass, strPass.s, 7 );
+		cu.Pass[7] = '\0';
+		
+		// we have everything, tell the master server to unban this guy
+		master->sendPacket( (char*)&cu , sizeof(stCacheUnban) , CACHE_UNBAN );
+
+	}
+}
 
-			stCacheUnban cu;
-			cu.ID	=	ID;
-			memcpy( cu.Pass, strPass.s, 7 );
-			cu.Pass[7] = '\0';
-			
-			// we have everything, tell the master server to unban this guy
-			master->sendPacket( (char*)&cu , sizeof(stCacheUnban) , CACHE_UNBAN );
 
-		}
 
+//
+// tell master to send us cache list of remote server (no need to have admin on that server)
+//
+void Console::cmdCacheListRemote(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server && bbnetID != -1)
+	{
+		CString serverIP = tokenize.getFirstToken(' ');
+		CString serverPort = tokenize.getFirstToken(' ');
+		CString strFilter = tokenize.getFirstToken(' ');
+		add(CString("req from %i ", bbnetID));
+		master->requestRemoteCacheList(strFilter, serverIP, serverPort, bbnetID);
 		return;
 	}
 
-	// tell master to send us cache list of remote server (no need to have admin on that server)
-	if (command == "cachelistremote")
+	// "Unkown command" ;)
+	unknownCommand(commandLine);
+}
+
+
+
+//
+// ban remotely cached player (id from the result of last cachelistremote call)
+// parameter are : password Id DurationInDays( 0 = unlimited ban )
+//
+void Console::cmdCacheBanRemote(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene->server)
 	{
-		if (scene->server && bbnetID != -1)
+		CString strPass = tokenize.getFirstToken(' ');
+		if( strPass == "" ) return;
+
+		CString strID = tokenize.getFirstToken(' ');
+		if( strID == "" ) return;
+		int ID = strID.toInt();
+		if( ID >= 50 || ID < 0 || !master->CachedPlayersRemote[ID].Valid )
 		{
-			CString serverIP = tokenize.getFirstToken(' ');
-			CString serverPort = tokenize.getFirstToken(' ');
-			CString strFilter = tokenize.getFirstToken(' ');
-			add(CString("req from %i ", bbnetID));
-			master->requestRemoteCacheList(strFilter, serverIP, serverPort, bbnetID);
+			add("\x3> Invalid ID of player");
 			return;
 		}
 
-		//return;
-		// "Unkown command" ;)
-	}
-
-	// ban remotely cached player (id from the result of last cachelistremote call)
-	// parameter are : password Id DurationInDays( 0 = unlimited ban )
-	if (command == "cachebanremote")
-	{
-		if (scene->server)
+		CString strDuration = tokenize.getFirstToken(' ');
+		int duration = 0;
+		if( strDuration != "" )
 		{
-			CString strPass = tokenize.getFirstToken(' ');
-			if( strPass == "" ) return;
+			duration = strDuration.toInt();
+			if( duration < 0 ) duration = 1;
+		}
 
-			CString strID = tokenize.getFirstToken(' ');
-			if( strID == "" ) return;
-			int ID = strID.toInt();
-			if( ID >= 50 || ID < 0 || !master->CachedPlayersRemote[ID].Valid )
-			{
-				add("\x3> Invalid ID of player");
-				return;
-			}
+		stCacheBan cb;
+		cb.Duration		=	duration;
+		cb.ID			=	ID;
+		sprintf( cb.IP , "%s", master->CachedPlayersRemote[ID].IP );
+		sprintf( cb.MAC , "%s", master->CachedPlayersRemote[ID].macAddr );
+		sprintf( cb.Nick , "%s", master->CachedPlayersRemote[ID].NickName );
+		memcpy( cb.Pass, strPass.s, 7 );
+		cb.Pass[7] = '\0';
+		
+		// we have everything, tell the master server to ban him!
+		master->sendPacket( (char*)&cb , sizeof(stCacheBan) , CACHE_BAN );
+	}
 
-			CString strDuration = tokenize.getFirstToken(' ');
-			int duration = 0;
-			if( strDuration != "" )
-			{
-				duration = strDuration.toInt();
-				if( duration < 0 ) duration = 1;
-			}
+	// "Unkown command" ;)
+	unknownCommand(commandLine);
+}
 
-			stCacheBan cb;
-			cb.Duration		=	duration;
-			cb.ID			=	ID;
-			sprintf( cb.IP , "%s", master->CachedPlayersRemote[ID].IP );
-			sprintf( cb.MAC , "%s", master->CachedPlayersRemote[ID].macAddr );
-			sprintf( cb.Nick , "%s", master->CachedPlayersRemote[ID].NickName );
-			memcpy( cb.Pass, strPass.s, 7 );
-			cb.Pass[7] = '\0';
-			
-			// we have everything, tell the master server to ban him!
-			master->sendPacket( (char*)&cb , sizeof(stCacheBan) , CACHE_BAN );
-		}
 
-		//return;
-		// "Unkown command" ;)
-	}
 
 #if defined(_PRO_)
-	// getinvalidchecksums [offsetFromEnd=50 [number=50]]
-	// request number(max 50) of entries from BadChecksums starting from number of entries-offsetFromEnd
-	if (command == "getinvalidchecksums")
-	{
-		if (scene && scene->server)
-		{
-			int num = -1, offsetFromEnd = 50;
-			CString offsetFromEndStr = tokenize.getFirstToken(' ');
-			if (offsetFromEndStr != "")
-				offsetFromEnd = offsetFromEndStr.toInt();
-			CString numStr = tokenize.getFirstToken(' ');
-			if (numStr != "")
-				num = numStr.toInt();
-			//scene->server->sendInvalidChecksums(bbnetID, num, offsetFromEnd);
-			std::vector<invalidChecksumEntity> list = scene->server->getInvalidChecksums(bbnetID, num, offsetFromEnd);
-			for (int i = 0; i < (int)list.size(); i++)
-			{
+//
+// getinvalidchecksums [offsetFromEnd=50 [number=50]]
+// request number(max 50) of entries from BadChecksums starting from number of entries-offsetFromEnd
+//
+void Console::cmdGetInvalidChecksums(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene && scene->server)
+	{
+		int num = -1, offsetFromEnd = 50;
+		CString offsetFromEndStr = tokenize.getFirstToken(' ');
+		if (offsetFromEndStr != "")
+			offsetFromEnd = offsetFromEndStr.toInt();
+		CString numStr = tokenize.getFirstToken(' ');
+		if (numStr != "")
+			num = numStr.toInt();
+		//scene->server->sendInvalidChecksums(bbnetID, num, offsetFromEnd);
+		std::vector<invalidChecksumEntity> list = scene->server->getInvalidChecksums(bbnetID, num, offsetFromEnd);
+		for (int i = 0; i < (int)list.size(); i++)
+		{
 #ifdef DEDICATED_SERVER
-				net_svcl_bad_checksum_entity bce;
-				memset(&bce, 0, sizeof(net_svcl_bad_checksum_entity));
-				strcpy(bce.name, list[i].name);
-				strcpy(bce.playerIP, list[i].playerIP);
-				bce.id = list[i].id;
-				bb_serverSend((char*)&bce, sizeof(net_svcl_bad_checksum_entity), NET_SVCL_BAD_CHECKSUM_ENTITY, bbnetID);
+			net_svcl_bad_checksum_entity bce;
+			memset(&bce, 0, sizeof(net_svcl_bad_checksum_entity));
+			strcpy(bce.name, list[i].name);
+			strcpy(bce.playerIP, list[i].playerIP);
+			bce.id = list[i].id;
+			bb_serverSend((char*)&bce, sizeof(net_svcl_bad_checksum_entity), NET_SVCL_BAD_CHECKSUM_ENTITY, bbnetID);
 #else
-				console->add(CString("%i) %s, IP: %s", list[i].id, list[i].name, list[i].playerIP));
+			console->add(CString("%i) %s, IP: %s", list[i].id, list[i].name, list[i].playerIP));
 #endif //DEDICATED_SERVER
-			}
 		}
-		return;
 	}
+}
 
-	if (command == "deleteinvalidchecksums")
-	{
-		if (scene && scene->server)
-			scene->server->deleteInvalidChecksums();
-		return;
-	}
 
-	if (command == "invalidchecksumsinfo")
-	{
 
-		if (scene && scene->server)
-		{
+//
+// Forget the invalid checksums
+//
+void Console::cmdDeleteInvalidChecksums(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	if (scene && scene->server)
+		scene->server->deleteInvalidChecksums();
+}
+
+
+
+//
+// How many invalid checksums we have
+//
+void Console::cmdInvalidChecksumsInfo(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+
+	if (scene && scene->server)
+	{
 #ifdef DEDICATED_SERVER
-			net_svcl_bad_checksum_info bci;
-			bci.number = scene->server->getNumberOfInvalidChecksums();
-			bb_serverSend((char*)&bci, sizeof(net_svcl_bad_checksum_info), NET_SVCL_BAD_CHECKSUM_INFO, bbnetID);
+		net_svcl_bad_checksum_info bci;
+		bci.number = scene->server->getNumberOfInvalidChecksums();
+		bb_serverSend((char*)&bci, sizeof(net_svcl_bad_checksum_info), NET_SVCL_BAD_CHECKSUM_INFO, bbnetID);
 #else
-			console->add(CString(">> %i", scene->server->getNumberOfInvalidChecksums()));
+		console->add(CString(">> %i", scene->server->getNumberOfInvalidChecksums()));
 #endif //DEDICATED_SERVER
-		}
-		return;
 	}
+}
+#endif
+
 
-#endif //_PRO_
 
 #ifdef _DEBUG
 #ifndef DEDICATED_SERVER
-	if (command == "status")
-	{
-		int i = tokenize.getFirstToken(' ').toInt();
-		if(i >= 0 && i <= 3)
-			status->set(i);
-		return;
-	}
+//
+// Debug status display
+//
+void Console::cmdStatus(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID)
+{
+	int i = tokenize.getFirstToken(' ').toInt();
+	if(i >= 0 && i <= 3)
+		status->set(i);
+}
 #endif
 #endif
 
-
-	add(CString("\x3> Unkown command : \"%s\"", command.s));
-	add(CString("\x3> Type \"?\" for commands list", command.s));
-	return;
-}
-
 void Console::SetDisplayEvents(bool b)
 {
 	if (displayEvents != b)
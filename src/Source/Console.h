@@ -29,6 +29,8 @@
 #include "Writting.h"
 #endif
 #include <vector>
+#include <unordered_map>
+#include <string>
 
 
 #ifndef DEDICATED_SERVER
@@ -138,6 +140,108 @@ public:
 
 private:
 	const std::vector<CString>& GetActiveMessages();
+
+	// Une commande, tokenize contient ce qui suit son nom
+	typedef void (Console::*CommandHandler)(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+
+	// Toutes les commandes, par nom en minuscule
+	static const std::unordered_map<std::string, CommandHandler> & getCommands();
+
+	// Execute une ligne, sans passer par sendCommand (les scripts passent par ici)
+	void runCommand(CString commandLine, bool isAdmin, unsigned long bbnetID);
+	void unknownCommand(CString commandLine);
+
+	// Les commandes
+	void cmdHelp(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdExecute(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdAdmin(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdInfo(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdRemoteAdmin(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdRemoteConsole(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdSet(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdQuit(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#ifndef DEDICATED_SERVER
+	void cmdHost(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#endif
+	void cmdDedicate(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdVoteOn(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdNoVote(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdAddMap(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdPlayerList(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdMove(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdMoveID(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdNukeAll(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdNuke(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdNukeID(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdAllWatch(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdAddReportURL(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdRemoveReportURL(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdRemoveAllReportURLs(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdListReportURLs(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdApproveAll(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdApprovePlayer(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdRejectPlayer(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdRejectAllPlayers(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdListApprovedPlayers(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdSaveMap(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdSaveMapForce(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdVote(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdMapList(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdMapListAll(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdRemoveMap(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdChangeMap(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#ifndef DEDICATED_SERVER
+	void cmdConnect(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#endif
+	void cmdDisconnect(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdSayAll(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#ifdef DEDICATED_SERVER
+	void cmdSayID(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#endif
+#ifndef DEDICATED_SERVER
+	void cmdSayTeam(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdEdit(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#endif
+#ifdef DEDICATED_SERVER
+	void cmdPlayerInfo(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdPlayersInfo(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdForcePlayerSpawn(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdBlueTeamScore(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdRedTeamScore(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdRedFlagReturn(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdBlueFlagReturn(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdMapInfos(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdListBlueSpawns(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdListRedSpawns(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdAllPlayerPos(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#endif
+#ifndef DEDICATED_SERVER
+	void cmdRebuildMap(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#endif
+	void cmdRestart(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdKick(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdKickID(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdBanList(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdBan(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdBanIP(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdBanID(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdUnban(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdCacheList(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdCacheBan(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdCacheBanned(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdCacheUnban(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdCacheListRemote(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdCacheBanRemote(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#if defined(_PRO_)
+	void cmdGetInvalidChecksums(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdDeleteInvalidChecksums(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+	void cmdInvalidChecksumsInfo(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#endif
+#ifdef _DEBUG
+#ifndef DEDICATED_SERVER
+	void cmdStatus(CString & tokenize, CString & commandLine, bool isAdmin, unsigned long bbnetID);
+#endif
+#endif
 };
 
 
@@ -0,0 +1,256 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "Database.h"
+
+
+CDatabase database;
+
+
+// Same order as EDatabaseStatement
+static const char *statementSQL[DB_STATEMENT_COUNT] =
+{
+	"Select IP, Name From BadChecksum limit ?1 offset (select count(*) from BadChecksum) - ?2",
+	"Select count(*) From BadChecksum",
+	"Insert into BadChecksum(IP,Name) Values(?1,?2)",
+	"Delete from BadChecksum",
+	"Select Value From LauncherSettings where Name = ?1",
+};
+
+
+
+//
+// Constructeur
+//
+CDatabase::CDatabase()
+{
+	m_db = 0;
+	m_writeDb = 0;
+	for (int i=0;i<DB_STATEMENT_COUNT;++i)
+	{
+		m_statements[i] = 0;
+		m_writeStatements[i] = 0;
+	}
+	m_committing = false;
+	m_stop = false;
+	m_done = true;
+}
+
+
+
+//
+// Destructeur
+//
+CDatabase::~CDatabase()
+{
+	close();
+}
+
+
+
+//
+// Open one connection
+//
+sqlite3 * CDatabase::openConnection(const char *filename, int busyTimeout)
+{
+	sqlite3 *db = 0;
+	if (sqlite3_open(filename, &db) != SQLITE_OK)
+	{
+		sqlite3_close(db);
+		return 0;
+	}
+
+	// Many servers can share the file, wait a bit instead of failing when it is locked
+	sqlite3_busy_timeout(db, busyTimeout);
+	sqlite3_exec(db, "PRAGMA journal_mode=WAL", 0, 0, 0);
+	sqlite3_exec(db, "PRAGMA synchronous=NORMAL", 0, 0, 0);
+	return db;
+}
+
+
+
+//
+// Open the file and start the writer
+//
+bool CDatabase::open(const char *filename)
+{
+	close();
+
+	m_db = openConnection(filename, 100);
+	if (!m_db) return false;
+
+	m_writeDb = openConnection(filename, 2000);
+	if (!m_writeDb)
+	{
+		close();
+		return false;
+	}
+
+	m_stop = false;
+	m_done = false;
+	if (!start(0, CTHREAD_PRIORITY_LOW))
+	{
+		m_done = true;
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+
+
+//
+// Commit the queue then close
+//
+void CDatabase::close()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_stop = true;
+		m_wakeUp.notify_all();
+		while (!m_done) m_wakeUp.wait(lock);
+	}
+
+	for (int i=0;i<DB_STATEMENT_COUNT;++i)
+	{
+		if (m_statements[i]) sqlite3_finalize(m_statements[i]);
+		if (m_writeStatements[i]) sqlite3_finalize(m_writeStatements[i]);
+		m_statements[i] = 0;
+		m_writeStatements[i] = 0;
+	}
+	if (m_db) sqlite3_close(m_db);
+	if (m_writeDb) sqlite3_close(m_writeDb);
+	m_db = 0;
+	m_writeDb = 0;
+}
+
+
+
+//
+// Get a cached statement
+//
+sqlite3_stmt * CDatabase::getStatement(sqlite3 *db, sqlite3_stmt **statements, int statement)
+{
+	if (!db || statement < 0 || statement >= DB_STATEMENT_COUNT) return 0;
+
+	if (!statements[statement])
+	{
+		if (sqlite3_prepare_v2(db, statementSQL[statement], -1, &(statements[statement]), 0) != SQLITE_OK)
+		{
+			sqlite3_finalize(statements[statement]);
+			statements[statement] = 0;
+		}
+		return statements[statement];
+	}
+
+	// Ready for a new run
+	sqlite3_reset(statements[statement]);
+	sqlite3_clear_bindings(statements[statement]);
+	return statements[statement];
+}
+
+
+
+//
+// A read statement, on the game thread
+//
+sqlite3_stmt * CDatabase::prepare(int statement)
+{
+	return getStatement(m_db, m_statements, statement);
+}
+
+
+
+//
+// Queue a write
+//
+void CDatabase::write(int statement, const char *arg1, const char *arg2)
+{
+	SDatabaseWrite entry;
+	entry.statement = statement;
+	if (arg1) entry.args.push_back(arg1);
+	if (arg2) entry.args.push_back(arg2);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (m_done) return; // Not opened
+	m_pending.push_back(entry);
+	m_wakeUp.notify_all();
+}
+
+
+
+//
+// Wait for the writer to empty the queue
+//
+void CDatabase::flush()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_done && (m_committing || !m_pending.empty())) m_wakeUp.wait(lock);
+}
+
+
+
+//
+// Commit a batch of writes, in one transaction
+//
+void CDatabase::commit(std::vector<SDatabaseWrite> & batch)
+{
+	sqlite3_exec(m_writeDb, "BEGIN", 0, 0, 0);
+	for (int i=0;i<(int)batch.size();++i)
+	{
+		sqlite3_stmt *stmt = getStatement(m_writeDb, m_writeStatements, batch[i].statement);
+		if (!stmt) continue;
+
+		for (int j=0;j<(int)batch[i].args.size();++j)
+		{
+			sqlite3_bind_text(stmt, j + 1, batch[i].args[j].c_str(), -1, SQLITE_TRANSIENT);
+		}
+		sqlite3_step(stmt);
+		sqlite3_reset(stmt);
+	}
+	sqlite3_exec(m_writeDb, "COMMIT", 0, 0, 0);
+}
+
+
+
+//
+// The writer thread. Everything that came in since the last commit goes in the next one
+//
+void CDatabase::execute(void *pArg)
+{
+	std::vector<SDatabaseWrite> batch;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		while (!m_stop && m_pending.empty()) m_wakeUp.wait(lock);
+		if (m_pending.empty()) break; // Stopped and nothing left
+
+		batch.swap(m_pending);
+		m_committing = true;
+		lock.unlock();
+		commit(batch);
+		batch.clear();
+		lock.lock();
+		m_committing = false;
+		m_wakeUp.notify_all();
+	}
+
+	m_done = true;
+	m_wakeUp.notify_all();
+}
@@ -0,0 +1,113 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef DATABASE_H
+#define DATABASE_H
+
+
+#include "sqlite3.h"
+#include "CThread.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+
+// The statements we run on bv2.db. They are prepared once and kept
+enum EDatabaseStatement
+{
+	DB_SELECT_BAD_CHECKSUMS,	// ?1 = how many, ?2 = offset from the end
+	DB_COUNT_BAD_CHECKSUMS,
+	DB_INSERT_BAD_CHECKSUM,		// ?1 = IP, ?2 = Name
+	DB_DELETE_BAD_CHECKSUMS,
+	DB_SELECT_LAUNCHER_SETTING,	// ?1 = Name
+	DB_STATEMENT_COUNT
+};
+
+
+// A write waiting for the writer thread, its arguments are bound as text
+struct SDatabaseWrite
+{
+	int statement;
+	std::vector<std::string> args;
+};
+
+
+// bv2.db, opened once for the whole game.
+// Reads run right away on the calling thread (the game thread).
+// Writes are queued and the writer thread commits them in batches, each in one transaction,
+// so they never stall a frame. The file is in WAL mode so the reads don't wait on the writer.
+class CDatabase : public CThread
+{
+private:
+	// The game thread connection, for the reads
+	sqlite3 *m_db;
+	sqlite3_stmt *m_statements[DB_STATEMENT_COUNT];
+
+	// The writer thread connection
+	sqlite3 *m_writeDb;
+	sqlite3_stmt *m_writeStatements[DB_STATEMENT_COUNT];
+
+	// The writes not committed yet, protected by m_mutex
+	std::mutex m_mutex;
+	std::condition_variable m_wakeUp;
+	std::vector<SDatabaseWrite> m_pending;
+	bool m_committing;
+	bool m_stop;
+	bool m_done;
+
+	// Opens one connection in WAL mode
+	static sqlite3 * openConnection(const char *filename, int busyTimeout);
+
+	// Get a cached statement, prepare it the first time. 0 if it can't be (missing table, ...)
+	static sqlite3_stmt * getStatement(sqlite3 *db, sqlite3_stmt **statements, int statement);
+
+	// Commit a batch of writes
+	void commit(std::vector<SDatabaseWrite> & batch);
+
+protected:
+	// The writer thread
+	void execute(void *pArg);
+
+public:
+	// Constructeur / Destructeur
+	CDatabase();
+	virtual ~CDatabase();
+
+	// Open the file and start the writer. Call it once the process is set (after the fork of the instances)
+	bool open(const char *filename);
+
+	// Commit what is left in the queue then close everything
+	void close();
+
+	// A read statement ready to be bound and stepped, on the game thread only. 0 if the database is not there
+	sqlite3_stmt * prepare(int statement);
+
+	// Queue a write, it returns right away
+	void write(int statement, const char *arg1 = 0, const char *arg2 = 0);
+
+	// Wait until everything queued so far is committed. For the reads that must see
+	// the writes just made (admin commands), it blocks the calling thread
+	void flush();
+};
+
+
+extern CDatabase database;
+
+
+#endif
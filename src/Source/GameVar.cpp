@@ -460,6 +460,9 @@ GameVar::GameVar()
 	sv_maxPing = 1000;
 	dksvarRegister(CString("sv_maxPing [int : 0 to 1000 (default 1000)]"), &sv_maxPing, 0, 1000,
 		LIMIT_MIN | LIMIT_MAX, true);
+	sv_maxRewind = 300;
+	dksvarRegister(CString("sv_maxRewind [int : 0 to 1000, 0 = no lag compensation (default 300)]"), &sv_maxRewind, 0, 1000,
+		LIMIT_MIN | LIMIT_MAX, true);
 	sv_autoSpectateWhenIdle = true;
 	dksvarRegister(CString("sv_autoSpectateWhenIdle [bool : true | false (default true)]"), &sv_autoSpectateWhenIdle, true);
 	sv_autoSpectateIdleMaxTime = 180;
@@ -806,175 +809,137 @@ GameVar::~GameVar()
 
 
 //
-// Pour envoyer les variables servers au autres tayouin
+// Les variables servers qu'on envoie, trouvées une seule fois
 //
-void GameVar::sendSVVar(UINT4 babonetID)
+static struct
 {
-	sendOne("sv_friendlyFire", babonetID);
-	sendOne("sv_reflectedDamage", babonetID);
-	sendOne("sv_timeToSpawn", babonetID);
-	sendOne("sv_topView", babonetID);
-	sendOne("sv_minSendInterval", babonetID);
-	sendOne("sv_forceRespawn", babonetID);
-	sendOne("sv_baboStats", babonetID);
-	sendOne("sv_roundTimeLimit", babonetID);
-	sendOne("sv_gameTimeLimit", babonetID);
-	sendOne("sv_scoreLimit", babonetID);
-	sendOne("sv_winLimit", babonetID);
-	sendOne("sv_gameType", babonetID);
-   sendOne("sv_serverType", babonetID);
+	const char * name;
+	bool remoteAdminOnly;
+	dksvarHandle var;
+} svVars[] = {
+	{"sv_friendlyFire", false, 0},
+	{"sv_reflectedDamage", false, 0},
+	{"sv_timeToSpawn", false, 0},
+	{"sv_topView", false, 0},
+	{"sv_minSendInterval", false, 0},
+	{"sv_forceRespawn", false, 0},
+	{"sv_baboStats", false, 0},
+	{"sv_roundTimeLimit", false, 0},
+	{"sv_gameTimeLimit", false, 0},
+	{"sv_scoreLimit", false, 0},
+	{"sv_winLimit", false, 0},
+	{"sv_gameType", false, 0},
+	{"sv_serverType", false, 0},
 #if defined(_PRO_)
-   sendOne("sv_spawnType", babonetID);
-   sendOne("sv_subGameType", babonetID);
+	{"sv_spawnType", false, 0},
+	{"sv_subGameType", false, 0},
 #endif
-	sendOne("sv_bombTime", babonetID);
-	sendOne("sv_gameName", babonetID);
-	sendOne("sv_port", babonetID);
-	sendOne("sv_maxPlayer", babonetID);
-   sendOne("sv_maxPlayerInGame", babonetID);
-	sendOne("sv_password", babonetID);
-	sendOne("sv_enableSMG", babonetID);
-	sendOne("sv_enableShotgun", babonetID);
-	sendOne("sv_enableSniper", babonetID);
-	sendOne("sv_enableDualMachineGun", babonetID);
-	sendOne("sv_enableChainGun", babonetID);
-	sendOne("sv_enableBazooka", babonetID);
-	sendOne("sv_enablePhotonRifle", babonetID);
-	sendOne("sv_enableFlameThrower", babonetID);
-	sendOne("sv_enableShotgunReload", babonetID);
-	sendOne("sv_slideOnIce", babonetID);
-	sendOne("sv_showEnemyTag", babonetID);
-	sendOne("sv_enableSecondary", babonetID);
-	sendOne("sv_enableKnives", babonetID);
-	sendOne("sv_enableNuclear", babonetID);
-	sendOne("sv_enableShield", babonetID);
+	{"sv_bombTime", false, 0},
+	{"sv_gameName", false, 0},
+	{"sv_port", false, 0},
+	{"sv_maxPlayer", false, 0},
+	{"sv_maxPlayerInGame", false, 0},
+	{"sv_password", false, 0},
+	{"sv_enableSMG", false, 0},
+	{"sv_enableShotgun", false, 0},
+	{"sv_enableSniper", false, 0},
+	{"sv_enableDualMachineGun", false, 0},
+	{"sv_enableChainGun", false, 0},
+	{"sv_enableBazooka", false, 0},
+	{"sv_enablePhotonRifle", false, 0},
+	{"sv_enableFlameThrower", false, 0},
+	{"sv_enableShotgunReload", false, 0},
+	{"sv_slideOnIce", false, 0},
+	{"sv_showEnemyTag", false, 0},
+	{"sv_enableSecondary", false, 0},
+	{"sv_enableKnives", false, 0},
+	{"sv_enableNuclear", false, 0},
+	{"sv_enableShield", false, 0},
 #if defined(_PRO_)
-	sendOne("sv_enableMinibot", babonetID);
+	{"sv_enableMinibot", false, 0},
+	{"sv_showKills", true, 0},
+	{"sv_beGoodServer", true, 0},
+	{"sv_validateWeapons", true, 0},
 #endif
-	sendOne("sv_autoBalance", babonetID);
-	sendOne("sv_autoBalanceTime", babonetID);
-	sendOne("sv_gamePublic", babonetID);
-	sendOne("sv_matchcode", babonetID);
-	sendOne("sv_matchmode", babonetID);
-	sendOne("sv_maxPing", babonetID);
-	sendOne("sv_shottyDropRadius", babonetID);
-	sendOne("sv_shottyRange", babonetID);
-	sendOne("sv_enableMolotov", babonetID);
-	sendOne("sv_ftMaxRange", babonetID);
-	sendOne("sv_ftMinRange", babonetID);
-	sendOne("sv_photonDamageCoefficient", babonetID);
-	sendOne("sv_zookaRemoteDet", babonetID);
-	sendOne("sv_smgDamage", babonetID);
-	sendOne("sv_ftDamage", babonetID);
-	sendOne("sv_dmgDamage", babonetID);
-	sendOne("sv_cgDamage", babonetID);
-	sendOne("sv_shottyDamage", babonetID);
-	sendOne("sv_sniperDamage", babonetID);
-	sendOne("sv_zookaDamage", babonetID);
-	sendOne("sv_photonType", babonetID);
-	sendOne("sv_zookaRadius", babonetID);
-	sendOne("sv_nukeRadius", babonetID);
-	sendOne("sv_nukeTimer", babonetID);
-	sendOne("sv_nukeReload", babonetID);
-	sendOne("sv_minTilesPerBabo", babonetID);
-	sendOne("sv_maxTilesPerBabo", babonetID);
-	sendOne("sv_photonDistMult", babonetID);
-	sendOne("sv_photonVerticalShift", babonetID);
-	sendOne("sv_photonHorizontalShift", babonetID);
-	sendOne("sv_joinMessage", babonetID);
-	sendOne("sv_sendJoinMessage", babonetID);
-	sendOne("sv_ftExpirationTimer", babonetID);
-	sendOne("sv_explodingFT", babonetID);
-	sendOne("sv_enableVote", babonetID);
+	{"sv_autoBalance", false, 0},
+	{"sv_autoBalanceTime", false, 0},
+	{"sv_gamePublic", false, 0},
+	{"sv_matchcode", false, 0},
+	{"sv_matchmode", false, 0},
+	{"sv_maxPing", false, 0},
+	{"sv_shottyDropRadius", false, 0},
+	{"sv_shottyRange", false, 0},
+	{"sv_enableMolotov", false, 0},
+	{"sv_ftMaxRange", false, 0},
+	{"sv_ftMinRange", false, 0},
+	{"sv_photonDamageCoefficient", false, 0},
+	{"sv_zookaRemoteDet", false, 0},
+	{"sv_smgDamage", false, 0},
+	{"sv_ftDamage", false, 0},
+	{"sv_dmgDamage", false, 0},
+	{"sv_cgDamage", false, 0},
+	{"sv_shottyDamage", false, 0},
+	{"sv_sniperDamage", false, 0},
+	{"sv_zookaDamage", false, 0},
+	{"sv_photonType", false, 0},
+	{"sv_zookaRadius", false, 0},
+	{"sv_nukeRadius", false, 0},
+	{"sv_nukeTimer", false, 0},
+	{"sv_nukeReload", false, 0},
+	{"sv_minTilesPerBabo", false, 0},
+	{"sv_maxTilesPerBabo", false, 0},
+	{"sv_photonDistMult", false, 0},
+	{"sv_photonVerticalShift", false, 0},
+	{"sv_photonHorizontalShift", false, 0},
+	{"sv_joinMessage", false, 0},
+	{"sv_sendJoinMessage", false, 0},
+	{"sv_ftExpirationTimer", false, 0},
+	{"sv_explodingFT", false, 0},
+	{"sv_enableVote", false, 0},
+};
+static const int nbSVVar = sizeof(svVars) / sizeof(svVars[0]);
+static bool svVarsFound = false;
+static dksvarHandle svNukeReload = 0;
+
+static void findSVVars()
+{
+	if (svVarsFound) return;
+	for (int i=0;i<nbSVVar;++i) svVars[i].var = dksvarFind(svVars[i].name);
+	svNukeReload = dksvarFind("sv_nukeReload");
+	svVarsFound = true;
+}
+
+
+
+//
+// Pour envoyer les variables servers au autres tayouin
+//
+void GameVar::sendSVVar(UINT4 babonetID)
+{
+	findSVVars();
+	for (int i=0;i<nbSVVar;++i)
+	{
+		if (!svVars[i].remoteAdminOnly) sendOne(svVars[i].var, babonetID);
+	}
 }
 
 void GameVar::sendSVVar(INT4 peerId)
 {
-	sendOne("sv_friendlyFire", peerId);
-	sendOne("sv_reflectedDamage", peerId);
-	sendOne("sv_timeToSpawn", peerId);
-	sendOne("sv_topView", peerId);
-	sendOne("sv_minSendInterval", peerId);
-	sendOne("sv_forceRespawn", peerId);
-	sendOne("sv_baboStats", peerId);
-	sendOne("sv_roundTimeLimit", peerId);
-	sendOne("sv_gameTimeLimit", peerId);
-	sendOne("sv_scoreLimit", peerId);
-	sendOne("sv_winLimit", peerId);
-	sendOne("sv_gameType", peerId);
-   sendOne("sv_serverType", peerId);
-#if defined(_PRO_)
-   sendOne("sv_spawnType", peerId);
-   sendOne("sv_subGameType", peerId);
-#endif
-	sendOne("sv_bombTime", peerId);
-	sendOne("sv_gameName", peerId);
-	sendOne("sv_port", peerId);
-	sendOne("sv_maxPlayer", peerId);
-   sendOne("sv_maxPlayerInGame", peerId);
-	sendOne("sv_password", peerId);
-	sendOne("sv_enableSMG", peerId);
-	sendOne("sv_enableShotgun", peerId);
-	sendOne("sv_enableSniper", peerId);
-	sendOne("sv_enableDualMachineGun", peerId);
-	sendOne("sv_enableChainGun", peerId);
-	sendOne("sv_enableBazooka", peerId);
-	sendOne("sv_enablePhotonRifle", peerId);
-	sendOne("sv_enableFlameThrower", peerId);
-	sendOne("sv_enableShotgunReload", peerId);
-	sendOne("sv_slideOnIce", peerId);
-	sendOne("sv_showEnemyTag", peerId);
-	sendOne("sv_enableSecondary", peerId);
-	sendOne("sv_enableKnives", peerId);
-	sendOne("sv_enableNuclear", peerId);
-	sendOne("sv_enableShield", peerId);
-#if defined(_PRO_)
-	sendOne("sv_enableMinibot", peerId);
-	sendOne("sv_showKills", peerId);
-	sendOne("sv_beGoodServer", peerId);
-	sendOne("sv_validateWeapons", peerId);
-#endif
-	sendOne("sv_autoBalance", peerId);
-	sendOne("sv_autoBalanceTime", peerId);
-	sendOne("sv_gamePublic", peerId);
-	sendOne("sv_matchcode", peerId);
-	sendOne("sv_matchmode", peerId);
-	sendOne("sv_maxPing", peerId);
-	sendOne("sv_shottyDropRadius", peerId);
-	sendOne("sv_shottyRange", peerId);
-	sendOne("sv_enableMolotov", peerId);
-	sendOne("sv_ftMaxRange", peerId);
-	sendOne("sv_ftMinRange", peerId);
-	sendOne("sv_photonDamageCoefficient", peerId);
-	sendOne("sv_zookaRemoteDet", peerId);
-	sendOne("sv_smgDamage", peerId);
-	sendOne("sv_ftDamage", peerId);
-	sendOne("sv_dmgDamage", peerId);
-	sendOne("sv_cgDamage", peerId);
-	sendOne("sv_shottyDamage", peerId);
-	sendOne("sv_sniperDamage", peerId);
-	sendOne("sv_zookaDamage", peerId);
-	sendOne("sv_photonType", peerId);
-	sendOne("sv_zookaRadius", peerId);
-	sendOne("sv_nukeRadius", peerId);
-	sendOne("sv_nukeTimer", peerId);
-	sendOne("sv_nukeReload", peerId);
-	sendOne("sv_minTilesPerBabo",peerId);
-	sendOne("sv_maxTilesPerBabo",peerId);
-	sendOne("sv_photonDistMult", peerId);
-	sendOne("sv_photonVerticalShift", peerId);
-	sendOne("sv_photonHorizontalShift", peerId);
-	sendOne("sv_joinMessage", peerId);
-	sendOne("sv_sendJoinMessage", peerId);
-	sendOne("sv_ftExpirationTimer", peerId);
-	sendOne("sv_explodingFT", peerId);
-	sendOne("sv_enableVote", peerId);
+	findSVVars();
+	for (int i=0;i<nbSVVar;++i) sendOne(svVars[i].var, peerId);
 }
 
 void GameVar::sendOne(char * varName, INT4 peerId)
 {
+	sendOne(dksvarFind(varName), peerId);
+}
+
+void GameVar::sendOne(dksvarHandle var, INT4 peerId)
+{
+	if (!var) return;
+
 	CString varCom;
-	dksvarGetFormatedVar(varName, &varCom);
+	dksvarGetFormatedVar(var, &varCom);
 	//varCom.insert("set ", 0);
 
 	if (varCom.len() > 79) varCom.resize(79);
@@ -985,11 +950,19 @@ void GameVar::sendOne(char * varName, INT4 peerId)
 
 void GameVar::sendOne(char * varName, UINT4 babonetID)
 {
+	sendOne(dksvarFind(varName), babonetID);
+}
+
+void GameVar::sendOne(dksvarHandle var, UINT4 babonetID)
+{
+	if (!var) return;
+
 	CString varCom;
-	dksvarGetFormatedVar(varName, &varCom);
+	dksvarGetFormatedVar(var, &varCom);
 	varCom.insert("set ", 0);
 
-	if(varName == "sv_nukeReload")
+	findSVVars();
+	if(var == svNukeReload)
 	{
 		weapons[WEAPON_NUCLEAR]->fireDelay = sv_nukeReload;
 	}
@@ -160,6 +160,7 @@ public:
 	int sv_matchmode;
 	bool sv_report;
 	int sv_maxPing;
+	int sv_maxRewind;
 	bool sv_autoSpectateWhenIdle;
 	int sv_autoSpectateIdleMaxTime;
 	bool sv_beGoodServer;
@@ -565,8 +566,10 @@ public:
 	// send server var to a peer(remote admin)
 	void sendSVVar(INT4 peerId);
 	void sendOne(char * varName, UINT4 babonetID);
+	void sendOne(dksvarHandle var, UINT4 babonetID);
 	// send one var to a peer( remote admin )
 	void sendOne(char * varName, INT4 peerId);
+	void sendOne(dksvarHandle var, INT4 peerId);
 #ifndef DEDICATED_SERVER
 	bool languageLoaded;
 	// Pour loader les lang_ var
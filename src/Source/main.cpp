@@ -27,6 +27,7 @@
 #include "Zeven.h"
 #include "Scene.h"
 #include "Console.h"
+#include "Database.h"
 #include <exception>
 #include "CMaster.h"
 #ifndef DEDICATED_SERVER
@@ -242,6 +243,9 @@ public:
 			nbFrameElapsed--;
 		}
 
+		// Les textures lues en arriere-plan, un peu par frame
+		dktUpdate();
+
 #ifdef _DX_
 		if (dkglGetDXDevice())
 		{
@@ -310,32 +314,59 @@ public:
 #ifdef DEDICATED_SERVER
 
 #include "CThread.h"
-	bool s_locked = false;
-	bool s_internalLock = false;
+#include <atomic>
+#include <limits>
+
+// How many typed commands can wait for the game thread
+#define COMMAND_QUEUE_SIZE 64
+
+//
+// The commands typed in the terminal, the game thread runs them between two ticks.
+// One thread pushes (stdin) and one pops (the game), so no lock is needed.
+//
+class CCommandQueue
+{
+private:
+	CString commands[COMMAND_QUEUE_SIZE];
+	std::atomic<unsigned int> head; // Next one to run, moved by the game thread
+	std::atomic<unsigned int> tail; // Next free slot, moved by the stdin thread
+
+public:
+	CCommandQueue() : head(0), tail(0) {}
+
+	// From the stdin thread, false if the queue is full
+	bool push(const char * command)
+	{
+		unsigned int t = tail.load(std::memory_order_relaxed);
+		if (t - head.load(std::memory_order_acquire) >= COMMAND_QUEUE_SIZE) return false;
+		commands[t % COMMAND_QUEUE_SIZE] = command;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	// From the game thread, false if there is nothing to run
+	bool pop(CString & command)
+	{
+		unsigned int h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire)) return false;
+		command = commands[h % COMMAND_QUEUE_SIZE];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+};
 
 class CMainLoopConsole : public CThread
 {
 public:
-	bool locked;
-	bool internalLock;
+	CCommandQueue commands;
 
 public:
 	CMainLoopConsole()
 	{
-		locked = false;
-		internalLock = false;
 	}
 
 	void execute(void* pArg)
 	{
-		#ifndef WIN32 // linux timestruct for nanosleep
-			timespec ts;
-
-			ts.tv_sec = 0;
-			ts.tv_nsec = 1000000;
-		#endif
-	
-
 		while (!quit)
 		{
 			// On va updater notre timer
@@ -344,6 +375,13 @@ public:
 			// On va chercher notre delay
 			float delay = dkcGetElapsedf();
 
+			//--- The commands typed in the terminal
+			CString command;
+			while (commands.pop(command))
+			{
+				console->sendCommand(command);
+			}
+
 			// On passe le nombre de frame �animer
 			while (nbFrameElapsed)
 			{
@@ -359,97 +397,26 @@ public:
 				//printf("FPS: %f\n", dkcGetFPS());
 			}
 
-			//--- On check si on n'est pas lock�avant de continuer
-			if (locked)
-			{
-				internalLock = true;
-			}
-
-			while (internalLock)
+			//--- Nothing to do until the next tick, we sleep until then in one go.
+			// The network is only read by the tick, so waking up on traffic would just spin.
+			float timeLeft = dkcGetTimeToNextFrame();
+			if (timeLeft > 0)
 			{
 				#ifdef WIN32
-					Sleep(1);
+					Sleep((DWORD)(timeLeft * 1000.0f));
 				#else
-					if(nanosleep(&ts,0))
+					timespec ts;
+					ts.tv_sec = 0;
+					ts.tv_nsec = (long)(timeLeft * 1000000000.0f);
+					if(nanosleep(&ts,0) && errno != EINTR)
 					{
-						printf("problem nanosleep internal lock\n");
+						printf("problem nanosleep main loop\n");
 					}
 				#endif
-			//	printf("--- internalLock (execute)\n");
-			}
-
-			#ifdef WIN32
-				Sleep(1);
-			#else
-			if(nanosleep(&ts,0))
-			{
-				printf("problem nanosleep main loop\n");
 			}
-			#endif
 		}
 
 		//printf(" game main loop has quit \n");
-
-	/*	char input[256];
-		while (!quit)
-		{
-			std::cin.getline(input,256);
-
-
-			lock();
-			console->sendCommand(input);//CString("Execute CTF"));
-			unlock();
-
-			#ifdef WIN32
-				Sleep(1);
-			#else
-				if(nanosleep(&ts,0))
-				{
-					printf("problem nanosleep console loop\n");
-				}
-				ts.tv_sec = 0;
-				ts.tv_nsec = 1000000;
-			#endif
-
-			//cin.ignore( 10000 , '\n');
-			//input[0] = 0;
-			//fflush(stdin);
-		};*/
-	}
-
-	void lock()
-	{
-		#ifndef WIN32 // linux timestruct for nanosleep
-
-			timespec ts;
-
-			ts.tv_sec = 0;
-			ts.tv_nsec = 1000000;
-		#endif
-
-		locked = true;
-		while (!internalLock)
-		{
-			#ifdef WIN32
-				Sleep(1);
-			#else
-				if(nanosleep(&ts,0))
-				{
-					printf("problem nanosleep lock\n");
-				}
-				ts.tv_sec = 0;
-				ts.tv_nsec = 1000000;
-				
-				
-			#endif
-		//	printf("--- internalLock (lock)\n");
-		}
-	}
-
-	void unlock()
-	{
-		locked = false;
-		internalLock = false;
 	}
 };
 
@@ -480,13 +447,6 @@ int main(int argc, const char* argv[])
 
 
 
-	#ifndef WIN32 // linux timestruct for nanosleep
-		timespec ts;
-
-		ts.tv_sec = 0;
-		ts.tv_nsec = 1000000; // 1 ms
-	#endif
-
 	// PREMI�E CHOSE �FAIRE, on load les config
 	dksvarInit(&stringInterface);
 	dksvarLoadConfig("main/bv2.cfg");
@@ -520,6 +480,9 @@ int main(int argc, const char* argv[])
 	console = new Console();
 	console->init();
 
+	// bv2.db stays open until we quit
+	if (!database.open("bv2.db")) console->add("\x4> Can not open bv2.db");
+
 	//--- On cr�le master
 	master = new CMaster();
 
@@ -572,27 +535,6 @@ int main(int argc, const char* argv[])
 				//printf("FPS: %f\n", dkcGetFPS());
 			}
 
-			//--- On check si on n'est pas lock�avant de continuer
-			if (s_locked)
-			{
-				s_internalLock = true;
-			}
-
-			while (s_internalLock)
-			{
-				#ifdef WIN32
-					Sleep(1);
-				#else
-					if(nanosleep(&ts,0))
-					{
-						printf("problem nanosleep internal lock\n");
-					}
-					ts.tv_sec = 0;
-					ts.tv_nsec = 1000000;
-				#endif
-			//	printf("--- internalLock (execute)\n");
-			}
-
 			#ifdef WIN32
 				Sleep(1);
 			#else
@@ -613,33 +555,46 @@ int main(int argc, const char* argv[])
 	{
 		CString executeCmd = "execute ";
 		executeCmd += (char*)(argv[1]);
-		console->sendCommand(executeCmd);
+		mainLoopConsole.commands.push(executeCmd.s);
 	}
 
 
 	char input[256];
 	while (!quit)
 	{
+		// getline blocks until something is typed, the game thread runs it on its next loop
 		std::cin.getline(input,256);
 
+		// No terminal (nohup, systemd...), the game runs on its own until it quits
+		if (std::cin.eof() || std::cin.bad())
+		{
+			while (!quit && mainLoopConsole.isRunning())
+			{
+				#ifdef WIN32
+					Sleep(100);
+				#else
+					dkcSleep(100);
+				#endif
+			}
+			break;
+		}
 
-		mainLoopConsole.lock();
-		if(std::cin.gcount())
-			console->sendCommand(input);//CString("Execute CTF"));
-		mainLoopConsole.unlock();
-
-
-		#ifdef WIN32
-			Sleep(1);
+		// More than 255 characters, getline stopped there and failed. We drop the rest of the line
+		if (std::cin.fail())
+		{
+			std::cin.clear();
+			std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+			printf("Command too long, ignored\n");
+			continue;
+		}
 
-		#else
-			if(nanosleep(&ts,0))
+		if(std::cin.gcount())
+		{
+			if (!mainLoopConsole.commands.push(input))
 			{
-				printf("problem nanosleep console loop\n");
+				printf("Too many commands waiting, \"%s\" ignored\n", input);
 			}
-			ts.tv_sec = 0;
-			ts.tv_nsec = 1000000;
-		#endif
+		}
 
 		//cin.ignore( 10000 , '\n');
 		//input[0] = 0;
@@ -659,6 +614,9 @@ int main(int argc, const char* argv[])
 	master = 0;
 	scene = 0;
 
+	// Commit the last writes
+	database.close();
+
 	dksvarSaveConfig("main/bv2.cfg");
 
 	// On shutdown le tout (L'ordre est assez important ici)
@@ -798,6 +756,9 @@ int WINAPI WinMain(	HINSTANCE	hInstance,				// Instance
 	console = new Console();
 	console->init();
 
+	// bv2.db stays open until we quit
+	if (!database.open("bv2.db")) console->add("\x4> Can not open bv2.db");
+
 	// Create the status manager
 	status = new CStatus();
 
@@ -853,6 +814,9 @@ int WINAPI WinMain(	HINSTANCE	hInstance,				// Instance
 	delete lobby;
 	lobby = 0;
 
+	// Commit the last writes
+	database.close();
+
 	dksvarSaveConfig("main/bv2.cfg");
 
 	// On shutdown le tout (L'ordre est assez important ici)
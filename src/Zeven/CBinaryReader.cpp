@@ -0,0 +1,246 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "CBinaryReader.h"
+#include <stdio.h>
+
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+// Empty files are valid, they just have nothing to read
+static const unsigned char emptyFile[1] = {0};
+
+
+
+//
+// Constructeurs
+//
+CBinaryReader::CBinaryReader()
+{
+	m_data = 0;
+	m_size = 0;
+	m_pos = 0;
+	m_ok = true;
+	m_mapping = 0;
+	m_mappingSize = 0;
+	m_owned = 0;
+#ifdef WIN32
+	m_fileHandle = 0;
+	m_mapHandle = 0;
+#endif
+}
+
+CBinaryReader::CBinaryReader(const char * filename)
+{
+	m_data = 0;
+	m_size = 0;
+	m_pos = 0;
+	m_ok = true;
+	m_mapping = 0;
+	m_mappingSize = 0;
+	m_owned = 0;
+#ifdef WIN32
+	m_fileHandle = 0;
+	m_mapHandle = 0;
+#endif
+	open(filename);
+}
+
+CBinaryReader::CBinaryReader(const void * data, int size)
+{
+	m_data = 0;
+	m_size = 0;
+	m_pos = 0;
+	m_ok = true;
+	m_mapping = 0;
+	m_mappingSize = 0;
+	m_owned = 0;
+#ifdef WIN32
+	m_fileHandle = 0;
+	m_mapHandle = 0;
+#endif
+	setBuffer(data, size);
+}
+
+
+
+//
+// Destructeur
+//
+CBinaryReader::~CBinaryReader()
+{
+	close();
+}
+
+
+
+//
+// Map the whole file
+//
+bool CBinaryReader::open(const char * filename)
+{
+	close();
+	if (!filename) return false;
+
+#ifdef WIN32
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	DWORD sizeHigh = 0;
+	DWORD size = GetFileSize(file, &sizeHigh);
+	if (sizeHigh || size > 0x7fffffff)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	if (size == 0)
+	{
+		CloseHandle(file);
+		m_data = emptyFile;
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+	void * view = (mapping) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+	if (view)
+	{
+		m_fileHandle = file;
+		m_mapHandle = mapping;
+		m_mapping = view;
+		m_mappingSize = (int)size;
+		m_data = (const unsigned char *)view;
+		m_size = (int)size;
+		return true;
+	}
+	if (mapping) CloseHandle(mapping);
+	CloseHandle(file);
+#else
+	int fd = ::open(filename, O_RDONLY);
+	if (fd == -1) return false;
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size > 0x7fffffff)
+	{
+		::close(fd);
+		return false;
+	}
+	int size = (int)fileStat.st_size;
+	if (size == 0)
+	{
+		::close(fd);
+		m_data = emptyFile;
+		return true;
+	}
+
+	void * view = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // The mapping keeps the file
+	if (view != MAP_FAILED)
+	{
+		m_mapping = view;
+		m_mappingSize = size;
+		m_data = (const unsigned char *)view;
+		m_size = size;
+		return true;
+	}
+#endif
+
+	// Could not map it (network drive, special file), we read it all at once
+	FILE * fic = fopen(filename, "rb");
+	if (!fic) return false;
+	fseek(fic, 0, SEEK_END);
+	long fileSize = ftell(fic);
+	fseek(fic, 0, SEEK_SET);
+	if (fileSize < 0 || fileSize > 0x7fffffff)
+	{
+		fclose(fic);
+		return false;
+	}
+	m_owned = new unsigned char [fileSize + 1];
+	m_size = (int)fread(m_owned, 1, fileSize, fic);
+	fclose(fic);
+	m_data = m_owned;
+	return true;
+}
+
+
+
+//
+// Someone else owns the memory
+//
+void CBinaryReader::setBuffer(const void * data, int size)
+{
+	close();
+	m_data = (const unsigned char *)data;
+	m_size = (data && size > 0) ? size : 0;
+}
+
+
+
+//
+// Give back the mapping
+//
+void CBinaryReader::close()
+{
+#ifdef WIN32
+	if (m_mapping) UnmapViewOfFile(m_mapping);
+	if (m_mapHandle) CloseHandle((HANDLE)m_mapHandle);
+	if (m_fileHandle) CloseHandle((HANDLE)m_fileHandle);
+	m_fileHandle = 0;
+	m_mapHandle = 0;
+#else
+	if (m_mapping) munmap(m_mapping, m_mappingSize);
+#endif
+	if (m_owned) delete [] m_owned;
+	m_owned = 0;
+	m_mapping = 0;
+	m_mappingSize = 0;
+	m_data = 0;
+	m_size = 0;
+	m_pos = 0;
+	m_ok = true;
+}
+
+
+
+//
+// A string in place
+//
+const char * CBinaryReader::getString()
+{
+	if (m_pos >= m_size)
+	{
+		m_ok = false;
+		return 0;
+	}
+	const char * string = (const char *)(m_data + m_pos);
+	const void * end = memchr(string, 0, m_size - m_pos);
+	if (!end)
+	{
+		m_ok = false;
+		m_pos = m_size;
+		return 0;
+	}
+	m_pos += (int)((const char *)end - string) + 1;
+	return string;
+}
@@ -0,0 +1,130 @@
+/*
+	Copyright 2012 bitHeads inc.
+
+	This file is part of the BaboViolent 2 source code.
+
+	The BaboViolent 2 source code is free software: you can redistribute it and/or 
+	modify it under the terms of the GNU General Public License as published by the 
+	Free Software Foundation, either version 3 of the License, or (at your option) 
+	any later version.
+
+	The BaboViolent 2 source code is distributed in the hope that it will be useful, 
+	but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along with the 
+	BaboViolent 2 source code. If not, see http://www.gnu.org/licenses/.
+*/
+
+
+#ifndef CBINARYREADER_H
+#define CBINARYREADER_H
+
+
+#include "CVector.h"
+#include <string.h>
+#include <stdint.h>
+
+
+// Read-only view over a whole file (memory mapped) or over a buffer we don't own.
+// Nothing is virtual and nothing is allocated while reading. Reading past the end
+// returns zeros and clears isOk(), so a loader checks once when it is done.
+class CBinaryReader
+{
+private:
+	const unsigned char * m_data;
+	int m_size;
+	int m_pos;
+	bool m_ok;
+
+	// What we have to give back on close
+	void * m_mapping;
+	int m_mappingSize;
+	unsigned char * m_owned;
+#ifdef WIN32
+	void * m_fileHandle;
+	void * m_mapHandle;
+#endif
+
+	// Not copiable, we hold the mapping
+	CBinaryReader(const CBinaryReader &);
+	void operator=(const CBinaryReader &);
+
+public:
+	// Constructeurs
+	CBinaryReader();
+	CBinaryReader(const char * filename);
+	CBinaryReader(const void * data, int size);
+
+	// Destructeur
+	~CBinaryReader();
+
+	// Map a whole file, falls back to reading it in memory
+	bool open(const char * filename);
+
+	// Read from memory owned by someone else
+	void setBuffer(const void * data, int size);
+
+	void close();
+
+	// The file was opened
+	bool isValid() const {return (m_data != 0);}
+
+	// Nothing was read past the end
+	bool isOk() const {return m_ok;}
+
+	int getPos() const {return m_pos;}
+	int getSize() const {return m_size;}
+	int getRemaining() const {return m_size - m_pos;}
+	const unsigned char * getData() const {return m_data;}
+
+	// Move forward, false if there is not that much left
+	bool skip(int count)
+	{
+		if (count < 0 || count > m_size - m_pos)
+		{
+			m_ok = false;
+			m_pos = m_size;
+			return false;
+		}
+		m_pos += count;
+		return true;
+	}
+
+	// The next count bytes as they are in the file, 0 if there is not that much left
+	const unsigned char * getSpan(int count)
+	{
+		if (!skip(count)) return 0;
+		return m_data + m_pos - count;
+	}
+
+	// Copy the next count bytes, dest is zeroed if there is not that much left
+	bool read(void * dest, int count)
+	{
+		const unsigned char * span = getSpan(count);
+		if (!span)
+		{
+			if (count > 0) memset(dest, 0, count);
+			return false;
+		}
+		memcpy(dest, span, count);
+		return true;
+	}
+
+	// Same sizes as FileIO
+	bool getBool() {return (getByte() == 1) ? true : false;}
+	char getByte() {char tmp; read(&tmp, sizeof(tmp)); return tmp;}
+	unsigned char getUByte() {unsigned char tmp; read(&tmp, sizeof(tmp)); return tmp;}
+	int getInt() {short tmp; read(&tmp, sizeof(tmp)); return tmp;} // short
+	unsigned int getUInt() {unsigned short tmp; read(&tmp, sizeof(tmp)); return tmp;} // unsigned short
+	int32_t getLong() {int32_t tmp; read(&tmp, sizeof(tmp)); return tmp;}
+	uint32_t getULong() {uint32_t tmp; read(&tmp, sizeof(tmp)); return tmp;}
+	float getFloat() {float tmp; read(&tmp, sizeof(tmp)); return tmp;}
+	CVector3f getVector3f() {float tmp[3]; read(tmp, sizeof(tmp)); return CVector3f(tmp[0], tmp[1], tmp[2]);}
+
+	// A '\0' terminated string, pointing in the file. 0 if the terminator is missing
+	const char * getString();
+};
+
+
+#endif
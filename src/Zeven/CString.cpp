@@ -37,36 +37,170 @@
 ////////////////////////////////////////////////////////////////////////////////////////
 CString::CString(char* fmt, ...)
 {
-    static char mString[MAX_CARAC];
+	s = m_local;
+	m_capacity = 0;
+	m_local[0] = '\0';
 
-    
-	if (!fmt)
+	if (!fmt) return;
+
+	// Ici on passe tout les param (c comme un printf) pour les mettre dans le string
+	va_list		ap;
+	va_start(ap, fmt);
+	setv(fmt, ap);
+	va_end(ap);
+
+    // avoid buffer overrun, le constructeur a toujours coupe a MAX_CARAC
+	resize(MAX_CARAC - 1);
+}
+
+
+
+//
+// Constructeur par deplacement
+//
+CString::CString(CString && objToMove) noexcept
+{
+	if (objToMove.m_capacity)
 	{
-		s = new char [1];
-		s[0] = '\0';
+		// On prend son bloc, il retombe sur son buffer local
+		s = objToMove.s;
+		m_capacity = objToMove.m_capacity;
+		objToMove.s = objToMove.m_local;
+		objToMove.m_capacity = 0;
+		objToMove.m_local[0] = '\0';
+	}
+	else
+	{
+		s = m_local;
+		m_capacity = 0;
+		memcpy(m_local, objToMove.m_local, CSTRING_LOCAL_SIZE);
+	}
+}
+
+
+
+//
+// Assignation par deplacement
+//
+void CString::operator=(CString && objToMove) noexcept
+{
+	if (this == &objToMove) return;
+	if (objToMove.m_capacity)
+	{
+		if (m_capacity) delete [] s;
+		s = objToMove.s;
+		m_capacity = objToMove.m_capacity;
+		objToMove.s = objToMove.m_local;
+		objToMove.m_capacity = 0;
+		objToMove.m_local[0] = '\0';
+	}
+	else
+	{
+		// Petite string, on garde notre bloc s'il y en a un
+		assign(objToMove.s, objToMove.len());
+	}
+}
+
+
+
+//
+// Copie length caracteres. string peut pointer dans notre propre bloc
+//
+void CString::assign(const char* string, int length)
+{
+	int capacity = m_capacity ? m_capacity : CSTRING_LOCAL_SIZE;
+	if (length < capacity)
+	{
+		memmove(s, string, length);
+		s[length] = '\0';
 		return;
 	}
 
-	// On cr�un char de 512 pour contenir le string (pas besoin de plus que 512 je crois)
-//	char *mString = new char[MAX_CARAC];
+	// Nouveau bloc, l'ancien est libere apres la copie au cas ou string pointe dedans
+	char* newBlock = new char[length+1];
+	memcpy(newBlock, string, length);
+	newBlock[length] = '\0';
+	if (m_capacity) delete [] s;
+	s = newBlock;
+	m_capacity = length+1;
+}
+
+
+
+//
+// Ajoute length caracteres a la fin
+//
+void CString::append(const char* string, int length)
+{
+	if (length <= 0) return;
+	int len_ = len();
+	int capacity = m_capacity ? m_capacity : CSTRING_LOCAL_SIZE;
+	if (len_ + length < capacity)
+	{
+		memmove(s + len_, string, length);
+		s[len_ + length] = '\0';
+		return;
+	}
+
+	// On double, pour que les += en boucle restent lineaires
+	int newCapacity = capacity * 2;
+	if (newCapacity < len_ + length + 1) newCapacity = len_ + length + 1;
+	char* newBlock = new char[newCapacity];
+	memcpy(newBlock, s, len_);
+	memcpy(newBlock + len_, string, length);
+	newBlock[len_ + length] = '\0';
+	if (m_capacity) delete [] s;
+	s = newBlock;
+	m_capacity = newCapacity;
+}
+
+
+
+//
+// Formate comme un printf dans notre bloc
+//
+void CString::setv(const char* fmt, va_list ap)
+{
+	// Formate d'abord sur la pile, les arguments peuvent pointer dans s
+	char mString[MAX_CARAC];
+	va_list ap2;
+	va_copy(ap2, ap);
+	int length = vsnprintf(mString, sizeof(mString), fmt, ap);
+	if (length < 0) length = 0;
+
+	if (length < MAX_CARAC)
+	{
+		assign(mString, length);
+	}
+	else
+	{
+		// Trop long pour la pile
+		char* newBlock = new char[length+1];
+		vsnprintf(newBlock, length+1, fmt, ap2);
+		if (m_capacity) delete [] s;
+		s = newBlock;
+		m_capacity = length+1;
+	}
+	va_end(ap2);
+}
+
+
+
+//
+// Formate dans le buffer de l'appelant
+//
+int CString::format(char* buffer, int size, const char* fmt, ...)
+{
+	if (size <= 0) return 0;
 
-	// Ici on passe tout les param (c comme un printf) pour les mettre dans le string
 	va_list		ap;
 	va_start(ap, fmt);
-#ifdef WIN32
-	_vsnprintf(mString, sizeof(mString), fmt, ap);
-#else
-	vsnprintf(mString, sizeof(mString), fmt, ap);
-#endif
+	int length = vsnprintf(buffer, size, fmt, ap);
 	va_end(ap);
 
-    // avoid buffer overrun
-    mString[MAX_CARAC - 1] = 0;
-	// On lui transfert la valeur finale
-	s = new char [strlen(mString)+1];
-	strcpy(s, mString);
-
-	//delete [] mString;
+	buffer[size-1] = '\0';
+	if (length < 0) return 0;
+	return (length < size) ? length : size-1;
 }
 
 
@@ -82,22 +216,9 @@ CString::CString(char* fmt, ...)
 void CString::resize(int newSize)
 {
 	if (newSize >= len()) return;
-	if (newSize > 0)
-	{
-		char tmp[10];
-		sprintf(tmp, "%%.%is", newSize);
-		CString newStr(tmp, s);
-		set("%s", newStr.s);
-	}
-	else
-	{
-		// On le remet �vide
-		delete [] s;
-		s = new char [1];
-		s[0] = '\0';
-	}
+	// On le coupe sur place, le bloc est garde
+	s[(newSize > 0) ? newSize : 0] = '\0';
 }
-
 ////////////////////////////////////////////////////////////////////////////////////////
 /// \brief Fonction qui permet de modifier la taille de la cha�e de caract�e et qui en
 /// plus l'inverse
@@ -111,25 +232,21 @@ void CString::resizeInverse(int newSize){
 
 	if (newSize > 0)
 	{
-		// On le resize
+		// On garde les newSize derniers caracteres
 		int len_ = len();
 		if (len_-newSize > 0)
 		{
-			CString newStr("%s", &(s[len_-newSize]));
-			set("%s", newStr.s);
+			memmove(s, &(s[len_-newSize]), newSize+1);
 		}
 	}
 	else
 	{
-		// On le remet �vide
-		delete [] s;
-		s = new char [1];
+		// On le remet vide
 		s[0] = '\0';
 	}
 }
 
 
-
 ////////////////////////////////////////////////////////////////////////////////////////////
 /// \brief Fonction qui permet d'assigner une valeur �une cha�e existante de la m�e fa�n
 ///	qu'un printf
@@ -141,31 +258,18 @@ void CString::set(char* fmt, ...){
 
 	if (!fmt)
 	{
-		delete [] s;
-		s = new char [1];
 		s[0] = '\0';
 		return;
 	}
 
-	// On cr�un char de 256 pour contenir le string (pas besoin de plus que 256 je crois)
-	char *mString = new char[MAX_CARAC];
-
 	// Ici on passe tout les param (c comme un printf) pour les mettre dans le string
 	va_list		ap;
 	va_start(ap, fmt);
-		vsprintf(mString, fmt, ap);
+	setv(fmt, ap);
 	va_end(ap);
-
-	// On lui transfert la valeur finale
-	delete [] s;
-	s = new char [strlen(mString)+1];
-	strcpy(s, mString);
-
-	delete [] mString;
 }
 
 
-
 ////////////////////////////////////////////////////////////////////////////////////////////
 /// \brief V�ifie l'extension d'une cha�e de caract�e
 ///
@@ -211,9 +315,9 @@ CString CString::getPath()
 	{
 		if (s[i] == '\\' || s[i] == '/')
 		{
-			char tmp[10];
-			sprintf(tmp, "%%.%is", i+1);
-			return CString(tmp, s);
+			CString result;
+			result.assign(s, i+1);
+			return result;
 		}
 	}
 
@@ -221,7 +325,6 @@ CString CString::getPath()
 }
 
 
-
 //////////////////////////////////////////////////////////////
 ///Obtenir le nom du fichier d'un chemin complet
 //////////////////////////////////////////////////////////////
@@ -233,9 +336,9 @@ CString CString::getFilename()
 	{
 		if (s[i] == '\\' || s[i] == '/')
 		{
-			char tmp[10];
-			sprintf(tmp, "%%.%is", len()-(i+1));
-			return CString(tmp, &(s[i+1]));
+			CString result;
+			result.assign(&(s[i+1]), len()-(i+1));
+			return result;
 		}
 	}
 
@@ -243,7 +346,6 @@ CString CString::getFilename()
 }
 
 
-
 ////////////////////////////////////////////////////////////////////////////////////////////
 /// \brief Enlever des caract�es au d�ut et �la fin de la cha�e
 ///
@@ -254,36 +356,18 @@ CString CString::getFilename()
 void CString::trim(char caracter)
 {
 
-	// En enl�e les caract�es au d�ut
-	int len_ = len();
-	int i=0;
-	for (i=0;i<len_;i++)
-	{
-		if (s[i] != caracter)
-		{
-			break;
-		}
-	}
-	CString newString("%s", &(s[i]));
-
-	// les dernier caract�e maintenant
-	for (i=newString.len()-1;i>=0;i--)
-	{
-		if (newString.s[i] != caracter)
-		{
-			break;
-		}
-	}
-
-	char tmp[10];
-	sprintf(tmp, "%%.%is", i+1);
-	CString newString2(tmp, newString.s);
+	// les dernier caract�e d'abord
+	int i=len()-1;
+	while (i >= 0 && s[i] == caracter) i--;
+	s[i+1] = '\0';
 
-	set("%s", newString2.s);
+	// En enl�e les caract�es au d�ut, sur place
+	int start=0;
+	while (s[start] && s[start] == caracter) start++;
+	if (start) memmove(s, &(s[start]), i+1-start+1);
 }
 
 
-
 ////////////////////////////////////////////////////////////////////////////////////////////
 /// \brief Permet de prendre le token suivant
 ///
@@ -304,7 +388,7 @@ CString CString::getNextToken(int caracter)
 	// On va chercher le dernier ' ' trouv�
 	for (int i = len()-1; i >= -1; i--)
 	{
-		if (s[i] == caracter || i == -1)
+		if (i == -1 || s[i] == caracter)
 		{
 			result = &(s[i+1]);
 			resize(i+1);
@@ -318,7 +402,6 @@ CString CString::getNextToken(int caracter)
 	return result;
 }
 
-
 ////////////////////////////////////////////////////////////////////////////////////////////
 /// \brief Permet de prendre le token �partir du d�ut
 ///
@@ -341,9 +424,7 @@ CString CString::getFirstToken(int caracterSeparator)
 	int len_ = len();
 	for (int i=0;i<=len_;i++){
 		if (s[i] == caracterSeparator || s[i] == '\0'){
-			char tmp[10];
-			sprintf(tmp, "%%.%is", i);
-			result = CString(tmp, s);
+			result.assign(s, i);
 			resizeInverse(len_-i);
 			break;
 		}
@@ -356,7 +437,6 @@ CString CString::getFirstToken(int caracterSeparator)
 }
 
 
-
 ////////////////////////////////////////////////////////////////////////////////////////////
 /// \brief Recherche de caract�es
 ///
@@ -584,12 +664,16 @@ bool CString::find(char* string_, char* strFound, int & index)
 ////////////////////////////////////////////////////////////////////////////////////////////
 void CString::insert(CString string, int index){
 
-	char tmp[10];
-	sprintf(tmp, "%%.%is%%s%%s", index);
-	CString newString(tmp, s, string.s, &(s[index]));
-	set("%s", newString.s);
+	int len_ = len();
+	if (index > len_) index = len_;
+	if (index < 0) index = 0;
+
+	CString newString;
+	newString.assign(s, index);
+	newString.append(string.s, string.len());
+	newString.append(&(s[index]), len_-index);
+	*this = static_cast<CString&&>(newString);
 }
-
 ////////////////////////////////////////////////////////////////////////////////////////////
 /// \brief Insertion de texte (avec pointeur)
 ///
@@ -613,14 +697,12 @@ void CString::insert(char *string, int index){
 ////////////////////////////////////////////////////////////////////////////////////////////
 void CString::remove(int index){
 
-	char tmp[10];
-	sprintf(tmp, "%%.%is%%s", index);
-	CString newString(tmp, s, &(s[index+1]));
-	set("%s", newString.s);
+	int len_ = len();
+	if (index < 0 || index >= len_) return;
+	memmove(&(s[index]), &(s[index+1]), len_-index);
 }
 
 
-
 ////////////////////////////////////////////////////////////////////////////////////////////
 /// \brief Remplis la cha�e de caract�e par le chemin de l'application
 ///
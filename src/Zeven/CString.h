@@ -30,6 +30,9 @@
 //E.P Uhhhmmm... pas sr que j'aime �...
 #define MAX_CARAC 512
 
+/// Caracteres gardes dans l'objet meme (avec le '\0'), une string plus courte n'alloue rien
+#define CSTRING_LOCAL_SIZE 20
+
 
 #include <string.h>
 #include <stdio.h>
@@ -52,20 +55,43 @@
 class CString
 {
 public:
-	/// Pointeur qui contient notre cha�e de caract�e
+	/// Pointeur qui contient notre chaine de caractere. Pointe sur m_local tant qu'elle y entre
 	char* s;
 
+private:
+	/// Taille du bloc alloue, 0 quand s pointe sur m_local
+	int m_capacity;
+
+	/// Les petites strings sont ici, sans allocation
+	char m_local[CSTRING_LOCAL_SIZE];
+
+	// Copie length caracteres. string peut pointer dans s, le bloc est garde s'il est assez grand
+	void assign(const char* string, int length);
+
+	// Formate comme un printf, tronque a MAX_CARAC-1 caracteres comme avant
+	void setv(const char* fmt, va_list ap);
+
+public:
 	// Constructeurs
 
-	///Constructeur par d�aut. La string est initialis� avec un seul caract�e, le caract�e nul.
-	CString(){s = new char[1]; s[0] = '\0';}
+	///Constructeur par defaut. La string est vide, rien n'est alloue.
+	CString(){s = m_local; m_capacity = 0; m_local[0] = '\0';}
 	CString(char* fmt, ...);
 
 	/// Constructeur copie
-	CString(const CString & objToCopy){s = new char[strlen(objToCopy.s)+1]; strcpy(s, objToCopy.s);}
+	CString(const CString & objToCopy){s = m_local; m_capacity = 0; assign(objToCopy.s, objToCopy.len());}
+
+	// Constructeur par deplacement, prend le bloc de l'autre
+	CString(CString && objToMove) noexcept;
 
 	/// Destructeur
-	virtual ~CString(){delete [] s;}
+	~CString(){if (m_capacity) delete [] s;}
+
+	// Ajoute length caracteres a la fin, le bloc double au besoin
+	void append(const char* string, int length);
+
+	// Formate dans le buffer de l'appelant, sans allocation. Retourne la longueur ecrite
+	static int format(char* buffer, int size, const char* fmt, ...);
 
 	// V�ifie l'extension d'une cha�e de caract�e
 	bool checkExtension(char * extension);
@@ -117,7 +143,7 @@ public:
 	void replace(char toReplace, char by){int len_=len(); for(int i=0;i<len_;i++) if(s[i] == toReplace) s[i]=by;}
 
 	///Vide la cha�e
-	void reset(){delete [] s; s = new char[1]; s[0] = '\0';}
+	void reset(){s[0] = '\0';}
 
 	// Changer ses dimensions
 	void resize(int newSize);
@@ -149,46 +175,32 @@ public:
 	char& operator[](const int i) const {return (i>=0 && i<len()) ? s[i] : ((i<0) ? s[0] : s[len()-1]);}
 
 	///Copier �partir d'un pointeur
-	void operator=(const char* string)
-	{
-		if(this->s != string)
-		{
-			delete [] s;
-			s = new char[strlen(string)+1];
-			strcpy(s, string);
-		}
-	}
-	///Copier �partir de l'adresse de l'objet
-	void operator=(const CString &objToCopy)
-	{
-		if(this != &objToCopy)
-		{
-			delete [] s;
-			s = new char[strlen(objToCopy.s)+1];
-			strcpy(s, objToCopy.s);
-		}
-	}
-	///Copier �partir d'un int
+	void operator=(const char* string){assign(string, (int)strlen(string));}
+	///Copier a partir de l'adresse de l'objet
+	void operator=(const CString &objToCopy){if (this != &objToCopy) assign(objToCopy.s, objToCopy.len());}
+	///Deplacer, prend le bloc de l'autre
+	void operator=(CString && objToMove) noexcept;
+	///Copier a partir d'un int
 	void operator=(int value){set("%i", value);}
 	///Copier �partir d'un flaot
 	void operator=(float value){set("%f", value);}
 
 	///Concat�ation �partir de l'adresse de la string (retourne une string)
-	CString operator+(const CString& string){return CString("%s%s", s, string.s);}
-	///Concat�ation �partir de l'adresse de la string (en affectant la valeur �la string courante)
-	void operator+=(const CString &string){set("%s%s", s, string.s);}
-	///Concat�ation �partir d'un pointeur sur une string (retourne une string)
-	CString operator+(char* string){return CString("%s%s", s, string);}
-	///Concat�ation �partir d'un pointeur sur une string (en affectant la valeur �la string courante)
-	void operator+=(char* string){set("%s%s", s, string);}
-	///Concat�ation �partir d'un int (retourne une string)
-	CString operator+(int value){return CString("%s%i", s, value);}
-	///Concat�ation �partir d'un int sur une string (en affectant la valeur �la string courante)
-	void operator+=(int value){set("%s%i", s, value);}
-	///Concat�ation �partir d'un float (retourne une string)
-	CString operator+(float value){return CString("%s%f", s, value);}
-	///Concat�ation �partir d'un float sur une string (en affectant la valeur �la string courante)
-	void operator+=(float value){set("%s%f", s, value);}
+	CString operator+(const CString& string){CString result(*this); result.append(string.s, string.len()); return result;}
+	///Concatenation a partir de l'adresse de la string (en affectant la valeur a la string courante)
+	void operator+=(const CString &string){append(string.s, string.len());}
+	///Concatenation a partir d'un pointeur sur une string (retourne une string)
+	CString operator+(char* string){CString result(*this); result.append(string, (int)strlen(string)); return result;}
+	///Concatenation a partir d'un pointeur sur une string (en affectant la valeur a la string courante)
+	void operator+=(char* string){append(string, (int)strlen(string));}
+	///Concatenation a partir d'un int (retourne une string)
+	CString operator+(int value){CString result(*this); result += value; return result;}
+	///Concatenation a partir d'un int sur une string (en affectant la valeur a la string courante)
+	void operator+=(int value){char tmp[16]; append(tmp, format(tmp, sizeof(tmp), "%i", value));}
+	///Concatenation a partir d'un float (retourne une string)
+	CString operator+(float value){CString result(*this); result += value; return result;}
+	///Concatenation a partir d'un float sur une string (en affectant la valeur a la string courante)
+	void operator+=(float value){char tmp[64]; append(tmp, format(tmp, sizeof(tmp), "%f", value));}
 
 	///Retourne vrai si les deux string sont identiques
 	bool operator==(const CString &string){return (stricmp(s, string.s)==0);}
@@ -69,8 +69,8 @@ void FileIO::putLine(CString line)
 CString FileIO::getLine()
 {
 	char buffer[160];
-	fgets(buffer, 160, m_file);
-	return buffer;
+	if (!fgets(buffer, 160, m_file)) buffer[0] = '\0'; // Fin du fichier
+	return CString("%s", buffer); // Pas formate, une ligne peut avoir des %
 }
 
 
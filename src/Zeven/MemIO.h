@@ -94,6 +94,7 @@ public:
 	void put(unsigned char * data, int size);
 
 	unsigned int getPos() { return m_pos; }
+	const char * getData() { return m_data; }
 };
 
 